@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Convert a meshtasticd packet capture (Logging: CaptureFile) to JSON, one object per line
+
+Usage:
+    bin/capture-to-json.py /var/log/meshtasticd.pcap > trace.json
+
+The record layout is described in src/platform/portduino/PacketCapture.h. Decoded records are expanded into their
+protobuf fields when the meshtastic python package is installed, otherwise their payload is given as hex.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+LINKTYPE = 147
+PCAP_HEADER = struct.Struct("<IHHiIII")
+RECORD_HEADER = struct.Struct("<IIII")
+CAPTURE_HEADER = struct.Struct("<BBHhhIIBBH")
+AIR_HEADER = struct.Struct("<IIIBBBB")
+
+TYPES = {0: "rx", 1: "tx", 2: "decoded"}
+FLAG_PKI_ENCRYPTED = 0x01
+
+try:
+    from google.protobuf.json_format import MessageToDict
+    from meshtastic.protobuf import mesh_pb2
+except ImportError:
+    mesh_pb2 = None
+
+
+def node_id(num):
+    return "!%08x" % num
+
+
+def decode_data(payload):
+    if mesh_pb2 is None:
+        return None
+    data = mesh_pb2.Data()
+    try:
+        data.ParseFromString(payload)
+    except Exception:
+        return None
+    return MessageToDict(data)
+
+
+def convert_record(ts_sec, ts_usec, record):
+    (version, rtype, header_len, rssi, snr_q, freq_khz, rx_time, ch_index, flags, _) = CAPTURE_HEADER.unpack_from(record)
+    to, frm, pid, air_flags, channel, next_hop, relay_node = AIR_HEADER.unpack_from(record, header_len)
+    payload = record[header_len + AIR_HEADER.size :]
+
+    out = {
+        "timestamp": ts_sec + ts_usec / 1e6,
+        "type": TYPES.get(rtype, rtype),
+        "from": node_id(frm),
+        "to": node_id(to),
+        "id": pid,
+        "hop_limit": air_flags & 0x07,
+        "hop_start": (air_flags & 0xE0) >> 5,
+        "want_ack": bool(air_flags & 0x08),
+        "via_mqtt": bool(air_flags & 0x10),
+        "next_hop": next_hop,
+        "relay_node": relay_node,
+        "pki_encrypted": bool(flags & FLAG_PKI_ENCRYPTED),
+    }
+    if rx_time:
+        out["rx_time"] = rx_time
+    if rtype != 1:
+        out["rssi"] = rssi
+        out["snr"] = snr_q / 4
+    if rtype == 2:
+        out["channel_index"] = ch_index
+        decoded = decode_data(payload)
+        if decoded is not None:
+            out["decoded"] = decoded
+        else:
+            out["payload"] = payload.hex()
+    else:
+        out["channel_hash"] = channel
+        out["frequency_mhz"] = freq_khz / 1000
+        out["encrypted"] = payload.hex()
+    return out
+
+
+def convert(f, out):
+    header = f.read(PCAP_HEADER.size)
+    if len(header) < PCAP_HEADER.size:
+        sys.exit("Not a packet capture: too short")
+    magic, _, _, _, _, _, linktype = PCAP_HEADER.unpack(header)
+    if magic != 0xA1B2C3D4 or linktype != LINKTYPE:
+        sys.exit("Not a meshtasticd packet capture")
+
+    while True:
+        rec = f.read(RECORD_HEADER.size)
+        if len(rec) < RECORD_HEADER.size:
+            break
+        ts_sec, ts_usec, incl_len, _ = RECORD_HEADER.unpack(rec)
+        record = f.read(incl_len)
+        if len(record) < incl_len:
+            break  # Still being written
+        out.write(json.dumps(convert_record(ts_sec, ts_usec, record)) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", help="capture file written by meshtasticd")
+    args = parser.parse_args()
+    with open(args.capture, "rb") as f:
+        convert(f, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Train the static dictionary used by src/mesh/compression/dictcomp.cpp
+
+Usage:
+    bin/train-compression-dict.py bin/compression-corpus.txt > src/mesh/compression/dictcomp_dict.h
+
+Each line of the corpus is one sample payload. Lines starting with "hex:" are binary payloads (encoded NodeInfo User,
+Telemetry, ...), everything else is UTF-8 text. Lines starting with "#" are comments.
+
+Bump --id whenever the dictionary changes: nodes refuse to decompress payloads made with a dictionary they don't have.
+"""
+
+import argparse
+import collections
+import sys
+
+MAX_DICT = 1536  # dictcomp.cpp can only address 2048 bytes back, and inputs may be up to 256 bytes
+MIN_SEG = 3
+MAX_SEG = 24
+NO_POS = 0xFFFF
+
+
+def hash3(a, b, c):
+    # Must match hash3() in dictcomp.cpp
+    return (((a << 16) | (b << 8) | c) * 2654435761 & 0xFFFFFFFF) >> 24
+
+
+def load_corpus(path):
+    samples = []
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not line or line.startswith("#"):
+                continue
+            if line.startswith("hex:"):
+                samples.append(bytes.fromhex(line[4:]))
+            else:
+                samples.append(line.encode("utf-8"))
+    return samples
+
+
+def train(samples, size):
+    # Score every substring by how many samples contain it times the bytes a 2 byte match saves
+    counts = collections.Counter()
+    for s in samples:
+        seen = set()
+        for i in range(len(s)):
+            for n in range(MIN_SEG, min(MAX_SEG, len(s) - i) + 1):
+                seen.add(s[i : i + n])
+        counts.update(seen)
+
+    scored = sorted(((c * (len(seg) - 2), seg) for seg, c in counts.items() if c > 1), reverse=True)
+
+    chosen = []
+    total = 0
+    for score, seg in scored:
+        if total + len(seg) > size:
+            continue
+        if any(seg in c for c in chosen):
+            continue
+        # A longer segment supersedes the shorter ones it contains
+        chosen = [c for c in chosen if c not in seg]
+        chosen.append(seg)
+        total = sum(len(c) for c in chosen)
+
+    # Most valuable segments last, nearest to the data
+    return b"".join(reversed(chosen))
+
+
+def chains(d):
+    head = [NO_POS] * 256
+    prev = [NO_POS] * len(d)
+    for p in range(len(d) - 2):
+        h = hash3(d[p], d[p + 1], d[p + 2])
+        prev[p] = head[h]
+        head[h] = p
+    return head, prev
+
+
+def c_array(ctype, name, values, width, per_line):
+    out = [f"static const {ctype} {name}[] = {{"]
+    for i in range(0, len(values), per_line):
+        out.append("    " + ", ".join(f"0x{v:0{width}x}" for v in values[i : i + per_line]) + ",")
+    out.append("};")
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("corpus")
+    parser.add_argument("--size", type=int, default=MAX_DICT)
+    parser.add_argument("--id", type=int, default=1)
+    args = parser.parse_args()
+
+    if args.size > MAX_DICT:
+        sys.exit(f"Dictionary size is limited to {MAX_DICT} bytes")
+
+    d = train(load_corpus(args.corpus), args.size)
+    head, prev = chains(d)
+
+    print("#pragma once")
+    print(f"// Generated by bin/train-compression-dict.py from {args.corpus}, do not edit")
+    print()
+    print("#include <stdint.h>")
+    print()
+    print(f"#define DICTCOMP_DICT_ID {args.id}")
+    print()
+    print(c_array("uint8_t", "dictcomp_dict", list(d), 2, 16))
+    print()
+    print("// Hash chains over the dictionary, see dictcomp_compress()")
+    print(c_array("uint16_t", "dictcomp_dict_head", head, 4, 12))
+    print()
+    print(c_array("uint16_t", "dictcomp_dict_prev", prev, 4, 12))
+
+
+if __name__ == "__main__":
+    main()
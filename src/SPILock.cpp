@@ -1,12 +1,25 @@
 #include "SPILock.h"
 #include "configuration.h"
+#include "mesh/PipelineStats.h"
 #include <Arduino.h>
 #include <assert.h>
 
-concurrency::Lock *spiLock;
+SPIBusLock *spiLock;
+
+void SPIBusLock::lock(SPIUser user)
+{
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+    uint32_t startTicks = PipelineStats::ticks();
+    Lock::lock();
+    // Nobody else can be recording while we hold the lock
+    pipelineStats.recordSpiWait(user, startTicks);
+#else
+    Lock::lock();
+#endif
+}
 
 void initSPI()
 {
     assert(!spiLock);
-    spiLock = new concurrency::Lock();
-}
\ No newline at end of file
+    spiLock = new SPIBusLock();
+}
@@ -2,11 +2,31 @@
 
 #include "../concurrency/LockGuard.h"
 
+/// Who is using the SPI bus, for lock-wait statistics
+enum SPIUser : uint8_t {
+    SPI_USER_RADIO,   // RadioLib transactions
+    SPI_USER_STORAGE, // Flash, SD card, sensors and everything else that just locks spiLock
+    SPI_USER_DISPLAY, // Screen updates
+    NUM_SPI_USERS
+};
+
+/**
+ * The lock for the SPI bus, which keeps a histogram of how long each kind of user waited for it (see PipelineStats), so
+ * we can tell how much the display and file system hold up the radio.
+ */
+class SPIBusLock : public concurrency::Lock
+{
+  public:
+    /// Lock as SPI_USER_STORAGE, so concurrency::LockGuard works as before
+    void lock() override { lock(SPI_USER_STORAGE); }
+    void lock(SPIUser user);
+};
+
 /**
  * Used to provide mutual exclusion for access to the SPI bus.  Usage:
  * concurrency::LockGuard g(spiLock);
  */
-extern concurrency::Lock *spiLock;
+extern SPIBusLock *spiLock;
 
 /** Setup SPI access and create the spiLock lock. */
-void initSPI();
\ No newline at end of file
+void initSPI();
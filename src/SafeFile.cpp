@@ -92,6 +92,15 @@ bool SafeFile::close()
     return true;
 }
 
+void SafeFile::abandon()
+{
+    if (!f)
+        return;
+
+    concurrency::LockGuard g(spiLock);
+    f.close();
+}
+
 /// Read our (closed) tempfile back in and compare the hash
 bool SafeFile::testReadback()
 {
@@ -105,10 +114,13 @@ bool SafeFile::testReadback()
         return false;
     }
 
-    int c = 0;
+    // Byte by byte reads are slow on LittleFS, and we hold the SPI lock throughout
+    uint8_t block[64];
+    int n = 0;
     uint8_t test_hash = 0;
-    while ((c = f2.read()) >= 0) {
-        test_hash ^= (uint8_t)c;
+    while ((n = f2.read(block, sizeof(block))) > 0) {
+        for (int i = 0; i < n; i++)
+            test_hash ^= block[i];
     }
     f2.close();
 
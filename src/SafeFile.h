@@ -37,6 +37,9 @@ class SafeFile : public Print
      */
     bool close();
 
+    /// Close the file without checking or installing it, for writers that are about to start over
+    void abandon();
+
   private:
     /// Read our (closed) tempfile back in and compare the hash
     bool testReadback();
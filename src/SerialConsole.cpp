@@ -4,6 +4,7 @@
 #include "PowerFSM.h"
 #include "Throttle.h"
 #include "configuration.h"
+#include "main.h"
 #include "time.h"
 
 #ifdef RP2040_SLOW_CLOCK
@@ -72,6 +73,12 @@ void SerialConsole::flush()
     Port.flush();
 }
 
+void SerialConsole::wakeForWrite()
+{
+    setIntervalFromNow(0);
+    runASAP = true;
+}
+
 // For the serial port we can't really detect if any client is on the other side, so instead just look for recent messages
 bool SerialConsole::checkIsConnected()
 {
@@ -37,6 +37,8 @@ class SerialConsole : public StreamAPI, public RedirectablePrint, private concur
     /// Check the current underlying physical link to see if the client is currently connected
     virtual bool checkIsConnected() override;
 
+    virtual void wakeForWrite() override;
+
     /// Possibly switch to protobufs if we see a valid protobuf message
     virtual void log_to_serial(const char *logLevel, const char *format, va_list arg);
 };
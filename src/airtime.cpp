@@ -163,6 +163,10 @@ int32_t AirTime::runOnce()
 {
     secSinceBoot++;
 
+    // The region or override may have changed
+    bool limited = myRegion && !config.lora.override_duty_cycle && myRegion->dutyCycle < 100;
+    budget.setRate(limited ? myRegion->dutyCycle : 100, millis());
+
     uint8_t utilPeriod = this->getPeriodUtilMinute();
     uint8_t utilPeriodTX = this->getPeriodUtilHour();
 
@@ -2,6 +2,7 @@
 
 #include "MeshRadio.h"
 #include "concurrency/OSThread.h"
+#include "mesh/AirtimeBudget.h"
 #include "configuration.h"
 #include <Arduino.h>
 #include <functional>
@@ -62,6 +63,9 @@ class AirTime : private concurrency::OSThread
     bool isTxAllowedChannelUtil(bool polite = false);
     bool isTxAllowedAirUtil();
 
+    /// Airtime the radio may still spend, and what it has spent per port
+    AirtimeBudget budget;
+
   private:
     bool firstTime = true;
     uint8_t lastUtilPeriod = 0;
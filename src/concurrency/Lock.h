@@ -12,6 +12,7 @@ class Lock
 {
   public:
     Lock();
+    virtual ~Lock() = default;
 
     Lock(const Lock &) = delete;
     Lock &operator=(const Lock &) = delete;
@@ -19,12 +20,12 @@ class Lock
     /// Locks the lock.
     //
     // Must not be called from an ISR.
-    void lock();
+    virtual void lock();
 
     // Unlocks the lock.
     //
     // Must not be called from an ISR.
-    void unlock();
+    virtual void unlock();
 
   private:
 #ifdef HAS_FREE_RTOS
@@ -224,35 +224,22 @@ uint8_t GPS::makeCASPacket(uint8_t class_id, uint8_t msg_id, uint8_t payload_siz
 
 GPS_RESPONSE GPS::getACK(const char *message, uint32_t waitMillis)
 {
-    uint8_t buffer[768] = {0};
-    uint8_t b;
-    int bytesRead = 0;
-    uint32_t startTimeout = millis() + waitMillis;
-#ifdef GPS_DEBUG
-    std::string debugmsg = "";
-#endif
-    while (millis() < startTimeout) {
-        if (_serial_gps->available()) {
-            b = _serial_gps->read();
+    uint32_t startTime = millis();
+    GPSStream::Frame frame;
 
+    while (Throttle::isWithinTimespanMs(startTime, waitMillis)) {
+        if (!nextFrame(frame))
+            continue;
+        if (frame.type != GPSStream::FRAME_NMEA)
+            continue;
 #ifdef GPS_DEBUG
-            debugmsg += vformat("%c", (b >= 32 && b <= 126) ? b : '.');
-#endif
-            buffer[bytesRead] = b;
-            bytesRead++;
-            if ((bytesRead == 767) || (b == '\r')) {
-                if (strnstr((char *)buffer, message, bytesRead) != nullptr) {
-#ifdef GPS_DEBUG
-                    LOG_DEBUG("Found: %s", message); // Log the found message
+        LOG_DEBUG("%.*s", frame.length, (const char *)frame.data);
 #endif
-                    return GNSS_RESPONSE_OK;
-                } else {
-                    bytesRead = 0;
+        if (frame.contains(message)) {
 #ifdef GPS_DEBUG
-                    LOG_DEBUG(debugmsg.c_str());
+            LOG_DEBUG("Found: %s", message); // Log the found message
 #endif
-                }
-            }
+            return GNSS_RESPONSE_OK;
         }
     }
     return GNSS_RESPONSE_NONE;
@@ -261,8 +248,7 @@ GPS_RESPONSE GPS::getACK(const char *message, uint32_t waitMillis)
 GPS_RESPONSE GPS::getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
 {
     uint32_t startTime = millis();
-    uint8_t buffer[CAS_ACK_NACK_MSG_SIZE] = {0};
-    uint8_t bufferPos = 0;
+    GPSStream::Frame frame;
 
     // CAS-ACK-(N)ACK structure
     //         | H1   | H2   | Payload Len | cls  | msg  | Payload                   | Checksum (4)              |
@@ -272,48 +258,30 @@ GPS_RESPONSE GPS::getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMilli
     // ACK-ACK | 0xBA | 0xCE | 0x04 | 0x00 | 0x05 | 0x01 | 0xXX | 0xXX | 0x00 | 0x00 | 0xXX | 0xXX | 0xXX | 0xXX |
 
     while (Throttle::isWithinTimespanMs(startTime, waitMillis)) {
-        if (_serial_gps->available()) {
-            buffer[bufferPos++] = _serial_gps->read();
-
-            // keep looking at the first two bytes of buffer until
-            // we have found the CAS frame header (0xBA, 0xCE), if not
-            // keep reading bytes until we find a frame header or we run
-            // out of time.
-            if ((bufferPos == 2) && !(buffer[0] == 0xBA && buffer[1] == 0xCE)) {
-                buffer[0] = buffer[1];
-                buffer[1] = 0;
-                bufferPos = 1;
-            }
-        }
-
-        // we have read all the bytes required for the Ack/Nack (14-bytes)
-        // and we must have found a frame to get this far
-        if (bufferPos == sizeof(buffer) - 1) {
-            uint8_t msg_cls = buffer[4];     // message class should be 0x05
-            uint8_t msg_msg_id = buffer[5];  // message id should be 0x00 or 0x01
-            uint8_t payload_cls = buffer[6]; // payload class id
-            uint8_t payload_msg = buffer[7]; // payload message id
-
-            // Check for an ACK-ACK for the specified class and message id
-            if ((msg_cls == 0x05) && (msg_msg_id == 0x01) && payload_cls == class_id && payload_msg == msg_id) {
+        if (!nextFrame(frame))
+            continue;
+
+        // The stream has already found the frame header and verified the checksum, we only need to look
+        // for an (N)ACK of the right message
+        if (frame.type != GPSStream::FRAME_CAS || frame.msgClass() != 0x05 || frame.payloadLength() < 2)
+            continue;
+        if (frame.payload()[0] != class_id || frame.payload()[1] != msg_id)
+            continue;
+
+        // Check for an ACK-ACK for the specified class and message id
+        if (frame.msgId() == 0x01) {
 #ifdef GPS_DEBUG
-                LOG_INFO("Got ACK for class %02X message %02X in %dms", class_id, msg_id, millis() - startTime);
+            LOG_INFO("Got ACK for class %02X message %02X in %dms", class_id, msg_id, millis() - startTime);
 #endif
-                return GNSS_RESPONSE_OK;
-            }
+            return GNSS_RESPONSE_OK;
+        }
 
-            // Check for an ACK-NACK for the specified class and message id
-            if ((msg_cls == 0x05) && (msg_msg_id == 0x00) && payload_cls == class_id && payload_msg == msg_id) {
+        // Check for an ACK-NACK for the specified class and message id
+        if (frame.msgId() == 0x00) {
 #ifdef GPS_DEBUG
-                LOG_WARN("Got NACK for class %02X message %02X in %dms", class_id, msg_id, millis() - startTime);
+            LOG_WARN("Got NACK for class %02X message %02X in %dms", class_id, msg_id, millis() - startTime);
 #endif
-                return GNSS_RESPONSE_NAK;
-            }
-
-            // This isn't the frame we are looking for, clear the buffer
-            // and try again until we run out of time.
-            memset(buffer, 0x0, sizeof(buffer));
-            bufferPos = 0;
+            return GNSS_RESPONSE_NAK;
         }
     }
     return GNSS_RESPONSE_NONE;
@@ -321,68 +289,43 @@ GPS_RESPONSE GPS::getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMilli
 
 GPS_RESPONSE GPS::getACK(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
 {
-    uint8_t b;
-    uint8_t ack = 0;
-    const uint8_t ackP[2] = {class_id, msg_id};
-    uint8_t buf[10] = {0xB5, 0x62, 0x05, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00};
     uint32_t startTime = millis();
     const char frame_errors[] = "More than 100 frame errors";
-    int sCounter = 0;
+    GPSStream::Frame frame;
+
+    while (Throttle::isWithinTimespanMs(startTime, waitMillis)) {
+        if (!nextFrame(frame))
+            continue;
+
+        if (frame.type == GPSStream::FRAME_NMEA) {
+            // u-blox reports a disabled UART receiver as a TXT sentence
+            if (frame.contains(frame_errors)) {
 #ifdef GPS_DEBUG
-    std::string debugmsg = "";
+                LOG_DEBUG("%.*s", frame.length, (const char *)frame.data);
 #endif
+                return GNSS_RESPONSE_FRAME_ERRORS;
+            }
+            continue;
+        }
 
-    for (int j = 2; j < 6; j++) {
-        buf[8] += buf[j];
-        buf[9] += buf[8];
-    }
-
-    for (int j = 0; j < 2; j++) {
-        buf[6 + j] = ackP[j];
-        buf[8] += buf[6 + j];
-        buf[9] += buf[8];
-    }
+        // UBX-ACK-ACK (0x05 0x01) or UBX-ACK-NAK (0x05 0x00), payload is the acknowledged class and id
+        if (frame.type != GPSStream::FRAME_UBX || frame.msgClass() != 0x05 || frame.payloadLength() < 2)
+            continue;
+        if (frame.payload()[0] != class_id || frame.payload()[1] != msg_id)
+            continue;
 
-    while (Throttle::isWithinTimespanMs(startTime, waitMillis)) {
-        if (ack > 9) {
+        if (frame.msgId() == 0x01) {
 #ifdef GPS_DEBUG
             LOG_INFO("Got ACK for class %02X message %02X in %dms", class_id, msg_id, millis() - startTime);
 #endif
             return GNSS_RESPONSE_OK; // ACK received
         }
-        if (_serial_gps->available()) {
-            b = _serial_gps->read();
-            if (b == frame_errors[sCounter]) {
-                sCounter++;
-                if (sCounter == 26) {
-#ifdef GPS_DEBUG
-
-                    LOG_DEBUG(debugmsg.c_str());
-#endif
-                    return GNSS_RESPONSE_FRAME_ERRORS;
-                }
-            } else {
-                sCounter = 0;
-            }
-#ifdef GPS_DEBUG
-            debugmsg += vformat("%02X", b);
-#endif
-            if (b == buf[ack]) {
-                ack++;
-            } else {
-                if (ack == 3 && b == 0x00) { // UBX-ACK-NAK message
-#ifdef GPS_DEBUG
-                    LOG_DEBUG(debugmsg.c_str());
-#endif
-                    LOG_WARN("Got NAK for class %02X message %02X", class_id, msg_id);
-                    return GNSS_RESPONSE_NAK; // NAK received
-                }
-                ack = 0; // Reset the acknowledgement counter
-            }
+        if (frame.msgId() == 0x00) {
+            LOG_WARN("Got NAK for class %02X message %02X", class_id, msg_id);
+            return GNSS_RESPONSE_NAK; // NAK received
         }
     }
 #ifdef GPS_DEBUG
-    LOG_DEBUG(debugmsg.c_str());
     LOG_WARN("No response for class %02X message %02X", class_id, msg_id);
 #endif
     return GNSS_RESPONSE_NONE; // No response received within timeout
@@ -399,73 +342,25 @@ GPS_RESPONSE GPS::getACK(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis)
  */
 int GPS::getACK(uint8_t *buffer, uint16_t size, uint8_t requestedClass, uint8_t requestedID, uint32_t waitMillis)
 {
-    uint16_t ubxFrameCounter = 0;
     uint32_t startTime = millis();
-    uint16_t needRead = 0;
+    GPSStream::Frame frame;
 
     while (Throttle::isWithinTimespanMs(startTime, waitMillis)) {
-        if (_serial_gps->available()) {
-            int c = _serial_gps->read();
-            switch (ubxFrameCounter) {
-            case 0:
-                // ubxFrame 'μ'
-                if (c == 0xB5) {
-                    ubxFrameCounter++;
-                }
-                break;
-            case 1:
-                // ubxFrame 'b'
-                if (c == 0x62) {
-                    ubxFrameCounter++;
-                } else {
-                    ubxFrameCounter = 0;
-                }
-                break;
-            case 2:
-                // Class
-                if (c == requestedClass) {
-                    ubxFrameCounter++;
-                } else {
-                    ubxFrameCounter = 0;
-                }
-                break;
-            case 3:
-                // Message ID
-                if (c == requestedID) {
-                    ubxFrameCounter++;
-                } else {
-                    ubxFrameCounter = 0;
-                }
-                break;
-            case 4:
-                // Payload length lsb
-                needRead = c;
-                ubxFrameCounter++;
-                break;
-            case 5:
-                // Payload length msb
-                needRead |= (c << 8);
-                ubxFrameCounter++;
-                // Check for buffer overflow
-                if (needRead >= size) {
-                    ubxFrameCounter = 0;
-                    break;
-                }
-                if (_serial_gps->readBytes(buffer, needRead) != needRead) {
-                    ubxFrameCounter = 0;
-                } else {
-                    // return payload length
+        if (!nextFrame(frame))
+            continue;
+        if (frame.type != GPSStream::FRAME_UBX || frame.msgClass() != requestedClass || frame.msgId() != requestedID)
+            continue;
+
+        uint16_t needRead = frame.payloadLength();
+        // Check for buffer overflow
+        if (needRead >= size)
+            continue;
+        memcpy(buffer, frame.payload(), needRead);
 #ifdef GPS_DEBUG
-                    LOG_INFO("Got ACK for class %02X message %02X in %dms", requestedClass, requestedID, millis() - startTime);
+        LOG_INFO("Got ACK for class %02X message %02X in %dms", requestedClass, requestedID, millis() - startTime);
 #endif
-                    return needRead;
-                }
-                break;
-
-            default:
-                break;
-            }
-        }
+        // return payload length
+        return needRead;
     }
     return 0;
 }
@@ -1008,6 +903,8 @@ void GPS::setConnected()
 // We want a GPS lock. Wake the hardware
 void GPS::up()
 {
+    lastWakeStartMsec = millis();
+    bytesAtWake = stream.getStats().bytesIn;
     scheduling.informSearching();
     setPowerState(GPS_ACTIVE);
 }
@@ -1015,6 +912,7 @@ void GPS::up()
 // We've got a GPS lock. Enter a low power state, potentially.
 void GPS::down()
 {
+    logStreamStats();
     scheduling.informGotLock();
     uint32_t predictedSearchDuration = scheduling.predictedSearchDurationMs();
     uint32_t sleepTime = scheduling.msUntilNextSearch();
@@ -1161,6 +1059,31 @@ void GPS::clearBuffer()
     while (x--)
         _serial_gps->read();
 #endif
+    stream.reset();
+}
+
+// Get the next framed message, topping up the ring from the UART if nothing complete is buffered.
+// Used by the blocking probe/ACK loops, so yield for a tick rather than spinning when the UART is idle.
+bool GPS::nextFrame(GPSStream::Frame &frame)
+{
+    if (stream.next(frame))
+        return true;
+    if (stream.fill(*_serial_gps) == 0) {
+        delay(1);
+        return false;
+    }
+    return stream.next(frame);
+}
+
+void GPS::logStreamStats()
+{
+    const GPSStream::Stats &stats = stream.getStats();
+    uint32_t awakeMs = millis() - lastWakeStartMsec;
+    uint32_t bytes = stats.bytesIn - bytesAtWake;
+    LOG_DEBUG("GPS stream: %u bytes in %ums (%u B/s), NMEA %u (%u skipped), UBX %u, CAS %u, bad checksums %u, garbage %u, "
+              "overflow %u",
+              bytes, awakeMs, awakeMs ? (uint32_t)((uint64_t)bytes * 1000 / awakeMs) : 0, stats.nmeaFrames, stats.nmeaSkipped,
+              stats.ubxFrames, stats.casFrames, stats.checksumErrors, stats.garbageBytes, stats.overflowBytes);
 }
 
 /// Prepare the GPS for the cpu entering deep or light sleep, expect to be gone for at least 100s of msecs
@@ -1354,33 +1277,23 @@ GnssModel_t GPS::probe(int serialSpeed)
 
 GnssModel_t GPS::getProbeResponse(unsigned long timeout, const std::vector<ChipInfo> &responseMap)
 {
-    String response = "";
-    unsigned long start = millis();
-    while (millis() - start < timeout) {
-        if (_serial_gps->available()) {
-            response += (char)_serial_gps->read();
+    uint32_t startTime = millis();
+    GPSStream::Frame frame;
 
-            if (response.endsWith(",") || response.endsWith("\r\n")) {
+    while (Throttle::isWithinTimespanMs(startTime, timeout)) {
+        if (!nextFrame(frame) || frame.type != GPSStream::FRAME_NMEA)
+            continue;
 #ifdef GPS_DEBUG
-                LOG_DEBUG(response.c_str());
+        LOG_DEBUG("%.*s", frame.length, (const char *)frame.data);
 #endif
-                // check if we can see our chips
-                for (const auto &chipInfo : responseMap) {
-                    if (strstr(response.c_str(), chipInfo.detectionString.c_str()) != nullptr) {
-                        LOG_INFO("%s detected", chipInfo.chipName.c_str());
-                        return chipInfo.driver;
-                    }
-                }
-            }
-            if (response.endsWith("\r\n")) {
-                response.trim();
-                response = ""; // Reset the response string for the next potential message
+        // check if we can see our chips
+        for (const auto &chipInfo : responseMap) {
+            if (frame.contains(chipInfo.detectionString.c_str())) {
+                LOG_INFO("%s detected", chipInfo.chipName.c_str());
+                return chipInfo.driver;
             }
         }
     }
-#ifdef GPS_DEBUG
-    LOG_DEBUG(response.c_str());
-#endif
     return GNSS_MODEL_UNKNOWN; // Return empty string on timeout
 }
 
@@ -1717,13 +1630,21 @@ bool GPS::hasFlow()
     return reader.passedChecksum() > 0;
 }
 
+// Only the sentences TinyGPS++ actually decodes are worth feeding to it character by character
+static bool isParsedSentence(const GPSStream::Frame &frame)
+{
+    if (frame.isSentence("GGA") || frame.isSentence("RMC"))
+        return true;
+#ifndef TINYGPS_OPTION_NO_CUSTOM_FIELDS
+    if (frame.isSentence("GSA"))
+        return true;
+#endif
+    return false;
+}
+
 bool GPS::whileActive()
 {
-    unsigned int charsInBuf = 0;
     bool isValid = false;
-#ifdef GPS_DEBUG
-    std::string debugmsg = "";
-#endif
     if (powerState != GPS_ACTIVE) {
         clearBuffer();
         return false;
@@ -1735,27 +1656,28 @@ bool GPS::whileActive()
     }
 #endif
     // First consume any chars that have piled up at the receiver
-    while (_serial_gps->available() > 0) {
-        int c = _serial_gps->read();
-        UBXscratch[charsInBuf] = c;
+    stream.fill(*_serial_gps);
+
+    GPSStream::Frame frame;
+    while (stream.next(frame)) {
+        // Binary replies only matter while we are waiting for them in getACK()
+        if (frame.type != GPSStream::FRAME_NMEA)
+            continue;
 #ifdef GPS_DEBUG
-        debugmsg += vformat("%c", (c >= 32 && c <= 126) ? c : '.');
+        LOG_DEBUG("%.*s", frame.length, (const char *)frame.data);
 #endif
-        isValid |= reader.encode(c);
-        if (charsInBuf > sizeof(UBXscratch) - 10 || c == '\r') {
-            if (strnstr((char *)UBXscratch, "$GPTXT,01,01,02,u-blox ag - www.u-blox.com*50", charsInBuf)) {
-                rebootsSeen++;
-            }
-            charsInBuf = 0;
-        } else {
-            charsInBuf++;
+        if (isParsedSentence(frame)) {
+            for (uint16_t i = 0; i < frame.length; i++)
+                isValid |= reader.encode(frame.data[i]);
+            continue;
         }
+
+        if (frame.isSentence("TXT") && frame.contains("$GPTXT,01,01,02,u-blox ag - www.u-blox.com*50"))
+            rebootsSeen++;
+        // Still proof that the chip is talking to us
+        isValid |= frame.nmeaChecksumOk();
+        stream.markSkipped();
     }
-#ifdef GPS_DEBUG
-    if (debugmsg != "") {
-        LOG_DEBUG(debugmsg.c_str());
-    }
-#endif
     return isValid;
 }
 void GPS::enable()
@@ -3,6 +3,7 @@
 #if !MESHTASTIC_EXCLUDE_GPS
 
 #include "GPSStatus.h"
+#include "GPSStream.h"
 #include "GpioLogic.h"
 #include "Observer.h"
 #include "TinyGPS++.h"
@@ -99,6 +100,9 @@ class GPS : private concurrency::OSThread
     /// Returns true if there's valid data flow with the chip.
     virtual bool hasFlow();
 
+    /// Parse and throughput counters of the serial ingestion layer
+    const GPSStream::Stats &getStreamStats() const { return stream.getStats(); }
+
     /// Return true if we are connected to a GPS
     bool isConnected() const { return hasGPS; }
 
@@ -148,6 +152,8 @@ class GPS : private concurrency::OSThread
     GnssModel_t gnssModel = GNSS_MODEL_UNKNOWN;
 
     TinyGPSPlus reader;
+    GPSStream stream;
+    uint32_t bytesAtWake = 0; // stream.bytesIn when we last woke, for throughput logging
     uint8_t fixQual = 0; // fix quality from GPGGA
     uint32_t lastChecksumFailCount = 0;
 
@@ -209,6 +215,12 @@ class GPS : private concurrency::OSThread
 
     GPS_RESPONSE getACKCas(uint8_t class_id, uint8_t msg_id, uint32_t waitMillis);
 
+    /// Get the next complete NMEA/UBX/CAS frame from the serial port, false if none arrived yet
+    bool nextFrame(GPSStream::Frame &frame);
+
+    /// Log parse and throughput statistics of the serial stream for the current wake period
+    void logStreamStats();
+
     /// Prepare the GPS for the cpu entering deep sleep, expect to be gone for at least 100s of msecs
     /// always returns 0 to indicate okay to sleep
     int prepareDeepSleep(void *unused);
@@ -0,0 +1,218 @@
+#include "GPSStream.h"
+#if !MESHTASTIC_EXCLUDE_GPS
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+static inline bool isSyncChar(uint8_t c)
+{
+    return c == '$' || c == 0xB5 || c == 0xBA;
+}
+
+bool GPSStream::Frame::isSentence(const char *type3) const
+{
+    // $ + two char talker + three char type
+    return type == FRAME_NMEA && length >= 6 && memcmp(data + 3, type3, 3) == 0;
+}
+
+bool GPSStream::Frame::contains(const char *text) const
+{
+    size_t textLen = strlen(text);
+    if (textLen == 0 || textLen > length)
+        return false;
+    for (size_t i = 0; i + textLen <= length; i++) {
+        if (data[i] == (uint8_t)text[0] && memcmp(data + i, text, textLen) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool GPSStream::Frame::nmeaChecksumOk() const
+{
+    if (type != FRAME_NMEA)
+        return false;
+    uint8_t parity = 0;
+    for (size_t i = 1; i < length; i++) {
+        if (data[i] == '*') {
+            if (i + 2 >= length || !isxdigit(data[i + 1]) || !isxdigit(data[i + 2]))
+                return false;
+            char hex[3] = {(char)data[i + 1], (char)data[i + 2], 0};
+            return parity == (uint8_t)strtoul(hex, nullptr, 16);
+        }
+        parity ^= data[i];
+    }
+    return false;
+}
+
+size_t GPSStream::fill(Stream &serial)
+{
+    size_t total = 0;
+
+    // Bounded so that a chattering receiver can't keep us in here forever
+    while (total < GPS_STREAM_BUFFER_SIZE) {
+        int avail = serial.available();
+        if (avail <= 0)
+            break;
+
+        if (used() == GPS_STREAM_BUFFER_SIZE) {
+            if (total > 0)
+                break; // Let the caller drain what we just read first
+
+            // We fell behind the UART. Old fixes are worthless, so drop the oldest data rather than the newest.
+            size_t drop = std::min<size_t>(used(), avail);
+            stats.overflowBytes += drop;
+            pendingLen = 0;
+            skip(drop);
+        }
+
+        size_t start = head & mask;
+        size_t span = std::min<size_t>(GPS_STREAM_BUFFER_SIZE - used(), GPS_STREAM_BUFFER_SIZE - start);
+        span = std::min<size_t>(span, avail);
+
+        size_t got = serial.readBytes(ring + start, span);
+        if (got == 0)
+            break;
+        head += got;
+        total += got;
+    }
+
+    stats.bytesIn += total;
+    return total;
+}
+
+bool GPSStream::next(Frame &frame)
+{
+    // Release the frame we handed out last time
+    if (pendingLen) {
+        skip(pendingLen);
+        pendingLen = 0;
+    }
+
+    while (used() > 0) {
+        size_t avail = used();
+        uint8_t c = at(0);
+
+        if (c == '$') {
+            size_t limit = std::min<size_t>(avail, GPS_STREAM_MAX_NMEA);
+            size_t i = std::max<size_t>(nmeaScanned, 1);
+            while (i < limit && at(i) != '\n')
+                i++;
+
+            if (i < limit) {
+                stats.nmeaFrames++;
+                emit(frame, FRAME_NMEA, i + 1);
+                return true;
+            }
+            if (avail < GPS_STREAM_MAX_NMEA) {
+                nmeaScanned = i; // Remember where we were, the rest of the sentence hasn't arrived yet
+                return false;
+            }
+            // Far too long for NMEA, resync
+            stats.garbageBytes++;
+            skip(1);
+            continue;
+        }
+
+        if (c == 0xB5 || c == 0xBA) {
+            bool isUBX = (c == 0xB5);
+            if (avail < 2)
+                return false;
+            if (at(1) != (isUBX ? 0x62 : 0xCE)) {
+                stats.garbageBytes++;
+                skip(1);
+                continue;
+            }
+            if (avail < 6)
+                return false;
+
+            // UBX: sync sync class id lenL lenH payload ckA ckB
+            // CAS: sync sync lenL lenH class id payload ck0 ck1 ck2 ck3
+            size_t payloadLen = isUBX ? (at(4) | (at(5) << 8)) : (at(2) | (at(3) << 8));
+            size_t len = payloadLen + (isUBX ? 8 : 10);
+            if (len > GPS_STREAM_MAX_FRAME) {
+                stats.garbageBytes++;
+                skip(1);
+                continue;
+            }
+            if (avail < len)
+                return false;
+
+            if (!(isUBX ? verifyUBX(len) : verifyCAS(len))) {
+                stats.checksumErrors++;
+                skip(1);
+                continue;
+            }
+
+            if (isUBX)
+                stats.ubxFrames++;
+            else
+                stats.casFrames++;
+            emit(frame, isUBX ? FRAME_UBX : FRAME_CAS, len);
+            return true;
+        }
+
+        // Not part of any frame, skip everything up to the next sync char in one go
+        size_t n = 1;
+        while (n < avail && !isSyncChar(at(n)))
+            n++;
+        stats.garbageBytes += n;
+        skip(n);
+    }
+    return false;
+}
+
+void GPSStream::reset()
+{
+    tail = head;
+    pendingLen = 0;
+    nmeaScanned = 0;
+}
+
+void GPSStream::skip(size_t n)
+{
+    tail += std::min(n, used());
+    nmeaScanned = 0;
+}
+
+bool GPSStream::verifyUBX(size_t len) const
+{
+    uint8_t ckA = 0, ckB = 0;
+    for (size_t i = 2; i < len - 2; i++) {
+        ckA += at(i);
+        ckB += ckA;
+    }
+    return ckA == at(len - 2) && ckB == at(len - 1);
+}
+
+bool GPSStream::verifyCAS(size_t len) const
+{
+    size_t payloadLen = len - 10;
+    uint32_t cksum = ((uint32_t)at(5) << 24) + ((uint32_t)at(4) << 16) + payloadLen;
+    for (size_t i = 0; i < payloadLen / 4; i++) {
+        size_t o = 6 + i * 4;
+        cksum += (uint32_t)at(o) | ((uint32_t)at(o + 1) << 8) | ((uint32_t)at(o + 2) << 16) | ((uint32_t)at(o + 3) << 24);
+    }
+    uint32_t expected =
+        (uint32_t)at(len - 4) | ((uint32_t)at(len - 3) << 8) | ((uint32_t)at(len - 2) << 16) | ((uint32_t)at(len - 1) << 24);
+    return cksum == expected;
+}
+
+void GPSStream::emit(Frame &frame, FrameType type, size_t len)
+{
+    size_t start = tail & mask;
+    if (start + len <= GPS_STREAM_BUFFER_SIZE) {
+        frame.data = ring + start;
+    } else {
+        size_t first = GPS_STREAM_BUFFER_SIZE - start;
+        memcpy(linear, ring + start, first);
+        memcpy(linear + first, ring, len - first);
+        frame.data = linear;
+    }
+    frame.type = type;
+    frame.length = len;
+    pendingLen = len;
+}
+
+#endif // Exclude GPS
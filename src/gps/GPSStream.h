@@ -0,0 +1,113 @@
+#pragma once
+#include "configuration.h"
+#if !MESHTASTIC_EXCLUDE_GPS
+
+#include <Arduino.h>
+
+// Must be a power of two. Large enough to hold a full second of NMEA at 9600 baud plus the biggest UBX reply we parse.
+#ifndef GPS_STREAM_BUFFER_SIZE
+#define GPS_STREAM_BUFFER_SIZE 1024
+#endif
+
+// Longest frame we will hand out. NMEA is limited to 82 chars, but vendor $P sentences and UBX-MON-VER are longer.
+#ifndef GPS_STREAM_MAX_FRAME
+#define GPS_STREAM_MAX_FRAME 512
+#endif
+
+// Longest line we accept as NMEA before treating it as garbage
+#define GPS_STREAM_MAX_NMEA 128
+
+/**
+ * Ring-buffered ingestion of the GPS serial port.
+ *
+ * Bytes are pulled from the UART in bulk (as many as available() reports, in as few readBytes() calls as the ring
+ * allows) and framed in a single pass into NMEA sentences, UBX packets and CASIC packets. Binary frames are checksum
+ * verified here; checksums of the NMEA sentences we parse are left to TinyGPS++ so its statistics keep working.
+ *
+ * Frames are handed out as views into the ring. Only a frame that wraps the end of the ring is copied into a
+ * linear scratch buffer.
+ */
+class GPSStream
+{
+  public:
+    enum FrameType : uint8_t { FRAME_NMEA, FRAME_UBX, FRAME_CAS };
+
+    struct Frame {
+        FrameType type;
+        const uint8_t *data; // Points at the sync char(s), valid until the next call to next(), fill() or reset()
+        uint16_t length;     // Whole frame, including header and checksum
+
+        /// UBX/CAS class and id, undefined for NMEA
+        uint8_t msgClass() const { return type == FRAME_UBX ? data[2] : data[4]; }
+        uint8_t msgId() const { return type == FRAME_UBX ? data[3] : data[5]; }
+
+        /// Binary payload, undefined for NMEA
+        const uint8_t *payload() const { return data + 6; }
+        uint16_t payloadLength() const { return length - (type == FRAME_UBX ? 8 : 10); }
+
+        /// True if this is an NMEA sentence of the given three letter type (talker ignored, e.g. "GGA" matches $GNGGA)
+        bool isSentence(const char *type3) const;
+
+        /// True if the NMEA sentence contains the given text
+        bool contains(const char *text) const;
+
+        /// True if the NMEA sentence carries a valid *hh checksum
+        bool nmeaChecksumOk() const;
+    };
+
+    struct Stats {
+        uint32_t bytesIn = 0;
+        uint32_t nmeaFrames = 0;
+        uint32_t nmeaSkipped = 0; // Framed but not dispatched to the parser
+        uint32_t ubxFrames = 0;
+        uint32_t casFrames = 0;
+        uint32_t checksumErrors = 0; // UBX/CAS only
+        uint32_t garbageBytes = 0;   // Bytes that were not part of any frame
+        uint32_t overflowBytes = 0;  // Bytes dropped because we fell behind the UART
+    };
+
+    /**
+     * Pull everything the serial port has buffered into the ring.
+     * @return number of bytes read
+     */
+    size_t fill(Stream &serial);
+
+    /**
+     * Find the next complete frame in the ring.
+     * @return false if no complete frame is buffered yet
+     */
+    bool next(Frame &frame);
+
+    /// Drop everything buffered, e.g. after sending a command whose old replies we don't care about
+    void reset();
+
+    /// Count a framed NMEA sentence that the caller chose not to parse
+    void markSkipped() { stats.nmeaSkipped++; }
+
+    const Stats &getStats() const { return stats; }
+
+  private:
+    static constexpr size_t mask = GPS_STREAM_BUFFER_SIZE - 1;
+    static_assert((GPS_STREAM_BUFFER_SIZE & mask) == 0, "GPS_STREAM_BUFFER_SIZE must be a power of two");
+
+    uint8_t ring[GPS_STREAM_BUFFER_SIZE];
+    uint8_t linear[GPS_STREAM_MAX_FRAME]; // Only used for frames that wrap around the end of the ring
+
+    // Free-running indices, the ring position is index & mask
+    size_t head = 0;        // Next byte to write
+    size_t tail = 0;        // Next byte to frame
+    size_t pendingLen = 0;  // Length of the frame last returned by next(), released on the next call
+    size_t nmeaScanned = 0; // How far we already searched for the end of a partial NMEA sentence
+
+    Stats stats;
+
+    size_t used() const { return head - tail; }
+    uint8_t at(size_t offset) const { return ring[(tail + offset) & mask]; }
+    void skip(size_t n);
+
+    bool verifyUBX(size_t len) const;
+    bool verifyCAS(size_t len) const;
+    void emit(Frame &frame, FrameType type, size_t len);
+};
+
+#endif // Exclude GPS
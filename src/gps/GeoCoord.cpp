@@ -593,4 +593,93 @@ double GeoCoord::toRadians(double deg)
 double GeoCoord::toDegrees(double r)
 {
     return r * 180 / PI;
-}
\ No newline at end of file
+}
+
+// latLongToMeter() works on a sphere of this radius, stay consistent with it
+#define GEO_EARTH_RADIUS 6366000.0f
+#define GEO_RADIANS_PER_UNIT (float)(PI / 180 / 1e7)
+
+GeoObserver::GeoObserver(int32_t latitude_i, int32_t longitude_i) : latitude_i(latitude_i), longitude_i(longitude_i)
+{
+    double lat = GeoCoord::toRadians(latitude_i * 1e-7);
+    cosLat = cos(lat);
+    sinLat = sin(lat);
+}
+
+void GeoObserver::toLocalMeters(const int32_t *lat_i, const int32_t *lon_i, size_t count, float *north, float *east) const
+{
+    for (size_t i = 0; i < count; i++) {
+        float dLat = (float)(lat_i[i] - latitude_i) * GEO_RADIANS_PER_UNIT;
+        // The short way round, across the antimeridian if need be
+        int64_t dLonI = (int64_t)lon_i[i] - longitude_i;
+        dLonI += dLonI > 1800000000 ? -3600000000LL : (dLonI < -1800000000 ? 3600000000LL : 0);
+        float dLon = (float)dLonI * GEO_RADIANS_PER_UNIT;
+
+        // cos() of the mid latitude by the angle sum formula, sin and cos of a small angle don't need trig
+        float h = dLat / 2;
+        float cosMid = cosLat * (1 - h * h / 2) - sinLat * h;
+
+        north[i] = GEO_EARTH_RADIUS * dLat;
+        east[i] = GEO_EARTH_RADIUS * dLon * cosMid;
+    }
+
+    // The flat approximation falls apart over long distances, fix up the few points that are that far away
+    const float limit = (float)GEO_LOCAL_MAX_METERS * GEO_LOCAL_MAX_METERS;
+    for (size_t i = 0; i < count; i++) {
+        if (north[i] * north[i] + east[i] * east[i] <= limit)
+            continue;
+        double lat1 = latitude_i * 1e-7, lon1 = longitude_i * 1e-7, lat2 = lat_i[i] * 1e-7, lon2 = lon_i[i] * 1e-7;
+        float d = GeoCoord::latLongToMeter(lat1, lon1, lat2, lon2);
+        float b = GeoCoord::bearing(lat1, lon1, lat2, lon2);
+        north[i] = cos(b) * d;
+        east[i] = sin(b) * d;
+    }
+}
+
+void GeoObserver::distanceAndBearing(const int32_t *lat_i, const int32_t *lon_i, size_t count, float *meters,
+                                     float *bearings) const
+{
+    // Use the output arrays for the north and east components
+    toLocalMeters(lat_i, lon_i, count, meters, bearings);
+    for (size_t i = 0; i < count; i++) {
+        float n = meters[i], e = bearings[i];
+        meters[i] = sqrtf(n * n + e * e);
+        bearings[i] = fastAtan2(e, n);
+    }
+}
+
+void GeoObserver::boxAround(float north, float east, int32_t *minLat, int32_t *maxLat, int32_t *minLon,
+                            int32_t *maxLon) const
+{
+    double dLat = north / GEO_EARTH_RADIUS / GEO_RADIANS_PER_UNIT;
+    double lat0 = std::max(latitude_i - dLat, -900000000.0), lat1 = std::min(latitude_i + dLat, 900000000.0);
+    *minLat = lat0;
+    *maxLat = lat1;
+
+    // A degree of longitude is narrowest at the edge of the box furthest from the equator
+    double cosEdge = cos(std::max(fabs(lat0), fabs(lat1)) * GEO_RADIANS_PER_UNIT);
+    double dLon = cosEdge > 0 ? east / GEO_EARTH_RADIUS / GEO_RADIANS_PER_UNIT / cosEdge : INFINITY;
+    if (dLon >= 1800000000.0) {
+        *minLon = -1800000000;
+        *maxLon = 1800000000;
+        return;
+    }
+    double lon0 = longitude_i - dLon, lon1 = longitude_i + dLon;
+    *minLon = lon0 < -1800000000.0 ? lon0 + 3600000000.0 : lon0;
+    *maxLon = lon1 > 1800000000.0 ? lon1 - 3600000000.0 : lon1;
+}
+
+float GeoObserver::fastAtan2(float y, float x)
+{
+    float ax = fabsf(x), ay = fabsf(y);
+    float mx = ax > ay ? ax : ay;
+    float mn = ax > ay ? ay : ax;
+    float z = mx > 0 ? mn / mx : 0;
+    float z2 = z * z;
+    // Minimax polynomial for atan() on [0, 1]
+    float r = z * (0.99997726f +
+                   z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+    r = ay > ax ? (float)(PI / 2) - r : r;
+    r = x < 0 ? (float)PI - r : r;
+    return y < 0 ? -r : r;
+}
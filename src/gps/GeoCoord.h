@@ -145,4 +145,39 @@ class GeoCoord
 
     // OLC getter
     void getOLCCode(char *code) { strncpy(code, _olc.code, OLC_CODE_LEN + 1); } // +1 for null termination
-};
\ No newline at end of file
+};
+
+/**
+ * Distances and bearings from one observer to many nodes, for screens that redraw every node every frame.
+ *
+ * The observer's trig is worked out once. Nearby points are projected onto a local equirectangular grid that needs no
+ * trig per point, in plain float loops the compiler can vectorize. Within GEO_LOCAL_MAX_METERS that agrees with
+ * GeoCoord::latLongToMeter() to within 0.01% and with GeoCoord::bearing() to within 0.2 degrees. Points further away
+ * are handed to those exact functions instead.
+ */
+#define GEO_LOCAL_MAX_METERS 100000
+
+class GeoObserver
+{
+  public:
+    /// Position in Meshtastic's 1e-7 degree integers
+    GeoObserver(int32_t latitude_i, int32_t longitude_i);
+
+    /// Meters north and east of the observer (negative for south and west) of count points
+    void toLocalMeters(const int32_t *latitude_i, const int32_t *longitude_i, size_t count, float *north, float *east) const;
+
+    /// Distance in meters and bearing in radians (0 is north, as GeoCoord::bearing()) to count points
+    void distanceAndBearing(const int32_t *latitude_i, const int32_t *longitude_i, size_t count, float *meters,
+                            float *bearings) const;
+
+    /// Latitude / longitude box reaching at least north meters north and south, and east meters east and west, of the
+    /// observer. minLon is more than maxLon if the box crosses the antimeridian.
+    void boxAround(float north, float east, int32_t *minLat, int32_t *maxLat, int32_t *minLon, int32_t *maxLon) const;
+
+    /// atan2() to within 1e-5 radians, branch free so that it vectorizes
+    static float fastAtan2(float y, float x);
+
+  private:
+    int32_t latitude_i, longitude_i;
+    float cosLat, sinLat;
+};
@@ -2307,9 +2307,11 @@ void Screen::blink()
     while (count > 0) {
         dispdev->fillRect(0, 0, dispdev->getWidth(), dispdev->getHeight());
         dispdev->display();
+        finishDisplay();
         delay(50);
         dispdev->clear();
         dispdev->display();
+        finishDisplay();
         delay(50);
         count = count - 1;
     }
@@ -2317,6 +2319,19 @@ void Screen::blink()
     dispdev->setBrightness(brightness);
 }
 
+void Screen::finishDisplay()
+{
+    // Same choice of display as in our constructor
+#if defined(USE_SH1106) || defined(USE_SH1107) || defined(USE_SH1107_128_64) || defined(USE_ST7789) || defined(USE_SSD1306)
+#elif defined(ST7735_CS) || defined(ILI9341_DRIVER) || defined(ILI9342_DRIVER) || defined(ST7701_CS) || defined(ST7789_CS) ||    \
+    defined(RAK14014) || defined(HX8357_CS) || defined(ILI9488_CS)
+    static_cast<TFTDisplay *>(dispdev)->flush();
+#elif ARCH_PORTDUINO && !HAS_TFT
+    if (!isAUTOOled)
+        static_cast<TFTDisplay *>(dispdev)->flush();
+#endif
+}
+
 void Screen::increaseBrightness()
 {
     brightness = ((brightness + 62) > 254) ? brightness : (brightness + 62);
@@ -559,6 +559,9 @@ class Screen : public concurrency::OSThread
 
     bool isAUTOOled = false;
 
+    /// TFTDisplay sends most of a redraw on later main loop iterations, send it all now because we are about to block the loop
+    void finishDisplay();
+
     // Screen dimensions (for convenience)
     // Defined during Screen::setup
     uint16_t displayWidth = 0;
@@ -959,7 +959,10 @@ extern unPhone unphone;
 GpioPin *TFTDisplay::backlightEnable = NULL;
 
 TFTDisplay::TFTDisplay(uint8_t address, int sda, int scl, OLEDDISPLAY_GEOMETRY geometry, HW_I2C i2cBus)
+    : concurrency::OSThread("TFTDisplay")
 {
+    OSThread::disable();
+
     LOG_DEBUG("TFTDisplay!");
 
 #ifdef TFT_BL
@@ -991,36 +994,77 @@ TFTDisplay::TFTDisplay(uint8_t address, int sda, int scl, OLEDDISPLAY_GEOMETRY g
 }
 
 // Write the buffer to the display memory
+//
+// Drawing pixel by pixel is slow, a full redraw would hold up the main loop (and so the radio) for tens of milliseconds.
+// So only TFT_PAGES_PER_PASS changed pages go out here, runOnce() sends the rest on the following main loop iterations.
+// buffer_back holds what the panel shows, so a frame drawn meanwhile simply replaces the pages not sent yet.
 void TFTDisplay::display(bool fromBlank)
 {
     if (fromBlank)
-        tft->fillScreen(TFT_BLACK);
-    // tft->clear();
-    concurrency::LockGuard g(spiLock);
+        blankFromPage = 0;
+
+    if (sendPages(TFT_PAGES_PER_PASS)) {
+        OSThread::setIntervalFromNow(0);
+        OSThread::enabled = true;
+    }
+}
 
-    uint16_t x, y;
+void TFTDisplay::flush()
+{
+    sendPages(UINT16_MAX);
+    OSThread::disable();
+}
 
-    for (y = 0; y < displayHeight; y++) {
-        for (x = 0; x < displayWidth; x++) {
-            auto isset = buffer[x + (y / 8) * displayWidth] & (1 << (y & 7));
-            if (!fromBlank) {
+int32_t TFTDisplay::runOnce()
+{
+    return sendPages(TFT_PAGES_PER_PASS) ? 0 : disable();
+}
+
+bool TFTDisplay::sendPages(uint16_t maxPages)
+{
+    uint16_t numPages = (displayHeight + 7) / 8;
+    uint16_t sent = 0;
+    uint16_t page;
+
+    for (page = 0; page < numPages && sent < maxPages; page++) {
+        uint8_t *src = buffer + page * displayWidth;
+        uint8_t *shown = buffer_back + page * displayWidth;
+        bool blank = page >= blankFromPage;
+        if (!blank && memcmp(src, shown, displayWidth) == 0)
+            continue;
+
+        uint16_t top = page * 8;
+        uint16_t rows = displayHeight - top < 8 ? displayHeight - top : 8;
+
+        spiLock->lock(SPI_USER_DISPLAY);
+        if (blank)
+            tft->fillRect(0, top, displayWidth, rows, TFT_BLACK);
+        for (uint16_t y = top; y < top + rows; y++) {
+            for (uint16_t x = 0; x < displayWidth; x++) {
                 // get src pixel in the page based ordering the OLED lib uses FIXME, super inefficent
-                auto dblbuf_isset = buffer_back[x + (y / 8) * displayWidth] & (1 << (y & 7));
+                auto isset = src[x] & (1 << (y & 7));
+                auto dblbuf_isset = blank ? 0 : shown[x] & (1 << (y & 7));
                 if (isset != dblbuf_isset) {
                     tft->drawPixel(x, y, isset ? TFT_MESH : TFT_BLACK);
                 }
-            } else if (isset) {
-                tft->drawPixel(x, y, TFT_MESH);
             }
         }
+        spiLock->unlock();
+
+        memcpy(shown, src, displayWidth);
+        if (blank)
+            blankFromPage = page + 1;
+        sent++;
     }
-    // Copy the Buffer to the Back Buffer
-    for (y = 0; y < (displayHeight / 8); y++) {
-        for (x = 0; x < displayWidth; x++) {
-            uint16_t pos = x + y * displayWidth;
-            buffer_back[pos] = buffer[pos];
-        }
+    if (blankFromPage >= numPages)
+        blankFromPage = UINT16_MAX;
+
+    // Anything left over?
+    for (; page < numPages; page++) {
+        if (page >= blankFromPage || memcmp(buffer + page * displayWidth, buffer_back + page * displayWidth, displayWidth))
+            return true;
     }
+    return false;
 }
 
 // Send a command to the display (low level function)
@@ -1054,6 +1098,8 @@ void TFTDisplay::sendCommand(uint8_t com)
     }
     case DISPLAYOFF: {
         // LOG_DEBUG("Display off");
+        // Pages not sent yet stay different from buffer_back, the next display() picks them up
+        OSThread::disable();
         backlightEnable->set(false);
 #if ARCH_PORTDUINO
         tft->clear();
@@ -1,8 +1,14 @@
 #pragma once
 
+#include "concurrency/OSThread.h"
 #include <GpioLogic.h>
 #include <OLEDDisplay.h>
 
+/// How many changed 8 pixel high pages display() sends per main loop iteration, the rest follow on later iterations
+#ifndef TFT_PAGES_PER_PASS
+#define TFT_PAGES_PER_PASS 4
+#endif
+
 /**
  * An adapter class that allows using the LovyanGFX library as if it was an OLEDDisplay implementation.
  *
@@ -12,7 +18,7 @@
  *
  * turn radio back on - currently with both on spi bus is fucked? or are we leaving chip select asserted?
  */
-class TFTDisplay : public OLEDDisplay
+class TFTDisplay : public OLEDDisplay, private concurrency::OSThread
 {
   public:
     /* constructor
@@ -24,6 +30,9 @@ class TFTDisplay : public OLEDDisplay
     virtual void display() override { display(false); };
     virtual void display(bool fromBlank);
 
+    // Send whatever display() left for later main loop iterations, for callers that are about to block the loop
+    void flush();
+
     // Turn the display upside down
     virtual void flipScreenVertically();
 
@@ -57,4 +66,14 @@ class TFTDisplay : public OLEDDisplay
 
     // Connect to the display
     virtual bool connect() override;
+
+  private:
+    // Send up to maxPages changed pages, @return true if some are still left
+    bool sendPages(uint16_t maxPages);
+
+    // Sends the pages display() left, one pass per main loop iteration
+    virtual int32_t runOnce() override;
+
+    // Pages from here down still need blanking, after display(true)
+    uint16_t blankFromPage = UINT16_MAX;
 };
\ No newline at end of file
@@ -110,11 +110,12 @@ void DEPG0290BNS800::finalizeUpdate()
     // Put a copy of the image into the "old memory".
     // Used with differential refreshes (e.g. FAST update), to determine which px need to move, and which can remain in place
     // We need to keep the "old memory" up to date, because don't know whether next refresh will be FULL or FAST etc.
+    // Image data is sent a chunk at a time, then finishTransfer terminates the write and enters deep-sleep
     if (updateType != FULL) {
         // writeNewImage(); // Not required for this display
         writeOldImage();
-        sendCommand(0x7F); // Terminate image write without update
-        wait();
+        refreshAfterTransfer = false;
+        return EInk::beginTransfer();
     }
 
     // Enter deep-sleep to save a few µA
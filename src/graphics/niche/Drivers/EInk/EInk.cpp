@@ -22,6 +22,18 @@ bool EInk::supports(UpdateTypes type)
         return false;
 }
 
+// Begins using the OSThread to send image data to the display
+// An image can take tens of milliseconds to send, which would hold up the rest of the firmware (the radio, in particular).
+// Instead, the OSThread calls transferChunk once per main loop iteration, until the derived class reports that all is sent.
+// finishTransfer then runs, typically to begin the update itself (and polling)
+void EInk::beginTransfer()
+{
+    updateRunning = true;
+    transferring = true;
+    OSThread::setIntervalFromNow(0);
+    OSThread::enabled = true;
+}
+
 // Begins using the OSThread to detect when a display update is complete
 // This allows the refresh operation to run "asynchronously".
 // Rather than blocking execution waiting for the update to complete, we are periodically checking the hardware's BUSY pin
@@ -31,6 +43,7 @@ bool EInk::supports(UpdateTypes type)
 void EInk::beginPolling(uint32_t interval, uint32_t expectedDuration)
 {
     updateRunning = true;
+    polling = true;
     pollingInterval = interval;
     pollingBegunAt = millis();
 
@@ -41,13 +54,13 @@ void EInk::beginPolling(uint32_t interval, uint32_t expectedDuration)
 }
 
 // Meshtastic's pseudo-threading layer
-// We're using this as a timer, to periodically check if an update is complete
+// We're using this to send image data in chunks, then as a timer, to periodically check if an update is complete
 // This is what allows us to update the display asynchronously
 int32_t EInk::runOnce()
 {
     // Check for polling timeout
     // Manually set at 10 seconds, in case some big task holds up the firmware's cooperative multitasking
-    if (millis() - pollingBegunAt > 10000)
+    if (polling && millis() - pollingBegunAt > 10000)
         failed = true;
 
     // Handle failure
@@ -56,16 +69,39 @@ int32_t EInk::runOnce()
     if (failed) {
         LOG_WARN("Display update failed. Check wiring & power supply.");
         updateRunning = false;
+        transferring = false;
+        polling = false;
         failed = false;
         return disable();
     }
 
+    // If sending image data
+    if (transferring) {
+        if (!transferChunk())
+            return 0; // Next chunk on the next main loop iteration
+        transferring = false;
+        finishTransfer(); // Typically begins the update, and polling
+        return nextStep();
+    }
+
     // If update not yet done
     if (!isUpdateDone())
         return pollingInterval; // Poll again in a few ms
 
     // If update done
-    finalizeUpdate();      // Any post-update code: power down panel hardware, hibernate, etc
+    polling = false;
+    finalizeUpdate(); // Any post-update code: power down panel hardware, hibernate, etc. Might send image data again
+    return nextStep();
+}
+
+// After a derived class has had its say: carry on sending, carry on polling, or stop
+int32_t EInk::nextStep()
+{
+    if (transferring)
+        return 0;
+    if (polling)
+        return RUN_SAME; // Interval already set by beginPolling
+
     updateRunning = false; // Change what we report via EInk::busy()
     return disable();      // Stop polling
 }
@@ -38,16 +38,24 @@ class EInk : private concurrency::OSThread
     const uint16_t height;
 
   protected:
+    void beginTransfer();                                            // Begin sending image data, a chunk per loop iteration
+    virtual bool transferChunk() { return true; }                    // Send next chunk of image data. True once all sent
+    virtual void finishTransfer() {}                                 // Run once all image data sent. Begin update, etc
     void beginPolling(uint32_t interval, uint32_t expectedDuration); // Begin checking repeatedly if update finished
     virtual bool isUpdateDone() = 0;                                 // Check once if update finished
     virtual void finalizeUpdate() {}                                 // Run any post-update code
     bool failed = false;                                             // If an error occurred during update
 
+    static constexpr uint32_t transferChunkSize = 1024; // Bytes of image data sent per main loop iteration
+
   private:
-    int32_t runOnce() override; // Repeated checking if update finished
+    int32_t runOnce() override; // Sending image data, then repeated checking if update finished
+    int32_t nextStep();         // What runOnce does after finishTransfer or finalizeUpdate
 
     const UpdateTypes supportedUpdateTypes; // Capabilities of a derived display class
     bool updateRunning = false;             // see EInk::busy()
+    bool transferring = false;              // Sending image data
+    bool polling = false;                   // Waiting for the update to complete
     uint32_t pollingInterval = 0;           // How often to check if update complete (ms)
     uint32_t pollingBegunAt = 0;            // To timeout during polling
 };
@@ -104,6 +104,7 @@ void LCMEN213EFC1::update(uint8_t *imageData, UpdateTypes type)
 {
     this->updateType = type;
     this->buffer = imageData;
+    transferCount = 0;
 
     reset();
 
@@ -121,14 +122,10 @@ void LCMEN213EFC1::update(uint8_t *imageData, UpdateTypes type)
         writeNewImage();
     }
 
-    sendCommand(0x04); // Power on the panel voltage
-    wait();
-
-    sendCommand(0x12); // Begin executing the update
-
-    // Let the update run async, on display hardware. Base class will poll completion, then finalize.
+    // Base class sends the image data a chunk at a time, then calls finishTransfer to begin the update
     // For a blocking update, call await after update
-    detachFromUpdate();
+    refreshAfterTransfer = true;
+    EInk::beginTransfer();
 }
 
 void LCMEN213EFC1::wait()
@@ -153,7 +150,7 @@ void LCMEN213EFC1::reset()
 void LCMEN213EFC1::sendCommand(const uint8_t command)
 {
     // Take firmware's SPI lock
-    spiLock->lock();
+    spiLock->lock(SPI_USER_DISPLAY);
 
     spi->beginTransaction(spiSettings);
     digitalWrite(pin_dc, LOW); // DC pin low indicates command
@@ -174,7 +171,7 @@ void LCMEN213EFC1::sendData(uint8_t data)
 void LCMEN213EFC1::sendData(const uint8_t *data, uint32_t size)
 {
     // Take firmware's SPI lock
-    spiLock->lock();
+    spiLock->lock(SPI_USER_DISPLAY);
 
     spi->beginTransaction(spiSettings);
     digitalWrite(pin_dc, HIGH); // DC pin HIGH indicates data, instead of command
@@ -250,16 +247,62 @@ void LCMEN213EFC1::configFast()
     sendData(LUT_FAST_BB, sizeof(LUT_FAST_BB));
 }
 
+// Queue the new image. Sent by transferChunk
 void LCMEN213EFC1::writeNewImage()
 {
-    sendCommand(0x13);
-    sendData(buffer, bufferSize);
+    if (transferCount < sizeof(transferCommands))
+        transferCommands[transferCount++] = 0x13;
 }
 
+// Queue the old image. Sent by transferChunk
 void LCMEN213EFC1::writeOldImage()
 {
-    sendCommand(0x10);
-    sendData(buffer, bufferSize);
+    if (transferCount < sizeof(transferCommands))
+        transferCommands[transferCount++] = 0x10;
+}
+
+// Send one chunk of image data. Called by the base class once per main loop iteration, until we return true
+bool LCMEN213EFC1::transferChunk()
+{
+    if (transferIndex >= transferCount)
+        return true;
+
+    if (transferOffset == 0)
+        sendCommand(transferCommands[transferIndex]);
+
+    uint32_t size = bufferSize - transferOffset;
+    if (size > transferChunkSize)
+        size = transferChunkSize;
+    sendData(buffer + transferOffset, size);
+    transferOffset += size;
+
+    if (transferOffset >= bufferSize) {
+        transferIndex++;
+        transferOffset = 0;
+    }
+    return transferIndex >= transferCount;
+}
+
+void LCMEN213EFC1::finishTransfer()
+{
+    transferCount = 0;
+    transferIndex = 0;
+    transferOffset = 0;
+
+    // Image data for an update
+    if (refreshAfterTransfer) {
+        sendCommand(0x04); // Power on the panel voltage
+        wait();
+
+        sendCommand(0x12); // Begin executing the update
+
+        // Let the update run async, on display hardware. Base class will poll completion, then finalize.
+        detachFromUpdate();
+    }
+
+    // Image data from finalizeUpdate
+    else
+        wait();
 }
 
 void LCMEN213EFC1::detachFromUpdate()
@@ -297,9 +340,11 @@ void LCMEN213EFC1::finalizeUpdate()
     // Put a copy of the image into the "old memory".
     // Used with differential refreshes (e.g. FAST update), to determine which px need to move, and which can remain in place
     // We need to keep the "old memory" up to date, because don't know whether next refresh will be FULL or FAST etc.
+    // Image data is sent a chunk at a time, then finishTransfer waits for the write to complete
     if (updateType != FULL) {
         writeOldImage();
-        wait();
+        refreshAfterTransfer = false;
+        EInk::beginTransfer();
     }
 }
 
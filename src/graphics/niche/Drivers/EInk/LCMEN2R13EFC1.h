@@ -46,6 +46,8 @@ class LCMEN213EFC1 : public EInk
     void configFast(); // Configure display for FAST refresh
     void writeNewImage();
     void writeOldImage(); // Used for "differential update", aka FAST refresh
+    bool transferChunk() override;  // Send the next chunk of the images queued by writeNewImage / writeOldImage
+    void finishTransfer() override; // Begin the update, or (after finalizeUpdate) wait for the write to complete
 
     void detachFromUpdate();
     bool isUpdateDone();
@@ -58,6 +60,12 @@ class LCMEN213EFC1 : public EInk
     uint8_t *buffer = nullptr;
     UpdateTypes updateType = UpdateTypes::UNSPECIFIED;
 
+    uint8_t transferCommands[2] = {0}; // Image writes queued for transferChunk: controller IC memory to write
+    uint8_t transferCount = 0;         // How many writes are queued
+    uint8_t transferIndex = 0;         // Which write is in progress
+    uint32_t transferOffset = 0;       // How far into the buffer that write is
+    bool refreshAfterTransfer = false; // Whether finishTransfer begins an update, or finalizes one
+
     uint8_t pin_dc = -1;
     uint8_t pin_cs = -1;
     uint8_t pin_busy = -1;
@@ -86,7 +86,7 @@ void SSD16XX::sendCommand(const uint8_t command)
         return;
 
     // Take firmware's SPI lock
-    spiLock->lock();
+    spiLock->lock(SPI_USER_DISPLAY);
 
     spi->beginTransaction(spiSettings);
     digitalWrite(pin_dc, LOW); // DC pin low indicates command
@@ -112,7 +112,7 @@ void SSD16XX::sendData(const uint8_t *data, uint32_t size)
         return;
 
     // Take firmware's SPI lock
-    spiLock->lock();
+    spiLock->lock(SPI_USER_DISPLAY);
 
     spi->beginTransaction(spiSettings);
     digitalWrite(pin_dc, HIGH); // DC pin HIGH indicates data, instead of command
@@ -177,6 +177,7 @@ void SSD16XX::update(uint8_t *imageData, UpdateTypes type)
 {
     this->updateType = type;
     this->buffer = imageData;
+    transferCount = 0;
 
     reset();
 
@@ -193,12 +194,10 @@ void SSD16XX::update(uint8_t *imageData, UpdateTypes type)
         writeNewImage();
     }
 
-    configUpdateSequence();
-    sendCommand(0x20); // Begin executing the update
-
-    // Let the update run async, on display hardware. Base class will poll completion, then finalize.
+    // Base class sends the image data a chunk at a time, then calls finishTransfer to begin the update
     // For a blocking update, call await after update
-    detachFromUpdate();
+    refreshAfterTransfer = true;
+    EInk::beginTransfer();
 }
 
 // Send SPI commands for controller IC to begin executing the refresh operation
@@ -212,16 +211,68 @@ void SSD16XX::configUpdateSequence()
     }
 }
 
+// Queue the image for the "new memory". Sent by transferChunk
 void SSD16XX::writeNewImage()
 {
-    sendCommand(0x24);
-    sendData(buffer, bufferSize);
+    if (transferCount < sizeof(transferCommands))
+        transferCommands[transferCount++] = 0x24;
 }
 
+// Queue the image for the "old memory". Sent by transferChunk
 void SSD16XX::writeOldImage()
 {
-    sendCommand(0x26);
-    sendData(buffer, bufferSize);
+    if (transferCount < sizeof(transferCommands))
+        transferCommands[transferCount++] = 0x26;
+}
+
+// Send one chunk of image data. Called by the base class once per main loop iteration, until we return true
+// The controller IC keeps its memory cursor between chunks, as long as no other command comes in between
+bool SSD16XX::transferChunk()
+{
+    if (transferIndex >= transferCount)
+        return true;
+
+    if (transferOffset == 0)
+        sendCommand(transferCommands[transferIndex]);
+
+    uint32_t size = bufferSize - transferOffset;
+    if (size > transferChunkSize)
+        size = transferChunkSize;
+    sendData(buffer + transferOffset, size);
+    transferOffset += size;
+
+    if (transferOffset >= bufferSize) {
+        transferIndex++;
+        transferOffset = 0;
+    }
+    return transferIndex >= transferCount;
+}
+
+void SSD16XX::finishTransfer()
+{
+    transferCount = 0;
+    transferIndex = 0;
+    transferOffset = 0;
+
+    // Image data for an update
+    if (refreshAfterTransfer) {
+        configUpdateSequence();
+        sendCommand(0x20); // Begin executing the update
+
+        // Let the update run async, on display hardware. Base class will poll completion, then finalize.
+        detachFromUpdate();
+    }
+
+    // Image data from finalizeUpdate
+    else {
+        sendCommand(0x7F); // Terminate image write without update
+        wait();
+
+        // Enter deep-sleep to save a few µA
+        // Waking from this requires that display's reset pin is broken out
+        if (pin_rst != 0xFF)
+            deepSleep();
+    }
 }
 
 void SSD16XX::detachFromUpdate()
@@ -249,11 +300,12 @@ void SSD16XX::finalizeUpdate()
     // Put a copy of the image into the "old memory".
     // Used with differential refreshes (e.g. FAST update), to determine which px need to move, and which can remain in place
     // We need to keep the "old memory" up to date, because don't know whether next refresh will be FULL or FAST etc.
+    // Image data is sent a chunk at a time, then finishTransfer terminates the write and enters deep-sleep
     if (updateType != FULL) {
         writeNewImage(); // Only required by some controller variants. Todo: Override just for GDEY0154D678?
         writeOldImage();
-        sendCommand(0x7F); // Terminate image write without update
-        wait();
+        refreshAfterTransfer = false;
+        return EInk::beginTransfer();
     }
 
     // Enter deep-sleep to save a few µA
@@ -40,6 +40,8 @@ class SSD16XX : public EInk
 
     virtual void writeNewImage();
     virtual void writeOldImage(); // Image which can be used at *next* update for "differential refresh"
+    virtual bool transferChunk() override;  // Send the next chunk of the images queued by writeNewImage / writeOldImage
+    virtual void finishTransfer() override; // Begin the update, or (after finalizeUpdate) terminate the write and sleep
 
     virtual void detachFromUpdate();
     virtual bool isUpdateDone() override;
@@ -53,6 +55,12 @@ class SSD16XX : public EInk
     uint8_t *buffer = nullptr;
     UpdateTypes updateType = UpdateTypes::UNSPECIFIED;
 
+    uint8_t transferCommands[2] = {0}; // Image writes queued for transferChunk: controller IC memory to write
+    uint8_t transferCount = 0;         // How many writes are queued
+    uint8_t transferIndex = 0;         // Which write is in progress
+    uint32_t transferOffset = 0;       // How far into the buffer that write is
+    bool refreshAfterTransfer = false; // Whether finishTransfer begins an update, or finalizes one
+
     uint8_t pin_dc = -1;
     uint8_t pin_cs = -1;
     uint8_t pin_busy = -1;
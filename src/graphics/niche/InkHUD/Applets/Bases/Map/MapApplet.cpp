@@ -13,17 +13,21 @@ void InkHUD::MapApplet::onRender()
         return;
     }
 
+    // Pick the nodes to fit the map around
+    // - the nearest to our own node
+    // - which nodes to use controlled by virtual shouldDrawNode method
+    findFitNodes();
+
     // Find center of map
     // - latitude and longitude
     // - will be placed at X(0.5), Y(0.5)
     getMapCenter(&latCenter, &lngCenter);
 
-    // Calculate North+East distance of each node to map center
-    // - which nodes to use controlled by virtual shouldDrawNode method
-    calculateAllMarkers();
+    // Calculate North+East distance of each of these nodes to map center
+    calculateMarkers(fitNodes);
 
     // Set the region shown on the map
-    // - default: fit all nodes, plus padding
+    // - default: fit those nodes, plus padding
     // - maybe overriden by derived applet
     // - getMapSize *sets* passed parameters (C-style)
     getMapSize(&widthMeters, &heightMeters);
@@ -31,6 +35,9 @@ void InkHUD::MapApplet::onRender()
     // Set the metersToPx conversion value
     calculateMapScale();
 
+    // Now the map's area is known, draw every node inside it
+    calculateMarkers(findVisibleNodes());
+
     // Special marker for own node
     meshtastic_NodeInfoLite *ourNode = nodeDB->getMeshNode(nodeDB->getNodeNum());
     if (ourNode && nodeDB->hasValidPosition(ourNode))
@@ -55,7 +62,7 @@ void InkHUD::MapApplet::onRender()
     }
 }
 
-// Find the center point, in the middle of all node positions
+// Find the center point, in the middle of the positions of the nodes the map is fitted to
 // Calculated values are written to the *lat and *long pointer args
 // - Finds the "mean lat long"
 // - Calculates furthest nodes from "mean lat long"
@@ -78,17 +85,9 @@ void InkHUD::MapApplet::getMapCenter(float *lat, float *lng)
     float yAvg = 0;
     float zAvg = 0;
 
-    // For each node in db
-    for (uint32_t i = 0; i < nodeDB->getNumMeshNodes(); i++) {
-        meshtastic_NodeInfoLite *node = nodeDB->getMeshNodeByIndex(i);
-
-        // Skip if no position
-        if (!nodeDB->hasValidPosition(node))
-            continue;
-
-        // Skip if derived applet doesn't want to show this node on the map
-        if (!shouldDrawNode(node))
-            continue;
+    // For each node the map is fitted to
+    for (uint16_t dbIndex : fitNodes) {
+        meshtastic_NodeInfoLite *node = nodeDB->getMeshNodeByIndex(dbIndex);
 
         // Latitude and Longitude of node, in radians
         float latRad = node->position.latitude_i * (1e-7) * DEG_TO_RAD;
@@ -172,16 +171,8 @@ void InkHUD::MapApplet::getMapCenter(float *lat, float *lng)
     float easternmost = lngCenter;
     float westernmost = lngCenter;
 
-    for (uint8_t i = 0; i < nodeDB->getNumMeshNodes(); i++) {
-        meshtastic_NodeInfoLite *node = nodeDB->getMeshNodeByIndex(i);
-
-        // Skip if no position
-        if (!nodeDB->hasValidPosition(node))
-            continue;
-
-        // Skip if derived applet doesn't want to show this node on the map
-        if (!shouldDrawNode(node))
-            continue;
+    for (uint16_t dbIndex : fitNodes) {
+        meshtastic_NodeInfoLite *node = nodeDB->getMeshNodeByIndex(dbIndex);
 
         // Check for a new top or bottom latitude
         float lat = node->position.latitude_i * 1e-7;
@@ -233,19 +224,12 @@ InkHUD::MapApplet::Marker InkHUD::MapApplet::calculateMarker(float lat, float ln
 {
     assert(lat != 0 || lng != 0); // Not null island. Applets should check this before calling.
 
-    // Bearing and distance from map center to node
-    float distanceFromCenter = GeoCoord::latLongToMeter(latCenter, lngCenter, lat, lng);
-    float bearingFromCenter = GeoCoord::bearing(latCenter, lngCenter, lat, lng); // in radians
-
-    // Split into meters north and meters east components (signed)
-    // - signedness of cos / sin automatically sets negative if south or west
-    float northMeters = cos(bearingFromCenter) * distanceFromCenter;
-    float eastMeters = sin(bearingFromCenter) * distanceFromCenter;
-
-    // Store this as a new marker
+    // Meters north and east of map center (signed, negative if south or west)
+    int32_t lat_i = lat * 1e7;
+    int32_t lng_i = lng * 1e7;
     Marker m;
-    m.eastMeters = eastMeters;
-    m.northMeters = northMeters;
+    getCenterObserver().toLocalMeters(&lat_i, &lng_i, 1, &m.northMeters, &m.eastMeters);
+
     m.hasHopsAway = hasHopsAway;
     m.hopsAway = hopsAway;
     return m;
@@ -348,12 +332,14 @@ void InkHUD::MapApplet::drawLabeledMarker(meshtastic_NodeInfoLite *node)
 // Need at least two, to draw a sensible map
 bool InkHUD::MapApplet::enoughMarkers()
 {
-    uint8_t count = 0;
-    for (uint8_t i = 0; i < nodeDB->getNumMeshNodes(); i++) {
-        meshtastic_NodeInfoLite *node = nodeDB->getMeshNodeByIndex(i);
+    const NodePositionIndex &positions = nodeDB->getPositionIndex();
+    if (positions.size() < 2)
+        return false;
 
+    uint8_t count = 0;
+    for (const NodePositionIndex::Entry &e : positions.getEntries()) {
         // Count nodes
-        if (nodeDB->hasValidPosition(node) && shouldDrawNode(node))
+        if (shouldDrawNode(nodeDB->getMeshNodeByIndex(e.dbIndex)))
             count++;
 
         // We need to find two
@@ -364,20 +350,56 @@ bool InkHUD::MapApplet::enoughMarkers()
     return false; // No nodes would be drawn (or just the one, uselessly at 0,0)
 }
 
+// Pick the nodes which the map will be sized to fit: the MAP_FIT_NODES nearest to our own node
+// If we don't have a position, the nearest to the middle of all the nodes instead
+void InkHUD::MapApplet::findFitNodes()
+{
+    const NodePositionIndex &positions = nodeDB->getPositionIndex();
+    fitNodes.clear();
+
+    int32_t lat;
+    int32_t lng;
+    meshtastic_NodeInfoLite *ourNode = nodeDB->getMeshNode(nodeDB->getNodeNum());
+    if (ourNode && nodeDB->hasValidPosition(ourNode)) {
+        lat = ourNode->position.latitude_i;
+        lng = ourNode->position.longitude_i;
+    } else {
+        int32_t minLat, maxLat, minLng, maxLng;
+        if (!positions.getBounds(&minLat, &maxLat, &minLng, &maxLng))
+            return;
+        lat = ((int64_t)minLat + maxLat) / 2;
+        lng = ((int64_t)minLng + maxLng) / 2;
+    }
+
+    // Skip any the derived applet doesn't want to show on the map
+    uint16_t nearest[MAP_FIT_NODES];
+    size_t count = positions.findNearest(lat, lng, MAP_FIT_NODES, nearest);
+    for (size_t i = 0; i < count; i++) {
+        if (shouldDrawNode(nodeDB->getMeshNodeByIndex(nearest[i])))
+            fitNodes.push_back(nearest[i]);
+    }
+
+    // If the derived applet ruled out almost all of those, fit the map to every node it does want
+    if (fitNodes.size() < 2) {
+        fitNodes.clear();
+        for (const NodePositionIndex::Entry &e : positions.getEntries()) {
+            if (shouldDrawNode(nodeDB->getMeshNodeByIndex(e.dbIndex)))
+                fitNodes.push_back(e.dbIndex);
+        }
+    }
+}
+
 // Calculate how far north and east of map center each node is
 // Derived applets can control which nodes to calculate (and later, draw) by overriding MapApplet::shouldDrawNode
-void InkHUD::MapApplet::calculateAllMarkers()
+void InkHUD::MapApplet::calculateMarkers(const std::vector<uint16_t> &nodes)
 {
     // Clear old markers
     markers.clear();
 
-    // For each node in db
-    for (uint32_t i = 0; i < nodeDB->getNumMeshNodes(); i++) {
-        meshtastic_NodeInfoLite *node = nodeDB->getMeshNodeByIndex(i);
-
-        // Skip if no position
-        if (!nodeDB->hasValidPosition(node))
-            continue;
+    // Positions are gathered first, then converted all at once
+    std::vector<int32_t> lats, lngs;
+    for (uint16_t dbIndex : nodes) {
+        meshtastic_NodeInfoLite *node = nodeDB->getMeshNodeByIndex(dbIndex);
 
         // Skip if derived applet doesn't want to show this node on the map
         if (!shouldDrawNode(node))
@@ -388,14 +410,49 @@ void InkHUD::MapApplet::calculateAllMarkers()
         if (node->num == nodeDB->getNodeNum())
             continue;
 
-        // Calculate marker and store it
-        markers.push_back(
-            calculateMarker(node->position.latitude_i * 1e-7,  // Lat, converted from Meshtastic's internal int32 style
-                            node->position.longitude_i * 1e-7, // Long, converted from Meshtastic's internal int32 style
-                            node->has_hops_away,               // Is the hopsAway number valid
-                            node->hops_away                    // Hops away
-                            ));
+        // Store the hops info now, position later
+        Marker m;
+        m.hasHopsAway = node->has_hops_away;
+        m.hopsAway = node->hops_away;
+        markers.push_back(m);
+        lats.push_back(node->position.latitude_i);
+        lngs.push_back(node->position.longitude_i);
     }
+
+    // Meters north and east of map center, for every marker in one go
+    std::vector<float> north(markers.size()), east(markers.size());
+    getCenterObserver().toLocalMeters(lats.data(), lngs.data(), markers.size(), north.data(), east.data());
+    size_t i = 0;
+    for (Marker &m : markers) {
+        m.northMeters = north[i];
+        m.eastMeters = east[i];
+        i++;
+    }
+}
+
+// Look up the nodes which land inside the applet, now that the map's center and scale are set
+// Includes the nodes the map was fitted to, and any others which happen to fall within it
+std::vector<uint16_t> InkHUD::MapApplet::findVisibleNodes()
+{
+    // All the nodes were in one spot: there is no area to search
+    if (isinf(metersToPx))
+        return fitNodes;
+
+    // Half the applet in each direction, plus a little for markers straddling the edge
+    float northMeters = (height() / 2) / metersToPx * 1.1;
+    float eastMeters = (width() / 2) / metersToPx * 1.1;
+    int32_t minLat, maxLat, minLng, maxLng;
+    getCenterObserver().boxAround(northMeters, eastMeters, &minLat, &maxLat, &minLng, &maxLng);
+
+    std::vector<uint16_t> visible;
+    nodeDB->getPositionIndex().findInBox(minLat, maxLat, minLng, maxLng, visible);
+    return visible;
+}
+
+// Map center, ready for converting positions to meters north and east of it
+GeoObserver InkHUD::MapApplet::getCenterObserver()
+{
+    return GeoObserver(latCenter * 1e7, lngCenter * 1e7);
 }
 
 // Determine the conversion factor between metres, and pixels on screen
@@ -8,6 +8,9 @@ Plots position of for a selection of nodes, with north facing up.
 Size of cross represents hops away.
 Our own node is identified with a faded label.
 
+The map is zoomed to fit the nodes nearest to us (MAP_FIT_NODES of them), then shows every node which falls inside it.
+Both lookups go through NodeDB's position index, so a render only touches the nodes near the map.
+
 The base applet doesn't handle any events; this is left to the derived applets.
 
 */
@@ -21,6 +24,11 @@ The base applet doesn't handle any events; this is left to the derived applets.
 #include "MeshModule.h"
 #include "gps/GeoCoord.h"
 
+// How many of the nodes nearest to us the map is zoomed to fit
+#ifndef MAP_FIT_NODES
+#define MAP_FIT_NODES 32
+#endif
+
 namespace NicheGraphics::InkHUD
 {
 
@@ -47,7 +55,10 @@ class MapApplet : public Applet
     };
 
     Marker calculateMarker(float lat, float lng, bool hasHopsAway, uint8_t hopsAway);
-    void calculateAllMarkers();
+    void findFitNodes();                                       // Which nodes the map is sized around
+    void calculateMarkers(const std::vector<uint16_t> &nodes); // Markers for these nodes, by NodeDB index
+    std::vector<uint16_t> findVisibleNodes();                  // Nodes inside the map, once it is sized and scaled
+    GeoObserver getCenterObserver();
     void calculateMapScale();                           // Conversion factor for meters to pixels
     void drawCross(int16_t x, int16_t y, uint8_t size); // Draw the X used for most markers
 
@@ -55,6 +66,7 @@ class MapApplet : public Applet
     float latCenter = 0;  // Map center: latitude
     float lngCenter = 0;  // Map center: longitude
 
+    std::vector<uint16_t> fitNodes; // NodeDB index of the nodes the map is sized around
     std::list<Marker> markers;
     uint32_t widthMeters = 0;  // Map width: meters
     uint32_t heightMeters = 0; // Map height: meters
@@ -27,7 +27,7 @@ CallbackObserver<DeviceScreen, esp_sleep_wakeup_cause_t> endSleepObserver =
 void tft_task_handler(void *param = nullptr)
 {
     while (true) {
-        spiLock->lock();
+        spiLock->lock(SPI_USER_DISPLAY);
         deviceScreen->task_handler();
         spiLock->unlock();
         deviceScreen->sleep();
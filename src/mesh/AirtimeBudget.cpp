@@ -0,0 +1,112 @@
+#include "AirtimeBudget.h"
+
+AirtimeClass AirtimeBudget::classify(meshtastic_MeshPacket_Priority priority, bool fromUs)
+{
+    if (!fromUs || priority >= meshtastic_MeshPacket_Priority_ACK)
+        return AIRTIME_ESSENTIAL;
+    if (priority <= meshtastic_MeshPacket_Priority_BACKGROUND)
+        return AIRTIME_BACKGROUND;
+    return AIRTIME_NORMAL;
+}
+
+void AirtimeBudget::setRate(float percent, uint32_t now)
+{
+    uint32_t newRate = percent < 100 ? (uint32_t)(percent * 10000) : 1000000;
+    if (newRate == ratePpm && capacityUs > 0)
+        return;
+
+    refill(now);
+    bool first = capacityUs == 0;
+    ratePpm = newRate;
+    capacityUs = isLimited() ? (int64_t)ratePpm * AIRTIME_BUDGET_BURST_SECS : 0;
+    // Start with a full bank, and never keep more than the new rate allows
+    if (first || balanceUs > capacityUs)
+        balanceUs = capacityUs;
+}
+
+void AirtimeBudget::refill(uint32_t now)
+{
+    balanceUs = balanceAt(now);
+    lastRefill = now;
+}
+
+int64_t AirtimeBudget::balanceAt(uint32_t now) const
+{
+    if (!isLimited())
+        return 0;
+    // ratePpm / 1000 us earned per ms
+    int64_t balance = balanceUs + (int64_t)(uint32_t)(now - lastRefill) * ratePpm / 1000;
+    return balance < capacityUs ? balance : capacityUs;
+}
+
+float AirtimeBudget::getBalanceMs(uint32_t now) const
+{
+    return balanceAt(now) / 1000.0f;
+}
+
+bool AirtimeBudget::mayTransmit(AirtimeClass cls, uint32_t airtimeMs, uint32_t now, uint32_t *waitMs)
+{
+    *waitMs = 0;
+    if (!isLimited())
+        return true;
+    refill(now);
+
+    uint8_t floorPercent = cls == AIRTIME_BACKGROUND ? AIRTIME_BUDGET_BACKGROUND_FLOOR
+                           : cls == AIRTIME_NORMAL   ? AIRTIME_BUDGET_NORMAL_FLOOR
+                                                     : 0;
+    int64_t needUs = capacityUs * floorPercent / 100 + (int64_t)airtimeMs * 1000;
+    if (needUs > capacityUs)
+        needUs = capacityUs; // A packet that won't fit above the floor still goes once the bank is full
+    if (balanceUs >= needUs)
+        return true;
+
+    // Rounded up, so that after waiting it may go
+    *waitMs = (uint32_t)(((needUs - balanceUs) * 1000 + ratePpm - 1) / ratePpm);
+    return false;
+}
+
+void AirtimeBudget::charge(const meshtastic_MeshPacket *p, uint32_t airtimeMs, uint32_t now)
+{
+    refill(now);
+    if (isLimited())
+        balanceUs -= (int64_t)airtimeMs * 1000;
+
+    meshtastic_PortNum port = portOf(p);
+    size_t i = 0;
+    while (i < numPorts && ports[i].port != port)
+        i++;
+    if (i == AIRTIME_BUDGET_MAX_PORTS) {
+        i--; // The slot for everything else
+    } else if (i == numPorts) {
+        if (numPorts == AIRTIME_BUDGET_MAX_PORTS - 1)
+            port = meshtastic_PortNum_MAX; // Last free slot, start counting everything else in it
+        ports[numPorts++].port = port;
+    }
+    ports[i].packets++;
+    ports[i].airtimeMs += airtimeMs;
+}
+
+void AirtimeBudget::notePort(const meshtastic_MeshPacket *p, meshtastic_PortNum port)
+{
+    for (Pending &e : pending) {
+        if (e.id == p->id && e.from == p->from) {
+            // Retransmissions come back already encrypted, keep what we knew
+            if (port != meshtastic_PortNum_UNKNOWN_APP)
+                e.port = port;
+            return;
+        }
+    }
+    Pending &e = pending[nextPending];
+    nextPending = (nextPending + 1) % AIRTIME_BUDGET_MAX_PENDING;
+    e.from = p->from;
+    e.id = p->id;
+    e.port = port;
+}
+
+meshtastic_PortNum AirtimeBudget::portOf(const meshtastic_MeshPacket *p) const
+{
+    for (const Pending &e : pending)
+        if (e.id == p->id && e.from == p->from)
+            return e.port;
+    return meshtastic_PortNum_UNKNOWN_APP;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "MeshTypes.h"
+
+/// How much unused airtime can be saved up, in seconds of earning it
+#define AIRTIME_BUDGET_BURST_SECS 600
+
+/// Share of the saved up airtime each class of traffic has to leave for the classes above it, in percent
+#define AIRTIME_BUDGET_BACKGROUND_FLOOR 50
+#define AIRTIME_BUDGET_NORMAL_FLOOR 20
+
+/// Background packets that would have to wait longer than this for airtime are dropped instead
+#define AIRTIME_BUDGET_MAX_DEFER_MS (2 * 60 * 1000)
+
+/// How often the radio looks at the budget again while waiting for it
+#define AIRTIME_BUDGET_RECHECK_MS 1000
+
+/// How many ports get their own airtime count, the last slot counts all other ports
+#define AIRTIME_BUDGET_MAX_PORTS 16
+
+/// How many queued packets we remember the port of
+#define AIRTIME_BUDGET_MAX_PENDING 32
+
+enum AirtimeClass : uint8_t {
+    AIRTIME_BACKGROUND, // Our own low priority packets: telemetry, position and node info broadcasts
+    AIRTIME_NORMAL,     // Our other packets
+    AIRTIME_ESSENTIAL,  // ACKs and routing, and packets we relay for others
+};
+
+/**
+ * A token bucket of transmit airtime, for regions with a duty cycle limit.
+ *
+ * Airtime is earned at the duty cycle rate and banked up to AIRTIME_BUDGET_BURST_SECS worth. The radio checks
+ * mayTransmit() before starting to send and charge()s the packet's airtime once it has gone out. Lower classes have to
+ * leave part of the bank for the ones above, so when the budget runs short telemetry waits (or is shed) first while ACKs
+ * and relayed packets still get through.
+ *
+ * Airtime sent is also added up per port. The radio only sees encrypted packets, so Router notes the port of each packet
+ * it sends by (from, id) and the radio looks it up again.
+ */
+class AirtimeBudget
+{
+  public:
+    struct PortAirtime {
+        meshtastic_PortNum port = meshtastic_PortNum_UNKNOWN_APP; // UNKNOWN_APP for packets relayed still encrypted
+        uint32_t packets = 0;
+        uint64_t airtimeMs = 0;
+    };
+
+    static AirtimeClass classify(meshtastic_MeshPacket_Priority priority, bool fromUs);
+
+    /// Earn airtime at percent of real time. 100% or more means there is no limit to keep.
+    void setRate(float percent, uint32_t now);
+    bool isLimited() const { return ratePpm < 1000000; }
+
+    /// Milliseconds of airtime banked, may be negative after a packet that didn't fit. 0 if there is no limit.
+    float getBalanceMs(uint32_t now) const;
+
+    /**
+     * Whether a packet of class cls taking airtimeMs may start now
+     * @param waitMs if not, how long until it may
+     */
+    bool mayTransmit(AirtimeClass cls, uint32_t airtimeMs, uint32_t now, uint32_t *waitMs);
+
+    /// Pay for a packet that was sent
+    void charge(const meshtastic_MeshPacket *p, uint32_t airtimeMs, uint32_t now);
+
+    /// Remember the port of a packet before it is encrypted
+    void notePort(const meshtastic_MeshPacket *p, meshtastic_PortNum port);
+
+    size_t getNumPorts() const { return numPorts; }
+    const PortAirtime &getPortAirtime(size_t i) const { return ports[i]; }
+
+  private:
+    uint32_t ratePpm = 1000000; // Airtime earned per unit of time, in parts per million
+    int64_t capacityUs = 0;     // Most we can bank
+    int64_t balanceUs = 0;      // What is banked
+    uint32_t lastRefill = 0;
+
+    struct Pending {
+        NodeNum from = 0;
+        PacketId id = 0;
+        meshtastic_PortNum port = meshtastic_PortNum_UNKNOWN_APP;
+    };
+    Pending pending[AIRTIME_BUDGET_MAX_PENDING];
+    size_t nextPending = 0;
+
+    PortAirtime ports[AIRTIME_BUDGET_MAX_PORTS];
+    size_t numPorts = 0;
+
+    void refill(uint32_t now);
+    int64_t balanceAt(uint32_t now) const;
+    meshtastic_PortNum portOf(const meshtastic_MeshPacket *p) const;
+};
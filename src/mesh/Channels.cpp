@@ -422,6 +422,17 @@ bool Channels::decryptForHash(ChannelIndex chIndex, ChannelHash channelHash)
     }
 }
 
+bool Channels::getKeyForHash(ChannelIndex chIndex, ChannelHash channelHash, CryptoKey &key)
+{
+    if (chIndex > getNumChannels() || getHash(chIndex) != channelHash)
+        return false;
+    key = getKey(chIndex);
+    if (key.length < 0)
+        return false;
+    LOG_DEBUG("Use channel %d (hash 0x%x)", chIndex, channelHash);
+    return true;
+}
+
 /** Given a channel index setup crypto for encoding that channel (or the primary channel if that channel is unsecured)
  *
  * This method is called before encoding outbound packets
@@ -75,6 +75,13 @@ class Channels
      */
     bool decryptForHash(ChannelIndex chIndex, ChannelHash channelHash);
 
+    /** Like decryptForHash(), but hands the key back instead of setting it on the shared crypto engine, so that the
+     * caller can decrypt with a CryptoContext of its own
+     *
+     * @return false if the channel hash or channel is invalid
+     */
+    bool getKeyForHash(ChannelIndex chIndex, ChannelHash channelHash, CryptoKey &key);
+
     /** Given a channel index setup crypto for encoding that channel (or the primary channel if that channel is unsecured)
      *
      * This method is called before encoding outbound packets
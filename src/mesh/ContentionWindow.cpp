@@ -0,0 +1,121 @@
+#include "ContentionWindow.h"
+
+// The range of LoRa SNRs mapped onto the window for relays
+static const int SNR_MIN = -20;
+static const int SNR_MAX = 10;
+
+void ContentionWindow::setRole(meshtastic_Config_DeviceConfig_Role role)
+{
+    cwMin = CONTENTION_CW_MIN;
+    cwMax = CONTENTION_CW_MAX;
+    relaysFirst = false;
+    switch (role) {
+    case meshtastic_Config_DeviceConfig_Role_ROUTER:
+    case meshtastic_Config_DeviceConfig_Role_REPEATER:
+        // Relay delays are 2 * CW slots for these, and must stay below the 2 * CONTENTION_CW_MAX the others wait first
+        cwMax = CONTENTION_CW_MAX - 1;
+        relaysFirst = true;
+        break;
+    case meshtastic_Config_DeviceConfig_Role_TRACKER:
+    case meshtastic_Config_DeviceConfig_Role_SENSOR:
+    case meshtastic_Config_DeviceConfig_Role_TAK_TRACKER:
+    case meshtastic_Config_DeviceConfig_Role_LOST_AND_FOUND:
+        cwMin = CONTENTION_CW_MIN + 1;
+        break;
+    default:
+        break;
+    }
+    if (backoff > cwMax - cwMin)
+        backoff = cwMax - cwMin;
+}
+
+void ContentionWindow::noteChannelBusy(PacketId id, uint32_t now)
+{
+    idleRun = 0;
+    if (id == lastDeferredId)
+        return;
+    lastDeferredId = id;
+    grow(now);
+}
+
+void ContentionWindow::noteChannelIdle(uint32_t now)
+{
+    decay(now);
+    if (backoff && ++idleRun >= CONTENTION_IDLE_TO_SHRINK) {
+        backoff--;
+        idleRun = 0;
+        lastChangeMsec = now;
+    }
+}
+
+void ContentionWindow::grow(uint32_t now)
+{
+    decay(now);
+    if (backoff < cwMax - cwMin)
+        backoff++;
+    idleRun = 0;
+    lastChangeMsec = now;
+}
+
+void ContentionWindow::decay(uint32_t now)
+{
+    if (!backoff) {
+        lastChangeMsec = now;
+        return;
+    }
+    uint32_t steps = (now - lastChangeMsec) / CONTENTION_DECAY_MSEC;
+    if (steps >= backoff) {
+        backoff = 0;
+        lastChangeMsec = now;
+    } else if (steps) {
+        backoff -= steps;
+        lastChangeMsec += steps * CONTENTION_DECAY_MSEC;
+    }
+}
+
+uint8_t ContentionWindow::getCWsize(float channelUtil, uint32_t now)
+{
+    decay(now);
+    if (channelUtil < 0)
+        channelUtil = 0;
+    else if (channelUtil > 100)
+        channelUtil = 100;
+    return clampCW(cwMin + (int)((cwMax - cwMin) * channelUtil / 100) + backoff);
+}
+
+uint8_t ContentionWindow::getCWsizeForSnr(float snr, uint32_t now)
+{
+    decay(now);
+    // High SNR means a close sender, so a large window: the ones further away should get to relay first
+    return clampCW(cwMin + (int)(snr - SNR_MIN) * (cwMax - cwMin) / (SNR_MAX - SNR_MIN));
+}
+
+uint32_t ContentionWindow::getTxDelaySlotsWeighted(float snr, uint32_t now)
+{
+    uint8_t cw = getCWsizeForSnr(snr, now);
+    if (relaysFirst)
+        return randomBelow(2 * cw);
+    // Wait out the longest a router or repeater may take first
+    return 2 * CONTENTION_CW_MAX + randomBelow(1UL << cw);
+}
+
+uint32_t ContentionWindow::getTxDelaySlotsWeightedWorst(float snr, uint32_t now)
+{
+    return 2 * CONTENTION_CW_MAX + (1UL << getCWsizeForSnr(snr, now));
+}
+
+uint32_t ContentionWindow::getRetransmissionSlots(float channelUtil, uint32_t now)
+{
+    // Our own window, then a relayer with an SNR halfway up the range
+    return (1UL << getCWsize(channelUtil, now)) + 2 * CONTENTION_CW_MAX +
+           (1UL << ((CONTENTION_CW_MAX + CONTENTION_CW_MIN) / 2));
+}
+
+uint32_t ContentionWindow::randomBelow(uint32_t n)
+{
+    // xorshift32
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return (uint32_t)(((uint64_t)rngState * n) >> 32);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "MeshTypes.h"
+
+/// Contention window sizes are exponents, a window of size CW holds 2^CW slots
+#define CONTENTION_CW_MIN 3
+#define CONTENTION_CW_MAX 8
+
+/// Clear channel checks in a row it takes to take one step of backoff off again
+#define CONTENTION_IDLE_TO_SHRINK 4
+
+/// Without more busy channel or lost packet signs, a step of backoff is dropped after this long
+#define CONTENTION_DECAY_MSEC (15 * 1000)
+
+/**
+ * Picks how many slots to wait before transmitting, from what we see of the channel.
+ *
+ * The base window grows with channel utilization (which includes RX_ALL_LOG airtime, so other meshes on our frequency
+ * count too) as before, but utilization is a one minute average and lags behind a burst of relays. So on top of it we
+ * keep a backoff in the style of 802.11 binary exponential backoff: when a reception is lost to a CRC error, a packet has
+ * to be retransmitted or CAD makes us put off a packet, the window doubles. CAD runs every few slots while somebody else
+ * transmits, so only the first busy check per packet counts. Clear channel checks and time shrink it again one step at a
+ * time, rather than all at once, as LoRa feedback is slow and a crowded mesh stays crowded for a while. The backoff only
+ * applies to our own packets: relays are already spread out by SNR and role, and a client that backed off would lose
+ * its place to farther nodes relaying.
+ *
+ * The bounds depend on the role: routers and repeaters relay for everyone so they stay in a smaller window, trackers and
+ * sensors only send background traffic so they start from a larger one.
+ *
+ * Delays are in slots, the radio multiplies by its slot time. Random numbers come from a small xorshift generator instead
+ * of random(), which is a hardware RNG read or a locked libc call on some platforms.
+ */
+class ContentionWindow
+{
+  public:
+    ContentionWindow() { setRole(meshtastic_Config_DeviceConfig_Role_CLIENT); }
+
+    void setRole(meshtastic_Config_DeviceConfig_Role role);
+    void seed(uint32_t seed) { rngState = seed ? seed : 1; }
+
+    /// CAD found the channel busy when we wanted to send packet id
+    void noteChannelBusy(PacketId id, uint32_t now);
+    /// CAD found the channel clear, so we sent
+    void noteChannelIdle(uint32_t now);
+    /// A reception was lost to a CRC error, most likely overlapping transmissions
+    void noteCollision(uint32_t now) { grow(now); }
+    /// A packet went unacknowledged and is sent again
+    void noteRetransmission(uint32_t now) { grow(now); }
+
+    /// Size of the window for our own packets at this channel utilization
+    uint8_t getCWsize(float channelUtil, uint32_t now);
+    /// Size of the window for a relayed packet received with this SNR: the further away its sender, the sooner we relay
+    uint8_t getCWsizeForSnr(float snr, uint32_t now);
+
+    /// A random number of slots to wait before sending our own packet
+    uint32_t getTxDelaySlots(float channelUtil, uint32_t now) { return randomBelow(1UL << getCWsize(channelUtil, now)); }
+    /// A random number of slots to wait before relaying, routers and repeaters go before the others
+    uint32_t getTxDelaySlotsWeighted(float snr, uint32_t now);
+    /// Most slots getTxDelaySlotsWeighted() may wait for a client
+    uint32_t getTxDelaySlotsWeightedWorst(float snr, uint32_t now);
+    /// Slots to allow for a relay of our packet and its ACK, on top of their airtime
+    uint32_t getRetransmissionSlots(float channelUtil, uint32_t now);
+
+    uint8_t getBackoff() const { return backoff; }
+    uint8_t getMinCW() const { return cwMin; }
+    uint8_t getMaxCW() const { return cwMax; }
+
+    /// Uniform in [0, n)
+    uint32_t randomBelow(uint32_t n);
+
+  private:
+    uint8_t cwMin = CONTENTION_CW_MIN;
+    uint8_t cwMax = CONTENTION_CW_MAX;
+    bool relaysFirst = false; // Routers and repeaters relay ahead of everyone else
+    uint8_t backoff = 0; // Steps the window is doubled on top of what utilization or SNR asks for
+    uint8_t idleRun = 0;
+    PacketId lastDeferredId = 0; // The packet the last busy channel held up
+    uint32_t lastChangeMsec = 0;
+    uint32_t rngState = 1;
+
+    void grow(uint32_t now);
+    void decay(uint32_t now);
+    uint8_t clampCW(int cw) const { return cw < cwMin ? cwMin : cw > cwMax ? cwMax : cw; }
+};
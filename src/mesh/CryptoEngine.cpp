@@ -205,12 +205,9 @@ void CryptoEngine::setKey(const CryptoKey &k)
 void CryptoEngine::encryptPacket(uint32_t fromNode, uint64_t packetId, size_t numBytes, uint8_t *bytes)
 {
     if (key.length > 0) {
-        initNonce(fromNode, packetId);
-        if (numBytes <= MAX_BLOCKSIZE) {
-            encryptAESCtr(key, nonce, numBytes, bytes);
-        } else {
-            LOG_ERROR("Packet too large for crypto engine: %d. noop encryption!", numBytes);
-        }
+        sharedContext.key = key;
+        if (cryptPacket(sharedContext, fromNode, packetId, bytes, numBytes))
+            memcpy(bytes, sharedContext.scratch, numBytes);
     }
 }
 
@@ -220,32 +217,60 @@ void CryptoEngine::decrypt(uint32_t fromNode, uint64_t packetId, size_t numBytes
     encryptPacket(fromNode, packetId, numBytes, bytes);
 }
 
-// Generic implementation of AES-CTR encryption.
 void CryptoEngine::encryptAESCtr(CryptoKey _key, uint8_t *_nonce, size_t numBytes, uint8_t *bytes)
 {
-    delete ctr;
-    ctr = nullptr;
-    if (_key.length == 16)
-        ctr = new CTR<AES128>();
-    else
-        ctr = new CTR<AES256>();
-    ctr->setKey(_key.bytes, _key.length);
-    static uint8_t scratch[MAX_BLOCKSIZE];
-    memcpy(scratch, bytes, numBytes);
-    memset(scratch + numBytes, 0,
-           sizeof(scratch) - numBytes); // Fill rest of buffer with zero (in case cypher looks at it)
+    if (_key.length <= 0 || numBytes > MAX_BLOCKSIZE)
+        return;
+    sharedContext.key = _key;
+    memcpy(sharedContext.nonce, _nonce, sizeof(sharedContext.nonce));
+    cryptAESCtr(sharedContext, bytes, numBytes);
+    memcpy(bytes, sharedContext.scratch, numBytes);
+}
 
-    ctr->setIV(_nonce, 16);
-    ctr->setCounterSize(4);
-    ctr->encrypt(bytes, scratch, numBytes);
+bool CryptoEngine::cryptPacket(CryptoContext &ctx, uint32_t fromNode, uint64_t packetId, const uint8_t *bytes,
+                               size_t numBytes) const
+{
+    if (numBytes > MAX_BLOCKSIZE) {
+        LOG_ERROR("Packet too large for crypto engine: %d. noop encryption!", numBytes);
+        return false;
+    }
+    if (ctx.key.length > 0) {
+        initNonce(ctx.nonce, fromNode, packetId);
+        cryptAESCtr(ctx, bytes, numBytes);
+    } else {
+        memcpy(ctx.scratch, bytes, numBytes);
+    }
+    return true;
+}
+
+namespace
+{
+// A cipher of our own on the stack, so that nothing is shared with other callers
+template <typename Cipher> void cryptCtr(CryptoContext &ctx, const uint8_t *bytes, size_t numBytes)
+{
+    CTR<Cipher> ctr;
+    ctr.setKey(ctx.key.bytes, ctx.key.length);
+    ctr.setIV(ctx.nonce, 16);
+    ctr.setCounterSize(4);
+    ctr.encrypt(ctx.scratch, bytes, numBytes);
+}
+} // namespace
+
+// Generic implementation of AES-CTR encryption.
+void CryptoEngine::cryptAESCtr(CryptoContext &ctx, const uint8_t *bytes, size_t numBytes) const
+{
+    if (ctx.key.length == 16)
+        cryptCtr<AES128>(ctx, bytes, numBytes);
+    else
+        cryptCtr<AES256>(ctx, bytes, numBytes);
 }
 
 /**
- * Init our 128 bit nonce for a new packet
+ * Init a 128 bit nonce for a new packet
  */
-void CryptoEngine::initNonce(uint32_t fromNode, uint64_t packetId, uint32_t extraNonce)
+void CryptoEngine::initNonce(uint8_t *nonce, uint32_t fromNode, uint64_t packetId, uint32_t extraNonce)
 {
-    memset(nonce, 0, sizeof(nonce));
+    memset(nonce, 0, 16);
 
     // use memcpy to avoid breaking strict-aliasing
     memcpy(nonce, &packetId, sizeof(uint64_t));
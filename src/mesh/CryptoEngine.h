@@ -23,6 +23,17 @@ struct CryptoKey {
 #define MAX_BLOCKSIZE 256
 #define TEST_CURVE25519_FIELD_OPS // Exposes Curve25519::isWeakPoint() for testing keys
 
+/**
+ * Everything one AES-CTR encryption or decryption works on. The engine keeps no state of its own for these, so threads
+ * that each bring their own context can use it at the same time without holding cryptLock.
+ */
+struct CryptoContext {
+    CryptoKey key = {};
+    uint8_t nonce[16] = {0};
+    /// Where the result is left
+    uint8_t scratch[MAX_BLOCKSIZE];
+};
+
 class CryptoEngine
 {
   public:
@@ -71,27 +82,46 @@ class CryptoEngine
      */
     virtual void encryptPacket(uint32_t fromNode, uint64_t packetId, size_t numBytes, uint8_t *bytes);
     virtual void decrypt(uint32_t fromNode, uint64_t packetId, size_t numBytes, uint8_t *bytes);
-    virtual void encryptAESCtr(CryptoKey key, uint8_t *nonce, size_t numBytes, uint8_t *bytes);
+    void encryptAESCtr(CryptoKey key, uint8_t *nonce, size_t numBytes, uint8_t *bytes);
+
+    /**
+     * Encrypt or decrypt (with CTR they are the same) a packet with ctx.key, leaving the result in ctx.scratch. A key
+     * length of 0 means no encryption, the bytes are copied as they are.
+     *
+     * Reentrant: only ctx is written, so this needs no lock as long as each caller has its own context.
+     * @return false if the packet is too large
+     */
+    bool cryptPacket(CryptoContext &ctx, uint32_t fromNode, uint64_t packetId, const uint8_t *bytes, size_t numBytes) const;
+
+    /// AES-CTR of numBytes (at most MAX_BLOCKSIZE) with ctx.key and ctx.nonce into ctx.scratch, reentrant like cryptPacket()
+    virtual void cryptAESCtr(CryptoContext &ctx, const uint8_t *bytes, size_t numBytes) const;
+
+    /**
+     * Init a 128 bit nonce for a new packet
+     *
+     * The NONCE is constructed by concatenating (from MSB to LSB):
+     * a 64 bit packet number (stored in little endian order)
+     * a 32 bit sending node number (stored in little endian order)
+     * a 32 bit block counter (starts at zero)
+     */
+    static void initNonce(uint8_t *nonce, uint32_t fromNode, uint64_t packetId, uint32_t extraNonce = 0);
 #ifndef PIO_UNIT_TESTING
   protected:
 #endif
     /** Our per packet nonce */
     uint8_t nonce[16] = {0};
     CryptoKey key = {};
-    CTRCommon *ctr = NULL;
+    /// Used by the old API that works on the key set with setKey(), under cryptLock
+    CryptoContext sharedContext;
 #if !(MESHTASTIC_EXCLUDE_PKI)
     uint8_t shared_key[32] = {0};
     uint8_t private_key[32] = {0};
 #endif
-    /**
-     * Init our 128 bit nonce for a new packet
-     *
-     * The NONCE is constructed by concatenating (from MSB to LSB):
-     * a 64 bit packet number (stored in little endian order)
-     * a 32 bit sending node number (stored in little endian order)
-     * a 32 bit block counter (starts at zero)
-     */
-    void initNonce(uint32_t fromNode, uint64_t packetId, uint32_t extraNonce = 0);
+    /** Init our own nonce, for the old API and PKI */
+    void initNonce(uint32_t fromNode, uint64_t packetId, uint32_t extraNonce = 0)
+    {
+        initNonce(nonce, fromNode, packetId, extraNonce);
+    }
 };
 
 extern CryptoEngine *crypto;
\ No newline at end of file
@@ -21,6 +21,7 @@ ErrorCode FloodingRouter::send(meshtastic_MeshPacket *p)
 
 bool FloodingRouter::shouldFilterReceived(const meshtastic_MeshPacket *p)
 {
+    noteRelayer(p);
     if (wasSeenRecently(p)) { // Note: this will also add a recent packet record
         printPacket("Ignore dupe incoming msg", p);
         rxDupe++;
@@ -45,7 +46,17 @@ bool FloodingRouter::shouldFilterReceived(const meshtastic_MeshPacket *p)
 
 void FloodingRouter::perhapsCancelDupe(const meshtastic_MeshPacket *p)
 {
-    if (config.device.role != meshtastic_Config_DeviceConfig_Role_ROUTER &&
+    RebroadcastSuppressor::Verdict verdict = judgeRebroadcast(p);
+    if (verdict == RebroadcastSuppressor::REDUNDANT) {
+        // Whatever our role, the relayers so far already reached our neighbors
+        if (Router::cancelSending(p->from, p->id)) {
+            LOG_DEBUG("Cancel rebroadcast of id=0x%x, neighbors already covered", p->id);
+            txRelayCanceled++;
+        }
+        return;
+    }
+    // If we know our rebroadcast would still reach neighbors the others missed, keep it
+    if (verdict == RebroadcastSuppressor::UNKNOWN && config.device.role != meshtastic_Config_DeviceConfig_Role_ROUTER &&
         config.device.role != meshtastic_Config_DeviceConfig_Role_REPEATER &&
         config.device.role != meshtastic_Config_DeviceConfig_Role_ROUTER_LATE) {
         // cancel rebroadcast of this message *if* there was already one, unless we're a router/repeater!
@@ -57,6 +68,53 @@ void FloodingRouter::perhapsCancelDupe(const meshtastic_MeshPacket *p)
     }
 }
 
+RebroadcastSuppressor::Verdict FloodingRouter::judgeRebroadcast(const meshtastic_MeshPacket *p)
+{
+    // A flooded DM still has to find its way to one node, which we can't tell from coverage
+    if (!isBroadcast(p->to))
+        return RebroadcastSuppressor::UNKNOWN;
+    // ROUTER_LATE is there to fill in after everybody else, it only moves its rebroadcast into the late window
+    if (config.device.role == meshtastic_Config_DeviceConfig_Role_ROUTER_LATE)
+        return RebroadcastSuppressor::UNKNOWN;
+
+    // The sender repeating a packet we relayed didn't hear us, so it gets relayed again however well covered it looks
+    uint8_t ourRelayID = nodeDB->getLastByteOfNodeNum(getNodeNum());
+    bool isRepeated = p->hop_start > 0 && p->hop_start == p->hop_limit;
+    if (isRepeated && wasRelayer(ourRelayID, p->id, getFrom(p)))
+        return RebroadcastSuppressor::UNKNOWN;
+
+    uint8_t relayers[NUM_RELAYERS];
+    uint8_t count = getRelayers(p->id, getFrom(p), relayers);
+    suppressor.setRole(config.device.role);
+    suppressor.setOurRelayId(ourRelayID);
+    return suppressor.judge(relayers, count, millis());
+}
+
+void FloodingRouter::noteRelayer(const meshtastic_MeshPacket *p)
+{
+    uint32_t now = millis();
+    suppressor.noteHeard(p->relay_node, now);
+    if (p->hop_start > 0 && p->hop_start - p->hop_limit == 1)
+        suppressor.noteRelayedFrom(p->relay_node, nodeDB->getLastByteOfNodeNum(getFrom(p)), now);
+}
+
+void FloodingRouter::sniffNeighborInfo(const meshtastic_MeshPacket *p)
+{
+    if (p->which_payload_variant != meshtastic_MeshPacket_decoded_tag ||
+        p->decoded.portnum != meshtastic_PortNum_NEIGHBORINFO_APP || isFromUs(p))
+        return;
+
+    meshtastic_NeighborInfo np = meshtastic_NeighborInfo_init_zero;
+    if (!pb_decode_from_bytes(p->decoded.payload.bytes, p->decoded.payload.size, &meshtastic_NeighborInfo_msg, &np))
+        return;
+
+    uint8_t neighbors[REBROADCAST_NEIGHBORS_PER_NODE];
+    size_t count = 0;
+    for (pb_size_t i = 0; i < np.neighbors_count && count < REBROADCAST_NEIGHBORS_PER_NODE; i++)
+        neighbors[count++] = nodeDB->getLastByteOfNodeNum(np.neighbors[i].node_id);
+    suppressor.noteNeighbors(nodeDB->getLastByteOfNodeNum(np.node_id), neighbors, count, millis());
+}
+
 bool FloodingRouter::isRebroadcaster()
 {
     return config.device.role != meshtastic_Config_DeviceConfig_Role_CLIENT_MUTE &&
@@ -67,7 +125,10 @@ void FloodingRouter::perhapsRebroadcast(const meshtastic_MeshPacket *p)
 {
     if (!isToUs(p) && (p->hop_limit > 0) && !isFromUs(p)) {
         if (p->id != 0) {
-            if (isRebroadcaster()) {
+            if (isRebroadcaster() && judgeRebroadcast(p) == RebroadcastSuppressor::REDUNDANT) {
+                LOG_DEBUG("No rebroadcast: neighbors already covered by the relayers");
+                txRelayCanceled++;
+            } else if (isRebroadcaster()) {
                 meshtastic_MeshPacket *tosend = packetPool.allocCopy(*p); // keep a copy because we will be sending it
 
                 tosend->hop_limit--; // bump down the hop count
@@ -103,6 +164,7 @@ void FloodingRouter::sniffReceived(const meshtastic_MeshPacket *p, const meshtas
         Router::cancelSending(p->to, p->decoded.request_id); // cancel rebroadcast for this DM
     }
 
+    sniffNeighborInfo(p);
     perhapsRebroadcast(p);
 
     // handle the packet as normal
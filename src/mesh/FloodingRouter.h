@@ -1,5 +1,6 @@
 #pragma once
 
+#include "RebroadcastSuppressor.h"
 #include "Router.h"
 
 /**
@@ -64,4 +65,17 @@ class FloodingRouter : public Router
 
     // Return true if we are a rebroadcaster
     bool isRebroadcaster();
+
+    /// Tells when rebroadcasting a broadcast would not reach anybody new
+    RebroadcastSuppressor suppressor;
+
+    /* Call for every packet we hear, before filtering: its relayer is one of our neighbors, and if it relayed the packet
+     * one hop from the sender, it heard the sender */
+    void noteRelayer(const meshtastic_MeshPacket *p);
+
+    /* Learn the neighbors of other nodes from the NeighborInfo packets we receive */
+    void sniffNeighborInfo(const meshtastic_MeshPacket *p);
+
+    /* Whether the relayers we heard of this packet already reached our neighbors. UNKNOWN for anything but broadcasts. */
+    RebroadcastSuppressor::Verdict judgeRebroadcast(const meshtastic_MeshPacket *p);
 };
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "FromRadioRing.h"
+#include "concurrency/LockGuard.h"
+#include "configuration.h"
+
+#include <pb_encode.h>
+#include <string.h>
+
+namespace
+{
+/// Whether sequence number a comes before b, allowing for them wrapping around
+bool before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+} // namespace
+
+FromRadioRing::FromRadioRing(size_t maxPackets, size_t capacity)
+    : maxEntries(maxPackets), capacity(capacity < meshtastic_FromRadio_size ? meshtastic_FromRadio_size : capacity)
+{
+    entries = new Entry[maxEntries];
+    bytes = new uint8_t[this->capacity];
+}
+
+FromRadioRing::~FromRadioRing()
+{
+    delete[] entries;
+    delete[] bytes;
+}
+
+const uint8_t *FromRadioRing::encode(const meshtastic_MeshPacket &p, size_t *len)
+{
+    // A FromRadio with nothing but the packet is its tag and length, then the packet. Encode the packet after room for
+    // those and fill them in, rather than filling in a whole FromRadio.
+    const size_t headerRoom = 3;
+    pb_ostream_t stream = pb_ostream_from_buffer(scratch + headerRoom, sizeof(scratch) - headerRoom);
+    if (!pb_encode(&stream, &meshtastic_MeshPacket_msg, &p)) {
+        LOG_ERROR("Can't encode packet for phone: %s", PB_GET_ERROR(&stream));
+        return nullptr;
+    }
+    size_t packetLen = stream.bytes_written;
+    uint8_t *start = scratch + headerRoom - (packetLen < 0x80 ? 2 : 3);
+    uint8_t *at = start;
+    *at++ = (meshtastic_FromRadio_packet_tag << 3) | PB_WT_STRING;
+    if (packetLen >= 0x80) {
+        *at++ = (uint8_t)(packetLen | 0x80);
+        *at++ = (uint8_t)(packetLen >> 7);
+    } else {
+        *at++ = (uint8_t)packetLen;
+    }
+    *len = packetLen + (at - start);
+    return start;
+}
+
+bool FromRadioRing::push(const meshtastic_MeshPacket &p, bool evictOldest)
+{
+    concurrency::LockGuard g(&lock);
+    size_t len;
+    const uint8_t *frame = encode(p, &len);
+    if (!frame)
+        return false;
+
+    reclaim();
+    while (headSeq - tailSeq == maxEntries || capacity - usedBytes < len) {
+        // A packet some client has read only waits for slower ones, which mustn't hold up the others
+        if (!evictOldest && !before(tailSeq, highWater()))
+            return false;
+        dropOldest();
+    }
+
+    Entry &e = entries[headSeq % maxEntries];
+    e.offset = headOffset;
+    e.len = len;
+    e.id = p.id;
+    e.to = p.to;
+    size_t first = capacity - headOffset < len ? capacity - headOffset : len;
+    memcpy(bytes + headOffset, frame, first);
+    memcpy(bytes, frame + first, len - first);
+    headOffset = (headOffset + len) % capacity;
+    usedBytes += len;
+    headSeq++;
+    return true;
+}
+
+void FromRadioRing::subscribe(Cursor &cursor)
+{
+    concurrency::LockGuard g(&lock);
+    if (cursor.subscribed)
+        return;
+    cursor.seq = before(readSeq, tailSeq) ? tailSeq : readSeq;
+    cursor.subscribed = true;
+    cursor.next = cursors;
+    cursors = &cursor;
+}
+
+void FromRadioRing::unsubscribe(Cursor &cursor)
+{
+    concurrency::LockGuard g(&lock);
+    for (Cursor **c = &cursors; *c; c = &(*c)->next) {
+        if (*c == &cursor) {
+            *c = cursor.next;
+            break;
+        }
+    }
+    cursor.subscribed = false;
+    cursor.next = nullptr;
+    reclaim();
+}
+
+void FromRadioRing::clamp(Cursor &cursor)
+{
+    if (before(cursor.seq, tailSeq)) {
+        LOG_WARN("Phone client missed %u packets, ToPhone queue was full", tailSeq - cursor.seq);
+        cursor.seq = tailSeq;
+    }
+}
+
+bool FromRadioRing::available(Cursor &cursor)
+{
+    concurrency::LockGuard g(&lock);
+    clamp(cursor);
+    return cursor.seq != headSeq;
+}
+
+size_t FromRadioRing::read(Cursor &cursor, uint8_t *buf)
+{
+    concurrency::LockGuard g(&lock);
+    clamp(cursor);
+    if (cursor.seq == headSeq)
+        return 0;
+
+    const Entry &e = entries[cursor.seq % maxEntries];
+    size_t first = capacity - e.offset < e.len ? capacity - e.offset : e.len;
+    memcpy(buf, bytes + e.offset, first);
+    memcpy(buf + first, bytes, e.len - first);
+    size_t len = e.len;
+
+    cursor.seq++;
+    if (before(readSeq, cursor.seq))
+        readSeq = cursor.seq;
+    reclaim();
+    return len;
+}
+
+size_t FromRadioRing::numQueued()
+{
+    concurrency::LockGuard g(&lock);
+    uint32_t from = lowWater();
+    return headSeq - (before(from, tailSeq) ? tailSeq : from);
+}
+
+NodeNum FromRadioRing::findTo(PacketId id)
+{
+    concurrency::LockGuard g(&lock);
+    for (uint32_t seq = tailSeq; seq != headSeq; seq++) {
+        const Entry &e = entries[seq % maxEntries];
+        if (e.id == id)
+            return e.to;
+    }
+    return 0;
+}
+
+uint32_t FromRadioRing::lowWater() const
+{
+    if (!cursors)
+        return readSeq;
+    uint32_t low = cursors->seq;
+    for (const Cursor *c = cursors->next; c; c = c->next) {
+        if (before(c->seq, low))
+            low = c->seq;
+    }
+    return low;
+}
+
+uint32_t FromRadioRing::highWater() const
+{
+    if (!cursors)
+        return readSeq;
+    uint32_t high = cursors->seq;
+    for (const Cursor *c = cursors->next; c; c = c->next) {
+        if (before(high, c->seq))
+            high = c->seq;
+    }
+    return high;
+}
+
+void FromRadioRing::dropOldest()
+{
+    usedBytes -= entries[tailSeq % maxEntries].len;
+    tailSeq++;
+}
+
+void FromRadioRing::reclaim()
+{
+    uint32_t low = lowWater();
+    while (tailSeq != headSeq && before(tailSeq, low))
+        dropOldest();
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "MeshTypes.h"
+#include "concurrency/Lock.h"
+
+/// Bytes of ring to set aside for each packet it may hold, most encoded packets are far smaller than the largest one
+#ifndef FROM_RADIO_RING_BYTES_PER_PACKET
+#define FROM_RADIO_RING_BYTES_PER_PACKET 192
+#endif
+
+/**
+ * Packets waiting for the phone, each encoded once as a FromRadio and shared by every connected client API.
+ *
+ * Each PhoneAPI subscribes a Cursor and reads packets at its own pace, so a packet one client reads is still there for the
+ * others. Its bytes are freed once every subscribed client has read it, or while nobody is connected, once whoever connects
+ * next has read it. When the ring is full the oldest packet is dropped to make room if the new one may evict it, or if some
+ * client has read it already, so a client that stopped reading only loses packets itself.
+ */
+class FromRadioRing
+{
+  public:
+    struct Cursor {
+        uint32_t seq = 0; // Of the next packet to read
+        bool subscribed = false;
+        Cursor *next = nullptr;
+    };
+
+    /**
+     * @param maxPackets most packets held at once
+     * @param capacity bytes of encoded packets held at once
+     */
+    FromRadioRing(size_t maxPackets, size_t capacity);
+    ~FromRadioRing();
+
+    FromRadioRing(const FromRadioRing &) = delete;
+    FromRadioRing &operator=(const FromRadioRing &) = delete;
+
+    /**
+     * Encode p for the phone and add it
+     * @param evictOldest whether to drop the oldest packet if there is no room, otherwise p is dropped
+     * @return false if p was dropped
+     */
+    bool push(const meshtastic_MeshPacket &p, bool evictOldest);
+
+    /// Start reading, from the first packet nobody has read yet
+    void subscribe(Cursor &cursor);
+    void unsubscribe(Cursor &cursor);
+
+    /// Whether there is a packet cursor hasn't read
+    bool available(Cursor &cursor);
+
+    /**
+     * Copy the next FromRadio for cursor to buf, which must hold meshtastic_FromRadio_size bytes
+     * @return its length, 0 if there is none
+     */
+    size_t read(Cursor &cursor, uint8_t *buf);
+
+    /// How many packets the slowest client still has to read, or nobody has read if none is connected
+    size_t numQueued();
+
+    /// The destination of a held packet with this id, 0 if there is none
+    NodeNum findTo(PacketId id);
+
+  private:
+    struct Entry {
+        uint32_t offset;
+        uint16_t len;
+        PacketId id;
+        NodeNum to;
+    };
+
+    concurrency::Lock lock;
+    Entry *entries;
+    size_t maxEntries;
+    uint8_t *bytes;
+    size_t capacity;
+    size_t usedBytes = 0;
+    size_t headOffset = 0;
+    uint32_t tailSeq = 0, headSeq = 0; // Packets [tailSeq, headSeq) are held
+    uint32_t readSeq = 0;              // Every packet before it was read by some client
+    Cursor *cursors = nullptr;
+    uint8_t scratch[meshtastic_FromRadio_size];
+
+    /// Encode p as a FromRadio in scratch, returns where it starts
+    const uint8_t *encode(const meshtastic_MeshPacket &p, size_t *len);
+    /// First packet that is still wanted
+    uint32_t lowWater() const;
+    /// First packet the fastest client hasn't read
+    uint32_t highWater() const;
+    void clamp(Cursor &cursor);
+    void dropOldest();
+    void reclaim();
+};
@@ -2,6 +2,7 @@
 
 #include <Arduino.h>
 #include <assert.h>
+#include <atomic>
 #include <functional>
 #include <memory>
 
@@ -65,6 +66,9 @@ template <class T> class Allocator
     /// Return a buffer for use by others
     virtual void release(T *p) = 0;
 
+    /// How many buffers have been handed out and not yet released
+    virtual size_t getNumInUse() const { return 0; }
+
   protected:
     // Alloc some storage
     virtual T *alloc(TickType_t maxWait) = 0;
@@ -85,14 +89,25 @@ template <class T> class MemoryDynamic : public Allocator<T>
     {
         assert(p);
         free(p);
+        numInUse--;
     }
 
+    virtual size_t getNumInUse() const override { return numInUse; }
+
   protected:
     // Alloc some storage
     virtual T *alloc(TickType_t maxWait) override
     {
         T *p = (T *)malloc(sizeof(T));
         assert(p);
+        numInUse++;
         return p;
     }
+
+  private:
+#ifdef ARCH_PORTDUINO
+    std::atomic<size_t> numInUse{0}; // meshtasticd also allocates from its web server thread
+#else
+    size_t numInUse = 0;
+#endif
 };
@@ -2,13 +2,21 @@
 #include "Channels.h"
 #include "MeshService.h"
 #include "NodeDB.h"
+#include "PipelineStats.h"
 #include "configuration.h"
 #include "modules/RoutingModule.h"
 #include <algorithm>
 #include <assert.h>
+#include <map>
 
 std::vector<MeshModule *> *MeshModule::modules;
 
+// Dispatch index for callModules(), see rebuildDispatchIndex()
+static std::map<uint32_t, std::vector<MeshModule *>> portModules;
+static std::vector<MeshModule *> anyPortModules;
+static std::vector<MeshModule *> encryptedModules;
+static bool dispatchIndexDirty = true;
+
 const meshtastic_MeshPacket *MeshModule::currentRequest;
 uint8_t MeshModule::numPeriodicModules = 0;
 
@@ -25,6 +33,8 @@ MeshModule::MeshModule(const char *_name) : name(_name)
         modules = new std::vector<MeshModule *>();
 
     modules->push_back(this);
+    // Our subclass constructors haven't run yet, so leave the actual indexing for later
+    dispatchIndexDirty = true;
 }
 
 void MeshModule::setup() {}
@@ -34,6 +44,42 @@ MeshModule::~MeshModule()
     auto it = std::find(modules->begin(), modules->end(), this);
     assert(it != modules->end());
     modules->erase(it);
+    dispatchIndexDirty = true;
+}
+
+/**
+ * Every portnum gets the list of modules that asked for it, merged with the modules that want to see every packet,
+ * in the order the modules were registered. So walking one list calls the interested modules in the same order a
+ * walk of all modules would. Undecoded packets only go to the modules with encryptedOk set.
+ */
+void MeshModule::rebuildDispatchIndex()
+{
+    portModules.clear();
+    anyPortModules.clear();
+    encryptedModules.clear();
+    dispatchIndexDirty = false;
+    if (!modules)
+        return;
+
+    for (auto m : *modules) {
+        if (m->encryptedOk)
+            encryptedModules.push_back(m);
+
+        meshtastic_PortNum port = m->getDispatchPortNum();
+        if (port == meshtastic_PortNum_UNKNOWN_APP) {
+            anyPortModules.push_back(m);
+            for (auto &entry : portModules)
+                entry.second.push_back(m);
+        } else {
+            auto it = portModules.find(port);
+            if (it == portModules.end())
+                it = portModules.emplace(port, anyPortModules).first; // Start out with everyone registered before us
+            it->second.push_back(m);
+        }
+    }
+
+    LOG_DEBUG("Module dispatch index: %u portnums, %u modules see all", (unsigned)portModules.size(),
+              (unsigned)anyPortModules.size());
 }
 
 // ⚠️ **Only call once** to set the initial delay before a module starts broadcasting periodically
@@ -101,7 +147,17 @@ void MeshModule::callModules(meshtastic_MeshPacket &mp, RxSource src)
     auto ourNodeNum = nodeDB->getNodeNum();
     bool toUs = isBroadcast(mp.to) || isToUs(&mp);
 
-    for (auto i = modules->begin(); i != modules->end(); ++i) {
+    if (dispatchIndexDirty)
+        rebuildDispatchIndex();
+
+    // Only walk the modules that could possibly want this packet
+    const std::vector<MeshModule *> *candidates = &encryptedModules;
+    if (isDecoded) {
+        auto it = portModules.find(mp.decoded.portnum);
+        candidates = it != portModules.end() ? &it->second : &anyPortModules;
+    }
+
+    for (auto i = candidates->begin(); i != candidates->end(); ++i) {
         auto &pi = **i;
 
         pi.currentRequest = &mp;
@@ -142,9 +198,15 @@ void MeshModule::callModules(meshtastic_MeshPacket &mp, RxSource src)
                 } else
                     printPacket("packet on wrong channel, but can't respond", &mp);
             } else {
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+                uint32_t moduleStart = PipelineStats::ticks();
+#endif
                 ProcessMessage handled = pi.handleReceived(mp);
 
                 pi.alterReceived(mp);
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+                pipelineStats.recordModule(pi.name, moduleStart);
+#endif
 
                 // Possibly send replies (but only if the message was directed to us specifically, i.e. not for promiscious
                 // sniffing) also: we only let the one module send a reply, once that happens, remaining modules are not
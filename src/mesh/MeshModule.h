@@ -144,6 +144,14 @@ class MeshModule
      */
     virtual bool wantPacket(const meshtastic_MeshPacket *p) = 0;
 
+    /**
+     * If wantPacket() can only ever accept decoded packets of a single portnum, return it here so callModules() doesn't
+     * bother asking about any other packet.  Read once after the modules are created.
+     *
+     * @return meshtastic_PortNum_UNKNOWN_APP (the default) to be asked about every packet
+     */
+    virtual meshtastic_PortNum getDispatchPortNum() { return meshtastic_PortNum_UNKNOWN_APP; }
+
     /** Called to handle a particular incoming message
 
     @return ProcessMessage::STOP if you've guaranteed you've handled this message and no other handlers should be considered for
@@ -213,6 +221,9 @@ class MeshModule
      */
     static meshtastic_MeshPacket *currentReply;
 
+    /// Sort the modules by getDispatchPortNum() for callModules(), keeping their registration order
+    static void rebuildDispatchIndex();
+
     friend class ReliableRouter;
 
     /** Messages can be received that have the want_response bit set.  If set, this callback will be invoked
@@ -25,11 +25,10 @@
 #endif
 
 /*
-receivedPacketQueue - this is a queue of messages we've received from the mesh, which we are keeping to deliver to the phone.
-It is implemented with a FreeRTos queue (wrapped with a little RTQueue class) of pointers to MeshPacket protobufs (which were
-alloced with new). After a packet ptr is removed from the queue and processed it should be deleted.  (eventually we should move
-sent packets into a 'sentToPhone' queue of packets we can delete just as soon as we are sure the phone has acked those packets -
-when the phone writes to FromNum)
+toPhoneRing - this is a queue of messages we've received from the mesh, which we are keeping to deliver to the phone.
+It is implemented with a FromRadioRing, which holds each packet already encoded as a FromRadio protobuf.  Every connected client
+API reads it at its own pace, and a packet is freed once they all have.  (eventually we should keep sent packets until we are
+sure the phone has acked those packets - when the phone writes to FromNum)
 
 mesh - an instance of Mesh class.  Which manages the interface to the mesh radio library, reception of packets from other nodes,
 arbitrating to select a node number and keeping the current nodedb.
@@ -60,8 +59,8 @@ Allocator<meshtastic_QueueStatus> &queueStatusPool = staticQueueStatusPool;
 #include "Router.h"
 
 MeshService::MeshService()
-    : toPhoneQueue(MAX_RX_TOPHONE), toPhoneQueueStatusQueue(MAX_RX_TOPHONE), toPhoneMqttProxyQueue(MAX_RX_TOPHONE),
-      toPhoneClientNotificationQueue(MAX_RX_TOPHONE / 2)
+    : toPhoneRing(MAX_RX_TOPHONE, MAX_RX_TOPHONE * FROM_RADIO_RING_BYTES_PER_PACKET), toPhoneQueueStatusQueue(MAX_RX_TOPHONE),
+      toPhoneMqttProxyQueue(MAX_RX_TOPHONE), toPhoneClientNotificationQueue(MAX_RX_TOPHONE / 2)
 {
     lastQueueStatus = {0, 0, 16, 0};
 }
@@ -152,17 +151,7 @@ void MeshService::reloadOwner(bool shouldSave)
 // search the queue for a request id and return the matching nodenum
 NodeNum MeshService::getNodenumFromRequestId(uint32_t request_id)
 {
-    NodeNum nodenum = 0;
-    for (int i = 0; i < toPhoneQueue.numUsed(); i++) {
-        meshtastic_MeshPacket *p = toPhoneQueue.dequeuePtr(0);
-        if (p->id == request_id) {
-            nodenum = p->to;
-            // make sure to continue this to make one full loop
-        }
-        // put it right back on the queue
-        toPhoneQueue.enqueue(p, 0);
-    }
-    return nodenum;
+    return toPhoneRing.findTo(request_id);
 }
 
 /**
@@ -294,26 +283,13 @@ void MeshService::sendToPhone(meshtastic_MeshPacket *p)
 #endif
 #endif
 
-    if (toPhoneQueue.numFree() == 0) {
-        if (p->decoded.portnum == meshtastic_PortNum_TEXT_MESSAGE_APP ||
-            p->decoded.portnum == meshtastic_PortNum_RANGE_TEST_APP) {
-            LOG_WARN("ToPhone queue is full, discard oldest");
-            meshtastic_MeshPacket *d = toPhoneQueue.dequeuePtr(0);
-            if (d)
-                releaseToPool(d);
-        } else {
-            LOG_WARN("ToPhone queue is full, drop packet");
-            releaseToPool(p);
-            fromNum++; // Make sure to notify observers in case they are reconnected so they can get the packets
-            return;
-        }
-    }
-
-    if (toPhoneQueue.enqueue(p, 0) == false) {
-        LOG_CRIT("Failed to queue a packet into toPhoneQueue!");
-        abort();
-    }
-    fromNum++;
+    // Encoded once here for every client, so the pool packet can go straight back
+    bool mayEvict =
+        p->decoded.portnum == meshtastic_PortNum_TEXT_MESSAGE_APP || p->decoded.portnum == meshtastic_PortNum_RANGE_TEST_APP;
+    if (!toPhoneRing.push(*p, mayEvict))
+        LOG_WARN("ToPhone queue is full, drop packet");
+    releaseToPool(p);
+    fromNum++; // Notify observers even if dropped, in case they are reconnected so they can get the packets
 }
 
 void MeshService::sendMqttMessageToClientProxy(meshtastic_MqttClientProxyMessage *m)
@@ -364,8 +340,8 @@ meshtastic_NodeInfoLite *MeshService::refreshLocalMeshNode()
     meshtastic_PositionLite &position = node->position;
 
     // Update our local node info with our time (even if we don't decide to update anyone else)
-    node->last_heard =
-        getValidTime(RTCQualityFromNet); // This nodedb timestamp might be stale, so update it if our clock is kinda valid
+    // This nodedb timestamp might be stale, so update it if our clock is kinda valid
+    nodeDB->setLastHeard(node, getValidTime(RTCQualityFromNet), node->via_mqtt);
 
     position.time = getValidTime(RTCQualityFromNet);
 
@@ -413,7 +389,7 @@ int MeshService::onGPSChanged(const meshtastic::GPSStatus *newStatus)
 #endif
 bool MeshService::isToPhoneQueueEmpty()
 {
-    return toPhoneQueue.isEmpty();
+    return toPhoneRing.numQueued() == 0;
 }
 
 uint32_t MeshService::GetTimeSinceMeshPacket(const meshtastic_MeshPacket *mp)
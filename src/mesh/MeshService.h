@@ -4,6 +4,7 @@
 #include <assert.h>
 #include <string>
 
+#include "FromRadioRing.h"
 #include "GPSStatus.h"
 #include "MemoryPool.h"
 #include "MeshRadio.h"
@@ -33,11 +34,9 @@ class MeshService
     CallbackObserver<MeshService, const meshtastic::GPSStatus *> gpsObserver =
         CallbackObserver<MeshService, const meshtastic::GPSStatus *>(this, &MeshService::onGPSChanged);
 #endif
-    /// received packets waiting for the phone to process them
-    /// FIXME, change to a DropOldestQueue and keep a count of the number of dropped packets to ensure
-    /// we never hang because android hasn't been there in a while
+    /// received packets waiting for the phone to process them, encoded once and read by every connected client
     /// FIXME - save this to flash on deep sleep
-    PointerQueue<meshtastic_MeshPacket> toPhoneQueue;
+    FromRadioRing toPhoneRing;
 
     // keep list of QueueStatus packets to be send to the phone
     PointerQueue<meshtastic_QueueStatus> toPhoneQueueStatusQueue;
@@ -80,9 +79,19 @@ class MeshService
     /// Do idle processing (mostly processing messages which have been queued from the radio)
     void loop();
 
-    /// Return the next packet destined to the phone.  FIXME, somehow use fromNum to allow the phone to retry the
-    /// last few packets if needs to.
-    meshtastic_MeshPacket *getForPhone() { return toPhoneQueue.dequeuePtr(0); }
+    /// Start delivering packets to a client API, each client reads them with its own cursor
+    void subscribeForPhone(FromRadioRing::Cursor &cursor) { toPhoneRing.subscribe(cursor); }
+    void unsubscribeForPhone(FromRadioRing::Cursor &cursor) { toPhoneRing.unsubscribe(cursor); }
+
+    /// Whether there is a packet this client hasn't read yet
+    bool hasForPhone(FromRadioRing::Cursor &cursor) { return toPhoneRing.available(cursor); }
+
+    /// Copy the next packet for this client, already encoded as a FromRadio, to buf. Returns its length, 0 if there is none.
+    /// FIXME, somehow use fromNum to allow the phone to retry the last few packets if needs to.
+    size_t getForPhone(FromRadioRing::Cursor &cursor, uint8_t *buf) { return toPhoneRing.read(cursor, buf); }
+
+    /// How many packets are waiting for the phone
+    size_t getNumQueuedForPhone() { return toPhoneRing.numQueued(); }
 
     /// Allows the bluetooth handler to free packets after they have been sent
     void releaseToPool(meshtastic_MeshPacket *p) { packetPool.release(p); }
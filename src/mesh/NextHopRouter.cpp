@@ -17,13 +17,19 @@ ErrorCode NextHopRouter::send(meshtastic_MeshPacket *p)
     p->relay_node = nodeDB->getLastByteOfNodeNum(getNodeNum()); // First set the relayer to us
     wasSeenRecently(p);                                         // FIXME, move this to a sniffSent method
 
-    p->next_hop = getNextHop(p->to, p->relay_node); // set the next hop
+    p->next_hop = getNextHop(p); // set the next hop
     LOG_DEBUG("Setting next hop for packet with dest %x to %x", p->to, p->next_hop);
 
     // If it's from us, ReliableRouter already handles retransmissions if want_ack is set. If a next hop is set and hop limit is
     // not 0 or want_ack is set, start retransmissions
     if ((!isFromUs(p) || !p->want_ack) && p->next_hop != NO_NEXT_HOP_PREFERENCE && (p->hop_limit > 0 || p->want_ack))
         startRetransmission(packetPool.allocCopy(*p)); // start retransmission for relayed packet
+    else if (isFromUs(p) && p->want_ack) {
+        // ReliableRouter queued it before we picked the next hop, remember whom we asked
+        PendingPacket *pending = findPendingPacket(getFrom(p), p->id);
+        if (pending)
+            pending->packet->next_hop = p->next_hop;
+    }
 
     return Router::send(p);
 }
@@ -32,11 +38,20 @@ bool NextHopRouter::shouldFilterReceived(const meshtastic_MeshPacket *p)
 {
     bool wasFallback = false;
     bool weWereNextHop = false;
+    noteRelayer(p);
     if (wasSeenRecently(p, true, &wasFallback, &weWereNextHop)) { // Note: this will also add a recent packet record
         printPacket("Ignore dupe incoming msg", p);
         rxDupe++;
         stopRetransmission(p->from, p->id);
 
+        // Another relayer of an ACK we learned from is an alternate next hop to its sender
+        for (const RecentAck &ack : recentAcks) {
+            if (ack.from != 0 && ack.from == p->from && ack.id == p->id) {
+                learnNextHop(p, ack.requestId);
+                break;
+            }
+        }
+
         // If it was a fallback to flooding, try to relay again
         if (wasFallback) {
             LOG_INFO("Fallback to flooding from relay_node=0x%x", p->relay_node);
@@ -50,7 +65,15 @@ bool NextHopRouter::shouldFilterReceived(const meshtastic_MeshPacket *p)
                 if (!findInTxQueue(p->from, p->id) && !perhapsRelay(p) && isToUs(p) && p->want_ack)
                     sendAckNak(meshtastic_Routing_Error_NONE, getFrom(p), p->id, p->channel, 0);
             } else if (!weWereNextHop) {
-                perhapsCancelDupe(p); // If it's a dupe, cancel relay if we were not explicitly asked to relay
+                uint8_t ourRelayID = nodeDB->getLastByteOfNodeNum(getNodeNum());
+                if (p->next_hop == ourRelayID && !wasRelayer(ourRelayID, p->id, getFrom(p))) {
+                    // The next hop of the relayer didn't relay it, so it failed over to us
+                    LOG_INFO("Fail over to us from relay_node=0x%x", p->relay_node);
+                    if (!findInTxQueue(p->from, p->id))
+                        perhapsRelay(p);
+                } else {
+                    perhapsCancelDupe(p); // If it's a dupe, cancel relay if we were not explicitly asked to relay
+                }
             }
         }
         return true;
@@ -61,26 +84,15 @@ bool NextHopRouter::shouldFilterReceived(const meshtastic_MeshPacket *p)
 
 void NextHopRouter::sniffReceived(const meshtastic_MeshPacket *p, const meshtastic_Routing *c)
 {
-    NodeNum ourNodeNum = getNodeNum();
-    uint8_t ourRelayID = nodeDB->getLastByteOfNodeNum(ourNodeNum);
     bool isAckorReply = (p->which_payload_variant == meshtastic_MeshPacket_decoded_tag) &&
                         (p->decoded.request_id != 0 || p->decoded.reply_id != 0);
     if (isAckorReply) {
         // Update next-hop for the original transmitter of this successful transmission to the relay node, but ONLY if "from" is
         // not 0 (means implicit ACK) and original packet was also relayed by this node, or we sent it directly to the destination
         if (p->from != 0) {
-            meshtastic_NodeInfoLite *origTx = nodeDB->getMeshNode(p->from);
-            if (origTx) {
-                // Either relayer of ACK was also a relayer of the packet, or we were the relayer and the ACK came directly from
-                // the destination
-                if (wasRelayer(p->relay_node, p->decoded.request_id, p->to) ||
-                    (wasRelayer(ourRelayID, p->decoded.request_id, p->to) && p->hop_start != 0 && p->hop_start == p->hop_limit)) {
-                    if (origTx->next_hop != p->relay_node) { // Not already set
-                        LOG_INFO("Update next hop of 0x%x to 0x%x based on ACK/reply", p->from, p->relay_node);
-                        origTx->next_hop = p->relay_node;
-                    }
-                }
-            }
+            learnNextHop(p, p->decoded.request_id);
+            if (p->decoded.request_id != 0)
+                recentAcks[recentAckIndex++ % NUM_RECENT_ACKS] = {p->from, p->id, p->to, p->decoded.request_id};
         }
         if (!isToUs(p)) {
             Router::cancelSending(p->to, p->decoded.request_id); // cancel rebroadcast for this DM
@@ -89,6 +101,7 @@ void NextHopRouter::sniffReceived(const meshtastic_MeshPacket *p, const meshtast
         }
     }
 
+    sniffNeighborInfo(p);
     perhapsRelay(p);
 
     // handle the packet as normal
@@ -100,7 +113,10 @@ bool NextHopRouter::perhapsRelay(const meshtastic_MeshPacket *p)
 {
     if (!isToUs(p) && !isFromUs(p) && p->hop_limit > 0) {
         if (p->next_hop == NO_NEXT_HOP_PREFERENCE || p->next_hop == nodeDB->getLastByteOfNodeNum(getNodeNum())) {
-            if (isRebroadcaster()) {
+            if (isRebroadcaster() && judgeRebroadcast(p) == RebroadcastSuppressor::REDUNDANT) {
+                LOG_DEBUG("Not rebroadcasting: neighbors already covered by the relayers");
+                txRelayCanceled++;
+            } else if (isRebroadcaster()) {
                 meshtastic_MeshPacket *tosend = packetPool.allocCopy(*p); // keep a copy because we will be sending it
                 LOG_INFO("Relaying received message coming from %x", p->relay_node);
 
@@ -118,15 +134,32 @@ bool NextHopRouter::perhapsRelay(const meshtastic_MeshPacket *p)
 }
 
 /**
- * Get the next hop for a destination, given the relay node
+ * Get the next hop for a packet, given its relay node
+ * @param failedHop a next hop that didn't relay it, not to ask again. Then only next hops that relayed our packets before
+ * will do, and none we learned from NodeDB.
  * @return the node number of the next hop, 0 if no preference (fallback to FloodingRouter)
  */
-uint8_t NextHopRouter::getNextHop(NodeNum to, uint8_t relay_node)
+uint8_t NextHopRouter::getNextHop(const meshtastic_MeshPacket *p, uint8_t failedHop)
 {
+    NodeNum to = p->to;
+    uint8_t relay_node = p->relay_node;
     // When we're a repeater router->sniffReceived will call NextHopRouter directly without checking for broadcast
     if (isBroadcast(to))
         return NO_NEXT_HOP_PREFERENCE;
 
+    uint32_t now = millis();
+    if (nextHops.knows(to, now)) {
+        // Not back to anyone who relayed it already, which includes whoever we got it from
+        uint8_t avoid[NUM_RELAYERS + 2];
+        uint8_t numAvoid = getRelayers(p->id, getFrom(p), avoid);
+        avoid[numAvoid++] = relay_node;
+        avoid[numAvoid++] = failedHop;
+        return nextHops.getNextHop(to, p->hop_limit, avoid, numAvoid, now, failedHop == NO_NEXT_HOP_PREFERENCE);
+    }
+    if (failedHop != NO_NEXT_HOP_PREFERENCE)
+        return NO_NEXT_HOP_PREFERENCE;
+
+    // Nothing learned since boot, go by what NodeDB kept
     meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(to);
     if (node && node->next_hop) {
         // We are careful not to return the relay node as the next hop
@@ -139,6 +172,33 @@ uint8_t NextHopRouter::getNextHop(NodeNum to, uint8_t relay_node)
     return NO_NEXT_HOP_PREFERENCE;
 }
 
+void NextHopRouter::learnNextHop(const meshtastic_MeshPacket *p, PacketId requestId)
+{
+    uint8_t ourRelayID = nodeDB->getLastByteOfNodeNum(getNodeNum());
+    if (p->relay_node == ourRelayID)
+        return;
+
+    // Either relayer of ACK was also a relayer of the packet, or we were the relayer and the ACK came directly from the
+    // destination. Otherwise it may not hear us, but it can still stand in for a next hop that went away.
+    uint8_t hopsBeyond = p->hop_start > p->hop_limit ? p->hop_start - p->hop_limit : 0;
+    if (wasRelayer(p->relay_node, requestId, p->to) ||
+        (wasRelayer(ourRelayID, requestId, p->to) && p->hop_start != 0 && p->hop_start == p->hop_limit))
+        nextHops.noteDelivered(p->from, p->relay_node, hopsBeyond, p->rx_snr, millis());
+    else
+        nextHops.noteAlternate(p->from, p->relay_node, hopsBeyond, p->rx_snr, millis());
+    updateNodeNextHop(p->from);
+}
+
+void NextHopRouter::updateNodeNextHop(NodeNum dest)
+{
+    meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(dest);
+    uint8_t best = nextHops.getNextHop(dest, HOP_MAX, nullptr, 0, millis());
+    if (node && node->next_hop != best) {
+        LOG_INFO("Update next hop of 0x%x to 0x%x based on ACK/reply", dest, best);
+        node->next_hop = best;
+    }
+}
+
 PendingPacket *NextHopRouter::findPendingPacket(GlobalPacketId key)
 {
     auto old = pending.find(key); // If we have an old record, someone messed up because id got reused
@@ -228,21 +288,36 @@ int32_t NextHopRouter::doRetransmissions()
             } else {
                 LOG_DEBUG("Sending retransmission fr=0x%x,to=0x%x,id=0x%x, tries left=%d", p.packet->from, p.packet->to,
                           p.packet->id, p.numRetransmissions);
+                iface->noteRetransmission();
 
                 if (!isBroadcast(p.packet->to)) {
+                    // The next hop we asked didn't relay it, or we would have stopped
+                    uint8_t failedHop = p.packet->next_hop;
+                    if (failedHop != NO_NEXT_HOP_PREFERENCE) {
+                        nextHops.noteFailed(p.packet->to, failedHop, now);
+                        updateNodeNextHop(p.packet->to);
+                    }
+
                     if (p.numRetransmissions == 1) {
                         // Last retransmission, reset next_hop (fallback to FloodingRouter)
                         p.packet->next_hop = NO_NEXT_HOP_PREFERENCE;
-                        // Also reset it in the nodeDB
+                        // Also reset it in the nodeDB, if it is one we didn't learn since boot
                         meshtastic_NodeInfoLite *sentTo = nodeDB->getMeshNode(p.packet->to);
-                        if (sentTo) {
+                        if (sentTo && !nextHops.knows(p.packet->to, now)) {
                             LOG_INFO("Resetting next hop for packet with dest 0x%x\n", p.packet->to);
                             sentTo->next_hop = NO_NEXT_HOP_PREFERENCE;
                         }
-                        FloodingRouter::send(packetPool.allocCopy(*p.packet));
-                    } else {
-                        NextHopRouter::send(packetPool.allocCopy(*p.packet));
+                    } else if (failedHop != NO_NEXT_HOP_PREFERENCE) {
+                        // Fail over to another next hop that relayed our packets before, or else ask the same one again
+                        uint8_t failover = getNextHop(p.packet, failedHop);
+                        if (failover != NO_NEXT_HOP_PREFERENCE) {
+                            LOG_INFO("Fail over to next hop 0x%x for packet with dest 0x%x", failover, p.packet->to);
+                            p.packet->next_hop = failover;
+                        }
                     }
+                    // Not our send(), which would pick the next hop again. The packet keeps the one set here, so if it fails
+                    // as well we know whom we asked.
+                    FloodingRouter::send(packetPool.allocCopy(*p.packet));
                 } else {
                     // Note: we call the superclass version because we don't want to have our version of send() add a new
                     // retransmission record
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "FloodingRouter.h"
+#include "NextHopTable.h"
 #include <unordered_map>
 
 /**
@@ -57,6 +58,11 @@ class GlobalPacketIdHashFunction
   NextHopRouter only 1 time). For the final retry, if no one actually relayed the packet, it will reset the next hop in order to
   fall back to the FloodingRouter again. Note that thus also intermediate hops will do a single retransmission if the intended
   next-hop didn’t relay, in order to fix changes in the middle of the route.
+  Every relayer an ACK comes back through, also on the duplicates of the ACK, is kept as a candidate next hop in a
+  NextHopTable scored by its deliveries. A retransmission goes to the best one that relayed our packets before and didn't just
+  fail, the final retry floods as before. NodeDB keeps the best next hop, which is used until we learn one after boot.
+  DMs still flood on: the final retry, of the sender and of each intermediate hop; a destination we have no next hop for;
+  and a relay by a node that heard a DM for another next hop and then a flooded copy of it (see shouldFilterReceived()).
 */
 class NextHopRouter : public FloodingRouter
 {
@@ -90,6 +96,8 @@ class NextHopRouter : public FloodingRouter
     constexpr static uint8_t NUM_INTERMEDIATE_RETX = 2;
     // The number of retransmissions the original sender will do
     constexpr static uint8_t NUM_RELIABLE_RETX = 3;
+    // The number of ACKs and replies we remember, so their duplicates can teach us alternate next hops
+    constexpr static uint8_t NUM_RECENT_ACKS = 4;
 
   protected:
     /**
@@ -139,11 +147,34 @@ class NextHopRouter : public FloodingRouter
     void setNextTx(PendingPacket *pending);
 
   private:
+    /** An ACK or reply we learned from, its duplicates are still encrypted when we see them */
+    struct RecentAck {
+        NodeNum from;
+        PacketId id;
+        NodeNum to;
+        PacketId requestId;
+    };
+
+    NextHopTable nextHops;
+    RecentAck recentAcks[NUM_RECENT_ACKS] = {};
+    uint8_t recentAckIndex = 0;
+
     /**
-     * Get the next hop for a destination, given the relay node
+     * Get the next hop for a packet, given its relay node
+     * @param failedHop a next hop that didn't relay it, not to ask again. Then only next hops that relayed our packets before
+     * will do, and none we learned from NodeDB.
      * @return the node number of the next hop, 0 if no preference (fallback to FloodingRouter)
      */
-    uint8_t getNextHop(NodeNum to, uint8_t relay_node);
+    uint8_t getNextHop(const meshtastic_MeshPacket *p, uint8_t failedHop = NO_NEXT_HOP_PREFERENCE);
+
+    /**
+     * An ACK or reply from p->from to a packet with id requestId came through p->relay_node. If it also relayed that packet,
+     * or the ACK came straight from its sender after we relayed it, it is a next hop to p->from, otherwise an alternate.
+     */
+    void learnNextHop(const meshtastic_MeshPacket *p, PacketId requestId);
+
+    /** Keep NodeDB's next hop for dest the best one we know */
+    void updateNodeNextHop(NodeNum dest);
 
     /** Check if we should be relaying this packet if so, do so.
      *  @return true if we did relay */
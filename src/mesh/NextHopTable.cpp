@@ -0,0 +1,215 @@
+#include "NextHopTable.h"
+
+#include <string.h>
+
+// Deliveries are averaged with a weight of 1/4 for the newest outcome. A next hop we only got one ACK through starts
+// from a bit below that, so it takes over from a next hop that worked well but failed twice in a row, not once.
+#define DELIVERY_WEIGHT_SHIFT 2
+#define NEW_CANDIDATE_DELIVERY 160
+
+static int8_t roundSnr(float snr)
+{
+    return snr < -128 ? -128 : snr > 127 ? 127 : (int8_t)(snr < 0 ? snr - 0.5f : snr + 0.5f);
+}
+
+void NextHopTable::expire(uint32_t now)
+{
+    for (size_t i = 0; i < numDestinations;) {
+        Destination &d = destinations[i];
+        for (uint8_t j = 0; j < d.numCandidates;) {
+            if (now - d.candidates[j].deliveredMsec >= NEXT_HOP_EXPIRE_MSEC)
+                d.candidates[j] = d.candidates[--d.numCandidates];
+            else
+                j++;
+        }
+        if (!d.numCandidates)
+            d = destinations[--numDestinations];
+        else
+            i++;
+    }
+}
+
+NextHopTable::Destination *NextHopTable::find(NodeNum dest)
+{
+    for (size_t i = 0; i < numDestinations; i++)
+        if (destinations[i].num == dest)
+            return &destinations[i];
+    return nullptr;
+}
+
+NextHopTable::Destination *NextHopTable::findOrAdd(NodeNum dest, uint32_t now)
+{
+    Destination *d = find(dest);
+    if (d)
+        return d;
+
+    if (numDestinations < NEXT_HOP_MAX_DESTINATIONS) {
+        d = &destinations[numDestinations++];
+    } else {
+        d = &destinations[0];
+        for (size_t i = 1; i < numDestinations; i++)
+            if (now - destinations[i].usedMsec > now - d->usedMsec)
+                d = &destinations[i];
+    }
+    memset(d, 0, sizeof(*d));
+    d->num = dest;
+    d->usedMsec = now;
+    return d;
+}
+
+NextHopTable::Candidate *NextHopTable::findCandidate(Destination *d, uint8_t hop)
+{
+    for (uint8_t i = 0; i < d->numCandidates; i++)
+        if (d->candidates[i].hop == hop)
+            return &d->candidates[i];
+    return nullptr;
+}
+
+uint8_t NextHopTable::fadedDelivery(const Candidate &c, uint32_t now) const
+{
+    uint32_t age = now - c.deliveredMsec;
+    if (age >= NEXT_HOP_EXPIRE_MSEC)
+        return 0;
+    return (uint64_t)c.delivery * (NEXT_HOP_EXPIRE_MSEC - age) / NEXT_HOP_EXPIRE_MSEC;
+}
+
+uint32_t NextHopTable::cost(const Candidate &c, uint32_t now) const
+{
+    uint8_t delivery = fadedDelivery(c, now);
+    if (!delivery)
+        return UINT32_MAX;
+    uint32_t etx = 255 * 100 / delivery;
+    if (c.snr < NEXT_HOP_GOOD_SNR)
+        etx += (NEXT_HOP_GOOD_SNR - c.snr) * NEXT_HOP_COST_PER_DB;
+    // We know nothing about the links further on, count one transmission each
+    return etx + c.hopsBeyond * 100;
+}
+
+NextHopTable::Candidate *NextHopTable::findOrAddCandidate(Destination *d, uint8_t hop, bool relayedOurs, float snr,
+                                                         uint32_t now)
+{
+    Candidate *c = findCandidate(d, hop);
+    if (c)
+        return c;
+
+    if (d->numCandidates < NEXT_HOP_CANDIDATES) {
+        c = &d->candidates[d->numCandidates++];
+    } else {
+        // Replace the worst one, alternates first, but never one that relayed our packets with an alternate
+        for (uint8_t i = 0; i < d->numCandidates; i++) {
+            Candidate &o = d->candidates[i];
+            if (o.relayedOurs && !relayedOurs)
+                continue;
+            if (!c || (c->relayedOurs && !o.relayedOurs) || (c->relayedOurs == o.relayedOurs && cost(o, now) > cost(*c, now)))
+                c = &o;
+        }
+        if (!c)
+            return nullptr;
+    }
+    memset(c, 0, sizeof(*c));
+    c->hop = hop;
+    c->delivery = NEW_CANDIDATE_DELIVERY;
+    c->snr = roundSnr(snr);
+    c->relayedOurs = relayedOurs;
+    return c;
+}
+
+bool NextHopTable::hasRoute(const Destination *d) const
+{
+    for (uint8_t i = 0; i < d->numCandidates; i++)
+        if (d->candidates[i].relayedOurs)
+            return true;
+    return false;
+}
+
+void NextHopTable::update(Candidate *c, uint8_t hopsBeyond, float snr, uint32_t now)
+{
+    c->snr += (roundSnr(snr) - c->snr) / (1 << DELIVERY_WEIGHT_SHIFT);
+    c->hopsBeyond = hopsBeyond;
+    c->deliveredMsec = now;
+}
+
+void NextHopTable::noteDelivered(NodeNum dest, uint8_t hop, uint8_t hopsBeyond, float snr, uint32_t now)
+{
+    if (!hop)
+        return;
+    expire(now);
+    Destination *d = findOrAdd(dest, now);
+    d->usedMsec = now;
+
+    Candidate *c = findOrAddCandidate(d, hop, true, snr, now);
+    c->relayedOurs = true;
+    c->delivery += (255 - c->delivery) >> DELIVERY_WEIGHT_SHIFT;
+    update(c, hopsBeyond, snr, now);
+}
+
+void NextHopTable::noteAlternate(NodeNum dest, uint8_t hop, uint8_t hopsBeyond, float snr, uint32_t now)
+{
+    if (!hop)
+        return;
+    expire(now);
+    // Only for destinations we have a route to, an alternate is no reason to forget another one
+    Destination *d = find(dest);
+    Candidate *c = d ? findOrAddCandidate(d, hop, false, snr, now) : nullptr;
+    // It may not hear us, so an ACK through it is no delivery of ours, but it is still around
+    if (c)
+        update(c, hopsBeyond, snr, now);
+}
+
+void NextHopTable::noteFailed(NodeNum dest, uint8_t hop, uint32_t now)
+{
+    expire(now);
+    Destination *d = find(dest);
+    Candidate *c = d ? findCandidate(d, hop) : nullptr;
+    if (c)
+        c->delivery -= (c->delivery + (1 << DELIVERY_WEIGHT_SHIFT) - 1) >> DELIVERY_WEIGHT_SHIFT;
+}
+
+uint8_t NextHopTable::getNextHop(NodeNum dest, uint8_t hopLimit, const uint8_t *avoid, size_t numAvoid, uint32_t now,
+                                 bool alternates)
+{
+    expire(now);
+    Destination *d = find(dest);
+    if (!d || !hasRoute(d))
+        return NO_NEXT_HOP_PREFERENCE;
+    d->usedMsec = now;
+
+    // Alternates only when none that relayed our packets will do
+    const Candidate *best = nullptr;
+    uint32_t bestCost = UINT32_MAX;
+    for (uint8_t i = 0; i < d->numCandidates; i++) {
+        const Candidate &c = d->candidates[i];
+        if ((!alternates && !c.relayedOurs) || c.hopsBeyond > hopLimit || (numAvoid && memchr(avoid, c.hop, numAvoid)) ||
+            fadedDelivery(c, now) * 100 < NEXT_HOP_MIN_DELIVERY * 255)
+            continue;
+        uint32_t candidateCost = cost(c, now);
+        if (!best || (c.relayedOurs && !best->relayedOurs) || (c.relayedOurs == best->relayedOurs && candidateCost < bestCost)) {
+            best = &c;
+            bestCost = candidateCost;
+        }
+    }
+    return best ? best->hop : NO_NEXT_HOP_PREFERENCE;
+}
+
+bool NextHopTable::knows(NodeNum dest, uint32_t now)
+{
+    expire(now);
+    Destination *d = find(dest);
+    return d && hasRoute(d);
+}
+
+uint8_t NextHopTable::getDeliveryPercent(NodeNum dest, uint8_t hop, uint32_t now)
+{
+    expire(now);
+    Destination *d = find(dest);
+    Candidate *c = d ? findCandidate(d, hop) : nullptr;
+    return c ? fadedDelivery(*c, now) * 100 / 255 : 0;
+}
+
+uint32_t NextHopTable::getCost(NodeNum dest, uint8_t hop, uint32_t now)
+{
+    expire(now);
+    Destination *d = find(dest);
+    Candidate *c = d ? findCandidate(d, hop) : nullptr;
+    return c ? cost(*c, now) : UINT32_MAX;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "MeshTypes.h"
+
+/// How many destinations we keep next hops for, the one we sent to least recently makes room for a new one
+#ifndef NEXT_HOP_MAX_DESTINATIONS
+#define NEXT_HOP_MAX_DESTINATIONS 32
+#endif
+
+/// Next hops kept per destination, the best one and alternates to fail over to
+#define NEXT_HOP_CANDIDATES 3
+
+/// A next hop no ACK came back through for this long is forgotten, its score fades out until then
+#define NEXT_HOP_EXPIRE_MSEC (12 * 60 * 60 * 1000UL)
+
+/// Share of deliveries a next hop must make, in percent, to be used at all
+#ifndef NEXT_HOP_MIN_DELIVERY
+#define NEXT_HOP_MIN_DELIVERY 40
+#endif
+
+/// Links with a lower SNR than this are penalized, as they are the first to drop packets when conditions change
+#define NEXT_HOP_GOOD_SNR -5
+/// Penalty per dB below NEXT_HOP_GOOD_SNR, in hundredths of a transmission
+#define NEXT_HOP_COST_PER_DB 5
+
+/**
+ * Next hops to each destination we sent to, scored by how well they deliver.
+ *
+ * NodeDB keeps one next hop per node, learned from the relayer of the last ACK that came back and reset whenever a
+ * delivery fails, after which direct messages to that node are flooded until another ACK teaches a new one. Here every
+ * relayer an ACK came back through is a candidate. Each keeps a moving average of its deliveries: an ACK through it
+ * counts as one, having to retransmit because it didn't relay our packet counts as a failure. Candidates are ranked by
+ * expected transmission count (ETX) of the path: the inverse of the delivery ratio for the link to the next hop, plus a
+ * penalty if that link is weak, plus one for every hop the ACK took to reach it. Without new ACKs the delivery ratio fades
+ * out over NEXT_HOP_EXPIRE_MSEC, so routes over nodes that went away age out.
+ *
+ * A relayer of the ACK that we didn't hear relay our own packet may not hear us, so it is only kept as an alternate: it
+ * isn't used while a next hop that did still works, and doesn't make a route to a destination on its own. When the best
+ * next hop fails, the next one is ready to take over, so the packet doesn't have to be flooded to everyone.
+ *
+ * Next hops are known by the last byte of their number only, as that is all relay_node carries.
+ */
+class NextHopTable
+{
+  public:
+    /**
+     * An ACK or reply from dest came back through hop, which also relayed our packet
+     * @param hopsBeyond how many hops the ACK took from dest to hop
+     * @param snr we heard it with
+     */
+    void noteDelivered(NodeNum dest, uint8_t hop, uint8_t hopsBeyond, float snr, uint32_t now);
+    /// An ACK or reply from dest came back through hop as well, but we didn't hear it relay our packet
+    void noteAlternate(NodeNum dest, uint8_t hop, uint8_t hopsBeyond, float snr, uint32_t now);
+    /// A packet to dest we sent through hop wasn't relayed in time
+    void noteFailed(NodeNum dest, uint8_t hop, uint32_t now);
+
+    /**
+     * The best next hop to dest that still delivers often enough, 0 if there is none
+     * @param hopLimit of the packet as we send it, next hops further from dest than it can go are no use
+     * @param avoid next hops not to use, such as the ones that already relayed the packet
+     * @param alternates whether to fall back to next hops we never heard relay our packets
+     */
+    uint8_t getNextHop(NodeNum dest, uint8_t hopLimit, const uint8_t *avoid, size_t numAvoid, uint32_t now,
+                       bool alternates = true);
+
+    /// Whether we have learned a next hop to dest, even if it doesn't deliver often enough anymore
+    bool knows(NodeNum dest, uint32_t now);
+
+    /// Delivery ratio of hop to dest in percent after fading with age, 0 if it isn't a candidate
+    uint8_t getDeliveryPercent(NodeNum dest, uint8_t hop, uint32_t now);
+    /// Expected transmissions to reach dest through hop in hundredths, UINT32_MAX if it isn't a candidate
+    uint32_t getCost(NodeNum dest, uint8_t hop, uint32_t now);
+
+  private:
+    struct Candidate {
+        uint8_t hop;
+        uint8_t delivery; // Moving average of deliveries, 255 is all of them
+        int8_t snr;       // Moving average of the SNR of ACKs through it, in dB
+        bool relayedOurs; // We heard it relay our packet, not only the ACK, so it hears us
+        uint8_t hopsBeyond;
+        uint32_t deliveredMsec;
+    };
+
+    struct Destination {
+        NodeNum num;
+        uint8_t numCandidates;
+        Candidate candidates[NEXT_HOP_CANDIDATES];
+        uint32_t usedMsec;
+    };
+
+    Destination destinations[NEXT_HOP_MAX_DESTINATIONS];
+    size_t numDestinations = 0;
+
+    /// Drop candidates without an ACK for too long, and destinations left without any
+    void expire(uint32_t now);
+    Destination *find(NodeNum dest);
+    /// Find the entry for dest, or make one, replacing the one we used least recently if full
+    Destination *findOrAdd(NodeNum dest, uint32_t now);
+    Candidate *findCandidate(Destination *d, uint8_t hop);
+    /// The candidate for hop, or a new one in place of the worst if there is none, nullptr if an alternate doesn't fit
+    Candidate *findOrAddCandidate(Destination *d, uint8_t hop, bool relayedOurs, float snr, uint32_t now);
+    bool hasRoute(const Destination *d) const;
+    /// Another ACK came through c
+    void update(Candidate *c, uint8_t hopsBeyond, float snr, uint32_t now);
+    uint8_t fadedDelivery(const Candidate &c, uint32_t now) const;
+    uint32_t cost(const Candidate &c, uint32_t now) const;
+};
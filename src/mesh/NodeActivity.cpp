@@ -0,0 +1,142 @@
+#include "NodeActivity.h"
+
+#include <algorithm>
+#include <string.h>
+
+void NodeActivity::clear()
+{
+    memset(local, 0, sizeof(local));
+    memset(mqtt, 0, sizeof(mqtt));
+    totalLocal = totalMqtt = 0;
+    newest = 0;
+    ahead.clear();
+    aheadLocal = aheadMqtt = 0;
+}
+
+void NodeActivity::setClock(uint32_t minute)
+{
+    if (minute < newest) {
+        // Our clock went backwards, what we heard after it is in the future now
+        uint32_t oldest = newest >= NODE_ACTIVITY_BUCKETS ? newest - NODE_ACTIVITY_BUCKETS + 1 : 0;
+        for (uint32_t m = std::max(minute + 1, oldest); m <= newest; m++) {
+            uint32_t slot = m % NODE_ACTIVITY_BUCKETS;
+            if (local[slot] || mqtt[slot])
+                addAhead(m, local[slot], mqtt[slot]);
+            totalLocal -= local[slot];
+            totalMqtt -= mqtt[slot];
+            local[slot] = mqtt[slot] = 0;
+        }
+        newest = minute;
+        return;
+    }
+
+    if (minute - newest >= NODE_ACTIVITY_BUCKETS) {
+        memset(local, 0, sizeof(local));
+        memset(mqtt, 0, sizeof(mqtt));
+        totalLocal = totalMqtt = 0;
+        newest = minute;
+    }
+    while (newest < minute) {
+        uint32_t slot = ++newest % NODE_ACTIVITY_BUCKETS;
+        totalLocal -= local[slot];
+        totalMqtt -= mqtt[slot];
+        local[slot] = mqtt[slot] = 0;
+    }
+
+    // What was ahead of the clock and no longer is goes into its bucket
+    size_t caughtUp = 0;
+    while (caughtUp < ahead.size() && ahead[caughtUp].minute <= newest) {
+        const Ahead &a = ahead[caughtUp++];
+        aheadLocal -= a.local;
+        aheadMqtt -= a.mqtt;
+        addToBucket(a.minute, a.local, a.mqtt);
+    }
+    ahead.erase(ahead.begin(), ahead.begin() + caughtUp);
+}
+
+void NodeActivity::addToBucket(uint32_t minute, uint16_t localCount, uint16_t mqttCount)
+{
+    if (!inWindow(minute))
+        return;
+    uint32_t slot = minute % NODE_ACTIVITY_BUCKETS;
+    local[slot] += localCount;
+    mqtt[slot] += mqttCount;
+    totalLocal += localCount;
+    totalMqtt += mqttCount;
+}
+
+std::vector<NodeActivity::Ahead>::iterator NodeActivity::findAhead(uint32_t minute)
+{
+    return std::lower_bound(ahead.begin(), ahead.end(), minute, [](const Ahead &a, uint32_t m) { return a.minute < m; });
+}
+
+void NodeActivity::addAhead(uint32_t minute, uint16_t localCount, uint16_t mqttCount)
+{
+    auto it = findAhead(minute);
+    if (it == ahead.end() || it->minute != minute)
+        it = ahead.insert(it, {minute, 0, 0});
+    it->local += localCount;
+    it->mqtt += mqttCount;
+    aheadLocal += localCount;
+    aheadMqtt += mqttCount;
+}
+
+void NodeActivity::add(uint32_t lastHeard, bool viaMqtt, uint32_t now)
+{
+    setClock(now / NODE_ACTIVITY_BUCKET_SECS);
+    uint32_t minute = lastHeard / NODE_ACTIVITY_BUCKET_SECS;
+    if (minute > newest)
+        addAhead(minute, viaMqtt ? 0 : 1, viaMqtt ? 1 : 0);
+    else
+        addToBucket(minute, viaMqtt ? 0 : 1, viaMqtt ? 1 : 0);
+}
+
+void NodeActivity::remove(uint32_t lastHeard, bool viaMqtt)
+{
+    uint32_t minute = lastHeard / NODE_ACTIVITY_BUCKET_SECS;
+    if (minute > newest) {
+        auto it = findAhead(minute);
+        if (it == ahead.end() || it->minute != minute)
+            return;
+        if (viaMqtt && it->mqtt) {
+            it->mqtt--;
+            aheadMqtt--;
+        } else if (!viaMqtt && it->local) {
+            it->local--;
+            aheadLocal--;
+        }
+        if (!it->local && !it->mqtt)
+            ahead.erase(it);
+        return;
+    }
+
+    if (!inWindow(minute))
+        return;
+    uint32_t slot = minute % NODE_ACTIVITY_BUCKETS;
+    if (viaMqtt && mqtt[slot]) {
+        mqtt[slot]--;
+        totalMqtt--;
+    } else if (!viaMqtt && local[slot]) {
+        local[slot]--;
+        totalLocal--;
+    }
+}
+
+size_t NodeActivity::countHeardWithin(uint32_t now, uint32_t secs, bool localOnly)
+{
+    setClock(now / NODE_ACTIVITY_BUCKET_SECS);
+    size_t future = aheadLocal + (localOnly ? 0 : aheadMqtt);
+    if (secs >= NODE_ACTIVITY_WINDOW_SECS)
+        return future + totalLocal + (localOnly ? 0 : totalMqtt);
+
+    // Everything from the minute secs ago up to the newest bucket, which is now's
+    uint32_t first = (now > secs ? now - secs : 0) / NODE_ACTIVITY_BUCKET_SECS;
+    if (first + NODE_ACTIVITY_BUCKETS <= newest)
+        first = newest - NODE_ACTIVITY_BUCKETS + 1;
+    size_t count = future;
+    for (uint32_t minute = first; minute <= newest; minute++) {
+        uint32_t slot = minute % NODE_ACTIVITY_BUCKETS;
+        count += local[slot] + (localOnly ? 0 : mqtt[slot]);
+    }
+    return count;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#define NODE_ACTIVITY_WINDOW_SECS (60 * 60 * 2) // How long NodeDB considers a node online
+#define NODE_ACTIVITY_BUCKET_SECS 60
+// One more than the window, so that its oldest minute is still there however far into the newest one we are
+#define NODE_ACTIVITY_BUCKETS (NODE_ACTIVITY_WINDOW_SECS / NODE_ACTIVITY_BUCKET_SECS + 1)
+
+/**
+ * How many nodes were last heard in each minute of the last two hours, kept separately for nodes heard directly and
+ * over MQTT.
+ *
+ * NodeDB moves a node from the bucket of its old last_heard to that of its new one whenever it hears it, and buckets
+ * fall off the end as time moves on. Counting the nodes heard within the window is then constant time, and within a
+ * shorter time a sum over at most one counter per minute, instead of a walk over the whole DB.
+ *
+ * Only our own clock moves the buckets on. A last_heard ahead of it (loaded from before an RTC reset, or our clock went
+ * backwards) is kept aside and counts as just now, like sinceLastSeen() does, until the clock catches up with it.
+ */
+class NodeActivity
+{
+  public:
+    void clear();
+
+    /// Count a node last heard at lastHeard, as seen at time now
+    void add(uint32_t lastHeard, bool viaMqtt, uint32_t now);
+    void remove(uint32_t lastHeard, bool viaMqtt);
+
+    /// Nodes heard within the last secs, to the minute, as seen at time now. A last_heard in the future counts as just
+    /// now.
+    size_t countHeardWithin(uint32_t now, uint32_t secs, bool localOnly);
+
+  private:
+    /// Nodes last heard in a minute after the newest bucket
+    struct Ahead {
+        uint32_t minute;
+        uint16_t local, mqtt;
+    };
+
+    uint16_t local[NODE_ACTIVITY_BUCKETS] = {};
+    uint16_t mqtt[NODE_ACTIVITY_BUCKETS] = {};
+    uint32_t totalLocal = 0, totalMqtt = 0;
+    uint32_t newest = 0;      // Minute number (since 1970) of the most recent bucket, which is our clock's
+    std::vector<Ahead> ahead; // Sorted by minute, usually empty
+    uint32_t aheadLocal = 0, aheadMqtt = 0;
+
+    /// Move the newest bucket to our clock's minute, forwards or backwards
+    void setClock(uint32_t minute);
+    void addToBucket(uint32_t minute, uint16_t localCount, uint16_t mqttCount);
+    void addAhead(uint32_t minute, uint16_t localCount, uint16_t mqttCount);
+    std::vector<Ahead>::iterator findAhead(uint32_t minute);
+    bool inWindow(uint32_t minute) const { return minute <= newest && minute + NODE_ACTIVITY_BUCKETS > newest; }
+};
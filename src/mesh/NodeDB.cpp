@@ -16,6 +16,7 @@
 #include "SPILock.h"
 #include "SafeFile.h"
 #include "TypeConversions.h"
+#include "concurrency/OSThread.h"
 #include "error.h"
 #include "main.h"
 #include "mesh-pb-constants.h"
@@ -375,6 +376,7 @@ NodeDB::NodeDB()
         config.has_position = true;
         info->has_position = true;
         info->position = TypeConversions::ConvertToPositionLite(fixedGPS);
+        indexPosition(info);
         nodeDB->setLocalPosition(fixedGPS);
         config.position.fixed_position = true;
 #endif
@@ -472,6 +474,9 @@ void NodeDB::installDefaultNodeDatabase()
     nodeDatabase.nodes = std::vector<meshtastic_NodeInfoLite>(MAX_NUM_NODES);
     numMeshNodes = 0;
     meshNodes = &nodeDatabase.nodes;
+    nodesMoved++;
+    activity.clear();
+    positions.clear();
 }
 
 void NodeDB::installDefaultConfig(bool preserveKey = false)
@@ -905,6 +910,7 @@ void NodeDB::resetNodes()
         clearLocalPosition();
     numMeshNodes = 1;
     std::fill(nodeDatabase.nodes.begin() + 1, nodeDatabase.nodes.end(), meshtastic_NodeInfoLite());
+    rebuildIndexes();
     devicestate.has_rx_text_message = false;
     devicestate.has_rx_waypoint = false;
     saveNodeDatabaseToDisk();
@@ -925,6 +931,7 @@ void NodeDB::removeNodeByNum(NodeNum nodeNum)
     numMeshNodes -= removed;
     std::fill(nodeDatabase.nodes.begin() + numMeshNodes, nodeDatabase.nodes.begin() + numMeshNodes + 1,
               meshtastic_NodeInfoLite());
+    rebuildIndexes();
     LOG_DEBUG("NodeDB::removeNodeByNum purged %d entries. Save changes", removed);
     saveNodeDatabaseToDisk();
 }
@@ -936,6 +943,7 @@ void NodeDB::clearLocalPosition()
     node->position.longitude_i = 0;
     node->position.altitude = 0;
     node->position.time = 0;
+    indexPosition(node);
     setLocalPosition(meshtastic_Position_init_default);
 }
 
@@ -958,6 +966,7 @@ void NodeDB::cleanupMeshDB()
     std::fill(nodeDatabase.nodes.begin() + numMeshNodes, nodeDatabase.nodes.begin() + numMeshNodes + removed,
               meshtastic_NodeInfoLite());
     LOG_DEBUG("cleanupMeshDB purged %d entries", removed);
+    rebuildIndexes();
 }
 
 void NodeDB::installDefaultDeviceState()
@@ -1106,6 +1115,7 @@ void NodeDB::loadFromDisk()
         numMeshNodes = MAX_NUM_NODES;
     }
     meshNodes->resize(MAX_NUM_NODES);
+    rebuildIndexes();
 
     // static DeviceState scratch; We no longer read into a tempbuf because this structure is 15KB of valuable RAM
     state = loadProto(deviceStateFileName, meshtastic_DeviceState_size, sizeof(meshtastic_DeviceState),
@@ -1300,6 +1310,7 @@ bool NodeDB::saveDeviceStateToDisk()
 
 bool NodeDB::saveNodeDatabaseToDisk()
 {
+    cancelNodeDatabaseSave();
 #ifdef FSCom
     spiLock->lock();
     FSCom.mkdir("/prefs");
@@ -1310,6 +1321,111 @@ bool NodeDB::saveNodeDatabaseToDisk()
     return saveProto(nodeDatabaseFileName, nodeDatabaseSize, &meshtastic_NodeDatabase_msg, &nodeDatabase, false);
 }
 
+#ifdef FSCom
+/// Runs NodeDB::continueNodeDatabaseSave() once per main loop iteration while a background save is in progress
+class NodeDatabaseSaveThread : public concurrency::OSThread
+{
+  public:
+    NodeDatabaseSaveThread() : OSThread("NodeDBSave") { disable(); }
+
+    void start()
+    {
+        setIntervalFromNow(0);
+        enabled = true;
+    }
+
+  protected:
+    int32_t runOnce() override { return nodeDB->continueNodeDatabaseSave() ? 0 : disable(); }
+};
+
+static NodeDatabaseSaveThread *nodeDatabaseSaveThread;
+#endif
+
+void NodeDB::saveNodeDatabaseInBackground()
+{
+#ifdef FSCom
+    // Already on it, nodes not written yet go out as they are now
+    if (nodeDbSaveFile)
+        return;
+
+    spiLock->lock();
+    FSCom.mkdir("/prefs");
+    spiLock->unlock();
+
+    LOG_INFO("Save %s in the background", nodeDatabaseFileName);
+    nodeDbSaveFile = new SafeFile(nodeDatabaseFileName, false);
+    nodeDbSaveNext = 0;
+    nodeDbSaveNodesMoved = nodesMoved;
+
+    if (!nodeDatabaseSaveThread)
+        nodeDatabaseSaveThread = new NodeDatabaseSaveThread();
+    nodeDatabaseSaveThread->start();
+#else
+    saveNodeDatabaseToDisk();
+#endif
+}
+
+bool NodeDB::continueNodeDatabaseSave()
+{
+#ifdef FSCom
+    if (!nodeDbSaveFile)
+        return false;
+
+    // Nodes we already wrote may have moved into the part we haven't, start over
+    if (nodeDbSaveNodesMoved != nodesMoved) {
+        LOG_DEBUG("Nodes moved during background save, restart it");
+        nodeDbSaveFile->abandon();
+        delete nodeDbSaveFile;
+        nodeDbSaveFile = new SafeFile(nodeDatabaseFileName, false);
+        nodeDbSaveNext = 0;
+        nodeDbSaveNodesMoved = nodesMoved;
+    }
+
+    // Same encoding as pb_encode() of nodeDatabase with meshtastic_NodeDatabase_callback, a few nodes at a time
+    pb_ostream_t stream = {&writecb, static_cast<Print *>(nodeDbSaveFile), SIZE_MAX};
+    bool okay = true;
+    if (nodeDbSaveNext == 0 && nodeDatabase.version)
+        okay = pb_encode_tag(&stream, PB_WT_VARINT, meshtastic_NodeDatabase_version_tag) &&
+               pb_encode_varint(&stream, nodeDatabase.version);
+
+    size_t start = nodeDbSaveNext;
+    size_t end = std::min(start + NODEDB_SAVE_NODES_PER_PASS, meshNodes->size());
+    for (; okay && nodeDbSaveNext < end; nodeDbSaveNext++) {
+        okay = pb_encode_tag(&stream, PB_WT_STRING, meshtastic_NodeDatabase_nodes_tag) &&
+               pb_encode_submessage(&stream, meshtastic_NodeInfoLite_fields, &meshNodes->at(nodeDbSaveNext));
+    }
+    // Checking and installing the file gets a main loop iteration of its own
+    if (okay && nodeDbSaveNext != start)
+        return true;
+
+    bool installed = okay && nodeDbSaveFile->close();
+    if (!okay)
+        nodeDbSaveFile->abandon();
+    delete nodeDbSaveFile;
+    nodeDbSaveFile = nullptr;
+    lastNodeDbSave = millis();
+
+    if (!installed) {
+        LOG_ERROR("Background save of %s failed, save it now", nodeDatabaseFileName);
+        saveToDisk(SEGMENT_NODEDATABASE);
+    }
+#endif
+    return false;
+}
+
+void NodeDB::cancelNodeDatabaseSave()
+{
+#ifdef FSCom
+    if (!nodeDbSaveFile)
+        return;
+    nodeDbSaveFile->abandon();
+    delete nodeDbSaveFile;
+    nodeDbSaveFile = nullptr;
+    if (nodeDatabaseSaveThread)
+        nodeDatabaseSaveThread->disable();
+#endif
+}
+
 bool NodeDB::saveToDiskNoRetry(int saveWhat)
 {
     bool success = true;
@@ -1417,21 +1533,47 @@ uint32_t sinceReceived(const meshtastic_MeshPacket *p)
     return delta;
 }
 
-#define NUM_ONLINE_SECS (60 * 60 * 2) // 2 hrs to consider someone offline
+#define NUM_ONLINE_SECS NODE_ACTIVITY_WINDOW_SECS // 2 hrs to consider someone offline
 
 size_t NodeDB::getNumOnlineMeshNodes(bool localOnly)
 {
-    size_t numseen = 0;
+    return activity.countHeardWithin(getTime(), NUM_ONLINE_SECS, localOnly);
+}
+
+size_t NodeDB::getNumHeardWithin(uint32_t secs, bool localOnly)
+{
+    return activity.countHeardWithin(getTime(), secs, localOnly);
+}
+
+void NodeDB::setLastHeard(meshtastic_NodeInfoLite *info, uint32_t lastHeard, bool viaMqtt)
+{
+    if (info->last_heard == lastHeard && info->via_mqtt == viaMqtt)
+        return;
+    activity.remove(info->last_heard, info->via_mqtt);
+    info->last_heard = lastHeard;
+    info->via_mqtt = viaMqtt;
+    activity.add(lastHeard, viaMqtt, getTime());
+}
 
-    // FIXME this implementation is kinda expensive
+void NodeDB::rebuildIndexes()
+{
+    nodesMoved++;
+    activity.clear();
+    positions.clear();
+    uint32_t now = getTime();
     for (int i = 0; i < numMeshNodes; i++) {
-        if (localOnly && meshNodes->at(i).via_mqtt)
-            continue;
-        if (sinceLastSeen(&meshNodes->at(i)) < NUM_ONLINE_SECS)
-            numseen++;
+        activity.add(meshNodes->at(i).last_heard, meshNodes->at(i).via_mqtt, now);
+        indexPosition(&meshNodes->at(i));
     }
+}
 
-    return numseen;
+void NodeDB::indexPosition(const meshtastic_NodeInfoLite *info)
+{
+    uint16_t dbIndex = info - &meshNodes->at(0);
+    if (hasValidPosition(info))
+        positions.set(dbIndex, info->position.latitude_i, info->position.longitude_i);
+    else
+        positions.remove(dbIndex);
 }
 
 #include "MeshModule.h"
@@ -1477,6 +1619,7 @@ void NodeDB::updatePosition(uint32_t nodeId, const meshtastic_Position &p, RxSou
             info->position.time = tmp_time;
     }
     info->has_position = true;
+    indexPosition(info);
     updateGUIforNode = info;
     notifyObservers(true); // Force an update whether or not our node counts have changed
 }
@@ -1514,7 +1657,7 @@ void NodeDB::addFromContact(meshtastic_SharedContact contact)
         return;
     }
     info->num = contact.node_num;
-    info->last_heard = getValidTime(RTCQualityNTP);
+    setLastHeard(info, getValidTime(RTCQualityNTP), info->via_mqtt);
     info->has_user = true;
     info->user = TypeConversions::ConvertToUserLite(contact.user);
     info->is_favorite = true;
@@ -1572,7 +1715,7 @@ bool NodeDB::updateUser(uint32_t nodeId, meshtastic_User &p, uint8_t channelInde
         // store our DB unless we just did so less than a minute ago
 
         if (!Throttle::isWithinTimespanMs(lastNodeDbSave, ONE_MINUTE_MS)) {
-            saveToDisk(SEGMENT_NODEDATABASE);
+            saveNodeDatabaseInBackground();
             lastNodeDbSave = millis();
         } else {
             LOG_DEBUG("Defer NodeDB saveToDisk for now");
@@ -1598,14 +1741,12 @@ void NodeDB::updateFrom(const meshtastic_MeshPacket &mp)
             return;
         }
 
-        if (mp.rx_time) // if the packet has a valid timestamp use it to update our last_heard
-            info->last_heard = mp.rx_time;
+        // if the packet has a valid timestamp use it to update our last_heard, and store if we received it via MQTT
+        setLastHeard(info, mp.rx_time ? mp.rx_time : info->last_heard, mp.via_mqtt);
 
         if (mp.rx_snr)
             info->snr = mp.rx_snr; // keep the most recent SNR we received for this node.
 
-        info->via_mqtt = mp.via_mqtt; // Store if we received this packet via MQTT
-
         // If hopStart was set and there wasn't someone messing with the limit in the middle, add hopsAway
         if (mp.hop_start != 0 && mp.hop_limit <= mp.hop_start) {
             info->has_hops_away = true;
@@ -1675,11 +1816,14 @@ meshtastic_NodeInfoLite *NodeDB::getOrCreateMeshNode(NodeNum n)
             }
 
             if (oldestIndex != -1) {
+                activity.remove(meshNodes->at(oldestIndex).last_heard, meshNodes->at(oldestIndex).via_mqtt);
+                positions.removeAndShift(oldestIndex);
                 // Shove the remaining nodes down the chain
                 for (int i = oldestIndex; i < numMeshNodes - 1; i++) {
                     meshNodes->at(i) = meshNodes->at(i + 1);
                 }
                 (numMeshNodes)--;
+                nodesMoved++;
             }
         }
         // add the node at the end
@@ -1688,6 +1832,7 @@ meshtastic_NodeInfoLite *NodeDB::getOrCreateMeshNode(NodeNum n)
         // everything is missing except the nodenum
         memset(lite, 0, sizeof(*lite));
         lite->num = n;
+        activity.add(lite->last_heard, lite->via_mqtt, getTime());
         LOG_INFO("Adding node to database with %i nodes and %u bytes free!", numMeshNodes, memGet.getFreeHeap());
     }
 
@@ -8,6 +8,8 @@
 #include <vector>
 
 #include "MeshTypes.h"
+#include "NodeActivity.h"
+#include "NodePositionIndex.h"
 #include "NodeStatus.h"
 #include "configuration.h"
 #include "mesh-pb-constants.h"
@@ -31,6 +33,13 @@ DeviceState versions used to be defined in the .proto file but really only this
 #define DEVICESTATE_CUR_VER 24
 #define DEVICESTATE_MIN_VER 24
 
+/// How many nodes a background save of the node database writes per main loop iteration
+#ifndef NODEDB_SAVE_NODES_PER_PASS
+#define NODEDB_SAVE_NODES_PER_PASS 8
+#endif
+
+class SafeFile;
+
 extern meshtastic_DeviceState devicestate;
 extern meshtastic_NodeDatabase nodeDatabase;
 extern meshtastic_ChannelFile channelFile;
@@ -116,6 +125,13 @@ class NodeDB
      */
     void updatePosition(uint32_t nodeId, const meshtastic_Position &p, RxSource src = RX_SRC_RADIO);
 
+    /// Bring the position index in step with info's position. Call this after changing a node's position other than
+    /// through updatePosition().
+    void indexPosition(const meshtastic_NodeInfoLite *info);
+
+    /// The nodes with a valid position, for map views and nearest-node lookups
+    const NodePositionIndex &getPositionIndex() const { return positions; }
+
     /** Update telemetry info for this node based on received metrics
      */
     void updateTelemetry(uint32_t nodeId, const meshtastic_Telemetry &t, RxSource src = RX_SRC_RADIO);
@@ -152,6 +168,15 @@ class NodeDB
      */
     size_t getNumOnlineMeshNodes(bool localOnly = false);
 
+    /* Return the number of nodes we've heard from in the last secs (to the minute, at most 2 hrs)
+     * @param localOnly if true, ignore nodes heard via MQTT
+     */
+    size_t getNumHeardWithin(uint32_t secs, bool localOnly = false);
+
+    /// Record that we heard from this node at lastHeard, keeps the online counts in step. Use this rather than writing
+    /// last_heard or via_mqtt directly.
+    void setLastHeard(meshtastic_NodeInfoLite *info, uint32_t lastHeard, bool viaMqtt);
+
     void initConfigIntervals(), initModuleConfigIntervals(), resetNodes(), removeNodeByNum(NodeNum nodeNum);
 
     bool factoryReset(bool eraseBleBonds = false);
@@ -205,13 +230,25 @@ class NodeDB
 
     bool hasValidPosition(const meshtastic_NodeInfoLite *n);
 
+    /// Save the node database a few nodes per main loop iteration, so a big database doesn't hold up the radio
+    void saveNodeDatabaseInBackground();
+
+    /// Write the next few nodes of a background save, @return true while there is more to write
+    bool continueNodeDatabaseSave();
+
     bool backupPreferences(meshtastic_AdminMessage_BackupLocation location);
     bool restorePreferences(meshtastic_AdminMessage_BackupLocation location,
                             int restoreWhat = SEGMENT_CONFIG | SEGMENT_MODULECONFIG | SEGMENT_DEVICESTATE | SEGMENT_CHANNELS);
 
   private:
-    uint32_t lastNodeDbSave = 0;    // when we last saved our db to flash
-    uint32_t lastBackupAttempt = 0; // when we last tried a backup automatically or manually
+    NodeActivity activity;              // last_heard of every node in the DB, bucketed by minute
+    NodePositionIndex positions;        // nodes with a valid position, by grid cell
+    uint32_t lastNodeDbSave = 0;        // when we last saved our db to flash
+    uint32_t lastBackupAttempt = 0;     // when we last tried a backup automatically or manually
+    uint32_t nodesMoved = 0;            // bumped whenever nodes change places in meshNodes
+    SafeFile *nodeDbSaveFile = nullptr; // background save in progress, if any
+    size_t nodeDbSaveNext = 0;          // next node the background save writes
+    uint32_t nodeDbSaveNodesMoved = 0;  // nodesMoved when the background save started writing nodes
     /// Find a node in our DB, create an empty NodeInfoLite if missing
     meshtastic_NodeInfoLite *getOrCreateMeshNode(NodeNum n);
 
@@ -226,6 +263,9 @@ class NodeDB
     /// read our db from flash
     void loadFromDisk();
 
+    /// recount activity and reindex positions from scratch, after nodes were loaded or removed in bulk
+    void rebuildIndexes();
+
     /// purge db entries without user info
     void cleanupMeshDB();
 
@@ -240,6 +280,9 @@ class NodeDB
     bool saveChannelsToDisk();
     bool saveDeviceStateToDisk();
     bool saveNodeDatabaseToDisk();
+
+    /// Drop a background save of the node database, we are about to write the file again anyway
+    void cancelNodeDatabaseSave();
 };
 
 extern NodeDB *nodeDB;
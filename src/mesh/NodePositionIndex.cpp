@@ -0,0 +1,237 @@
+#include "NodePositionIndex.h"
+
+#include <algorithm>
+#include <math.h>
+
+// Cell numbers covering all valid latitudes and longitudes, offset to be positive in the key
+#define LAT_CELL_MIN (-900000000 >> NODE_POSITION_CELL_SHIFT)
+#define LAT_CELL_MAX (900000000 >> NODE_POSITION_CELL_SHIFT)
+#define LON_CELL_MIN (-1800000000 >> NODE_POSITION_CELL_SHIFT)
+#define LON_CELL_MAX (1800000000 >> NODE_POSITION_CELL_SHIFT)
+// Not a key any cell has
+#define NO_CELL UINT32_MAX
+
+uint32_t NodePositionIndex::cellKey(int32_t latCell, int32_t lonCell)
+{
+    return ((uint32_t)(latCell - LAT_CELL_MIN) << 12) | (uint32_t)(lonCell - LON_CELL_MIN);
+}
+
+static bool cellBefore(const NodePositionIndex::Entry &e, uint32_t cell)
+{
+    return e.cell < cell;
+}
+
+static bool cellAfter(uint32_t cell, const NodePositionIndex::Entry &e)
+{
+    return cell < e.cell;
+}
+
+void NodePositionIndex::clear()
+{
+    entries.clear();
+    cells.clear();
+    boundsValid = true;
+}
+
+int NodePositionIndex::find(uint16_t dbIndex) const
+{
+    if (dbIndex >= cells.size() || cells[dbIndex] == NO_CELL)
+        return -1;
+    // Only the node's own cell needs looking through
+    auto it = std::lower_bound(entries.begin(), entries.end(), cells[dbIndex], cellBefore);
+    for (; it != entries.end() && it->cell == cells[dbIndex]; ++it)
+        if (it->dbIndex == dbIndex)
+            return it - entries.begin();
+    return -1;
+}
+
+void NodePositionIndex::erase(size_t i)
+{
+    const Entry &e = entries[i];
+    if (e.latitude_i == minLat || e.latitude_i == maxLat || e.longitude_i == minLon || e.longitude_i == maxLon)
+        boundsValid = false;
+    cells[e.dbIndex] = NO_CELL;
+    entries.erase(entries.begin() + i);
+}
+
+void NodePositionIndex::set(uint16_t dbIndex, int32_t latitude_i, int32_t longitude_i)
+{
+    int i = find(dbIndex);
+    if (i >= 0) {
+        if (entries[i].latitude_i == latitude_i && entries[i].longitude_i == longitude_i)
+            return;
+        erase(i);
+    }
+
+    Entry e;
+    e.cell = cellKey(cellOf(latitude_i), cellOf(longitude_i));
+    e.dbIndex = dbIndex;
+    e.latitude_i = latitude_i;
+    e.longitude_i = longitude_i;
+    entries.insert(std::upper_bound(entries.begin(), entries.end(), e.cell, cellAfter), e);
+    if (dbIndex >= cells.size())
+        cells.resize(dbIndex + 1, NO_CELL);
+    cells[dbIndex] = e.cell;
+
+    if (entries.size() == 1) {
+        minLat = maxLat = latitude_i;
+        minLon = maxLon = longitude_i;
+        boundsValid = true;
+    } else if (boundsValid) {
+        minLat = std::min(minLat, latitude_i);
+        maxLat = std::max(maxLat, latitude_i);
+        minLon = std::min(minLon, longitude_i);
+        maxLon = std::max(maxLon, longitude_i);
+    }
+}
+
+void NodePositionIndex::remove(uint16_t dbIndex)
+{
+    int i = find(dbIndex);
+    if (i >= 0)
+        erase(i);
+}
+
+void NodePositionIndex::removeAndShift(uint16_t dbIndex)
+{
+    remove(dbIndex);
+    if (dbIndex < cells.size())
+        cells.erase(cells.begin() + dbIndex);
+    for (Entry &e : entries)
+        if (e.dbIndex > dbIndex)
+            e.dbIndex--;
+}
+
+bool NodePositionIndex::getBounds(int32_t *minLatOut, int32_t *maxLatOut, int32_t *minLonOut, int32_t *maxLonOut) const
+{
+    if (entries.empty())
+        return false;
+    if (!boundsValid) {
+        minLat = maxLat = entries[0].latitude_i;
+        minLon = maxLon = entries[0].longitude_i;
+        for (const Entry &e : entries) {
+            minLat = std::min(minLat, e.latitude_i);
+            maxLat = std::max(maxLat, e.latitude_i);
+            minLon = std::min(minLon, e.longitude_i);
+            maxLon = std::max(maxLon, e.longitude_i);
+        }
+        boundsValid = true;
+    }
+    *minLatOut = minLat;
+    *maxLatOut = maxLat;
+    *minLonOut = minLon;
+    *maxLonOut = maxLon;
+    return true;
+}
+
+void NodePositionIndex::rowRange(int32_t latCell, int32_t lonCell0, int32_t lonCell1, size_t *begin, size_t *end) const
+{
+    lonCell0 = std::max(lonCell0, (int32_t)LON_CELL_MIN);
+    lonCell1 = std::min(lonCell1, (int32_t)LON_CELL_MAX);
+    if (latCell < LAT_CELL_MIN || latCell > LAT_CELL_MAX || lonCell0 > lonCell1) {
+        *begin = *end = 0;
+        return;
+    }
+    uint32_t first = cellKey(latCell, lonCell0), last = cellKey(latCell, lonCell1);
+    auto lo = std::lower_bound(entries.begin(), entries.end(), first, cellBefore);
+    auto hi = std::upper_bound(lo, entries.end(), last, cellAfter);
+    *begin = lo - entries.begin();
+    *end = hi - entries.begin();
+}
+
+size_t NodePositionIndex::findInBox(int32_t minLatIn, int32_t maxLatIn, int32_t minLonIn, int32_t maxLonIn,
+                                    std::vector<uint16_t> &found) const
+{
+    size_t before = found.size();
+    if (minLonIn > maxLonIn) {
+        // Either side of the antimeridian
+        findInBox(minLatIn, maxLatIn, minLonIn, INT32_MAX, found);
+        findInBox(minLatIn, maxLatIn, INT32_MIN, maxLonIn, found);
+        return found.size() - before;
+    }
+
+    for (int32_t row = cellOf(minLatIn); row <= cellOf(maxLatIn); row++) {
+        size_t begin, end;
+        rowRange(row, cellOf(minLonIn), cellOf(maxLonIn), &begin, &end);
+        for (size_t i = begin; i < end; i++) {
+            const Entry &e = entries[i];
+            if (e.latitude_i >= minLatIn && e.latitude_i <= maxLatIn && e.longitude_i >= minLonIn && e.longitude_i <= maxLonIn)
+                found.push_back(e.dbIndex);
+        }
+    }
+    return found.size() - before;
+}
+
+size_t NodePositionIndex::findNearest(int32_t latitude_i, int32_t longitude_i, size_t count, uint16_t *found) const
+{
+    if (count == 0 || entries.empty())
+        return 0;
+
+    // Squared flat-earth distance, in latitude units
+    const double lonScale = cos(latitude_i * 1e-7 * M_PI / 180);
+    auto distance2 = [&](const Entry &e) {
+        double dLat = (double)e.latitude_i - latitude_i;
+        double dLon = ((double)e.longitude_i - longitude_i) * lonScale;
+        return dLat * dLat + dLon * dLon;
+    };
+
+    // The nearest so far, nearest first
+    std::vector<std::pair<double, uint16_t>> best;
+    best.reserve(count + 1);
+    auto consider = [&](const Entry &e) {
+        double d2 = distance2(e);
+        if (best.size() == count && d2 >= best.back().first)
+            return;
+        auto at = std::upper_bound(best.begin(), best.end(), d2,
+                                   [](double d, const std::pair<double, uint16_t> &o) { return d < o.first; });
+        best.insert(at, std::make_pair(d2, e.dbIndex));
+        if (best.size() > count)
+            best.pop_back();
+    };
+
+    int32_t bLatMin, bLatMax, bLonMin, bLonMax;
+    getBounds(&bLatMin, &bLatMax, &bLonMin, &bLonMax);
+    const int32_t cy = cellOf(latitude_i), cx = cellOf(longitude_i);
+    const double cellSize = (double)(1 << NODE_POSITION_CELL_SHIFT) * lonScale; // Narrowest side of a cell
+
+    // Search rings of cells outwards from the point's own cell. Everything beyond ring r is at least r cells away, so
+    // once we have enough nodes nearer than that we're done. If the nodes are so sparse that we'd look at more cells
+    // than there are nodes, just look at every node instead.
+    size_t cellsSearched = 0;
+    bool complete = false;
+    for (int32_t r = 0; !complete; r++) {
+        for (int32_t dy = -r; dy <= r; dy++) {
+            size_t ranges[2][2];
+            size_t numRanges = 0;
+            if (dy == -r || dy == r) {
+                rowRange(cy + dy, cx - r, cx + r, &ranges[0][0], &ranges[0][1]);
+                numRanges = 1;
+                cellsSearched += 2 * r + 1;
+            } else {
+                rowRange(cy + dy, cx - r, cx - r, &ranges[0][0], &ranges[0][1]);
+                rowRange(cy + dy, cx + r, cx + r, &ranges[1][0], &ranges[1][1]);
+                numRanges = 2;
+                cellsSearched += 2;
+            }
+            for (size_t n = 0; n < numRanges; n++)
+                for (size_t i = ranges[n][0]; i < ranges[n][1]; i++)
+                    consider(entries[i]);
+        }
+
+        bool coversAll = cy - r <= cellOf(bLatMin) && cy + r >= cellOf(bLatMax) && cx - r <= cellOf(bLonMin) &&
+                         cx + r >= cellOf(bLonMax);
+        double reach = r * cellSize;
+        if (coversAll || (best.size() == count && best.back().first <= reach * reach)) {
+            complete = true;
+        } else if (cellsSearched > entries.size()) {
+            best.clear();
+            for (const Entry &e : entries)
+                consider(e);
+            complete = true;
+        }
+    }
+
+    for (size_t i = 0; i < best.size(); i++)
+        found[i] = best[i].second;
+    return best.size();
+}
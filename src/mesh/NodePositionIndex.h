@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Grid cells are 2^20 * 1e-7 degrees on a side, about 11.6 km north to south
+#define NODE_POSITION_CELL_SHIFT 20
+
+/**
+ * The nodes in NodeDB that have a valid position, on a uniform latitude / longitude grid.
+ *
+ * NodeDB keeps this up to date as positions arrive and nodes come and go, so map views can walk just the nodes with a
+ * position, look up those in an area, or find the nearest ones, without going through the whole DB. Nodes are known by
+ * their index in NodeDB.
+ *
+ * Entries are kept sorted by cell, so an area is a binary search per row of cells. Longitudes don't wrap around at
+ * +-180 for findNearest(), same as for the bounding box.
+ */
+class NodePositionIndex
+{
+  public:
+    struct Entry {
+        uint32_t cell;
+        uint16_t dbIndex;
+        int32_t latitude_i, longitude_i;
+    };
+
+    void clear();
+
+    /// Add the node at dbIndex, or move it
+    void set(uint16_t dbIndex, int32_t latitude_i, int32_t longitude_i);
+    void remove(uint16_t dbIndex);
+    /// The node at dbIndex left the DB and the ones after it moved down to fill the gap
+    void removeAndShift(uint16_t dbIndex);
+
+    size_t size() const { return entries.size(); }
+    /// All nodes with a position, in no particular order
+    const std::vector<Entry> &getEntries() const { return entries; }
+
+    /// The smallest box around all the nodes. Returns false if there are none.
+    bool getBounds(int32_t *minLat, int32_t *maxLat, int32_t *minLon, int32_t *maxLon) const;
+
+    /// Nodes inside the box, edges included. If minLon > maxLon the box crosses the antimeridian.
+    size_t findInBox(int32_t minLat, int32_t maxLat, int32_t minLon, int32_t maxLon, std::vector<uint16_t> &found) const;
+
+    /// Up to count nodes nearest to the point, nearest first. Distances are flat-earth around the point, which is exact
+    /// enough to rank nodes anywhere near it.
+    size_t findNearest(int32_t latitude_i, int32_t longitude_i, size_t count, uint16_t *found) const;
+
+  private:
+    std::vector<Entry> entries;  // Sorted by cell
+    std::vector<uint32_t> cells; // Cell of each node by dbIndex, NO_CELL if it has no position
+
+    // Cached bounding box, recomputed when a node on its edge goes away
+    mutable bool boundsValid = true;
+    mutable int32_t minLat = 0, maxLat = 0, minLon = 0, maxLon = 0;
+
+    static int32_t cellOf(int32_t degrees_i) { return degrees_i >> NODE_POSITION_CELL_SHIFT; } // Rounds down
+    static uint32_t cellKey(int32_t latCell, int32_t lonCell);
+    /// Entries with cells from row latCell, columns lonCell0 to lonCell1
+    void rowRange(int32_t latCell, int32_t lonCell0, int32_t lonCell1, size_t *begin, size_t *end) const;
+    int find(uint16_t dbIndex) const;
+    void erase(size_t i);
+};
@@ -23,7 +23,7 @@ bool PacketHistory::wasSeenRecently(const meshtastic_MeshPacket *p, bool withUpd
         return false; // Not a floodable message ID, so we don't care
     }
 
-    PacketRecord r;
+    PacketRecord r = {};
     r.id = p->id;
     r.sender = getFrom(p);
     r.rxTimeMsec = millis();
@@ -155,4 +155,20 @@ void PacketHistory::removeRelayer(const uint8_t relayer, const uint32_t id, cons
 
     recentPackets.erase(found);
     recentPackets.insert(r);
-}
\ No newline at end of file
+}
+/* Copy the relayers we heard of a packet in the history given an ID and sender
+ * @return how many there are, up to NUM_RELAYERS */
+uint8_t PacketHistory::getRelayers(const uint32_t id, const NodeNum sender, uint8_t relayers[NUM_RELAYERS])
+{
+    PacketRecord r = {.sender = sender, .id = id, .rxTimeMsec = 0, .next_hop = 0};
+    auto found = recentPackets.find(r);
+    if (found == recentPackets.end())
+        return 0;
+
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < NUM_RELAYERS; i++) {
+        if (found->relayed_by[i])
+            relayers[count++] = found->relayed_by[i];
+    }
+    return count;
+}
@@ -65,4 +65,8 @@ class PacketHistory
 
     // Remove a relayer from the list of relayers of a packet in the history given an ID and sender
     void removeRelayer(const uint8_t relayer, const uint32_t id, const NodeNum sender);
+
+    /* Copy the relayers we heard of a packet in the history given an ID and sender
+     * @return how many there are, up to NUM_RELAYERS */
+    uint8_t getRelayers(const uint32_t id, const NodeNum sender, uint8_t relayers[NUM_RELAYERS]);
 };
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "PayloadCompression.h"
+
+#if !MESHTASTIC_EXCLUDE_COMPRESSION
+#include "Default.h"
+#include "Router.h"
+#include "Throttle.h"
+#include "compression/dictcomp.h"
+
+// Every node sends its NodeInfo at least this often, so after this long we have heard from everyone on the channel
+#define COMPRESSION_HOLDOFF_MS (default_node_info_broadcast_secs * 1000UL)
+
+PayloadCompression payloadCompression;
+
+bool PayloadCompression::isCompressiblePort(meshtastic_PortNum port)
+{
+    return port == meshtastic_PortNum_TEXT_MESSAGE_APP || port == meshtastic_PortNum_NODEINFO_APP ||
+           port == meshtastic_PortNum_TELEMETRY_APP;
+}
+
+void PayloadCompression::noteSender(ChannelIndex chIndex, const meshtastic_Data &d)
+{
+    if (chIndex >= MAX_NUM_CHANNELS)
+        return;
+    ChannelState &ch = state[chIndex];
+    if (d.has_bitfield && (d.bitfield & BITFIELD_COMPRESSION_CAPABLE_MASK)) {
+        ch.heardCapable = true;
+        ch.lastCapableMs = millis();
+    } else {
+        if (!ch.heardLegacy || !Throttle::isWithinTimespanMs(ch.lastLegacyMs, COMPRESSION_HOLDOFF_MS))
+            LOG_DEBUG("Legacy sender on channel %u, payload compression off", chIndex);
+        ch.heardLegacy = true;
+        ch.lastLegacyMs = millis();
+    }
+}
+
+bool PayloadCompression::isNegotiated(ChannelIndex chIndex)
+{
+    if (chIndex >= MAX_NUM_CHANNELS)
+        return false;
+
+    // Until we have listened for a full NodeInfo interval we can't know there are no legacy nodes around
+    static bool listenedLongEnough;
+    if (!listenedLongEnough)
+        listenedLongEnough = millis() >= COMPRESSION_HOLDOFF_MS;
+    if (!listenedLongEnough)
+        return false;
+
+    const ChannelState &ch = state[chIndex];
+    if (ch.heardLegacy && Throttle::isWithinTimespanMs(ch.lastLegacyMs, COMPRESSION_HOLDOFF_MS))
+        return false;
+    return ch.heardCapable && Throttle::isWithinTimespanMs(ch.lastCapableMs, COMPRESSION_HOLDOFF_MS);
+}
+
+bool PayloadCompression::compress(const meshtastic_Data &in, meshtastic_Data &out)
+{
+    if (!isCompressiblePort(in.portnum) || in.payload.size == 0)
+        return false;
+
+    uint8_t compressed[sizeof(in.payload.bytes)];
+    int len = dictcomp_compress(in.payload.bytes, in.payload.size, compressed, sizeof(compressed));
+    if (len < 0 || (size_t)len >= in.payload.size) {
+        stats.uncompressed++;
+        return false;
+    }
+
+    stats.compressed++;
+    stats.bytesIn += in.payload.size;
+    stats.bytesOut += len;
+
+    out = in;
+    memcpy(out.payload.bytes, compressed, len);
+    out.payload.size = len;
+    out.has_bitfield = true;
+    out.bitfield |= BITFIELD_COMPRESSED_MASK;
+    return true;
+}
+
+bool PayloadCompression::decompress(meshtastic_Data &d)
+{
+    uint8_t plain[sizeof(d.payload.bytes)];
+    int len = dictcomp_decompress(d.payload.bytes, d.payload.size, plain, sizeof(plain));
+    if (len < 0) {
+        stats.failed++;
+        return false;
+    }
+
+    stats.decompressed++;
+    memcpy(d.payload.bytes, plain, len);
+    d.payload.size = len;
+    d.bitfield &= ~BITFIELD_COMPRESSED_MASK;
+    return true;
+}
+
+void PayloadCompression::noteCompressed(NodeNum from, PacketId id)
+{
+    if (wasCompressed(from, id))
+        return;
+    recentCompressed[recentCompressedIndex] = {from, id};
+    recentCompressedIndex = (recentCompressedIndex + 1) % NUM_RECENT_COMPRESSED;
+}
+
+bool PayloadCompression::wasCompressed(NodeNum from, PacketId id) const
+{
+    for (const RecentPacket &r : recentCompressed)
+        if (r.from == from && r.id == id && id != 0)
+            return true;
+    return false;
+}
+
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Channels.h"
+#include "configuration.h"
+#include "mesh-pb-constants.h"
+
+#if !MESHTASTIC_EXCLUDE_COMPRESSION
+
+/**
+ * Transparent compression of selected payloads with the trained dictionary codec (compression/dictcomp.h).
+ *
+ * Compression is negotiated per channel. Every packet we originate advertises BITFIELD_COMPRESSION_CAPABLE, and we
+ * only start compressing on a channel once we have listened for long enough to have heard every regular sender there
+ * (a NodeInfo interval) and all of them advertised the capability. A single legacy sender turns it off again for the
+ * same hold-off period. Compressed payloads are flagged with BITFIELD_COMPRESSED and restored in perhapsDecode(), so
+ * modules, the phone and MQTT only ever see the original payload. Relays decode too, so we remember which packets arrived
+ * compressed to compress them again when we forward them. MQTT re-encrypts those, and the ones we compressed ourselves,
+ * from the original payload when it uplinks encrypted packets, as other MQTT clients can't decompress them.
+ */
+class PayloadCompression
+{
+  public:
+    struct Stats {
+        uint32_t compressed = 0;   // Packets we sent compressed
+        uint32_t uncompressed = 0; // Eligible packets that didn't get smaller
+        uint32_t bytesIn = 0;      // Payload bytes before compression, of compressed packets
+        uint32_t bytesOut = 0;     // and after
+        uint32_t decompressed = 0;
+        uint32_t failed = 0; // Malformed or unknown dictionary
+    };
+
+    /// Ports whose payloads are worth compressing: text, NodeInfo and telemetry
+    static bool isCompressiblePort(meshtastic_PortNum port);
+
+    /// Record whether the originator of a packet we decoded on this channel understands compressed payloads
+    void noteSender(ChannelIndex chIndex, const meshtastic_Data &d);
+
+    /// True if everybody we have heard on this channel recently can decompress
+    bool isNegotiated(ChannelIndex chIndex);
+
+    /**
+     * Copy in to out with the payload compressed.
+     *
+     * @return false (and out untouched) if the port is not compressible or the payload wouldn't get smaller
+     */
+    bool compress(const meshtastic_Data &in, meshtastic_Data &out);
+
+    /// Restore a payload flagged as compressed in place, false if it was malformed
+    bool decompress(meshtastic_Data &d);
+
+    /// Remember that a packet we decoded arrived compressed, or that we sent it compressed
+    void noteCompressed(NodeNum from, PacketId id);
+
+    /// Whether a packet arrived or went out compressed, as far as we still remember
+    bool wasCompressed(NodeNum from, PacketId id) const;
+
+    const Stats &getStats() const { return stats; }
+
+  private:
+    struct ChannelState {
+        uint32_t lastCapableMs = 0;
+        uint32_t lastLegacyMs = 0;
+        bool heardCapable = false;
+        bool heardLegacy = false;
+    };
+
+    struct RecentPacket {
+        NodeNum from;
+        PacketId id;
+    };
+
+    // Enough to cover the packets waiting in our TX queue, relayed ones and our own
+    constexpr static uint8_t NUM_RECENT_COMPRESSED = 32;
+
+    ChannelState state[MAX_NUM_CHANNELS];
+    RecentPacket recentCompressed[NUM_RECENT_COMPRESSED] = {};
+    uint8_t recentCompressedIndex = 0;
+    Stats stats;
+};
+
+extern PayloadCompression payloadCompression;
+
+#endif
@@ -48,6 +48,7 @@ void PhoneAPI::handleStartConfig()
     if (!isConnected()) {
         onConnectionChanged(true);
         observe(&service->fromNumChanged);
+        service->subscribeForPhone(packetCursor);
 #ifdef FSCom
         observe(&xModem.packetReady);
 #endif
@@ -80,6 +81,7 @@ void PhoneAPI::close()
         state = STATE_SEND_NOTHING;
         resetReadIndex();
         unobserve(&service->fromNumChanged);
+        service->unsubscribeForPhone(packetCursor);
 #ifdef FSCom
         unobserve(&xModem.packetReady);
 #endif
@@ -478,6 +480,13 @@ size_t PhoneAPI::getFromRadio(uint8_t *buf)
             fromRadioScratch.which_payload_variant = meshtastic_FromRadio_packet_tag;
             fromRadioScratch.packet = *packetForPhone;
             releasePhonePacket();
+        } else {
+            // Packets from the mesh were encoded once for every client, just copy the bytes
+            size_t numbytes = service->getForPhone(packetCursor, buf);
+            if (numbytes) {
+                LOG_DEBUG("Phone downloaded packet (%u bytes)", (unsigned)numbytes);
+                return numbytes;
+            }
         }
         break;
 
@@ -602,9 +611,7 @@ bool PhoneAPI::available()
 #endif
 #endif
 
-        if (!packetForPhone)
-            packetForPhone = service->getForPhone();
-        hasPacket = !!packetForPhone;
+        hasPacket = !!packetForPhone || service->hasForPhone(packetCursor);
         return hasPacket;
     }
     default:
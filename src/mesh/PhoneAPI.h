@@ -1,5 +1,6 @@
 #pragma once
 
+#include "FromRadioRing.h"
 #include "Observer.h"
 #include "mesh-pb-constants.h"
 #include "meshtastic/portnums.pb.h"
@@ -61,8 +62,11 @@ class PhoneAPI
      */
     uint32_t fromRadioNum = 0;
 
-    /// We temporarily keep the packet here between the call to available and getFromRadio.  We will free it after the phone
-    /// downloads it
+    /// Where we are in the packets from the mesh, which are shared by every connected client
+    FromRadioRing::Cursor packetCursor;
+
+    /// We temporarily keep a StoreForward packet here between the call to available and getFromRadio.  We will free it after
+    /// the phone downloads it
     meshtastic_MeshPacket *packetForPhone = NULL;
 
     // file transfer packets destined for phone. Push it to the queue then free it.
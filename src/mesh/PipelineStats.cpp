@@ -0,0 +1,319 @@
+#include "PipelineStats.h"
+
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+#include <stdio.h>
+#include <string.h>
+
+PipelineStats pipelineStats;
+
+#ifdef ARCH_PORTDUINO
+#define STATS_GUARD() std::lock_guard<std::mutex> guard(lock)
+#else
+// Everything else only touches us from the main loop
+#define STATS_GUARD()
+#endif
+
+// The stage each stage is timed from. Relayed packets are queued for TX while the modules still run, so TX_QUEUED
+// is timed from DECODED rather than DISPATCHED. Packets we originate only show up from TX_QUEUED on.
+static const PipelineStage predecessor[NUM_PIPELINE_STAGES] = {
+    STAGE_RX_ISR, // none
+    STAGE_RX_ISR, STAGE_RX_READ, STAGE_RX_QUEUED, STAGE_DECODED, STAGE_DECODED, STAGE_TX_QUEUED,
+};
+
+static const char *const stageNames[NUM_PIPELINE_STAGES] = {"rx_isr",     "rx_read",   "rx_queued", "decoded",
+                                                            "dispatched", "tx_queued", "tx_started"};
+
+static const char *const spiUserNames[NUM_SPI_USERS] = {"radio", "storage", "display"};
+
+// The same, for the flat summary list where they sit next to stage and module names
+static const char *const spiSummaryNames[NUM_SPI_USERS] = {"spi_radio", "spi_storage", "spi_display"};
+
+PipelineStats::PipelineStats()
+{
+#ifdef ARCH_NRF52
+    // The cycle counter is off unless a debugger turned it on
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+uint32_t PipelineStats::ticksToUs(uint32_t ticks)
+{
+#if defined(ARCH_ESP32)
+    return ticks / getCpuFrequencyMhz();
+#elif defined(ARCH_NRF52)
+    return ticks / (SystemCoreClock / 1000000);
+#else
+    return ticks;
+#endif
+}
+
+void PipelineStats::Histogram::add(uint32_t us)
+{
+    uint8_t bucket = us < 16 ? 0 : (31 - __builtin_clz(us)) - 3;
+    if (bucket >= PIPELINE_HISTOGRAM_BUCKETS)
+        bucket = PIPELINE_HISTOGRAM_BUCKETS - 1;
+    buckets[bucket]++;
+    count++;
+    totalUs += us;
+    if (us > maxUs)
+        maxUs = us;
+}
+
+uint32_t PipelineStats::Histogram::percentileUs(uint8_t percent) const
+{
+    if (!count)
+        return 0;
+    uint64_t want = ((uint64_t)count * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (uint8_t b = 0; b < PIPELINE_HISTOGRAM_BUCKETS - 1; b++) {
+        seen += buckets[b];
+        if (seen >= want)
+            return ((uint32_t)16 << b) < maxUs ? (uint32_t)16 << b : maxUs;
+    }
+    return maxUs;
+}
+
+const char *PipelineStats::stageName(PipelineStage stage)
+{
+    return stage < NUM_PIPELINE_STAGES ? stageNames[stage] : "?";
+}
+
+PipelineStats::Trace *PipelineStats::findTrace(const meshtastic_MeshPacket *p, bool create)
+{
+    NodeNum from = getFrom(p);
+    Trace *oldest = &traces[0];
+    for (auto &t : traces) {
+        if (t.stamped && t.from == from && t.id == p->id) {
+            t.lastUsed = ++useCounter;
+            return &t;
+        }
+        if (t.lastUsed < oldest->lastUsed)
+            oldest = &t;
+    }
+    if (!create)
+        return nullptr;
+
+    // Recycle whatever we touched longest ago, finished or not
+    *oldest = Trace();
+    oldest->from = from;
+    oldest->id = p->id;
+    oldest->lastUsed = ++useCounter;
+    return oldest;
+}
+
+void PipelineStats::begin(const meshtastic_MeshPacket *p, uint32_t isrTicks)
+{
+    STATS_GUARD();
+    Trace *t = findTrace(p, true);
+
+    // We may hear a packet again while we still have it queued for relaying, only restart the receive side
+    t->stamped &= ~((1 << STAGE_RX_ISR) | (1 << STAGE_RX_READ) | (1 << STAGE_RX_QUEUED));
+    t->at[STAGE_RX_ISR] = isrTicks;
+    t->stamped |= 1 << STAGE_RX_ISR;
+    stampLocked(p, STAGE_RX_READ);
+}
+
+void PipelineStats::stamp(const meshtastic_MeshPacket *p, PipelineStage stage)
+{
+    STATS_GUARD();
+    stampLocked(p, stage);
+}
+
+void PipelineStats::stampLocked(const meshtastic_MeshPacket *p, PipelineStage stage)
+{
+    uint32_t now = ticks();
+    Trace *t = findTrace(p, true);
+
+    PipelineStage prev = predecessor[stage];
+    if (prev != stage && (t->stamped & (1 << prev))) {
+        uint32_t elapsed = now - t->at[prev];
+        // A predecessor stamped after us belongs to a later copy of the packet, ignore it
+        if ((int32_t)elapsed >= 0)
+            stages[stage].add(ticksToUs(elapsed));
+    }
+    t->at[stage] = now;
+    t->stamped |= 1 << stage;
+}
+
+void PipelineStats::recordModule(const char *name, uint32_t startTicks)
+{
+    uint32_t us = ticksToUs(ticks() - startTicks);
+    STATS_GUARD();
+
+    // Module names are string literals, so comparing pointers is enough
+    for (size_t i = 0; i < numModules; i++) {
+        if (modules[i].name == name) {
+            modules[i].hist.add(us);
+            return;
+        }
+    }
+    if (numModules < PIPELINE_MAX_MODULES) {
+        modules[numModules].name = name;
+        modules[numModules].hist.add(us);
+        numModules++;
+    }
+}
+
+void PipelineStats::recordIrqService(uint32_t isrTicks)
+{
+    uint32_t us = ticksToUs(ticks() - isrTicks);
+    STATS_GUARD();
+    irqService.add(us);
+}
+
+void PipelineStats::recordSpiWait(SPIUser user, uint32_t startTicks)
+{
+    uint32_t us = ticksToUs(ticks() - startTicks);
+    STATS_GUARD();
+    spiWaits[user].add(us);
+}
+
+size_t PipelineStats::getNumSummaries() const
+{
+    STATS_GUARD();
+    return (NUM_PIPELINE_STAGES - STAGE_RX_READ) + 1 + numModules + NUM_SPI_USERS;
+}
+
+const char *PipelineStats::getSummary(size_t i, Histogram &out) const
+{
+    STATS_GUARD();
+    // STAGE_RX_ISR is where the clock starts, it has no histogram of its own
+    if (i < NUM_PIPELINE_STAGES - STAGE_RX_READ) {
+        out = stages[STAGE_RX_READ + i];
+        return stageNames[STAGE_RX_READ + i];
+    }
+    i -= NUM_PIPELINE_STAGES - STAGE_RX_READ;
+    if (i == 0) {
+        out = irqService;
+        return "irq_service";
+    }
+    i--;
+    if (i < numModules) {
+        out = modules[i].hist;
+        return modules[i].name;
+    }
+    i -= numModules;
+    if (i < NUM_SPI_USERS) {
+        out = spiWaits[i];
+        return spiSummaryNames[i];
+    }
+    return nullptr;
+}
+
+// Appends "name":{...} to buf if it fits, returns false otherwise
+static bool appendSummary(char *buf, size_t len, size_t &used, bool first, const char *name,
+                          const PipelineStats::Histogram &h)
+{
+    char entry[128];
+    int n = snprintf(entry, sizeof(entry), "%s\"%s\":{\"n\":%u,\"p50\":%u,\"p95\":%u,\"max\":%u}", first ? "" : ",", name,
+                     h.count, h.percentileUs(50), h.percentileUs(95), h.maxUs);
+    // Room for the entry plus the closing brace and terminator
+    if (n < 0 || used + n + 2 > len)
+        return false;
+    memcpy(buf + used, entry, n);
+    used += n;
+    return true;
+}
+
+size_t PipelineStats::writeStagesJson(char *buf, size_t len, size_t from) const
+{
+    STATS_GUARD();
+    if (len < 3)
+        return from;
+    size_t used = 0;
+    buf[used++] = '{';
+    size_t i;
+    // STAGE_RX_ISR is where the clock starts, it has no histogram of its own
+    for (i = from < STAGE_RX_READ ? (size_t)STAGE_RX_READ : from; i <= NUM_PIPELINE_STAGES; i++) {
+        bool fits = i < NUM_PIPELINE_STAGES ? appendSummary(buf, len, used, used == 1, stageNames[i], stages[i])
+                                            : appendSummary(buf, len, used, used == 1, "irq_service", irqService);
+        if (!fits)
+            break;
+    }
+    buf[used++] = '}';
+    buf[used] = 0;
+    return i;
+}
+
+size_t PipelineStats::writeModulesJson(char *buf, size_t len, size_t from) const
+{
+    STATS_GUARD();
+    if (len < 3)
+        return from;
+    size_t used = 0;
+    buf[used++] = '{';
+    size_t i;
+    for (i = from; i < numModules; i++) {
+        if (!appendSummary(buf, len, used, used == 1, modules[i].name, modules[i].hist))
+            break;
+    }
+    buf[used++] = '}';
+    buf[used] = 0;
+    return i;
+}
+
+size_t PipelineStats::writeSpiWaitsJson(char *buf, size_t len, size_t from) const
+{
+    STATS_GUARD();
+    if (len < 3)
+        return from;
+    size_t used = 0;
+    buf[used++] = '{';
+    size_t i;
+    for (i = from; i < NUM_SPI_USERS; i++) {
+        if (!appendSummary(buf, len, used, used == 1, spiUserNames[i], spiWaits[i]))
+            break;
+    }
+    buf[used++] = '}';
+    buf[used] = 0;
+    return i;
+}
+
+static void appendHistogram(std::string &out, const char *name, const PipelineStats::Histogram &h)
+{
+    char tmp[160];
+    snprintf(tmp, sizeof(tmp), "\"%s\":{\"count\":%u,\"mean_us\":%u,\"p50_us\":%u,\"p95_us\":%u,\"max_us\":%u,\"buckets\":[",
+             name, h.count, h.count ? (uint32_t)(h.totalUs / h.count) : 0, h.percentileUs(50), h.percentileUs(95), h.maxUs);
+    out += tmp;
+    for (uint8_t b = 0; b < PIPELINE_HISTOGRAM_BUCKETS; b++) {
+        snprintf(tmp, sizeof(tmp), b ? ",%u" : "%u", h.buckets[b]);
+        out += tmp;
+    }
+    out += "]}";
+}
+
+std::string PipelineStats::toJson() const
+{
+    STATS_GUARD();
+    std::string out = "{\"bucket_limits_us\":[";
+    char tmp[16];
+    for (uint8_t b = 0; b < PIPELINE_HISTOGRAM_BUCKETS - 1; b++) {
+        snprintf(tmp, sizeof(tmp), b ? ",%u" : "%u", 16u << b);
+        out += tmp;
+    }
+    out += "],\"stages\":{";
+    for (uint8_t i = STAGE_RX_READ; i < NUM_PIPELINE_STAGES; i++) {
+        if (i != STAGE_RX_READ)
+            out += ",";
+        appendHistogram(out, stageNames[i], stages[i]);
+    }
+    out += "},";
+    appendHistogram(out, "irq_service", irqService);
+    out += ",\"modules\":{";
+    for (size_t i = 0; i < numModules; i++) {
+        if (i)
+            out += ",";
+        appendHistogram(out, modules[i].name, modules[i].hist);
+    }
+    out += "},\"spi_wait\":{";
+    for (uint8_t i = 0; i < NUM_SPI_USERS; i++) {
+        if (i)
+            out += ",";
+        appendHistogram(out, spiUserNames[i], spiWaits[i]);
+    }
+    out += "}}";
+    return out;
+}
+
+#endif
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "MeshTypes.h"
+#include "SPILock.h"
+#include "configuration.h"
+#include <string>
+#ifdef ARCH_PORTDUINO
+#include <mutex>
+#endif
+
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+
+/// Stages of the packet pipeline we timestamp
+enum PipelineStage : uint8_t {
+    STAGE_RX_ISR,     // Radio raised its receive interrupt
+    STAGE_RX_READ,    // handleReceiveInterrupt() read the packet off the radio
+    STAGE_RX_QUEUED,  // Router::enqueueReceivedMessage()
+    STAGE_DECODED,    // perhapsDecode() finished
+    STAGE_DISPATCHED, // MeshModule::callModules() finished
+    STAGE_TX_QUEUED,  // Added to the radio's txQueue
+    STAGE_TX_STARTED, // startSend()
+    NUM_PIPELINE_STAGES
+};
+
+/// Log2 buckets: bucket 0 is < 16 us, bucket b < 16 << b us, the last one catches everything from ~4 s up
+#define PIPELINE_HISTOGRAM_BUCKETS 20
+
+/// How many modules get their own handleReceived() histogram
+#define PIPELINE_MAX_MODULES 24
+
+/// How many packets we can follow through the pipeline at the same time
+#define PIPELINE_MAX_TRACES 16
+
+/**
+ * Latency tracing of the packet pipeline, so we can tell where the time goes on a busy router.
+ *
+ * Each stage stamps the packet with a cycle counter (the CPU cycle counter on ESP32 and nRF52, micros() elsewhere).
+ * MeshPacket is generated from the protobufs, so the stamps live in a small table keyed by (from, id) instead, which
+ * also follows a packet through the copies the router makes of it. Every stage has a fixed predecessor and a histogram
+ * of the time since it, e.g. STAGE_DECODED records time spent in fromRadioQueue plus decoding. Modules get a histogram
+ * of the time spent in their handleReceived().
+ *
+ * Waits for the SPI bus get a histogram per SPIUser, the radio's is part of the time a received packet sits in the radio.
+ * Most SPI users run on the main loop like the radio does, so what really holds the radio up is the time from its interrupt
+ * until the main loop gets around to servicing it, which has a histogram of its own (irq_service).
+ *
+ * Cycle counters wrap (every ~18 s at 240 MHz), intervals longer than that are misreported.
+ *
+ * On Linux the web server reads the histograms from its own thread, so there everything goes through a mutex.
+ */
+class PipelineStats
+{
+  public:
+    struct Histogram {
+        uint32_t buckets[PIPELINE_HISTOGRAM_BUCKETS] = {0};
+        uint32_t count = 0;
+        uint32_t maxUs = 0;
+        uint64_t totalUs = 0;
+
+        void add(uint32_t us);
+
+        /// Upper bound of the bucket holding the given percentile, in microseconds
+        uint32_t percentileUs(uint8_t percent) const;
+    };
+
+    PipelineStats();
+
+    /// Monotonic timestamp, cheap enough to take in an ISR
+    static inline uint32_t ticks()
+    {
+#if defined(ARCH_ESP32)
+        return ESP.getCycleCount();
+#elif defined(ARCH_NRF52)
+        return DWT->CYCCNT;
+#else
+        return micros();
+#endif
+    }
+
+    static uint32_t ticksToUs(uint32_t ticks);
+
+    /// Start following a packet we just received, at (earlier) time isrTicks
+    void begin(const meshtastic_MeshPacket *p, uint32_t isrTicks);
+
+    /// Record that p reached stage now
+    void stamp(const meshtastic_MeshPacket *p, PipelineStage stage);
+
+    /// Record time spent by the module called name since startTicks
+    void recordModule(const char *name, uint32_t startTicks);
+
+    /// Record that the radio interrupt which fired at isrTicks is being serviced now
+    void recordIrqService(uint32_t isrTicks);
+
+    /// Record time user waited for the SPI bus since startTicks
+    void recordSpiWait(SPIUser user, uint32_t startTicks);
+
+    const Histogram &getStage(PipelineStage stage) const { return stages[stage]; }
+    const Histogram &getSpiWait(SPIUser user) const { return spiWaits[user]; }
+    const Histogram &getIrqService() const { return irqService; }
+    static const char *stageName(PipelineStage stage);
+
+    /**
+     * Write {"stage":{"n":..,"p50":..,"p95":..,"max":..},...} summaries (in microseconds) for stages or modules,
+     * starting at index from and stopping at whatever no longer fits in len. The stages end with irq_service, at index
+     * NUM_PIPELINE_STAGES.
+     *
+     * @return index of the first entry not written, so the caller can page through them
+     */
+    size_t writeStagesJson(char *buf, size_t len, size_t from = 0) const;
+    size_t writeModulesJson(char *buf, size_t len, size_t from = 0) const;
+    size_t writeSpiWaitsJson(char *buf, size_t len, size_t from = 0) const;
+
+    size_t getNumModules() const { return numModules; }
+
+    /// Stages, irq_service, modules, then SPI bus waits, one flat list for the admin request to page through
+    size_t getNumSummaries() const;
+
+    /// Copy summary i into out, @return its name or nullptr once i is past the end
+    const char *getSummary(size_t i, Histogram &out) const;
+
+    /// Everything including the bucket counts, for the Linux web server
+    std::string toJson() const;
+
+  private:
+    struct Trace {
+        NodeNum from = 0;
+        PacketId id = 0;
+        uint32_t lastUsed = 0;
+        uint8_t stamped = 0; // Bitmask of stages in at[]
+        uint32_t at[NUM_PIPELINE_STAGES] = {0};
+    };
+
+    struct ModuleSlot {
+        const char *name = nullptr;
+        Histogram hist;
+    };
+
+    Trace *findTrace(const meshtastic_MeshPacket *p, bool create);
+    void stampLocked(const meshtastic_MeshPacket *p, PipelineStage stage);
+
+    Trace traces[PIPELINE_MAX_TRACES];
+    uint32_t useCounter = 0;
+
+    Histogram stages[NUM_PIPELINE_STAGES];
+    Histogram irqService;
+    ModuleSlot modules[PIPELINE_MAX_MODULES];
+    size_t numModules = 0;
+
+    Histogram spiWaits[NUM_SPI_USERS];
+
+#ifdef ARCH_PORTDUINO
+    mutable std::mutex lock;
+#endif
+};
+
+extern PipelineStats pipelineStats;
+
+#endif
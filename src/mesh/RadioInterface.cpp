@@ -237,10 +237,7 @@ uint32_t RadioInterface::getRetransmissionMsec(const meshtastic_MeshPacket *p)
     // Make sure enough time has elapsed for this packet to be sent and an ACK is received.
     // LOG_DEBUG("Waiting for flooding message with airtime %d and slotTime is %d", packetAirtime, slotTimeMsec);
     float channelUtil = airTime->channelUtilizationPercent();
-    uint8_t CWsize = map(channelUtil, 0, 100, CWmin, CWmax);
-    // Assuming we pick max. of CWsize and there will be a client with SNR at half the range
-    return 2 * packetAirtime + (pow(2, CWsize) + 2 * CWmax + pow(2, int((CWmax + CWmin) / 2))) * slotTimeMsec +
-           PROCESSING_TIME_MSEC;
+    return 2 * packetAirtime + contention.getRetransmissionSlots(channelUtil, millis()) * slotTimeMsec + PROCESSING_TIME_MSEC;
 }
 
 /** The delay to use when we want to send something */
@@ -248,31 +245,22 @@ uint32_t RadioInterface::getTxDelayMsec()
 {
     /** We wait a random multiple of 'slotTimes' (see definition in header file) in order to avoid collisions.
     The pool to take a random multiple from is the contention window (CW), which size depends on the
-    current channel utilization. */
+    current channel utilization and how busy we found the channel lately. */
     float channelUtil = airTime->channelUtilizationPercent();
-    uint8_t CWsize = map(channelUtil, 0, 100, CWmin, CWmax);
-    // LOG_DEBUG("Current channel utilization is %f so setting CWsize to %d", channelUtil, CWsize);
-    return random(0, pow(2, CWsize)) * slotTimeMsec;
+    return contention.getTxDelaySlots(channelUtil, millis()) * slotTimeMsec;
 }
 
 /** The CW size to use when calculating SNR_based delays */
 uint8_t RadioInterface::getCWsize(float snr)
 {
-    // The minimum value for a LoRa SNR
-    const uint32_t SNR_MIN = -20;
-
-    // The maximum value for a LoRa SNR
-    const uint32_t SNR_MAX = 10;
-
-    return map(snr, SNR_MIN, SNR_MAX, CWmin, CWmax);
+    return contention.getCWsizeForSnr(snr, millis());
 }
 
 /** The worst-case SNR_based packet delay */
 uint32_t RadioInterface::getTxDelayMsecWeightedWorst(float snr)
 {
-    uint8_t CWsize = getCWsize(snr);
     // offset the maximum delay for routers: (2 * CWmax * slotTimeMsec)
-    return (2 * CWmax * slotTimeMsec) + pow(2, CWsize) * slotTimeMsec;
+    return contention.getTxDelaySlotsWeightedWorst(snr, millis()) * slotTimeMsec;
 }
 
 /** The delay to use when we want to flood a message */
@@ -280,22 +268,17 @@ uint32_t RadioInterface::getTxDelayMsecWeighted(float snr)
 {
     //  high SNR = large CW size (Long Delay)
     //  low SNR = small CW size (Short Delay)
-    uint32_t delay = 0;
-    uint8_t CWsize = getCWsize(snr);
-    // LOG_DEBUG("rx_snr of %f so setting CWsize to:%d", snr, CWsize);
-    if (config.device.role == meshtastic_Config_DeviceConfig_Role_ROUTER ||
-        config.device.role == meshtastic_Config_DeviceConfig_Role_REPEATER) {
-        delay = random(0, 2 * CWsize) * slotTimeMsec;
-        LOG_DEBUG("rx_snr found in packet. Router: setting tx delay:%d", delay);
-    } else {
-        // offset the maximum delay for routers: (2 * CWmax * slotTimeMsec)
-        delay = (2 * CWmax * slotTimeMsec) + random(0, pow(2, CWsize)) * slotTimeMsec;
-        LOG_DEBUG("rx_snr found in packet. Setting tx delay:%d", delay);
-    }
-
+    // Routers and repeaters pick from 2 * CWsize slots, the others wait for them first (see ContentionWindow)
+    uint32_t delay = contention.getTxDelaySlotsWeighted(snr, millis()) * slotTimeMsec;
+    LOG_DEBUG("rx_snr found in packet. Setting tx delay:%d", delay);
     return delay;
 }
 
+void RadioInterface::noteRetransmission()
+{
+    contention.noteRetransmission(millis());
+}
+
 void printPacket(const char *prefix, const meshtastic_MeshPacket *p)
 {
 #if defined(DEBUG_PORT) && !defined(DEBUG_MUTE)
@@ -377,6 +360,7 @@ bool RadioInterface::init()
     // constructor time.
 
     applyModemConfig();
+    contention.seed(random(1, INT32_MAX));
 
     return true;
 }
@@ -440,6 +424,8 @@ uint32_t RadioInterface::getChannelNum()
  */
 void RadioInterface::applyModemConfig()
 {
+    contention.setRole(config.device.role);
+
     // Set up default configuration
     // No Sync Words in LORA mode
     meshtastic_Config_LoRaConfig &loraConfig = config.lora;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MemoryPool.h"
+#include "ContentionWindow.h"
 #include "MeshTypes.h"
 #include "Observer.h"
 #include "PointerQueue.h"
@@ -92,8 +93,11 @@ class RadioInterface
     uint32_t maxPacketTimeMsec = 3246; // calculated on startup, this is the default for LongFast
     const uint32_t PROCESSING_TIME_MSEC =
         4500;                // time to construct, process and construct a packet again (empirically determined)
-    const uint8_t CWmin = 3; // minimum CWsize
-    const uint8_t CWmax = 8; // maximum CWsize
+    const uint8_t CWmin = CONTENTION_CW_MIN; // minimum CWsize
+    const uint8_t CWmax = CONTENTION_CW_MAX; // maximum CWsize
+
+    /// Sizes our contention windows from what we see of the channel, see setTransmitDelay()
+    ContentionWindow contention;
 
     meshtastic_MeshPacket *sendingPacket = NULL; // The packet we are currently sending
     uint32_t lastTxStart = 0L;
@@ -183,6 +187,9 @@ class RadioInterface
     /** The delay to use when we want to flood a message. Use a weighted scale based on SNR */
     uint32_t getTxDelayMsecWeighted(float snr);
 
+    /** A packet of ours went unacknowledged and is being sent again, so back off further */
+    void noteRetransmission();
+
     /** If the packet is not already in the late rebroadcast window, move it there */
     virtual void clampToLateRebroadcastWindow(NodeNum from, PacketId id) { return; }
 
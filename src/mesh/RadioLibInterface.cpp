@@ -1,6 +1,7 @@
 #include "RadioLibInterface.h"
 #include "MeshTypes.h"
 #include "NodeDB.h"
+#include "PipelineStats.h"
 #include "PowerMon.h"
 #include "SPILock.h"
 #include "Throttle.h"
@@ -17,7 +18,7 @@
 #endif
 void LockingArduinoHal::spiBeginTransaction()
 {
-    spiLock->lock();
+    spiLock->lock(SPI_USER_RADIO);
 
     ArduinoHal::spiBeginTransaction();
 }
@@ -56,6 +57,9 @@ RadioLibInterface::RadioLibInterface(LockingArduinoHal *hal, RADIOLIB_PIN_TYPE c
 void INTERRUPT_ATTR RadioLibInterface::isrLevel0Common(PendingISR cause)
 {
     instance->disableInterrupt();
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+    instance->lastIsrTicks = PipelineStats::ticks();
+#endif
 
     BaseType_t xHigherPriorityTaskWoken;
     instance->notifyFromISR(&xHigherPriorityTaskWoken, cause, true);
@@ -178,6 +182,9 @@ ErrorCode RadioLibInterface::send(meshtastic_MeshPacket *p)
         packetPool.release(p);
         return res;
     }
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+    pipelineStats.stamp(p, STAGE_TX_QUEUED);
+#endif
 
     // set (random) transmit delay to let others reconfigure their radio,
     // to avoid collisions and implement timing-based flooding
@@ -245,6 +252,10 @@ currently active.
 */
 void RadioLibInterface::onNotify(uint32_t notification)
 {
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+    if (notification == ISR_TX || notification == ISR_RX)
+        pipelineStats.recordIrqService(lastIsrTicks);
+#endif
     switch (notification) {
     case ISR_TX:
         handleTransmitInterrupt();
@@ -270,11 +281,15 @@ void RadioLibInterface::onNotify(uint32_t notification)
                 if (delay_remaining > 0) {
                     // There's still some delay pending on this packet, so resume waiting for it to elapse
                     notifyLater(delay_remaining, TRANSMIT_DELAY_COMPLETED, false);
+                } else if (!haveAirtimeFor(txp)) {
+                    // Waiting for the airtime budget, or txp was shed
                 } else {
                     if (isChannelActive()) { // check if there is currently a LoRa packet on the channel
-                        startReceive();      // try receiving this packet, afterwards we'll be trying to transmit again
+                        contention.noteChannelBusy(txp->id, millis());
+                        startReceive(); // try receiving this packet, afterwards we'll be trying to transmit again
                         setTransmitDelay();
                     } else {
+                        contention.noteChannelIdle(millis());
                         // Send any outgoing packets we have ready as fast as possible to keep the time between channel scan and
                         // actual transmission as short as possible
                         txp = txQueue.dequeue();
@@ -284,6 +299,7 @@ void RadioLibInterface::onNotify(uint32_t notification)
                             // Packet has been sent, count it toward our TX airtime utilization.
                             uint32_t xmitMsec = getPacketTime(txp);
                             airTime->logAirtime(TX_LOG, xmitMsec);
+                            airTime->budget.charge(txp, xmitMsec, millis());
                         }
                         LOG_DEBUG("%d packets remain in the TX queue", txQueue.getMaxLen() - txQueue.getFree());
                     }
@@ -298,6 +314,25 @@ void RadioLibInterface::onNotify(uint32_t notification)
     }
 }
 
+bool RadioLibInterface::haveAirtimeFor(meshtastic_MeshPacket *txp)
+{
+    AirtimeClass cls = AirtimeBudget::classify(txp->priority, isFromUs(txp));
+    uint32_t waitMs;
+    if (airTime->budget.mayTransmit(cls, getPacketTime(txp), millis(), &waitMs))
+        return true;
+
+    if (cls == AIRTIME_BACKGROUND && waitMs > AIRTIME_BUDGET_MAX_DEFER_MS) {
+        // It would be stale by the time it could go, drop it so the packets behind it aren't held up
+        LOG_WARN("Airtime budget spent, drop background packet id=0x%08x", txp->id);
+        packetPool.release(txQueue.dequeue());
+        setTransmitDelay();
+    } else {
+        // Check again in a while, a more important packet may have been queued in front by then
+        notifyLater(min(waitMs, (uint32_t)AIRTIME_BUDGET_RECHECK_MS), TRANSMIT_DELAY_COMPLETED, false);
+    }
+    return false;
+}
+
 void RadioLibInterface::setTransmitDelay()
 {
     meshtastic_MeshPacket *p = txQueue.getFront();
@@ -424,6 +459,8 @@ void RadioLibInterface::handleReceiveInterrupt()
     if (state != RADIOLIB_ERR_NONE) {
         LOG_ERROR("Ignore received packet due to error=%d", state);
         rxBad++;
+        if (state == RADIOLIB_ERR_CRC_MISMATCH)
+            contention.noteCollision(millis());
 
         airTime->logAirtime(RX_ALL_LOG, xmitMsec);
 
@@ -464,6 +501,9 @@ void RadioLibInterface::handleReceiveInterrupt()
             mp->relay_node = mp->hop_start == 0 ? NO_RELAY_NODE : radioBuffer.header.relay_node;
 
             addReceiveMetadata(mp);
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+            pipelineStats.begin(mp, lastIsrTicks);
+#endif
 
             mp->which_payload_variant =
                 meshtastic_MeshPacket_encrypted_tag; // Mark that the payload is still encrypted at this point
@@ -526,6 +566,9 @@ bool RadioLibInterface::startSend(meshtastic_MeshPacket *txp)
             // bits
             enableInterrupt(isrTxLevel0);
             lastTxStart = millis();
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+            pipelineStats.stamp(txp, STAGE_TX_STARTED);
+#endif
             printPacket("Started Tx", txp);
         }
 
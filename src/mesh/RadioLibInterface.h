@@ -86,6 +86,11 @@ class RadioLibInterface : public RadioInterface, protected concurrency::Notified
     /// are _trying_ to receive a packet currently (note - we might just be waiting for one)
     bool isReceiving = false;
 
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+    /// PipelineStats::ticks() when the last radio interrupt fired
+    volatile uint32_t lastIsrTicks = 0;
+#endif
+
   public:
     /** Our ISR code currently needs this to find our active instance
      */
@@ -151,6 +156,9 @@ class RadioLibInterface : public RadioInterface, protected concurrency::Notified
      * doing the transmit */
     void setTransmitDelay();
 
+    /** Whether the airtime budget lets txp at the front of the queue go now. If not, either wait for it or shed txp. */
+    bool haveAirtimeFor(meshtastic_MeshPacket *txp);
+
     /**
      * random timer with certain min. and max. settings
      * @return Timestamp after which the packet may be sent
@@ -0,0 +1,193 @@
+#include "RebroadcastSuppressor.h"
+
+#include <string.h>
+
+// Expected extra coverage in percent of the range of a rebroadcast, after hearing the packet from this many relayers
+static const uint8_t extraCoverageAfter[] = {100, 41, 19, 9, 5};
+
+void RebroadcastSuppressor::setRole(meshtastic_Config_DeviceConfig_Role role)
+{
+    switch (role) {
+    case meshtastic_Config_DeviceConfig_Role_ROUTER:
+    case meshtastic_Config_DeviceConfig_Role_REPEATER:
+        minExtraCoverage = REBROADCAST_ROUTER_MIN_EXTRA_COVERAGE;
+        countRelayers = false;
+        break;
+    default:
+        minExtraCoverage = REBROADCAST_MIN_EXTRA_COVERAGE;
+        countRelayers = true;
+        break;
+    }
+}
+
+void RebroadcastSuppressor::expire(uint32_t now)
+{
+    bool ageLinks = now - linksMsec > REBROADCAST_LINKS_EXPIRE_MSEC;
+    if (ageLinks)
+        linksMsec = now;
+    for (size_t i = 0; i < numNodes;) {
+        Node &n = nodes[i];
+        if (n.heard && now - n.heardMsec > REBROADCAST_HEARD_EXPIRE_MSEC)
+            n.heard = false;
+        if (n.hasNeighbors && now - n.neighborsMsec > REBROADCAST_NEIGHBORS_EXPIRE_MSEC)
+            n.hasNeighbors = false;
+        if (ageLinks) {
+            memcpy(n.links[1], n.links[0], sizeof(n.links[1]));
+            memset(n.links[0], 0, sizeof(n.links[0]));
+        }
+        if (!n.heard && !n.hasNeighbors)
+            n = nodes[--numNodes];
+        else
+            i++;
+    }
+}
+
+RebroadcastSuppressor::Node *RebroadcastSuppressor::find(uint8_t id)
+{
+    for (size_t i = 0; i < numNodes; i++)
+        if (nodes[i].id == id)
+            return &nodes[i];
+    return nullptr;
+}
+
+RebroadcastSuppressor::Node *RebroadcastSuppressor::findOrAdd(uint8_t id, uint32_t now)
+{
+    Node *n = find(id);
+    if (n)
+        return n;
+
+    if (numNodes < REBROADCAST_MAX_NODES) {
+        n = &nodes[numNodes++];
+    } else {
+        uint32_t oldest = 0;
+        for (size_t i = 0; i < numNodes; i++) {
+            const Node &c = nodes[i];
+            uint32_t age = UINT32_MAX;
+            if (c.heard)
+                age = now - c.heardMsec;
+            if (c.hasNeighbors && now - c.neighborsMsec < age)
+                age = now - c.neighborsMsec;
+            if (!n || age > oldest) {
+                n = &nodes[i];
+                oldest = age;
+            }
+        }
+    }
+    memset(n, 0, sizeof(*n));
+    n->id = id;
+    return n;
+}
+
+void RebroadcastSuppressor::noteHeard(uint8_t node, uint32_t now)
+{
+    if (!node || node == ourId)
+        return;
+    expire(now);
+    Node *n = findOrAdd(node, now);
+    n->heard = true;
+    n->heardMsec = now;
+}
+
+void RebroadcastSuppressor::noteNeighbors(uint8_t node, const uint8_t *neighbors, size_t count, uint32_t now)
+{
+    if (!node || node == ourId)
+        return;
+    expire(now);
+    Node *n = findOrAdd(node, now);
+    n->hasNeighbors = true;
+    n->neighborsMsec = now;
+    n->numNeighbors = 0;
+    for (size_t i = 0; i < count && n->numNeighbors < REBROADCAST_NEIGHBORS_PER_NODE; i++)
+        if (neighbors[i])
+            n->neighbors[n->numNeighbors++] = neighbors[i];
+}
+
+void RebroadcastSuppressor::noteRelayedFrom(uint8_t relayer, uint8_t sender, uint32_t now)
+{
+    if (!relayer || !sender || relayer == sender || relayer == ourId)
+        return;
+    expire(now);
+    // We heard the relayer, the sender we only care about if it is a neighbor too
+    Node *r = findOrAdd(relayer, now);
+    r->links[0][sender / 32] |= 1UL << (sender % 32);
+    Node *s = find(sender);
+    if (s)
+        s->links[0][relayer / 32] |= 1UL << (relayer % 32);
+}
+
+size_t RebroadcastSuppressor::getNumNeighbors(uint32_t now)
+{
+    expire(now);
+    size_t count = 0;
+    for (size_t i = 0; i < numNodes; i++)
+        count += nodes[i].heard;
+    return count;
+}
+
+int RebroadcastSuppressor::getExtraCoverage(const uint8_t *relayers, size_t count, uint32_t now, bool *complete)
+{
+    expire(now);
+    if (complete)
+        *complete = true;
+
+    // Everybody the relayers reach as far as we know, a bit per last byte
+    uint32_t covered[256 / 32] = {0};
+    size_t numRelayers = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint8_t r = relayers[i];
+        if (!r || r == ourId)
+            continue;
+        covered[r / 32] |= 1UL << (r % 32);
+        numRelayers++;
+
+        const Node *n = find(r);
+        if (complete && (!n || !n->hasNeighbors || n->numNeighbors == REBROADCAST_NEIGHBORS_PER_NODE))
+            *complete = false;
+        if (!n)
+            continue;
+        if (n->hasNeighbors)
+            for (uint8_t j = 0; j < n->numNeighbors; j++)
+                covered[n->neighbors[j] / 32] |= 1UL << (n->neighbors[j] % 32);
+        for (size_t j = 0; j < 256 / 32; j++)
+            covered[j] |= n->links[0][j] | n->links[1][j];
+    }
+
+    size_t neighbors = 0, uncovered = 0;
+    for (size_t i = 0; i < numNodes; i++) {
+        if (!nodes[i].heard)
+            continue;
+        neighbors++;
+        uint8_t id = nodes[i].id;
+        if (!(covered[id / 32] & (1UL << (id % 32))))
+            uncovered++;
+    }
+    if (!numRelayers || !neighbors)
+        return -1;
+    return uncovered * 100 / neighbors;
+}
+
+RebroadcastSuppressor::Verdict RebroadcastSuppressor::judge(const uint8_t *relayers, size_t count, uint32_t now)
+{
+    bool complete = false;
+    int extra = getNumNeighbors(now) >= REBROADCAST_MIN_NEIGHBORS ? getExtraCoverage(relayers, count, now, &complete) : -1;
+    if (extra >= 0 && extra < minExtraCoverage)
+        return REDUNDANT;
+    if (extra >= 0 && complete)
+        return USEFUL;
+    if (!countRelayers)
+        return UNKNOWN;
+
+    // Count the distinct relayers other than us
+    uint8_t distinct[REBROADCAST_NEIGHBORS_PER_NODE];
+    size_t k = 0;
+    for (size_t i = 0; i < count && k < sizeof(distinct); i++) {
+        uint8_t r = relayers[i];
+        if (!r || r == ourId || memchr(distinct, r, k))
+            continue;
+        distinct[k++] = r;
+    }
+    if (!k)
+        return UNKNOWN;
+    uint8_t estimate = extraCoverageAfter[k < sizeof(extraCoverageAfter) ? k : sizeof(extraCoverageAfter) - 1];
+    return estimate < minExtraCoverage ? REDUNDANT : USEFUL;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "MeshTypes.h"
+
+/// How many nodes around us we keep track of, heard directly or known from their NeighborInfo
+#define REBROADCAST_MAX_NODES 32
+
+/// As many neighbors as a NeighborInfo packet carries
+#define REBROADCAST_NEIGHBORS_PER_NODE 10
+
+/// Forget a node we haven't heard directly for this long
+#define REBROADCAST_HEARD_EXPIRE_MSEC (2 * 60 * 60 * 1000UL)
+
+/// Forget a neighbor list after this long, a bit more than the longest NeighborInfo interval
+#define REBROADCAST_NEIGHBORS_EXPIRE_MSEC (13 * 60 * 60 * 1000UL)
+
+/// Forget that two nodes heard each other after between this long and twice as long, about the NodeInfo interval
+#define REBROADCAST_LINKS_EXPIRE_MSEC (3 * 60 * 60 * 1000UL)
+
+/// With fewer neighbors than this we may not have heard them all yet, and there is little airtime to save, so don't go by
+/// coverage
+#ifndef REBROADCAST_MIN_NEIGHBORS
+#define REBROADCAST_MIN_NEIGHBORS 3
+#endif
+
+/// Share of our neighbors a rebroadcast has to reach that no relayer did, in percent, or it is redundant
+#ifndef REBROADCAST_MIN_EXTRA_COVERAGE
+#define REBROADCAST_MIN_EXTRA_COVERAGE 25
+#endif
+/// Routers and repeaters keep going for less, the mesh relies on them
+#ifndef REBROADCAST_ROUTER_MIN_EXTRA_COVERAGE
+#define REBROADCAST_ROUTER_MIN_EXTRA_COVERAGE 10
+#endif
+
+/**
+ * Decides whether rebroadcasting a flooded packet would still reach anybody new.
+ *
+ * Every relayer we hear directly is one of our neighbors. When we are about to relay a broadcast that has already been
+ * relayed by others (as PacketHistory remembers), the neighbors of ours that one of them reaches already got it. If the
+ * share left over is below what the role asks for, our rebroadcast would only cost airtime. Clients want at least
+ * REBROADCAST_MIN_EXTRA_COVERAGE, routers and repeaters go on for less.
+ *
+ * Who the neighbors of a relayer are we learn two ways:
+ * - NeighborInfo packets list them. They are rarely heard, as NeighborInfo isn't sent over LoRa on the default channel.
+ * - The relays we hear anyway. A packet relayed by R one hop from its sender S means R heard S directly. As every node
+ *   sends NodeInfo, position and telemetry now and then, this soon links up the neighbors we share with the relayers.
+ * Links learned from relays are never all of a node's neighbors, and neither are those of a full NeighborInfo. So they
+ * can tell us that a relay is redundant, but not that it is useful.
+ *
+ * When they can't tell, clients go by how many relayers they heard instead: the area a rebroadcast can add after hearing
+ * the packet k times falls off quickly with k (Ni et al., "The broadcast storm problem in a mobile ad hoc network"), so
+ * they cancel after the first duplicate from another relayer, as FloodingRouter always did. Routers and repeaters only
+ * stand down when the neighbors they know of are covered.
+ *
+ * Nodes are known by the last byte of their number only, as that is all relay_node carries.
+ */
+class RebroadcastSuppressor
+{
+  public:
+    enum Verdict { UNKNOWN, USEFUL, REDUNDANT };
+
+    void setRole(meshtastic_Config_DeviceConfig_Role role);
+    /// Our own last byte, which is never a neighbor of ours
+    void setOurRelayId(uint8_t id) { ourId = id; }
+
+    /// We heard a packet relayed (or sent) by node
+    void noteHeard(uint8_t node, uint32_t now);
+    /// node says these are its neighbors
+    void noteNeighbors(uint8_t node, const uint8_t *neighbors, size_t count, uint32_t now);
+    /// relayer relayed a packet one hop from its sender, so the two heard each other
+    void noteRelayedFrom(uint8_t relayer, uint8_t sender, uint32_t now);
+
+    /**
+     * Percent of our neighbors that none of these relayers reaches as far as we know, or -1 if we heard no neighbors. Where
+     * we know only some neighbors of the relayers this is an upper bound.
+     * @param complete if not nullptr, set to whether we know all neighbors of the relayers, not only some of them
+     */
+    int getExtraCoverage(const uint8_t *relayers, size_t count, uint32_t now, bool *complete = nullptr);
+    /// Whether we should still rebroadcast a packet these relayers have already sent, UNKNOWN if there are none
+    Verdict judge(const uint8_t *relayers, size_t count, uint32_t now);
+
+    /// Nodes we have heard directly lately
+    size_t getNumNeighbors(uint32_t now);
+
+  private:
+    struct Node {
+        uint8_t id;
+        bool heard;        // Directly, so it is one of our neighbors
+        bool hasNeighbors; // We know its neighbors from NeighborInfo
+        uint8_t numNeighbors;
+        uint8_t neighbors[REBROADCAST_NEIGHBORS_PER_NODE];
+        uint32_t heardMsec;
+        uint32_t neighborsMsec;
+        uint32_t links[2][256 / 32]; // Nodes heard relaying it or relayed by it, a bit per last byte. [1] is older.
+    };
+
+    Node nodes[REBROADCAST_MAX_NODES];
+    size_t numNodes = 0;
+    uint8_t ourId = 0;
+    uint8_t minExtraCoverage = REBROADCAST_MIN_EXTRA_COVERAGE;
+    bool countRelayers = true; // Without neighbor lists, go by the number of relayers
+    uint32_t linksMsec = 0;    // When links[0] of every node was started
+
+    /// Drop what is too old to go by
+    void expire(uint32_t now);
+    Node *find(uint8_t id);
+    /// Find the entry for id, or make one, replacing the one we have known least about for longest if full
+    Node *findOrAdd(uint8_t id, uint32_t now);
+};
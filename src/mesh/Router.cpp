@@ -15,7 +15,14 @@
 #include "mqtt/MQTT.h"
 #endif
 #include "Default.h"
+#if !MESHTASTIC_EXCLUDE_COMPRESSION
+#include "PayloadCompression.h"
+#endif
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+#include "PipelineStats.h"
+#endif
 #if ARCH_PORTDUINO
+#include "platform/portduino/PacketCapture.h"
 #include "platform/portduino/PortduinoGlue.h"
 #endif
 #if ENABLE_JSON_LOGGING || ARCH_PORTDUINO
@@ -80,6 +87,9 @@ int32_t Router::runOnce()
  */
 void Router::enqueueReceivedMessage(meshtastic_MeshPacket *p)
 {
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+    pipelineStats.stamp(p, STAGE_RX_QUEUED);
+#endif
     // Try enqueue until successful
     while (!fromRadioQueue.enqueue(p, 0)) {
         meshtastic_MeshPacket *old_p;
@@ -271,6 +281,10 @@ ErrorCode Router::send(meshtastic_MeshPacket *p)
 
     fixPriority(p); // Before encryption, fix the priority if it's unset
 
+    // The radio only sees the encrypted packet, tell it the port for airtime accounting
+    airTime->budget.notePort(p, p->which_payload_variant == meshtastic_MeshPacket_decoded_tag ? p->decoded.portnum
+                                                                                              : meshtastic_PortNum_UNKNOWN_APP);
+
     // If the packet is not yet encrypted, do so now
     if (p->which_payload_variant == meshtastic_MeshPacket_decoded_tag) {
         ChannelIndex chIndex = p->channel; // keep as a local because we are about to change it
@@ -299,6 +313,9 @@ ErrorCode Router::send(meshtastic_MeshPacket *p)
 #endif
 
     assert(iface); // This should have been detected already in sendLocal (or we just received a packet from outside)
+#if ARCH_PORTDUINO
+    packetCapture.recordEncrypted(p, CAPTURE_TX, iface->getFreq());
+#endif
     return iface->send(p);
 }
 
@@ -330,8 +347,6 @@ void Router::sniffReceived(const meshtastic_MeshPacket *p, const meshtastic_Rout
 
 DecodeState perhapsDecode(meshtastic_MeshPacket *p)
 {
-    concurrency::LockGuard g(cryptLock);
-
     if (config.device.role == meshtastic_Config_DeviceConfig_Role_REPEATER &&
         config.device.rebroadcast_mode == meshtastic_Config_DeviceConfig_RebroadcastMode_ALL_SKIP_DECODING)
         return DecodeState::DECODE_FAILURE;
@@ -357,6 +372,8 @@ DecodeState perhapsDecode(meshtastic_MeshPacket *p)
     if (p->channel == 0 && isToUs(p) && p->to > 0 && !isBroadcast(p->to) && nodeDB->getMeshNode(p->from) != nullptr &&
         nodeDB->getMeshNode(p->from)->user.public_key.size > 0 && nodeDB->getMeshNode(p->to)->user.public_key.size > 0 &&
         rawSize > MESHTASTIC_PKC_OVERHEAD) {
+        // PKI still works on the engine's own keys and our scratch buffer
+        concurrency::LockGuard g(cryptLock);
         LOG_DEBUG("Attempt PKI decryption");
 
         if (crypto->decryptCurve25519(p->from, nodeDB->getMeshNode(p->from)->user.public_key, p->id, rawSize, p->encrypted.bytes,
@@ -387,22 +404,23 @@ DecodeState perhapsDecode(meshtastic_MeshPacket *p)
 
     // assert(p->which_payloadVariant == MeshPacket_encrypted_tag);
     if (!decrypted) {
+        // A context of our own, so that channel decryption doesn't need cryptLock
+        CryptoContext ctx;
         // Try to find a channel that works with this hash
         for (chIndex = 0; chIndex < channels.getNumChannels(); chIndex++) {
             // Try to use this hash/channel pair
-            if (channels.decryptForHash(chIndex, p->channel)) {
-                // we have to copy into a scratch buffer, because these bytes are a union with the decoded protobuf. Create a
-                // fresh copy for each decrypt attempt.
-                memcpy(bytes, p->encrypted.bytes, rawSize);
-                // Try to decrypt the packet if we can
-                crypto->decrypt(p->from, p->id, rawSize, bytes);
+            if (channels.getKeyForHash(chIndex, p->channel, ctx.key)) {
+                // Try to decrypt the packet if we can. The plaintext goes to the context's scratch buffer, because the
+                // encrypted bytes are a union with the decoded protobuf.
+                if (!crypto->cryptPacket(ctx, p->from, p->id, p->encrypted.bytes, rawSize))
+                    break;
 
-                // printBytes("plaintext", bytes, p->encrypted.size);
+                // printBytes("plaintext", ctx.scratch, p->encrypted.size);
 
                 // Take those raw bytes and convert them back into a well structured protobuf we can understand
                 meshtastic_Data decodedtmp;
                 memset(&decodedtmp, 0, sizeof(decodedtmp));
-                if (!pb_decode_from_bytes(bytes, rawSize, &meshtastic_Data_msg, &decodedtmp)) {
+                if (!pb_decode_from_bytes(ctx.scratch, rawSize, &meshtastic_Data_msg, &decodedtmp)) {
                     LOG_ERROR("Invalid protobufs in received mesh packet id=0x%08x (bad psk?)!", p->id);
                 } else if (decodedtmp.portnum == meshtastic_PortNum_UNKNOWN_APP) {
                     LOG_ERROR("Invalid portnum (bad psk?)!");
@@ -416,36 +434,31 @@ DecodeState perhapsDecode(meshtastic_MeshPacket *p)
         }
     }
     if (decrypted) {
+        // Compression dictionaries and packet capture are still shared
+        concurrency::LockGuard g(cryptLock);
         // parsing was successful
         p->channel = chIndex; // change to store the index instead of the hash
         if (p->decoded.has_bitfield)
             p->decoded.want_response |= p->decoded.bitfield & BITFIELD_WANT_RESPONSE_MASK;
 
-        /* Not actually ever used.
-        // Decompress if needed. jm
-        if (p->decoded.portnum == meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP) {
-            // Decompress the payload
-            char compressed_in[meshtastic_Constants_DATA_PAYLOAD_LEN] = {};
-            char decompressed_out[meshtastic_Constants_DATA_PAYLOAD_LEN] = {};
-            int decompressed_len;
-
-            memcpy(compressed_in, p->decoded.payload.bytes, p->decoded.payload.size);
-
-            decompressed_len = unishox2_decompress_simple(compressed_in, p->decoded.payload.size, decompressed_out);
-
-            // LOG_DEBUG("**Decompressed length - %d ", decompressed_len);
-
-            memcpy(p->decoded.payload.bytes, decompressed_out, decompressed_len);
-
-            // Switch the port from PortNum_TEXT_MESSAGE_COMPRESSED_APP to PortNum_TEXT_MESSAGE_APP
-            p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
-        } */
+#if !MESHTASTIC_EXCLUDE_COMPRESSION
+        if (!isFromUs(p))
+            payloadCompression.noteSender(chIndex, p->decoded);
+        if (p->decoded.has_bitfield && (p->decoded.bitfield & BITFIELD_COMPRESSED_MASK)) {
+            if (!payloadCompression.decompress(p->decoded)) {
+                LOG_WARN("Failed to decompress payload of packet id=0x%08x (unknown dictionary?)", p->id);
+                return DecodeState::DECODE_FAILURE;
+            }
+            payloadCompression.noteCompressed(getFrom(p), p->id);
+        }
+#endif
 
         printPacket("decoded message", p);
 #if ENABLE_JSON_LOGGING
         LOG_TRACE("%s", MeshPacketSerializer::JsonSerialize(p, false).c_str());
 #elif ARCH_PORTDUINO
-        if (settingsStrings[traceFilename] != "" || settingsMap[logoutputlevel] == level_trace) {
+        packetCapture.recordDecoded(p);
+        if (!settingsStrings[traceFilename].empty() || settingsMap[logoutputlevel] == level_trace) {
             LOG_TRACE("%s", MeshPacketSerializer::JsonSerialize(p, false).c_str());
         }
 #endif
@@ -458,7 +471,7 @@ DecodeState perhapsDecode(meshtastic_MeshPacket *p)
 
 /** Return 0 for success or a Routing_Error code for failure
  */
-meshtastic_Routing_Error perhapsEncode(meshtastic_MeshPacket *p)
+meshtastic_Routing_Error perhapsEncode(meshtastic_MeshPacket *p, bool allowCompression)
 {
     concurrency::LockGuard g(cryptLock);
 
@@ -470,44 +483,22 @@ meshtastic_Routing_Error perhapsEncode(meshtastic_MeshPacket *p)
             p->decoded.has_bitfield = true;
             p->decoded.bitfield |= (config.lora.config_ok_to_mqtt << BITFIELD_OK_TO_MQTT_SHIFT);
             p->decoded.bitfield |= (p->decoded.want_response << BITFIELD_WANT_RESPONSE_SHIFT);
+#if !MESHTASTIC_EXCLUDE_COMPRESSION
+            p->decoded.bitfield |= BITFIELD_COMPRESSION_CAPABLE_MASK;
+#endif
         }
 
-        size_t numbytes = pb_encode_to_bytes(bytes, sizeof(bytes), &meshtastic_Data_msg, &p->decoded);
-
-        /* Not actually used, so save the cycles
-        //  TODO: Allow modules to opt into compression.
-        if (p->decoded.portnum == meshtastic_PortNum_TEXT_MESSAGE_APP) {
-
-            char original_payload[meshtastic_Constants_DATA_PAYLOAD_LEN];
-            memcpy(original_payload, p->decoded.payload.bytes, p->decoded.payload.size);
-
-            char compressed_out[meshtastic_Constants_DATA_PAYLOAD_LEN] = {0};
-
-            int compressed_len;
-            compressed_len = unishox2_compress_simple(original_payload, p->decoded.payload.size, compressed_out);
-
-            LOG_DEBUG("Original length - %d ", p->decoded.payload.size);
-            LOG_DEBUG("Compressed length - %d ", compressed_len);
-            LOG_DEBUG("Original message - %s ", p->decoded.payload.bytes);
-
-            // If the compressed length is greater than or equal to the original size, don't use the compressed form
-            if (compressed_len >= p->decoded.payload.size) {
-
-                LOG_DEBUG("Not using compressing message");
-                // Set the uncompressed payload variant anyway. Shouldn't hurt?
-                // p->decoded.which_payloadVariant = Data_payload_tag;
-
-                // Otherwise we use the compressor
-            } else {
-                LOG_DEBUG("Use compressed message");
-                // Copy the compressed data into the meshpacket
-
-                p->decoded.payload.size = compressed_len;
-                memcpy(p->decoded.payload.bytes, compressed_out, compressed_len);
-
-                p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_COMPRESSED_APP;
-            }
-        } */
+        const meshtastic_Data *data = &p->decoded;
+#if !MESHTASTIC_EXCLUDE_COMPRESSION
+        // Packets we originate, and relayed ones that arrived compressed: perhapsDecode() restored their payload
+        meshtastic_Data compressed;
+        if (allowCompression && (isFromUs(p) || payloadCompression.wasCompressed(getFrom(p), p->id)) &&
+            payloadCompression.isNegotiated(p->channel) && payloadCompression.compress(p->decoded, compressed)) {
+            data = &compressed;
+            payloadCompression.noteCompressed(getFrom(p), p->id);
+        }
+#endif
+        size_t numbytes = pb_encode_to_bytes(bytes, sizeof(bytes), &meshtastic_Data_msg, data);
 
         if (numbytes + MESHTASTIC_HEADER_LENGTH > MAX_LORA_PAYLOAD_LEN)
             return meshtastic_Routing_Error_TOO_LARGE;
@@ -608,6 +599,9 @@ void Router::handleReceived(meshtastic_MeshPacket *p, RxSource src)
 
     // Take those raw bytes and convert them back into a well structured protobuf we can understand
     auto decodedState = perhapsDecode(p);
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+    pipelineStats.stamp(p, STAGE_DECODED);
+#endif
     if (decodedState == DecodeState::DECODE_FATAL) {
         // Fatal decoding error, we can't do anything with this packet
         LOG_WARN("Fatal decode error, dropping packet");
@@ -652,6 +646,9 @@ void Router::handleReceived(meshtastic_MeshPacket *p, RxSource src)
     // call modules here
     if (!skipHandle) {
         MeshModule::callModules(*p, src);
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+        pipelineStats.stamp(p, STAGE_DISPATCHED);
+#endif
 
 #if !MESHTASTIC_EXCLUDE_MQTT
         // Mark as pki_encrypted if it is not yet decoded and MQTT encryption is also enabled, hash matches and it's a DM not to
@@ -677,10 +674,12 @@ void Router::perhapsHandleReceived(meshtastic_MeshPacket *p)
     LOG_TRACE("%s", MeshPacketSerializer::JsonSerializeEncrypted(p).c_str());
 #elif ARCH_PORTDUINO
     // Even ignored packets get logged in the trace
-    if (settingsStrings[traceFilename] != "" || settingsMap[logoutputlevel] == level_trace) {
+    bool jsonTrace = !settingsStrings[traceFilename].empty() || settingsMap[logoutputlevel] == level_trace;
+    if (jsonTrace || packetCapture.isOpen())
         p->rx_time = getValidTime(RTCQualityFromNet); // store the arrival timestamp for the phone
+    packetCapture.recordEncrypted(p, CAPTURE_RX, iface ? iface->getFreq() : 0);
+    if (jsonTrace)
         LOG_TRACE("%s", MeshPacketSerializer::JsonSerializeEncrypted(p).c_str());
-    }
 #endif
     // assert(radioConfig.has_preferences);
     if (is_in_repeated(config.lora.ignore_incoming, p->from)) {
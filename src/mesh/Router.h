@@ -59,6 +59,9 @@ class Router : protected concurrency::OSThread, protected PacketHistory
      */
     meshtastic_MeshPacket *allocForSending();
 
+    /// How many received packets are waiting to be processed
+    size_t getNumFromRadioQueued() { return fromRadioQueue.numUsed(); }
+
     /** Return Underlying interface's TX queue status */
     meshtastic_QueueStatus getQueueStatus();
 
@@ -150,8 +153,10 @@ enum DecodeState { DECODE_SUCCESS, DECODE_FAILURE, DECODE_FATAL };
 DecodeState perhapsDecode(meshtastic_MeshPacket *p);
 
 /** Return 0 for success or a Routing_Error code for failure
+ *
+ * @param allowCompression false to always encode the original payload, for MQTT clients that can't decompress it
  */
-meshtastic_Routing_Error perhapsEncode(meshtastic_MeshPacket *p);
+meshtastic_Routing_Error perhapsEncode(meshtastic_MeshPacket *p, bool allowCompression = true);
 
 extern Router *router;
 
@@ -159,7 +164,11 @@ extern Router *router;
 // FIXME, move this someplace better
 PacketId generatePacketId();
 
+#define BITFIELD_COMPRESSED_SHIFT 3
+#define BITFIELD_COMPRESSION_CAPABLE_SHIFT 2
 #define BITFIELD_WANT_RESPONSE_SHIFT 1
 #define BITFIELD_OK_TO_MQTT_SHIFT 0
+#define BITFIELD_COMPRESSED_MASK (1 << BITFIELD_COMPRESSED_SHIFT)
+#define BITFIELD_COMPRESSION_CAPABLE_MASK (1 << BITFIELD_COMPRESSION_CAPABLE_SHIFT)
 #define BITFIELD_WANT_RESPONSE_MASK (1 << BITFIELD_WANT_RESPONSE_SHIFT)
 #define BITFIELD_OK_TO_MQTT_MASK (1 << BITFIELD_OK_TO_MQTT_SHIFT)
\ No newline at end of file
@@ -4,9 +4,7 @@
 #include "Throttle.h"
 #include "configuration.h"
 
-#define START1 0x94
-#define START2 0xc3
-#define HEADER_LEN 4
+#include <algorithm>
 
 int32_t StreamAPI::runOncePart()
 {
@@ -26,47 +24,21 @@ int32_t StreamAPI::readStream()
         bool recentRx = Throttle::isWithinTimespanMs(lastRxMsec, 2000);
         return recentRx ? 5 : 250;
     } else {
-        while (stream->available()) { // Currently we never want to block
-            int cInt = stream->read();
-            if (cInt < 0)
+        uint8_t chunk[STREAM_RX_CHUNK_SIZE];
+        int available;
+        while ((available = stream->available()) > 0) { // Currently we never want to block
+            size_t len = readAvailable(chunk, std::min((size_t)available, sizeof(chunk)));
+            if (len == 0)
                 break; // We ran out of characters (even though available said otherwise) - this can happen on rf52 adafruit
                        // arduino
 
-            uint8_t c = (uint8_t)cInt;
-
-            // Use the read pointer for a little state machine, first look for framing, then length bytes, then payload
-            size_t ptr = rxPtr;
-
-            rxPtr++;        // assume we will probably advance the rxPtr
-            rxBuf[ptr] = c; // store all bytes (including framing)
-
-            // console->printf("rxPtr %d ptr=%d c=0x%x\n", rxPtr, ptr, c);
-
-            if (ptr == 0) { // looking for START1
-                if (c != START1)
-                    rxPtr = 0;     // failed to find framing
-            } else if (ptr == 1) { // looking for START2
-                if (c != START2)
-                    rxPtr = 0;                             // failed to find framing
-            } else if (ptr >= HEADER_LEN - 1) {            // we have at least read our 4 byte framing
-                uint32_t len = (rxBuf[2] << 8) + rxBuf[3]; // big endian 16 bit length follows framing
-
-                // console->printf("len %d\n", len);
-
-                if (ptr == HEADER_LEN - 1) {
-                    // we _just_ finished our 4 byte header, validate length now (note: a length of zero is a valid
-                    // protobuf also)
-                    if (len > MAX_TO_FROM_RADIO_SIZE)
-                        rxPtr = 0; // length is bogus, restart search for framing
-                }
-
-                if (rxPtr != 0)                        // Is packet still considered 'good'?
-                    if (ptr + 1 >= len + HEADER_LEN) { // have we received all of the payload?
-                        rxPtr = 0;                     // start over again on the next packet
-
-                        // If we didn't just fail the packet and we now have the right # of bytes, parse it
-                        handleToRadio(rxBuf + HEADER_LEN, len);
-                    }
+            const uint8_t *bytes = chunk;
+            while (len) {
+                size_t used = framer.feed(bytes, len);
+                bytes += used;
+                len -= used;
+                if (framer.hasFrame())
+                    handleToRadio(framer.getPayload(), framer.getPayloadLen());
             }
         }
 
@@ -76,18 +48,53 @@ int32_t StreamAPI::readStream()
     }
 }
 
+size_t StreamAPI::readAvailable(uint8_t *buf, size_t len)
+{
+    size_t n = 0;
+    while (n < len) {
+        int c = stream->read();
+        if (c < 0)
+            break;
+        buf[n++] = (uint8_t)c;
+    }
+    return n;
+}
+
+static void writeHeader(uint8_t *buf, size_t len)
+{
+    buf[0] = STREAM_FRAME_START1;
+    buf[1] = STREAM_FRAME_START2;
+    buf[2] = (len >> 8) & 0xff;
+    buf[3] = len & 0xff;
+}
+
 /**
  * call getFromRadio() and deliver encapsulated packets to the Stream
  */
 void StreamAPI::writeStream()
 {
     if (canWrite) {
-        uint32_t len;
-        do {
-            // Send every packet we can
-            len = getFromRadio(txBuf + HEADER_LEN);
-            emitTxBuffer(len);
-        } while (len);
+        // Send every packet we can, as many to a write as fit in txBuf
+        writingPackets = true;
+        bool more = true;
+        while (more) {
+            size_t used = 0;
+            while (used + MAX_STREAM_BUF_SIZE <= sizeof(txBuf)) {
+                size_t len = getFromRadio(txBuf + used + STREAM_FRAME_HEADER_LEN);
+                if (!len) {
+                    more = false;
+                    break;
+                }
+                writeHeader(txBuf + used, len);
+                used += STREAM_FRAME_HEADER_LEN + len;
+            }
+            if (used) {
+                stream->write(txBuf, used);
+                stream->flush();
+            }
+        }
+        writingPackets = false;
+        packetsWaiting = false;
     }
 }
 
@@ -97,17 +104,18 @@ void StreamAPI::writeStream()
 void StreamAPI::emitTxBuffer(size_t len)
 {
     if (len != 0) {
-        txBuf[0] = START1;
-        txBuf[1] = START2;
-        txBuf[2] = (len >> 8) & 0xff;
-        txBuf[3] = len & 0xff;
-
-        auto totalLen = len + HEADER_LEN;
-        stream->write(txBuf, totalLen);
+        writeHeader(txBuf, len);
+        stream->write(txBuf, len + STREAM_FRAME_HEADER_LEN);
         stream->flush();
     }
 }
 
+void StreamAPI::emitFromRadioScratch()
+{
+    emitTxBuffer(pb_encode_to_bytes(txBuf + STREAM_FRAME_HEADER_LEN, meshtastic_FromRadio_size, &meshtastic_FromRadio_msg,
+                                    &fromRadioScratch));
+}
+
 void StreamAPI::emitRebooted()
 {
     // In case we send a FromRadio packet
@@ -116,10 +124,10 @@ void StreamAPI::emitRebooted()
     fromRadioScratch.rebooted = true;
 
     // LOG_DEBUG("Emitting reboot packet for serial shell");
-    emitTxBuffer(pb_encode_to_bytes(txBuf + HEADER_LEN, meshtastic_FromRadio_size, &meshtastic_FromRadio_msg, &fromRadioScratch));
+    emitFromRadioScratch();
 }
 
-void StreamAPI::emitLogRecord(meshtastic_LogRecord_Level level, const char *src, const char *format, va_list arg)
+void StreamAPI::beginLogRecord(meshtastic_LogRecord_Level level, const char *src)
 {
     // In case we send a FromRadio packet
     memset(&fromRadioScratch, 0, sizeof(fromRadioScratch));
@@ -129,13 +137,36 @@ void StreamAPI::emitLogRecord(meshtastic_LogRecord_Level level, const char *src,
     uint32_t rtc_sec = getValidTime(RTCQuality::RTCQualityDevice, true);
     fromRadioScratch.log_record.time = rtc_sec;
     strncpy(fromRadioScratch.log_record.source, src, sizeof(fromRadioScratch.log_record.source) - 1);
+}
 
+void StreamAPI::emitLogRecord(meshtastic_LogRecord_Level level, const char *src, const char *format, va_list arg)
+{
+    // Packets have the link first. Logging from inside getFromRadio() would also overwrite the batch being put together.
+    if (writingPackets || packetsWaiting) {
+        droppedLogRecords++;
+        return;
+    }
+    if (droppedLogRecords) {
+        beginLogRecord(meshtastic_LogRecord_Level_WARNING, "StreamAPI");
+        snprintf(fromRadioScratch.log_record.message, sizeof(fromRadioScratch.log_record.message),
+                 "%u log records dropped to send packets first", (unsigned)droppedLogRecords);
+        droppedLogRecords = 0;
+        emitFromRadioScratch();
+    }
+
+    beginLogRecord(level, src);
     auto num_printed =
         vsnprintf(fromRadioScratch.log_record.message, sizeof(fromRadioScratch.log_record.message) - 1, format, arg);
     if (num_printed > 0 && fromRadioScratch.log_record.message[num_printed - 1] ==
                                '\n') // Strip any ending newline, because we have records for framing instead.
         fromRadioScratch.log_record.message[num_printed - 1] = '\0';
-    emitTxBuffer(pb_encode_to_bytes(txBuf + HEADER_LEN, meshtastic_FromRadio_size, &meshtastic_FromRadio_msg, &fromRadioScratch));
+    emitFromRadioScratch();
+}
+
+void StreamAPI::onNowHasData(uint32_t fromRadioNum)
+{
+    packetsWaiting = true;
+    wakeForWrite();
 }
 
 /// Hookable to find out when connection changes
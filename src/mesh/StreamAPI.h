@@ -2,12 +2,28 @@
 
 #include "PhoneAPI.h"
 #include "Stream.h"
+#include "StreamFramer.h"
 #include "concurrency/OSThread.h"
 #include <cstdarg>
 
 // A To/FromRadio packet + our 32 bit header
 #define MAX_STREAM_BUF_SIZE (MAX_TO_FROM_RADIO_SIZE + sizeof(uint32_t))
 
+// Room for this many worst case FromRadio packets in txBuf. Real packets are much smaller, so writeStream() usually
+// packs several more than this into each write.
+#ifndef STREAM_TX_BATCH_FRAMES
+#if defined(ARCH_PORTDUINO)
+#define STREAM_TX_BATCH_FRAMES 4
+#elif defined(ARCH_ESP32)
+#define STREAM_TX_BATCH_FRAMES 2
+#else
+#define STREAM_TX_BATCH_FRAMES 1
+#endif
+#endif
+
+// Bytes taken from the stream per read, on the stack
+#define STREAM_RX_CHUNK_SIZE 64
+
 /**
  * A version of our 'phone' API that talks over a Stream.  So therefore well suited to use with serial links
  * or TCP connections.
@@ -37,7 +53,7 @@ class StreamAPI : public PhoneAPI
     Stream *stream;
 
     uint8_t rxBuf[MAX_STREAM_BUF_SIZE] = {0};
-    size_t rxPtr = 0;
+    StreamFramer framer = StreamFramer(rxBuf, MAX_TO_FROM_RADIO_SIZE);
 
     /// time of last rx, used, to slow down our polling if we haven't heard from anyone
     uint32_t lastRxMsec = 0;
@@ -62,6 +78,14 @@ class StreamAPI : public PhoneAPI
      */
     void writeStream();
 
+    /// Packets go out before log records: set while writeStream() fills txBuf, and while packets wait for it to run
+    bool writingPackets = false;
+    bool packetsWaiting = false;
+    uint32_t droppedLogRecords = 0;
+
+    /// Start a log record in fromRadioScratch
+    void beginLogRecord(meshtastic_LogRecord_Level level, const char *src);
+
   protected:
     /**
      * Send a FromRadio.rebooted = true packet to the phone
@@ -70,6 +94,15 @@ class StreamAPI : public PhoneAPI
 
     virtual void onConnectionChanged(bool connected) override;
 
+    /// Wakes our thread to send the new packets rather than waiting for the next poll
+    virtual void onNowHasData(uint32_t fromRadioNum) override;
+
+    /// Subclasses should make runOncePart() get called soon
+    virtual void wakeForWrite() {}
+
+    /// Read up to len bytes that are already available. Subclasses whose link can read in bulk should override this.
+    virtual size_t readAvailable(uint8_t *buf, size_t len);
+
     /// Check the current underlying physical link to see if the client is currently connected
     virtual bool checkIsConnected() override = 0;
 
@@ -78,11 +111,14 @@ class StreamAPI : public PhoneAPI
      */
     void emitTxBuffer(size_t len);
 
+    /// Encode fromRadioScratch into txBuf and send it
+    void emitFromRadioScratch();
+
     /// Are we allowed to write packets to our output stream (subclasses can turn this off - i.e. SerialConsole)
     bool canWrite = true;
 
     /// Subclasses can use this scratch buffer if they wish
-    uint8_t txBuf[MAX_STREAM_BUF_SIZE] = {0};
+    uint8_t txBuf[MAX_STREAM_BUF_SIZE * STREAM_TX_BATCH_FRAMES] = {0};
 
     /// Low level function to emit a protobuf encapsulated log record
     void emitLogRecord(meshtastic_LogRecord_Level level, const char *src, const char *format, va_list arg);
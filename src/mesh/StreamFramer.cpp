@@ -0,0 +1,56 @@
+#include "StreamFramer.h"
+
+#include <string.h>
+
+size_t StreamFramer::feed(const uint8_t *bytes, size_t len)
+{
+    if (complete) {
+        rxPtr = 0;
+        complete = false;
+    }
+
+    size_t used = 0;
+    while (used < len) {
+        if (rxPtr == 0) {
+            // Skip ahead to anything that could start a frame
+            const uint8_t *start = (const uint8_t *)memchr(bytes + used, STREAM_FRAME_START1, len - used);
+            if (!start)
+                return len;
+            used = start - bytes + 1;
+            buf[rxPtr++] = STREAM_FRAME_START1;
+            continue;
+        }
+
+        if (rxPtr < STREAM_FRAME_HEADER_LEN) {
+            uint8_t c = bytes[used];
+            if (rxPtr == 1 && c != STREAM_FRAME_START2) {
+                // Not framing after all, but this byte could still be the start of some
+                rxPtr = 0;
+                continue;
+            }
+            used++;
+            buf[rxPtr++] = c;
+            if (rxPtr < STREAM_FRAME_HEADER_LEN)
+                continue;
+
+            // Big endian 16 bit length follows framing (note: a length of zero is a valid protobuf also)
+            payloadLen = (buf[2] << 8) | buf[3];
+            if (payloadLen > maxPayload) {
+                rxPtr = 0; // length is bogus, restart search for framing
+                continue;
+            }
+        } else {
+            size_t wanted = STREAM_FRAME_HEADER_LEN + payloadLen - rxPtr;
+            size_t n = len - used < wanted ? len - used : wanted;
+            memcpy(buf + rxPtr, bytes + used, n);
+            rxPtr += n;
+            used += n;
+        }
+
+        if (rxPtr == STREAM_FRAME_HEADER_LEN + payloadLen) {
+            complete = true;
+            break;
+        }
+    }
+    return used;
+}
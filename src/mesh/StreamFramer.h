@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define STREAM_FRAME_START1 0x94
+#define STREAM_FRAME_START2 0xc3
+#define STREAM_FRAME_HEADER_LEN 4
+
+/**
+ * Splits a byte stream into our 0x94C3 framed packets (see StreamAPI for the wire encoding), taking the bytes in whatever
+ * chunks they arrive in. Anything between frames, such as debug text, is skipped over.
+ */
+class StreamFramer
+{
+  public:
+    /// buf must have room for a header and maxPayload bytes
+    StreamFramer(uint8_t *buf, size_t maxPayload) : buf(buf), maxPayload(maxPayload) {}
+
+    /**
+     * Take bytes until a whole frame has arrived or they run out
+     * @return how many bytes were used. If that completed a frame, hasFrame() is true until the next call.
+     */
+    size_t feed(const uint8_t *bytes, size_t len);
+
+    bool hasFrame() const { return complete; }
+    const uint8_t *getPayload() const { return buf + STREAM_FRAME_HEADER_LEN; }
+    size_t getPayloadLen() const { return payloadLen; }
+
+  private:
+    uint8_t *buf;
+    size_t maxPayload;
+    size_t rxPtr = 0; // Bytes of the current frame we have, header included
+    size_t payloadLen = 0;
+    bool complete = false;
+};
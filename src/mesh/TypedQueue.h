@@ -6,7 +6,7 @@
 #include "concurrency/OSThread.h"
 #include "freertosinc.h"
 
-#ifdef HAS_FREE_RTOS
+#if defined(HAS_FREE_RTOS) && !defined(ARCH_ESP32)
 
 /**
  * A wrapper for freertos queues.  Note: each element object should be small
@@ -17,6 +17,17 @@ template <class T> class TypedQueue
     static_assert(std::is_standard_layout<T>::value, "T must be standard layout");
     QueueHandle_t h;
     concurrency::OSThread *reader = NULL;
+    uint32_t overflows = 0;
+    int maxUsed = 0;
+
+    bool noteEnqueued(bool ok)
+    {
+        if (!ok)
+            overflows++;
+        else if (numUsed() > maxUsed)
+            maxUsed = numUsed();
+        return ok;
+    }
 
   public:
     explicit TypedQueue(int maxElements) : h(xQueueCreate(maxElements, sizeof(T))) { assert(h); }
@@ -37,7 +48,7 @@ template <class T> class TypedQueue
             reader->setInterval(0);
             concurrency::mainDelay.interrupt();
         }
-        return xQueueSendToBack(h, &x, maxWait) == pdTRUE;
+        return noteEnqueued(xQueueSendToBack(h, &x, maxWait) == pdTRUE);
     }
 
     bool enqueueFromISR(T x, BaseType_t *higherPriWoken)
@@ -46,7 +57,10 @@ template <class T> class TypedQueue
             reader->setInterval(0);
             concurrency::mainDelay.interruptFromISR(higherPriWoken);
         }
-        return xQueueSendToBackFromISR(h, &x, higherPriWoken) == pdTRUE;
+        bool ok = xQueueSendToBackFromISR(h, &x, higherPriWoken) == pdTRUE;
+        if (!ok)
+            overflows++;
+        return ok;
     }
 
     bool dequeue(T *p, TickType_t maxWait = portMAX_DELAY) { return xQueueReceive(h, p, maxWait) == pdTRUE; }
@@ -60,65 +74,197 @@ template <class T> class TypedQueue
      * Note: thread will not be automatically enabled, just have its interval set to 0
      */
     void setReader(concurrency::OSThread *t) { reader = t; }
+
+    /// How many elements were turned away because the queue was full
+    uint32_t getOverflows() { return overflows; }
+
+    /// The most elements that were ever waiting at once
+    int getMaxUsed() { return maxUsed; }
 };
 
 #else
 
-#include <queue>
+#include <atomic>
 
 /**
- * A wrapper for freertos queues.  Note: each element object should be small
- * and POD (Plain Old Data type) as elements are memcpied by value.
+ * A bounded lock-free queue, used on ESP32 and native instead of a FreeRTOS queue. Note: each element object should be small
+ * and POD (Plain Old Data type) as elements are copied by value.
+ *
+ * Any number of threads (and ISRs) may enqueue at once without taking a lock or a critical section. It is meant for one
+ * reader, but producers that drop the oldest element to make room may dequeue too, so dequeue is safe from several threads
+ * as well. Each slot carries a sequence number saying whose turn it is (D. Vyukov's bounded queue), so a thread that
+ * is preempted half way through only holds up its own slot, never the whole queue.
+ *
+ * The queue never blocks on native. On ESP32 a non-zero maxWait polls once a tick until there is room, or an element.
  */
 template <class T> class TypedQueue
 {
-    std::queue<T> q;
-    concurrency::OSThread *reader = NULL;
+    static_assert(std::is_standard_layout<T>::value, "T must be standard layout");
+
+    struct Cell {
+        std::atomic<uint32_t> seq;
+        T value;
+    };
+
+    Cell *cells;
+    uint32_t mask; // Number of cells - 1, a power of two
     int maxElements;
+    std::atomic<uint32_t> head; // Position of the next element to dequeue
+    std::atomic<uint32_t> tail; // Position of the next element to enqueue
+    std::atomic<uint32_t> overflows;
+    std::atomic<int> maxUsed;
+    concurrency::OSThread *reader = NULL;
 
-  public:
-    explicit TypedQueue(int _maxElements) : maxElements(_maxElements) {}
+    bool tryEnqueue(const T &x)
+    {
+        uint32_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            if ((int32_t)(pos - head.load(std::memory_order_acquire)) >= maxElements)
+                return false;
+            Cell &c = cells[pos & mask];
+            int32_t diff = (int32_t)(c.seq.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    c.value = x;
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // The element a lap ahead of us is still being read
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
 
-    int numFree()
+    bool tryDequeue(T *p)
     {
-        if (maxElements <= 0)
-            return 1; // Always claim 1 free, because we can grow to any size
-        return maxElements - numUsed();
+        uint32_t pos = head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &c = cells[pos & mask];
+            int32_t diff = (int32_t)(c.seq.load(std::memory_order_acquire) - (pos + 1));
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    *p = c.value;
+                    c.seq.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Empty, or the next element is still being written
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
     }
 
-    bool isEmpty() { return q.empty(); }
+    /// Wait a tick, returns false once maxWait has run out
+    static bool wait(TickType_t &maxWait)
+    {
+#ifdef HAS_FREE_RTOS
+        if (maxWait == 0)
+            return false;
+        vTaskDelay(1);
+        if (maxWait != portMAX_DELAY)
+            maxWait--;
+        return true;
+#else
+        return false;
+#endif
+    }
 
-    int numUsed() { return q.size(); }
+    void noteEnqueued()
+    {
+        int used = numUsed();
+        int prev = maxUsed.load(std::memory_order_relaxed);
+        while (used > prev && !maxUsed.compare_exchange_weak(prev, used, std::memory_order_relaxed)) {
+        }
+    }
 
-    bool enqueue(T x, TickType_t maxWait = portMAX_DELAY)
+  public:
+    explicit TypedQueue(int _maxElements)
+        : maxElements(_maxElements > 0 ? _maxElements : 1), head(0), tail(0), overflows(0), maxUsed(0)
     {
-        if (numFree() <= 0)
-            return false;
+        uint32_t numCells = 1;
+        while (numCells < (uint32_t)maxElements)
+            numCells <<= 1;
+        mask = numCells - 1;
+        cells = new Cell[numCells];
+        for (uint32_t i = 0; i < numCells; i++)
+            cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    ~TypedQueue() { delete[] cells; }
+
+    TypedQueue(const TypedQueue &) = delete;
+    TypedQueue &operator=(const TypedQueue &) = delete;
 
+    int numFree() { return maxElements - numUsed(); }
+
+    bool isEmpty() { return numUsed() == 0; }
+
+    int numUsed()
+    {
+        // Read head first, so the difference can't go negative as other threads move both on
+        uint32_t h = head.load(std::memory_order_acquire);
+        int used = (int32_t)(tail.load(std::memory_order_acquire) - h);
+        return used < 0 ? 0 : used > maxElements ? maxElements : used;
+    }
+
+    /** euqueue a packet.  Also, maxWait used to default to portMAX_DELAY, but we now want to callers to THINK about what blocking
+     * they want */
+    bool enqueue(T x, TickType_t maxWait)
+    {
+        while (!tryEnqueue(x)) {
+            if (!wait(maxWait)) {
+                overflows.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        noteEnqueued();
         if (reader) {
             reader->setInterval(0);
             concurrency::mainDelay.interrupt();
         }
-
-        q.push(x);
         return true;
     }
 
-    // bool enqueueFromISR(T x, BaseType_t *higherPriWoken) { return xQueueSendToBackFromISR(h, &x, higherPriWoken) == pdTRUE; }
+    bool enqueueFromISR(T x, BaseType_t *higherPriWoken)
+    {
+        if (!tryEnqueue(x)) {
+            overflows.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        noteEnqueued();
+        if (reader) {
+            reader->setInterval(0);
+            concurrency::mainDelay.interruptFromISR(higherPriWoken);
+        }
+        return true;
+    }
 
     bool dequeue(T *p, TickType_t maxWait = portMAX_DELAY)
     {
-        if (isEmpty())
-            return false;
-        else {
-            *p = q.front();
-            q.pop();
-            return true;
+        while (!tryDequeue(p)) {
+            if (!wait(maxWait))
+                return false;
         }
+        return true;
     }
 
-    // bool dequeueFromISR(T *p, BaseType_t *higherPriWoken) { return xQueueReceiveFromISR(h, p, higherPriWoken); }
+    bool dequeueFromISR(T *p, BaseType_t *higherPriWoken) { return tryDequeue(p); }
 
+    /**
+     * Set a thread that is reading from this queue
+     * If a message is pushed to this queue that thread will be scheduled to run ASAP.
+     *
+     * Note: thread will not be automatically enabled, just have its interval set to 0
+     */
     void setReader(concurrency::OSThread *t) { reader = t; }
+
+    /// How many elements were turned away because the queue was full
+    uint32_t getOverflows() { return overflows.load(std::memory_order_relaxed); }
+
+    /// The most elements that were ever waiting at once
+    int getMaxUsed() { return maxUsed.load(std::memory_order_relaxed); }
 };
-#endif
\ No newline at end of file
+#endif
@@ -1,5 +1,6 @@
 #include "ServerAPI.h"
 #include "configuration.h"
+#include "main.h"
 #include <Arduino.h>
 
 template <typename T>
@@ -36,6 +37,18 @@ template <class T> int32_t ServerAPI<T>::runOnce()
     }
 }
 
+template <class T> size_t ServerAPI<T>::readAvailable(uint8_t *buf, size_t len)
+{
+    int n = client.read(buf, len);
+    return n > 0 ? n : 0;
+}
+
+template <class T> void ServerAPI<T>::wakeForWrite()
+{
+    setIntervalFromNow(0);
+    runASAP = true;
+}
+
 template <class T, class U> APIServerPort<T, U>::APIServerPort(int port) : U(port), concurrency::OSThread("ApiServer") {}
 
 template <class T, class U> void APIServerPort<T, U>::init()
@@ -28,6 +28,11 @@ template <class T> class ServerAPI : public StreamAPI, private concurrency::OSTh
 
     virtual int32_t runOnce() override; // Check for dropped client connections
 
+    /// Read straight from the socket rather than a byte at a time
+    virtual size_t readAvailable(uint8_t *buf, size_t len) override;
+
+    virtual void wakeForWrite() override;
+
     /// Check the current underlying physical link to see if the client is currently connected
     virtual bool checkIsConnected() override;
 };
@@ -0,0 +1,146 @@
+#include "dictcomp.h"
+#include "dictcomp_dict.h"
+
+#include <string.h>
+
+#define MIN_MATCH 3
+#define MAX_MATCH 18
+#define MAX_DISTANCE 2048
+#define MAX_LITERAL_RUN 128
+#define MAX_CHAIN 32 // How many earlier occurrences of a 3-byte prefix we are willing to compare against
+#define NO_POS 0xFFFF
+
+static_assert(sizeof(dictcomp_dict) + DICTCOMP_MAX_INPUT <= MAX_DISTANCE, "Dictionary too large to address");
+
+#define DICT_LEN sizeof(dictcomp_dict)
+
+const uint8_t dictcomp_dict_id = DICTCOMP_DICT_ID;
+
+// Must match hash3() in bin/train-compression-dict.py, the dictionary's hash chains are generated offline
+static inline uint8_t hash3(uint8_t a, uint8_t b, uint8_t c)
+{
+    return (uint8_t)((((uint32_t)a << 16 | (uint32_t)b << 8 | c) * 2654435761u) >> 24);
+}
+
+// The match window is the dictionary followed by the input
+static inline uint8_t windowAt(const uint8_t *in, size_t pos)
+{
+    return pos < DICT_LEN ? dictcomp_dict[pos] : in[pos - DICT_LEN];
+}
+
+static bool emitLiterals(const uint8_t *lit, size_t n, uint8_t *out, size_t &o, size_t olen)
+{
+    while (n > 0) {
+        size_t run = n < MAX_LITERAL_RUN ? n : MAX_LITERAL_RUN;
+        if (o + 1 + run > olen)
+            return false;
+        out[o++] = (uint8_t)(run - 1);
+        memcpy(out + o, lit, run);
+        o += run;
+        lit += run;
+        n -= run;
+    }
+    return true;
+}
+
+int dictcomp_compress(const uint8_t *in, size_t len, uint8_t *out, size_t olen)
+{
+    if (len > DICTCOMP_MAX_INPUT || olen < 1)
+        return -1;
+
+    // Hash chains: the dictionary part is precomputed in flash, only the input part lives on the stack.
+    // head[] holds the most recent window position for each hash, prev[] links input positions to older ones.
+    uint16_t head[256];
+    uint16_t prev[DICTCOMP_MAX_INPUT];
+    memcpy(head, dictcomp_dict_head, sizeof(head));
+
+    auto insert = [&](size_t i) {
+        if (i + MIN_MATCH > len)
+            return;
+        uint8_t h = hash3(in[i], in[i + 1], in[i + 2]);
+        prev[i] = head[h];
+        head[h] = (uint16_t)(DICT_LEN + i);
+    };
+
+    size_t o = 0;
+    out[o++] = DICTCOMP_DICT_ID;
+
+    size_t litStart = 0;
+    size_t i = 0;
+    while (i < len) {
+        size_t bestLen = 0, bestDist = 0;
+
+        if (i + MIN_MATCH <= len) {
+            size_t cur = DICT_LEN + i;
+            size_t maxLen = (len - i) < MAX_MATCH ? (len - i) : MAX_MATCH;
+            uint16_t cand = head[hash3(in[i], in[i + 1], in[i + 2])];
+
+            // Chains only ever point backwards, so once we are out of reach we can stop
+            for (int chain = 0; cand != NO_POS && chain < MAX_CHAIN && cur - cand <= MAX_DISTANCE; chain++) {
+                size_t l = 0;
+                while (l < maxLen && windowAt(in, cand + l) == in[i + l])
+                    l++;
+                if (l > bestLen) {
+                    bestLen = l;
+                    bestDist = cur - cand;
+                    if (l == maxLen)
+                        break;
+                }
+                cand = cand >= DICT_LEN ? prev[cand - DICT_LEN] : dictcomp_dict_prev[cand];
+            }
+        }
+
+        if (bestLen < MIN_MATCH) {
+            insert(i);
+            i++;
+            continue;
+        }
+
+        if (!emitLiterals(in + litStart, i - litStart, out, o, olen) || o + 2 > olen)
+            return -1;
+        out[o++] = (uint8_t)(0x80 | ((bestLen - MIN_MATCH) << 3) | ((bestDist - 1) >> 8));
+        out[o++] = (uint8_t)((bestDist - 1) & 0xFF);
+
+        for (size_t k = 0; k < bestLen; k++)
+            insert(i + k);
+        i += bestLen;
+        litStart = i;
+    }
+
+    if (!emitLiterals(in + litStart, len - litStart, out, o, olen))
+        return -1;
+    return (int)o;
+}
+
+int dictcomp_decompress(const uint8_t *in, size_t len, uint8_t *out, size_t olen)
+{
+    if (len < 1 || in[0] != DICTCOMP_DICT_ID)
+        return -1;
+
+    size_t i = 1, o = 0;
+    while (i < len) {
+        uint8_t token = in[i++];
+        if (!(token & 0x80)) {
+            size_t run = token + 1;
+            if (i + run > len || o + run > olen)
+                return -1;
+            memcpy(out + o, in + i, run);
+            i += run;
+            o += run;
+            continue;
+        }
+
+        if (i >= len)
+            return -1;
+        size_t matchLen = ((token >> 3) & 0x0F) + MIN_MATCH;
+        size_t dist = ((size_t)(token & 0x07) << 8 | in[i++]) + 1;
+        if (dist > DICT_LEN + o || o + matchLen > olen)
+            return -1;
+
+        // Byte by byte, matches may overlap the bytes they produce
+        size_t src = DICT_LEN + o - dist;
+        for (size_t k = 0; k < matchLen; k++, src++)
+            out[o++] = src < DICT_LEN ? dictcomp_dict[src] : out[src - DICT_LEN];
+    }
+    return (int)o;
+}
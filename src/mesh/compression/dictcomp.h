@@ -0,0 +1,38 @@
+#pragma once
+
+/**
+ * Small-packet LZ compressor with a static, trained dictionary.
+ *
+ * Mesh payloads are far too short for an adaptive compressor to learn anything, so the history window is primed with a
+ * dictionary of byte sequences that are common in our traffic (chat phrases, node names, protobuf field prefixes of
+ * NodeInfo and telemetry). The dictionary is generated by bin/train-compression-dict.py and lives in dictcomp_dict.h.
+ *
+ * Stream format:
+ *   byte 0         dictionary id, so that retrained dictionaries can coexist on the mesh
+ *   0lllllll       literal run of l+1 bytes follows (1..128)
+ *   1LLLLddd dddddddd
+ *                  copy L+3 bytes (3..18) from distance d+1 (1..2048) back in dictionary ++ output
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// Largest input dictcomp_compress() accepts, bounds the per-call scratch on the stack
+#define DICTCOMP_MAX_INPUT 256
+
+/// Id of the dictionary compiled into this firmware
+extern const uint8_t dictcomp_dict_id;
+
+/**
+ * Compress len bytes from in into out.
+ *
+ * @return compressed length, or -1 if the input is too long or the result would not fit in olen
+ */
+int dictcomp_compress(const uint8_t *in, size_t len, uint8_t *out, size_t olen);
+
+/**
+ * Decompress len bytes from in into out.
+ *
+ * @return decompressed length, or -1 if the stream is malformed, uses an unknown dictionary or would overflow olen
+ */
+int dictcomp_decompress(const uint8_t *in, size_t len, uint8_t *out, size_t olen);
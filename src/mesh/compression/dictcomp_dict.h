@@ -0,0 +1,262 @@
+#pragma once
+// Generated by bin/train-compression-dict.py from bin/compression-corpus.txt, do not edit
+
+#include <stdint.h>
+
+#define DICTCOMP_DICT_ID 1
+
+static const uint8_t dictcomp_dict[] = {
+    0x61, 0x66, 0x65, 0x20, 0x61, 0x73, 0x20, 0x61, 0x61, 0x73, 0x74, 0x20, 0x61, 0x74, 0x20, 0x72,
+    0x61, 0x74, 0x65, 0x64, 0x62, 0x28, 0x2b, 0x38, 0x64, 0x1a, 0x04, 0x37, 0x64, 0x20, 0x63, 0x6c,
+    0x65, 0x1a, 0x04, 0x64, 0x65, 0x20, 0x63, 0x68, 0x65, 0x20, 0x68, 0x65, 0x65, 0x20, 0x75, 0x70,
+    0x65, 0x20, 0x75, 0x73, 0x65, 0x20, 0x77, 0x65, 0x65, 0x64, 0x2c, 0x20, 0x65, 0x65, 0x74, 0x20,
+    0x65, 0x6c, 0x61, 0x79, 0x65, 0x6e, 0x74, 0x20, 0x67, 0x12, 0x16, 0x08, 0x68, 0x20, 0x74, 0x6f,
+    0x68, 0x65, 0x72, 0x20, 0x69, 0x63, 0x65, 0x20, 0x69, 0x73, 0x20, 0x69, 0x6c, 0x6c, 0x20, 0x62,
+    0x6e, 0x20, 0x61, 0x6e, 0x6e, 0x20, 0x73, 0x6f, 0x6e, 0x67, 0x20, 0x66, 0x6e, 0x74, 0x20, 0x6d,
+    0x6f, 0x77, 0x2c, 0x20, 0x70, 0x79, 0x20, 0x74, 0x72, 0x65, 0x20, 0x61, 0x72, 0x65, 0x73, 0x65,
+    0x73, 0x20, 0x61, 0x20, 0x73, 0x65, 0x64, 0x20, 0x73, 0x69, 0x67, 0x6e, 0x73, 0x6f, 0x6d, 0x65,
+    0x74, 0x20, 0x6f, 0x66, 0x74, 0x20, 0x75, 0x70, 0x74, 0x27, 0x73, 0x20, 0x79, 0x2c, 0x20, 0x20,
+    0x6d, 0x6f, 0x0a, 0x09, 0x21, 0x34, 0x0a, 0x09, 0x21, 0x36, 0x0a, 0x09, 0x21, 0x37, 0x0a, 0x09,
+    0x21, 0x61, 0x38, 0x0a, 0x09, 0x21, 0x63, 0x0a, 0x09, 0x21, 0x66, 0x31, 0x12, 0x15, 0x08, 0x1f,
+    0x15, 0x12, 0x15, 0x08, 0x59, 0x15, 0x12, 0x16, 0x08, 0x30, 0x15, 0x1a, 0x0f, 0x0d, 0xae, 0x47,
+    0x1a, 0x0f, 0x0d, 0xe1, 0x7a, 0x20, 0x61, 0x6e, 0x64, 0x20, 0x20, 0x63, 0x61, 0x6e, 0x20, 0x20,
+    0x64, 0x6f, 0x77, 0x6e, 0x20, 0x68, 0x61, 0x73, 0x20, 0x20, 0x68, 0x6f, 0x70, 0x73, 0x20, 0x69,
+    0x73, 0x20, 0x61, 0x20, 0x69, 0x73, 0x20, 0x63, 0x20, 0x6c, 0x6f, 0x6e, 0x67, 0x20, 0x6d, 0x65,
+    0x65, 0x74, 0x20, 0x6e, 0x65, 0x77, 0x20, 0x20, 0x6e, 0x6f, 0x74, 0x20, 0x20, 0x74, 0x61, 0x6b,
+    0x65, 0x20, 0x74, 0x6f, 0x20, 0x68, 0x20, 0x75, 0x70, 0x20, 0x2c, 0x20, 0x6e, 0x6f, 0x20, 0x30,
+    0x20, 0x6d, 0x69, 0x6e, 0x35, 0x28, 0x32, 0x42, 0x20, 0x40, 0x1d, 0x29, 0x5c, 0x40, 0x1d, 0x8f,
+    0xc2, 0x40, 0x1d, 0xa4, 0x70, 0x41, 0x25, 0x3d, 0x0a, 0x97, 0x41, 0x25, 0xe1, 0x7a, 0x14, 0x41,
+    0x25, 0xec, 0x51, 0x47, 0x6f, 0x6f, 0x64, 0x20, 0x4a, 0x75, 0x73, 0x74, 0x20, 0x54, 0x68, 0x65,
+    0x20, 0x55, 0x40, 0x1d, 0x33, 0x33, 0x61, 0x72, 0x65, 0x20, 0x75, 0x61, 0x74, 0x74, 0x65, 0x72,
+    0x65, 0x20, 0x63, 0x61, 0x72, 0x65, 0x20, 0x72, 0x65, 0x70, 0x65, 0x64, 0x20, 0x61, 0x73, 0x65,
+    0x64, 0x20, 0x74, 0x68, 0x65, 0x6c, 0x6c, 0x6f, 0x20, 0x68, 0x65, 0x20, 0x6d, 0x65, 0x68, 0x65,
+    0x20, 0x72, 0x65, 0x69, 0x12, 0x15, 0x08, 0x69, 0x6e, 0x67, 0x20, 0x6f, 0x6e, 0x69, 0x67, 0x68,
+    0x74, 0x70, 0x20, 0x74, 0x68, 0x65, 0x72, 0x69, 0x6e, 0x67, 0x20, 0x73, 0x65, 0x20, 0x73, 0x65,
+    0x73, 0x74, 0x20, 0x63, 0x68, 0x74, 0x20, 0x69, 0x73, 0x20, 0x74, 0x20, 0x6d, 0x65, 0x20, 0x76,
+    0x65, 0x64, 0x20, 0x74, 0x76, 0x69, 0x6e, 0x67, 0x20, 0x79, 0x20, 0x69, 0x73, 0x20, 0x79, 0x20,
+    0x6e, 0x65, 0x74, 0xc7, 0x68, 0x12, 0x16, 0x08, 0x0a, 0x09, 0x21, 0x32, 0x12, 0x08, 0x43, 0x61,
+    0x72, 0x20, 0x15, 0x9a, 0x99, 0x81, 0x40, 0x1d, 0x20, 0x61, 0x67, 0x61, 0x69, 0x6e, 0x20, 0x63,
+    0x6c, 0x65, 0x61, 0x72, 0x20, 0x63, 0x6f, 0x6e, 0x66, 0x69, 0x20, 0x68, 0x69, 0x67, 0x68, 0x20,
+    0x20, 0x6d, 0x65, 0x73, 0x68, 0x21, 0x20, 0x74, 0x65, 0x73, 0x74, 0x20, 0x20, 0x74, 0x68, 0x65,
+    0x20, 0x65, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6c, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6e, 0x20, 0x74,
+    0x68, 0x65, 0x20, 0x73, 0x20, 0x74, 0x6f, 0x64, 0x61, 0x79, 0x20, 0x75, 0x73, 0x69, 0x6e, 0x67,
+    0x28, 0x04, 0x38, 0x03, 0x42, 0x20, 0x28, 0x04, 0x42, 0x20, 0x28, 0x2b, 0x38, 0x03, 0x42, 0x20,
+    0x28, 0x47, 0x38, 0x03, 0x42, 0x20, 0x33, 0x64, 0x28, 0x30, 0x42, 0x20, 0x40, 0x1d, 0x52, 0xb8,
+    0x53, 0x6f, 0x6c, 0x61, 0x72, 0x20, 0x53, 0x77, 0x69, 0x74, 0x63, 0x68, 0x54, 0x68, 0x61, 0x6e,
+    0x6b, 0x73, 0x61, 0x6e, 0x67, 0x65, 0x20, 0x74, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x3f, 0x61, 0x76,
+    0x65, 0x20, 0x61, 0x20, 0x65, 0x20, 0x61, 0x72, 0x65, 0x20, 0x65, 0x20, 0x6f, 0x6e, 0x20, 0x74,
+    0x65, 0x2c, 0x20, 0x62, 0x65, 0x20, 0x65, 0x72, 0x20, 0x69, 0x73, 0x20, 0x65, 0x74, 0x20, 0x79,
+    0x6f, 0x75, 0x67, 0x12, 0x15, 0x08, 0x43, 0x15, 0x67, 0x1a, 0x0f, 0x0d, 0x67, 0x72, 0x6f, 0x75,
+    0x6e, 0x64, 0x68, 0x12, 0x15, 0x08, 0x20, 0x15, 0x68, 0x12, 0x15, 0x08, 0x35, 0x15, 0x68, 0x12,
+    0x16, 0x08, 0x41, 0x15, 0x68, 0x1a, 0x0f, 0x0d, 0xa4, 0x70, 0x68, 0x1a, 0x0f, 0x0d, 0xb8, 0x1e,
+    0x68, 0x61, 0x6e, 0x6b, 0x73, 0x20, 0x69, 0x1a, 0x0f, 0x0d, 0xa4, 0x70, 0x69, 0x6e, 0x67, 0x20,
+    0x6c, 0x6f, 0x6d, 0x65, 0x20, 0x6e, 0x6f, 0x77, 0x6e, 0x20, 0x79, 0x6f, 0x75, 0x20, 0x6f, 0x64,
+    0x65, 0x20, 0x6f, 0x6e, 0x74, 0x65, 0x73, 0x74, 0x20, 0x66, 0x20, 0x6c, 0x61, 0x74, 0x65, 0x20,
+    0x6f, 0x75, 0x74, 0x20, 0x20, 0x73, 0x65, 0x74, 0x20, 0x20, 0x74, 0x68, 0x61, 0x74, 0x4e, 0x6f,
+    0x64, 0x65, 0x20, 0x57, 0x68, 0x61, 0x74, 0x20, 0x64, 0x69, 0x6e, 0x67, 0x20, 0x65, 0x20, 0x74,
+    0x6f, 0x20, 0x69, 0x6e, 0x67, 0x20, 0x68, 0x12, 0x09, 0x48, 0x6f, 0x6d, 0x65, 0x20, 0x20, 0x61,
+    0x72, 0x72, 0x69, 0x76, 0x65, 0x20, 0x63, 0x6c, 0x6f, 0x73, 0x65, 0x64, 0x20, 0x67, 0x72, 0x65,
+    0x61, 0x74, 0x20, 0x20, 0x72, 0x61, 0x6e, 0x67, 0x65, 0x20, 0x20, 0x74, 0x68, 0x61, 0x6e, 0x6b,
+    0x73, 0x20, 0x74, 0x68, 0x65, 0x20, 0x64, 0x65, 0x2c, 0x20, 0x77, 0x69, 0x6c, 0x6c, 0x20, 0x40,
+    0x1d, 0xcd, 0xcc, 0xd8, 0x41, 0x25, 0x41, 0x25, 0x66, 0x66, 0x96, 0x40, 0x28, 0x41, 0x25, 0xb8,
+    0x1e, 0x45, 0x3f, 0x28, 0x53, 0x69, 0x67, 0x6e, 0x61, 0x6c, 0x20, 0x57, 0x65, 0x6c, 0x63, 0x6f,
+    0x6d, 0x65, 0x64, 0x28, 0x2b, 0x38, 0x02, 0x42, 0x20, 0x6f, 0x64, 0x65, 0x20, 0x69, 0x73, 0x20,
+    0x72, 0x20, 0x6e, 0x6f, 0x64, 0x65, 0x20, 0x74, 0x20, 0x63, 0x68, 0x65, 0x63, 0x6b, 0x74, 0x20,
+    0x79, 0x6f, 0x75, 0x72, 0x20, 0x75, 0x6e, 0x6e, 0x69, 0x6e, 0x67, 0x20, 0x0a, 0x09, 0x21, 0x62,
+    0x12, 0x04, 0x42, 0x61, 0x73, 0x65, 0x1a, 0x04, 0x12, 0x04, 0x48, 0x6f, 0x6d, 0x65, 0x1a, 0x04,
+    0x20, 0x68, 0x65, 0x61, 0x72, 0x20, 0x6d, 0x65, 0x20, 0x69, 0x73, 0x20, 0x67, 0x6f, 0x6f, 0x64,
+    0x20, 0x70, 0x6c, 0x65, 0x61, 0x73, 0x65, 0x20, 0x20, 0x72, 0x6f, 0x75, 0x74, 0x65, 0x72, 0x20,
+    0x20, 0x75, 0x70, 0x64, 0x61, 0x74, 0x65, 0x20, 0x28, 0x09, 0x42, 0x20, 0x28, 0x2b, 0x42, 0x20,
+    0x65, 0x64, 0x20, 0x74, 0x6f, 0x20, 0x65, 0x65, 0x20, 0x79, 0x6f, 0x75, 0x20, 0x74, 0x65, 0x77,
+    0x20, 0x6e, 0x6f, 0x64, 0x65, 0x20, 0x68, 0x1a, 0x0f, 0x0d, 0x66, 0x66, 0x68, 0x65, 0x20, 0x74,
+    0x72, 0x61, 0x69, 0x6c, 0x69, 0x6e, 0x67, 0x20, 0x74, 0x68, 0x65, 0x20, 0x69, 0x72, 0x6d, 0x77,
+    0x61, 0x72, 0x65, 0x20, 0x6c, 0x65, 0x61, 0x73, 0x65, 0x20, 0x72, 0x65, 0x6d, 0x65, 0x72, 0x67,
+    0x65, 0x6e, 0x63, 0x79, 0x6f, 0x73, 0x69, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x73, 0x20, 0x67, 0x6f,
+    0x6f, 0x64, 0x2c, 0x20, 0x73, 0x20, 0x74, 0x68, 0x65, 0x20, 0x12, 0x04, 0x52, 0x6f, 0x6f, 0x66,
+    0x1a, 0x04, 0x30, 0x12, 0x0b, 0x4d, 0x6f, 0x62, 0x69, 0x6c, 0x65, 0x20, 0x20, 0x61, 0x6e, 0x79,
+    0x6f, 0x6e, 0x65, 0x20, 0x68, 0x20, 0x65, 0x76, 0x65, 0x72, 0x79, 0x6f, 0x6e, 0x65, 0x20, 0x66,
+    0x6f, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20, 0x20, 0x67, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x20,
+    0x20, 0x6c, 0x6f, 0x63, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x72, 0x65, 0x63, 0x65, 0x69, 0x76,
+    0x65, 0x64, 0x20, 0x72, 0x75, 0x6e, 0x6e, 0x69, 0x6e, 0x67, 0x3f, 0x20, 0x74, 0x68, 0x65, 0x20,
+    0x68, 0x69, 0x6c, 0x6c, 0x35, 0x12, 0x04, 0x52, 0x6f, 0x6f, 0x66, 0x1a, 0x04, 0x69, 0x67, 0x6e,
+    0x61, 0x6c, 0x20, 0x69, 0x73, 0x20, 0x50, 0x6c, 0x65, 0x61, 0x73, 0x65, 0x20, 0x20, 0x63, 0x68,
+    0x65, 0x63, 0x6b, 0x20, 0x69, 0x6e, 0x20, 0x20, 0x64, 0x65, 0x6c, 0x69, 0x76, 0x65, 0x72, 0x65,
+    0x64, 0x20, 0x6f, 0x6e, 0x20, 0x74, 0x68, 0x65, 0x20, 0x72, 0x6f, 0x68, 0x65, 0x63, 0x6b, 0x69,
+    0x6e, 0x67, 0x20, 0x69, 0x6e, 0x74, 0x20, 0x66, 0x69, 0x72, 0x6d, 0x77, 0x61, 0x72, 0x65, 0x12,
+    0x07, 0x47, 0x61, 0x74, 0x65, 0x77, 0x61, 0x79, 0x1a, 0x04, 0x12, 0x0d, 0x52, 0x65, 0x70, 0x65,
+    0x61, 0x74, 0x65, 0x72, 0x20, 0x20, 0x61, 0x6e, 0x74, 0x65, 0x6e, 0x6e, 0x61, 0x20, 0x74, 0x6f,
+    0x20, 0x74, 0x68, 0x65, 0x20, 0x4d, 0x65, 0x73, 0x73, 0x61, 0x67, 0x65, 0x20, 0x65, 0x20, 0x61,
+    0x74, 0x20, 0x74, 0x68, 0x65, 0x20, 0x63, 0x61, 0x12, 0x08, 0x48, 0x61, 0x6e, 0x64, 0x68, 0x65,
+    0x6c, 0x64, 0x1a, 0x04, 0x20, 0x62, 0x61, 0x63, 0x6b, 0x20, 0x6f, 0x6e, 0x6c, 0x69, 0x6e, 0x65,
+    0x20, 0x68, 0x65, 0x72, 0x65, 0x2c, 0x20, 0x69, 0x6f, 0x6e, 0x20, 0x61, 0x72, 0x65, 0x20, 0x79,
+    0x6f, 0x75, 0x20, 0x20, 0x63, 0x68, 0x61, 0x6e, 0x6e, 0x65, 0x6c, 0x20, 0x73, 0x20, 0x61, 0x6e,
+    0x79, 0x6f, 0x6e, 0x65, 0x20, 0x20, 0x79, 0x6f, 0x75, 0x72, 0x20, 0x6d, 0x65, 0x73, 0x73, 0x61,
+    0x67, 0x65, 0x4d, 0x51, 0x54, 0x54, 0x20, 0x67, 0x61, 0x74, 0x65, 0x77, 0x61, 0x79, 0x20, 0x12,
+    0x0f, 0x4d, 0x65, 0x73, 0x68, 0x74, 0x61, 0x73, 0x74, 0x69, 0x63, 0x20, 0x31, 0x12, 0x0f, 0x4d,
+    0x65, 0x73, 0x68, 0x74, 0x61, 0x73, 0x74, 0x69, 0x63, 0x20, 0x37, 0x12, 0x0f, 0x4d, 0x65, 0x73,
+    0x68, 0x74, 0x61, 0x73, 0x74, 0x69, 0x63, 0x20, 0x39, 0x2c, 0x20, 0x62, 0x65, 0x20, 0x74, 0x68,
+    0x65, 0x72, 0x65, 0x20, 0x69, 0x6e, 0x20, 0x34, 0x12, 0x0f, 0x4d, 0x65, 0x73, 0x68, 0x74, 0x61,
+    0x73, 0x74, 0x69, 0x63, 0x20, 0x35, 0x12, 0x0f, 0x4d, 0x65, 0x73, 0x68, 0x74, 0x61, 0x73, 0x74,
+    0x69, 0x63, 0x20, 0x33, 0x12, 0x0c, 0x42, 0x61, 0x73, 0x65, 0x20, 0x53, 0x74, 0x61, 0x74, 0x69,
+    0x6f, 0x6e, 0x1a, 0x04, 0x20, 0x66, 0x72, 0x6f, 0x6d, 0x20, 0x74, 0x68, 0x65, 0x20, 0x64, 0x12,
+    0x13, 0x48, 0x69, 0x6c, 0x6c, 0x74, 0x6f, 0x70, 0x20, 0x52, 0x6f, 0x75, 0x74, 0x65, 0x72, 0x20,
+    0x68, 0x61, 0x6e, 0x6e, 0x65, 0x6c, 0x20, 0x75, 0x74, 0x69, 0x6c, 0x69, 0x7a, 0x61, 0x74, 0x69,
+    0x6f, 0x6e, 0x54, 0x65, 0x73, 0x74, 0x20, 0x6d, 0x65, 0x73, 0x73, 0x61, 0x67, 0x65, 0x20,
+};
+
+// Hash chains over the dictionary, see dictcomp_compress()
+static const uint16_t dictcomp_dict_head[] = {
+    0x05c2, 0x05f8, 0x0261, 0x04e8, 0x049e, 0x0541, 0x0517, 0x03ca, 0x0545, 0x0492, 0x0359, 0x04cb,
+    0x038e, 0x04da, 0x048f, 0x0281, 0x05d2, 0x0552, 0x050e, 0x05d4, 0x05af, 0x04dc, 0x04eb, 0x02d8,
+    0x04e4, 0x05cb, 0x0498, 0x055c, 0x053f, 0x04c5, 0x048b, 0x03cc, 0x0376, 0x0504, 0x0590, 0x05ed,
+    0x05b0, 0x03e1, 0x0350, 0x0391, 0x040c, 0x05c7, 0x0491, 0x0520, 0x05db, 0x05ce, 0x02c7, 0x0150,
+    0x0190, 0x05e4, 0x0291, 0x04cd, 0x0506, 0x05e9, 0x03ae, 0x053d, 0x051f, 0x0586, 0x050a, 0xffff,
+    0x05ac, 0xffff, 0x05b9, 0x058b, 0x05f6, 0x05e6, 0x041c, 0x046a, 0x030f, 0x0523, 0x0397, 0x056a,
+    0xffff, 0x0340, 0x0490, 0x0495, 0x05eb, 0x04a7, 0x04a9, 0x048c, 0x057a, 0x04f4, 0x0524, 0x01ce,
+    0x05b8, 0xffff, 0x0469, 0x05fa, 0x053a, 0x051a, 0x0509, 0x04c9, 0x0595, 0x05a5, 0x055b, 0x040d,
+    0x0528, 0x055e, 0x04c0, 0x05b2, 0x04ef, 0x05c1, 0x05de, 0x0513, 0x0588, 0x0315, 0x05d5, 0x03fb,
+    0x0244, 0x0431, 0x022b, 0x05d3, 0x05e0, 0x05f5, 0x00a5, 0x05b7, 0x03cb, 0x04af, 0x056c, 0x05b6,
+    0x029a, 0xffff, 0x03a6, 0x05dc, 0x03df, 0x05dd, 0x05ea, 0x05ee, 0xffff, 0x0360, 0x04bb, 0x05b1,
+    0x05f0, 0x0555, 0x05ab, 0x05d0, 0x04f3, 0x05f9, 0x05bb, 0x0534, 0x05e2, 0x03b9, 0x0540, 0x05b3,
+    0x05a8, 0x0526, 0x047a, 0x055d, 0x05f4, 0x05e5, 0x051b, 0x048a, 0x04bc, 0x04be, 0x0596, 0x01b3,
+    0x05c6, 0x0505, 0x041e, 0x05f3, 0x05fc, 0x0343, 0x0487, 0x058c, 0x05e8, 0x05e7, 0x03e0, 0x00cf,
+    0xffff, 0x04d0, 0x03c6, 0x05c0, 0x0557, 0x0468, 0x0115, 0x052a, 0x04a2, 0x0516, 0x05df, 0x04dd,
+    0x05ec, 0x00ea, 0x02f1, 0x0295, 0x05ad, 0x04df, 0x05d1, 0x0347, 0x04ec, 0x0231, 0x0525, 0x05cc,
+    0x05a3, 0x0587, 0x02c0, 0x0219, 0x0500, 0x05c4, 0x05f7, 0x058f, 0x046f, 0x0508, 0x05c5, 0x0444,
+    0xffff, 0x0456, 0x03c5, 0x05da, 0x0242, 0x0451, 0x05a4, 0x033d, 0x04e9, 0x040f, 0x0592, 0x046c,
+    0x0421, 0x05fb, 0x05d7, 0x0488, 0x023a, 0x03ea, 0x058a, 0x0311, 0x05c3, 0x0546, 0x046b, 0x05ba,
+    0x05f2, 0x05aa, 0x04e3, 0x04ab, 0x0554, 0x05f1, 0x04b3, 0x0398, 0x05e3, 0x0544, 0x05e1, 0x0489,
+    0x0533, 0x0416, 0x05b4, 0x05ef, 0x05b5, 0x038f, 0xffff, 0x034c, 0x04ee, 0x017c, 0x02bb, 0x04c8,
+    0x0578, 0x035b, 0x044f, 0x038d,
+};
+
+static const uint16_t dictcomp_dict_prev[] = {
+    0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+    0x000a, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x0011, 0xffff, 0xffff, 0xffff,
+    0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+    0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x000f,
+    0x002c, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+    0xffff, 0x000b, 0xffff, 0x0039, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x0007, 0xffff, 0x001c,
+    0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x0034, 0x0026, 0x0001,
+    0x002d, 0x004f, 0xffff, 0xffff, 0xffff, 0x0013, 0xffff, 0x004c, 0xffff, 0xffff, 0xffff, 0xffff,
+    0xffff, 0x0019, 0xffff, 0x002f, 0xffff, 0x0046, 0xffff, 0xffff, 0xffff, 0xffff, 0x0064, 0xffff,
+    0x0045, 0xffff, 0x005e, 0x001d, 0x002a, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x0049,
+    0xffff, 0x0002, 0xffff, 0x0074, 0x0053, 0xffff, 0xffff, 0xffff, 0x0005, 0xffff, 0x0020, 0xffff,
+    0x0017, 0x0048, 0xffff, 0x000c, 0xffff, 0x0061, 0x0038, 0xffff, 0xffff, 0x0004, 0xffff, 0x003d,
+    0xffff, 0xffff, 0xffff, 0xffff, 0x0068, 0x0054, 0x0009, 0xffff, 0xffff, 0x007b, 0x0016, 0x007e,
+    0x0014, 0x009b, 0xffff, 0x006e, 0xffff, 0x0059, 0x0027, 0xffff, 0xffff, 0xffff, 0x00a2, 0x0076,
+    0x00a3, 0x0093, 0x00a6, 0x0035, 0x0095, 0x008a, 0x00aa, 0xffff, 0xffff, 0xffff, 0xffff, 0x00ae,
+    0xffff, 0xffff, 0xffff, 0x00b3, 0x004e, 0xffff, 0xffff, 0x0029, 0xffff, 0x0036, 0x003e, 0x006f,
+    0xffff, 0x00bc, 0x0008, 0x0072, 0xffff, 0xffff, 0x0077, 0xffff, 0x0006, 0xffff, 0xffff, 0x0018,
+    0xffff, 0xffff, 0xffff, 0x0047, 0x00cb, 0xffff, 0xffff, 0x00bb, 0x00bd, 0x0089, 0x0042, 0xffff,
+    0x0012, 0x0033, 0x00b4, 0x005b, 0x0055, 0xffff, 0x004d, 0x0097, 0x00a4, 0xffff, 0x00c8, 0x00be,
+    0xffff, 0xffff, 0x008d, 0x00af, 0x00ab, 0x00b2, 0x007f, 0xffff, 0x0025, 0x00a1, 0x0057, 0x0058,
+    0x0080, 0x0081, 0x00ec, 0x00ee, 0x00ef, 0x00ac, 0x006d, 0x0070, 0x00d5, 0x00e7, 0x0067, 0x0094,
+    0x0073, 0xffff, 0xffff, 0x003c, 0x008f, 0xffff, 0x00b8, 0x00c2, 0xffff, 0xffff, 0x0024, 0xffff,
+    0xffff, 0x0090, 0x0078, 0x0056, 0x006a, 0xffff, 0xffff, 0xffff, 0x0031, 0x00de, 0xffff, 0xffff,
+    0x010f, 0xffff, 0x00f5, 0x0098, 0xffff, 0x003b, 0xffff, 0x0107, 0x0082, 0x0040, 0x0043, 0x011c,
+    0x00dc, 0x0083, 0xffff, 0x00ed, 0xffff, 0x0110, 0x003f, 0x00c0, 0x00dd, 0xffff, 0x00e5, 0xffff,
+    0x0114, 0xffff, 0x002b, 0x00a8, 0x00f1, 0x00db, 0x0086, 0x00a9, 0xffff, 0x00da, 0xffff, 0x00cc,
+    0xffff, 0x0065, 0x0113, 0x00f7, 0x00d6, 0x00e3, 0x0085, 0xffff, 0x00b6, 0xffff, 0x0051, 0xffff,
+    0x001a, 0xffff, 0x006c, 0xffff, 0xffff, 0x00ba, 0x0096, 0xffff, 0xffff, 0x00ca, 0x00b7, 0x00c5,
+    0xffff, 0x005f, 0x0149, 0x0084, 0xffff, 0x0103, 0x0099, 0x010a, 0x0030, 0xffff, 0x00d9, 0x00f2,
+    0x0037, 0x00df, 0x00e0, 0x0157, 0x0106, 0x0135, 0x00e1, 0x0156, 0x015f, 0x0133, 0x00d2, 0x010c,
+    0x015c, 0x0062, 0x013e, 0x00e8, 0x0003, 0xffff, 0x0153, 0x016a, 0xffff, 0x0144, 0x014e, 0x00b9,
+    0x0170, 0xffff, 0x00d3, 0x013a, 0x0176, 0x0172, 0x002e, 0x00fd, 0x0177, 0x0112, 0x0179, 0x0165,
+    0x0166, 0x017d, 0x014d, 0x0140, 0x00c1, 0x00f4, 0x0044, 0xffff, 0x00fb, 0x013d, 0x00d8, 0x0123,
+    0x0168, 0x009e, 0xffff, 0xffff, 0x018e, 0x000e, 0x0171, 0x017e, 0x0050, 0xffff, 0xffff, 0x0187,
+    0x0188, 0x0181, 0x0121, 0x015a, 0x0052, 0x019a, 0x009d, 0x0192, 0x014a, 0x00fa, 0x015b, 0x010d,
+    0x00e9, 0x0199, 0x00f3, 0x0185, 0x01a3, 0xffff, 0x00f6, 0x017b, 0x014f, 0x00ad, 0x0146, 0xffff,
+    0x016f, 0x0174, 0xffff, 0x0195, 0x009c, 0x0197, 0x0198, 0x0109, 0xffff, 0x0175, 0x01a6, 0x01a7,
+    0x009a, 0x01b8, 0x00c9, 0x0102, 0xffff, 0xffff, 0x0186, 0x0158, 0x0069, 0x00c6, 0xffff, 0x000d,
+    0x0193, 0x019b, 0x0138, 0x01bb, 0x00e4, 0x003a, 0xffff, 0x001b, 0xffff, 0x01a2, 0xffff, 0x012d,
+    0x0163, 0xffff, 0x015d, 0x0010, 0x0182, 0x01bc, 0x00d4, 0x0126, 0x012c, 0x01b5, 0x00bf, 0x001e,
+    0x0060, 0x0137, 0x01cf, 0x017a, 0x01c5, 0x01c8, 0x00d0, 0xffff, 0x019c, 0x00fe, 0x01e6, 0xffff,
+    0x018d, 0x01b2, 0x007c, 0x01ec, 0x01ab, 0xffff, 0x01bd, 0xffff, 0x011d, 0xffff, 0x013f, 0x01d0,
+    0x019f, 0x01a0, 0x0164, 0x010b, 0x01f8, 0x01e5, 0x01fd, 0x01f4, 0x01da, 0x0125, 0x01fc, 0x01fe,
+    0x0203, 0xffff, 0x008e, 0xffff, 0x0202, 0x0204, 0x0209, 0x0196, 0xffff, 0xffff, 0x0208, 0x020a,
+    0x020f, 0x01e8, 0xffff, 0x01a8, 0x0111, 0xffff, 0x01b6, 0x0180, 0x00eb, 0x0124, 0x0201, 0x009f,
+    0x0143, 0x01dd, 0x01c9, 0x01f7, 0x0142, 0xffff, 0x0101, 0x0122, 0x0021, 0x007d, 0x01d7, 0x00c4,
+    0x0224, 0xffff, 0x0015, 0x021b, 0x0222, 0x0223, 0x0228, 0xffff, 0x0130, 0xffff, 0x022c, 0x022d,
+    0x020c, 0x00c3, 0x0000, 0x01c0, 0x01ae, 0x0079, 0x0127, 0x0128, 0x0216, 0x01cd, 0x01ee, 0x0184,
+    0x01c3, 0x011f, 0xffff, 0x01e2, 0x00b1, 0x013b, 0x015e, 0x006b, 0x01d4, 0x0237, 0x0159, 0x020d,
+    0xffff, 0xffff, 0x0088, 0x00f0, 0x0139, 0x0226, 0x0148, 0x022e, 0x019e, 0x021a, 0x0167, 0x01fa,
+    0x01c1, 0x0189, 0x0214, 0x0162, 0x0221, 0x0239, 0x021f, 0xffff, 0x025d, 0x0230, 0x004a, 0x0200,
+    0x0260, 0x007a, 0x0248, 0x0257, 0x01ff, 0x0263, 0x024f, 0x018a, 0x00f9, 0x024b, 0x01f6, 0x0028,
+    0x00b5, 0x024c, 0x0249, 0x026b, 0x0268, 0x019d, 0x0220, 0x0211, 0x01ba, 0x01cb, 0xffff, 0x0183,
+    0x0100, 0x00c7, 0x0108, 0x0071, 0x01f1, 0x0232, 0x005d, 0x023f, 0x01e9, 0x0256, 0xffff, 0x01c6,
+    0x0191, 0x01ea, 0x0252, 0xffff, 0x01e4, 0x0275, 0x025e, 0x0240, 0x0266, 0x0151, 0x00b0, 0x0283,
+    0x018b, 0x010e, 0x0278, 0x0289, 0x0292, 0x0293, 0x01bf, 0x028c, 0x027a, 0x0297, 0x01c4, 0x029b,
+    0x0274, 0x0288, 0x0120, 0x00ff, 0xffff, 0x029d, 0x016c, 0x01d1, 0x0233, 0x01db, 0x02a4, 0x02a5,
+    0x0117, 0x0243, 0x0154, 0xffff, 0x024d, 0x024e, 0x026a, 0x0092, 0x0294, 0x027e, 0xffff, 0x02ab,
+    0x02a6, 0x02a7, 0x0284, 0x012b, 0x021d, 0x023c, 0x02b7, 0x00f8, 0x022f, 0x00e6, 0x01ac, 0x020b,
+    0x011b, 0x01d8, 0x025b, 0x00e2, 0x00d1, 0x02b5, 0x027f, 0x0264, 0xffff, 0x0235, 0x027d, 0x0023,
+    0x02b2, 0x0273, 0x001f, 0x01eb, 0x028e, 0x020e, 0x01f9, 0x004b, 0xffff, 0x0178, 0xffff, 0x00a0,
+    0x0251, 0x02c1, 0x02d0, 0x0104, 0x008b, 0x012a, 0x0267, 0x026f, 0x028d, 0x02ae, 0x027c, 0x02e2,
+    0x01fb, 0x02d5, 0x0254, 0x023e, 0x0229, 0x01ca, 0x029e, 0x02ce, 0x02cf, 0x005a, 0x02aa, 0x0282,
+    0x02eb, 0x0087, 0x02ca, 0x0280, 0x023d, 0x02bc, 0x02bd, 0x0298, 0x0269, 0x0255, 0x025a, 0x01a5,
+    0x02ad, 0xffff, 0x02f9, 0x02fa, 0x02d9, 0x01ad, 0xffff, 0x02c8, 0x01d6, 0x02ed, 0x02dd, 0x02c2,
+    0x0155, 0xffff, 0x0265, 0x029f, 0x0116, 0x0305, 0x0063, 0x025f, 0x0160, 0x01de, 0x0131, 0x0262,
+    0x0218, 0x016e, 0x01b0, 0x01a9, 0x0136, 0x01d3, 0x02f5, 0x02a2, 0x031e, 0x02e7, 0x028a, 0x02a1,
+    0x0134, 0x0322, 0x0253, 0x02ea, 0x030c, 0x02e8, 0x02e9, 0x0327, 0x02b0, 0x02b1, 0x02de, 0x02b3,
+    0x0213, 0x032a, 0x0210, 0x0332, 0x02af, 0x0091, 0x0161, 0x0270, 0xffff, 0x025c, 0x02cd, 0x0316,
+    0x005c, 0x0234, 0x023b, 0x021c, 0x01e7, 0x02f4, 0x02fe, 0xffff, 0x031d, 0x01c2, 0x028b, 0x0250,
+    0x02d2, 0x0132, 0x0339, 0x00fc, 0x0207, 0x0236, 0x033e, 0x0279, 0x0341, 0x01e0, 0x01d2, 0x034a,
+    0x0323, 0x02bf, 0x0334, 0x0286, 0x0330, 0xffff, 0x01e1, 0x014b, 0x01f3, 0x0206, 0x030b, 0x030a,
+    0x02a8, 0x033f, 0x0194, 0x022a, 0x02e0, 0x02f3, 0x0326, 0x0212, 0x033a, 0x02ef, 0x02f0, 0x0329,
+    0x0296, 0x034f, 0x0357, 0x0205, 0x0318, 0x02c4, 0x0075, 0x0369, 0x036a, 0x02fd, 0x031b, 0x01a1,
+    0x02b9, 0x0277, 0x01ef, 0xffff, 0x0378, 0x0362, 0x0373, 0x02c9, 0x02f6, 0x02df, 0x0333, 0x01be,
+    0x032e, 0x032c, 0x029c, 0x0320, 0x0302, 0x0303, 0x032d, 0x037c, 0x0382, 0x0215, 0x02db, 0x0032,
+    0x0145, 0x02cc, 0x0317, 0x016d, 0x0331, 0x0241, 0x01a4, 0x01ed, 0xffff, 0x0370, 0x0309, 0x035f,
+    0x026e, 0x0395, 0x034e, 0x01d5, 0x0304, 0x02f8, 0x035a, 0x0300, 0x0276, 0x01f0, 0x035e, 0x036b,
+    0x036c, 0x036d, 0x0377, 0x0246, 0x0141, 0x0394, 0x0390, 0x014c, 0x0152, 0x033b, 0x0351, 0x02d4,
+    0x0393, 0x021e, 0x0328, 0x0325, 0x033c, 0x02e4, 0x0364, 0x03b2, 0x0308, 0x03a4, 0x0306, 0x02ec,
+    0x0310, 0x03af, 0x037e, 0x02d1, 0x02dc, 0x039b, 0x02ac, 0x01aa, 0x0313, 0x0319, 0x0366, 0x03bf,
+    0x02ba, 0x0119, 0xffff, 0x03be, 0x031a, 0x01b1, 0x0342, 0x02ff, 0x039d, 0x03cd, 0x012e, 0x03ce,
+    0x037f, 0x0380, 0x02cb, 0x02e5, 0x039c, 0x0381, 0x03dd, 0x03a2, 0x0371, 0x0372, 0x03c2, 0x0374,
+    0x02e3, 0x02b6, 0x02f2, 0x02be, 0x031c, 0x0337, 0x0354, 0x03c7, 0x038c, 0x0375, 0x00a7, 0x018f,
+    0x03b3, 0x03a9, 0x01f2, 0x038a, 0x0388, 0x0389, 0x02a3, 0x03ad, 0x03ec, 0x03f8, 0x03a7, 0x016b,
+    0x0227, 0x03c9, 0x0384, 0x0129, 0x0290, 0x0321, 0x036f, 0x03a8, 0x03bb, 0x03f0, 0x03b4, 0x03b5,
+    0x017f, 0x0217, 0x03eb, 0x0299, 0xffff, 0x0287, 0x0169, 0x011a, 0x03d8, 0x01dc, 0x01df, 0x039a,
+    0x02d6, 0x039f, 0x0363, 0x0259, 0x03d2, 0x026c, 0x0285, 0x0367, 0x03aa, 0x03ab, 0x03ac, 0x03f7,
+    0x032b, 0x02a9, 0x02e6, 0x041b, 0x0358, 0x041f, 0x03f9, 0x0426, 0x0368, 0xffff, 0x0405, 0x03a1,
+    0x034d, 0x03e2, 0x02ee, 0x03a3, 0x0353, 0xffff, 0x03b8, 0x02e1, 0x0432, 0xffff, 0x03da, 0x0344,
+    0x00d7, 0x039e, 0x03b6, 0x030d, 0x0355, 0x03d7, 0x0415, 0x0147, 0x0386, 0x0346, 0x03e4, 0x0411,
+    0x03ef, 0x0387, 0x0439, 0x0383, 0x0417, 0x0247, 0x043f, 0x0440, 0x0441, 0x03e8, 0x026d, 0x0022,
+    0x03db, 0x03e5, 0x0425, 0x0427, 0x0453, 0x043a, 0x03ee, 0x0418, 0x0345, 0x0365, 0x0404, 0x02fc,
+    0x03f4, 0x03f5, 0x03d6, 0x0430, 0x043c, 0x03de, 0x00ce, 0x03dc, 0x0258, 0x0448, 0x0457, 0x0419,
+    0x01b7, 0x0409, 0x034b, 0x0412, 0x0459, 0x0402, 0x0312, 0x01af, 0x03d0, 0x02c3, 0x0435, 0x0433,
+    0x0385, 0x044b, 0x0445, 0x045c, 0x0349, 0x035d, 0xffff, 0x0452, 0x0454, 0x047c, 0x0442, 0x03e7,
+    0x038b, 0x03b1, 0x0465, 0x0301, 0x012f, 0x042a, 0x042b, 0x042c, 0x042d, 0x042e, 0x042f, 0x03d4,
+    0x01e3, 0x0460, 0x0356, 0x036e, 0x0424, 0x0462, 0x0403, 0x03f1, 0x03ff, 0x0348, 0x0401, 0x045a,
+    0x0485, 0x0406, 0x0407, 0x0455, 0x049a, 0x0480, 0x0379, 0x037a, 0x037b, 0x0476, 0x03c1, 0x0483,
+    0x0443, 0x0446, 0x0466, 0x0335, 0x03a0, 0x02b8, 0x0475, 0x046e, 0x0447, 0x041d, 0x03d9, 0x0470,
+    0x0173, 0x03c3, 0x0467, 0x044e, 0x047b, 0x047d, 0x04b5, 0x0408, 0x0434, 0x03d5, 0x031f, 0x049f,
+    0x04a0, 0x0041, 0x035c, 0x0477, 0x045d, 0x027b, 0x04a3, 0x040a, 0x0238, 0x02d7, 0x03f2, 0x01cc,
+    0x03fc, 0x03fd, 0x03fe, 0x0494, 0x0400, 0x03e3, 0x04cc, 0x044c, 0xffff, 0xffff, 0x03c4, 0x0461,
+    0x048e, 0x0118, 0x04b7, 0x04b4, 0x0396, 0x03fa, 0x040b, 0x04d5, 0x008c, 0x018c, 0x03f3, 0x04ba,
+    0x04d2, 0x03bc, 0x03bd, 0x03cf, 0x043b, 0x048d, 0x03ed, 0x02d3, 0x0449, 0x01b4, 0x04de, 0x0437,
+    0x0438, 0x04a6, 0x03d3, 0x0479, 0x04d7, 0x04b6, 0x04f1, 0x01c7, 0x02fb, 0x02da, 0x0307, 0x02c6,
+    0x03e6, 0x04e7, 0x0420, 0x02a0, 0x045b, 0x0436, 0x0422, 0x04a1, 0x00cd, 0x04f0, 0x04f2, 0x0502,
+    0x0314, 0x0336, 0x04c4, 0x04cf, 0x03c0, 0x0225, 0x03b0, 0x013c, 0x04ce, 0x02b4, 0x04b0, 0x04e5,
+    0x04ea, 0x047f, 0x04a5, 0x0361, 0x0338, 0x04c1, 0x046d, 0x04ff, 0x04d6, 0x04b1, 0x04d8, 0x03f6,
+    0x0510, 0x04a8, 0x0507, 0x047e, 0x051d, 0x037d, 0x04ad, 0x0486, 0x03e9, 0x0245, 0x0484, 0x04ed,
+    0x04b2, 0x0497, 0x030e, 0x050c, 0x0496, 0x043d, 0x0410, 0x04ae, 0x04fd, 0x049c, 0x0531, 0x049d,
+    0x0478, 0x0474, 0x040e, 0x04ca, 0x04fe, 0x0324, 0x01b9, 0x0423, 0x0537, 0x050f, 0x052d, 0x043e,
+    0x044a, 0x04aa, 0x051e, 0x049b, 0x0471, 0x052e, 0x052f, 0x04d3, 0x0503, 0x04e2, 0x03a5, 0x02f7,
+    0x04f6, 0x04f7, 0x04f8, 0x04f9, 0x04ac, 0x03c8, 0x0428, 0x0501, 0x053b, 0x04b9, 0x04e1, 0x045e,
+    0x04e0, 0x0547, 0x04d4, 0x04db, 0x0399, 0x0559, 0x01d9, 0x0514, 0x052b, 0x04f5, 0x04c6, 0x0530,
+    0x04a4, 0x0560, 0x0543, 0x04c7, 0xffff, 0x04bd, 0x0105, 0x0542, 0x04d1, 0x055f, 0x0565, 0x0561,
+    0x0562, 0x0563, 0x0564, 0x056e, 0x0566, 0x0567, 0x0568, 0x0569, 0x044d, 0x028f, 0x01f5, 0x056d,
+    0x0573, 0x056f, 0x0570, 0x0571, 0x0572, 0x057c, 0x0574, 0x0575, 0x0576, 0x0577, 0x0472, 0x0551,
+    0x04bf, 0x0271, 0x0272, 0x0519, 0x04e6, 0x0553, 0x0548, 0x0521, 0x0522, 0x052c, 0x04d9, 0x04c2,
+    0x0580, 0xffff, 0x03b7, 0x02c5, 0x057b, 0x0581, 0x057d, 0x057e, 0x057f, 0x0594, 0x0599, 0x0582,
+    0x0583, 0x0584, 0x0585, 0x050b, 0xffff, 0x04fb, 0x0598, 0x059e, 0x059a, 0x059b, 0x059c, 0x059d,
+    0x05a7, 0x059f, 0x05a0, 0x05a1, 0x05a2, 0x024a, 0x011e, 0x032f, 0x0593, 0x056b, 0x0392, 0x0499,
+    0x0532, 0x0450, 0x0597, 0x0458, 0x0591, 0x0464, 0x0482, 0x0527, 0x0558, 0x05a6, 0x0512, 0x04fc,
+    0x0463, 0x0515, 0x0493, 0x03d1, 0x0535, 0x058d, 0x058e, 0x05ca, 0x055a, 0x054c, 0xffff, 0x0529,
+    0x0473, 0x053e, 0x0481, 0x0550, 0x051c, 0x0589, 0x03ba, 0x05bc, 0x0429, 0x054e, 0x05d6, 0x05cf,
+    0x0556, 0x0549, 0x0518, 0x05ae, 0x05c8, 0x0536, 0x053c, 0x0538, 0x0539, 0x05d8, 0x0579, 0x0413,
+    0x0511, 0x05a9, 0x050d, 0x041a, 0x0066, 0x05bd, 0x05be, 0x05bf, 0x04b8, 0x0352, 0x045f, 0x05c9,
+    0x0414, 0x04c3, 0x054a, 0x054b, 0x05cd, 0x054d, 0x05d9, 0x054f, 0x04fa, 0xffff, 0xffff,
+};
@@ -48,6 +48,11 @@ const char *USX_TEMPLATES[] = {"tfff-of-tfTtf:rf:rf.fffZ", "tfff-of-tf", "(fff)
 /// possible horizontal sets and states
 enum { USX_ALPHA = 0, USX_SYM, USX_NUM, USX_DICT, USX_DELTA, USX_NUM_TEMP };
 
+/// Enum indicating nibble type - USX_NIB_NUM means ch is a number '0' to '9', \n
+/// USX_NIB_HEX_LOWER means ch is between 'a' to 'f', \n
+/// USX_NIB_HEX_UPPER means ch is between 'A' to 'F'
+enum { USX_NIB_NUM = 0, USX_NIB_HEX_LOWER, USX_NIB_HEX_UPPER, USX_NIB_NOT };
+
 /// This 2D array has the characters for the sets USX_ALPHA, USX_SYM and USX_NUM. Where a character cannot fit into a uint8_t, 0
 /// is used and handled in code.
 uint8_t usx_sets[][28] = {{0,   ' ', 'e', 't', 'a', 'o', 'i', 'n', 's', 'r', 'l', 'c', 'd', 'h',
@@ -119,12 +124,25 @@ const int UTF8_PREFIX[] = {0xC0, 0xE0, 0xF0};
 /// Offset at which usx_code_94 starts
 #define USX_OFFSET_94 33
 
+/// Character classes used by the encoder, one lookup instead of a chain of range compares per character. \n
+/// Low 2 bits - nibble type (USX_NIB_*), USX_CC_UPPER set for 'A' to 'Z'
+uint8_t usx_char_class[256];
+#define USX_CC_NIB_MASK 0x03
+#define USX_CC_UPPER 0x04
+
+/// Vertical decoder lookup indexed by the next 8 bits of the stream, see readVCodeIdx(). \n
+/// Same encoding as usx_vcode_lookup: 3 bits code len - 1, 5 bits vertical pos
+uint8_t usx_vcode_lookup256[256];
+
 /// global to indicate whether initialization is complete or not
 uint8_t is_inited = 0;
 
+static uint8_t lookupVCode(uint8_t code);
+
 /// Fills the usx_code_94 94 letter array based on sets of characters at usx_sets \n
 /// For each element in usx_code_94, first 3 msb bits is set (USX_ALPHA / USX_SYM / USX_NUM) \n
-/// and the rest 5 bits indicate the vertical position in the corresponding set
+/// and the rest 5 bits indicate the vertical position in the corresponding set. \n
+/// Also builds the character class and vertical decoder lookup tables.
 void init_coder()
 {
     if (is_inited)
@@ -140,9 +158,41 @@ void init_coder()
             }
         }
     }
+    for (int c = 0; c < 256; c++) {
+        uint8_t cls = USX_NIB_NOT;
+        if (c >= '0' && c <= '9')
+            cls = USX_NIB_NUM;
+        else if (c >= 'a' && c <= 'f')
+            cls = USX_NIB_HEX_LOWER;
+        else if (c >= 'A' && c <= 'F')
+            cls = USX_NIB_HEX_UPPER;
+        if (c >= 'A' && c <= 'Z')
+            cls |= USX_CC_UPPER;
+        usx_char_class[c] = cls;
+        usx_vcode_lookup256[c] = lookupVCode(c);
+    }
     is_inited = 1;
 }
 
+/// Returns 1 if every byte of the 4 packed in w is between lo and hi (both below 0x80), testing all of them at once
+static inline int allBytesInRange(uint32_t w, uint8_t lo, uint8_t hi)
+{
+    const uint32_t ones = 0x01010101;
+    const uint32_t highs = 0x80808080;
+    uint32_t low7 = w & ~highs;                           // No carries between bytes below
+    uint32_t ge_lo = (low7 + ones * (0x80 - lo)) & highs; // High bit set where byte >= lo
+    uint32_t gt_hi = (low7 + ones * (0x7F - hi)) & highs; // High bit set where byte > hi
+    return (ge_lo & ~gt_hi & ~w & highs) == highs;
+}
+
+/// Returns 1 if the 5 characters at in are all upper case letters
+static inline int isUpperRun5(const char *in)
+{
+    uint32_t w;
+    memcpy(&w, in, sizeof(w));
+    return allBytesInRange(w, 'A', 'Z') && (usx_char_class[(uint8_t)in[4]] & USX_CC_UPPER);
+}
+
 /// Mask for retrieving each code to be encoded according to its length
 unsigned int usx_mask[] = {0x80, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC, 0xFE, 0xFF};
 
@@ -345,7 +395,14 @@ int matchOccurance(const char *in, int len, int l, char *out, int olen, int *ol,
     int j, k;
     int longest_dist = 0;
     int longest_len = 0;
+    // Anything shorter than NICE_LEN is discarded below, so compare the first NICE_LEN bytes a word at a time up front
+    uint32_t head4;
+    memcpy(&head4, in + l, sizeof(head4));
     for (j = l - NICE_LEN; j >= 0; j--) {
+        uint32_t cand4;
+        memcpy(&cand4, in + j, sizeof(cand4));
+        if (cand4 != head4 || in[j + 4] != in[l + 4])
+            continue;
         for (k = l; k < len && j + k - l < l; k++) {
             if (in[k] != in[j + k - l])
                 break;
@@ -455,21 +512,11 @@ uint8_t getBaseCode(char ch)
     return 0;
 }
 
-/// Enum indicating nibble type - USX_NIB_NUM means ch is a number '0' to '9', \n
-/// USX_NIB_HEX_LOWER means ch is between 'a' to 'f', \n
-/// USX_NIB_HEX_UPPER means ch is between 'A' to 'F'
-enum { USX_NIB_NUM = 0, USX_NIB_HEX_LOWER, USX_NIB_HEX_UPPER, USX_NIB_NOT };
-/// Gets 4 bit code assuming ch falls between '0' to '9', \n
+/// Gets nibble type (USX_NIB_*) of ch, USX_NIB_NOT unless it falls between '0' to '9', \n
 /// 'A' to 'F' or 'a' to 'f'
 char getNibbleType(char ch)
 {
-    if (ch >= '0' && ch <= '9')
-        return USX_NIB_NUM;
-    else if (ch >= 'a' && ch <= 'f')
-        return USX_NIB_HEX_LOWER;
-    else if (ch >= 'A' && ch <= 'F')
-        return USX_NIB_HEX_UPPER;
-    return USX_NIB_NOT;
+    return usx_char_class[(uint8_t)ch] & USX_CC_NIB_MASK;
 }
 
 /// Starts coding of nibble sets
@@ -530,7 +577,7 @@ int unishox2_compress_lines(const char *in, int len, UNISHOX_API_OUT_AND_LEN(cha
 
     uint8_t state;
 
-    int l, ll, ol;
+    int l, ol;
     char c_in, c_next;
     int prev_uni;
     uint8_t is_upper, is_all_upper;
@@ -548,6 +595,15 @@ int unishox2_compress_lines(const char *in, int len, UNISHOX_API_OUT_AND_LEN(cha
 #endif
 
     init_coder();
+
+    // These are checked at every position, measure them once
+    int template_lens[5] = {0};
+    int freq_seq_lens[6] = {0};
+    for (int i = 0; usx_templates != NULL && i < 5; i++)
+        template_lens[i] = usx_templates[i] ? (int)strlen(usx_templates[i]) : 0;
+    for (int i = 0; usx_freq_seq != NULL && i < 6; i++)
+        freq_seq_lens[i] = (int)strlen(usx_freq_seq[i]);
+
     ol = 0;
     prev_uni = 0;
     state = USX_ALPHA;
@@ -656,7 +712,7 @@ int unishox2_compress_lines(const char *in, int len, UNISHOX_API_OUT_AND_LEN(cha
             int i;
             for (i = 0; i < 5; i++) {
                 if (usx_templates[i]) {
-                    int rem = (int)strlen(usx_templates[i]);
+                    int rem = template_lens[i];
                     int j = 0;
                     for (; j < rem && l + j < len; j++) {
                         char c_t = usx_templates[i][j];
@@ -702,7 +758,7 @@ int unishox2_compress_lines(const char *in, int len, UNISHOX_API_OUT_AND_LEN(cha
         if (usx_freq_seq != NULL) {
             int i;
             for (i = 0; i < 6; i++) {
-                int seq_len = (int)strlen(usx_freq_seq[i]);
+                int seq_len = freq_seq_lens[i];
                 if (len - seq_len >= 0 && l <= len - seq_len) {
                     if (memcmp(usx_freq_seq[i], in + l, seq_len) == 0 && usx_hcode_lens[usx_freq_codes[i] >> 5]) {
                         SAFE_APPEND_BITS2(rawolen,
@@ -720,7 +776,7 @@ int unishox2_compress_lines(const char *in, int len, UNISHOX_API_OUT_AND_LEN(cha
         c_in = in[l];
 
         is_upper = 0;
-        if (c_in >= 'A' && c_in <= 'Z')
+        if (usx_char_class[(uint8_t)c_in] & USX_CC_UPPER)
             is_upper = 1;
         else {
             if (is_all_upper) {
@@ -750,11 +806,7 @@ int unishox2_compress_lines(const char *in, int len, UNISHOX_API_OUT_AND_LEN(cha
 
         if (c_in >= 32 && c_in <= 126) {
             if (is_upper && !is_all_upper) {
-                for (ll = l + 4; ll >= l && ll < len; ll--) {
-                    if (in[ll] < 'A' || in[ll] > 'Z')
-                        break;
-                }
-                if (ll == l - 1) {
+                if (l + 4 < len && isUpperRun5(in + l)) {
                     SAFE_APPEND_BITS2(rawolen, ol = append_switch_code(out, olen, ol, state));
                     SAFE_APPEND_BITS2(rawolen, ol = append_bits(out, olen, ol, usx_hcodes[USX_ALPHA], usx_hcode_lens[USX_ALPHA]));
                     state = USX_ALPHA;
@@ -879,7 +931,7 @@ int unishox2_compress_simple(const char *in, int len, char *out)
 // Reads one bit from in
 int readBit(const char *in, int bit_no)
 {
-    return in[bit_no >> 3] & (0x80 >> (bit_no % 8));
+    return in[bit_no >> 3] & (0x80 >> (bit_no & 7));
 }
 
 // Reads next 8 bits, if available
@@ -919,27 +971,28 @@ uint8_t usx_vcode_lookup[36] = {(1 << 5) + 0,  (1 << 5) + 0,  (2 << 5) + 1,  (2
                                 (6 << 5) + 17, (6 << 5) + 17, (7 << 5) + 18, (7 << 5) + 19, (7 << 5) + 20, (7 << 5) + 21,
                                 (7 << 5) + 22, (7 << 5) + 23, (7 << 5) + 24, (7 << 5) + 25, (7 << 5) + 26, (7 << 5) + 27};
 
+/// Finds the vertical code for the next 8 bits (code) by splitting the list of vertical codes into sections. \n
+/// Only used by init_coder() to expand usx_vcode_lookup into usx_vcode_lookup256.
+static uint8_t lookupVCode(uint8_t code)
+{
+    int i = 0;
+    while (code > usx_vsections[i])
+        i++;
+    return usx_vcode_lookup[usx_vsection_pos[i] + ((code & usx_vsection_mask[i]) >> usx_vsection_shift[i])];
+}
+
 /// Decodes the vertical code from the given bitstream at in \n
-/// This is designed to use less memory using a 36 uint8_t buffer \n
-/// compared to using a 256 uint8_t buffer to decode the next 8 bits read by read8bitCode() \n
-/// by splitting the list of vertical codes. \n
-/// Decoder is designed for using less memory, not speed. \n
+/// with a single lookup of the next 8 bits read by read8bitCode() in usx_vcode_lookup256. \n
 /// Returns the veritical code index or 99 if match could not be found. \n
 /// Also updates bit_no_p with how many ever bits used by the vertical code.
 int readVCodeIdx(const char *in, int len, int *bit_no_p)
 {
     if (*bit_no_p < len) {
-        uint8_t code = read8bitCode(in, len, *bit_no_p);
-        int i = 0;
-        do {
-            if (code <= usx_vsections[i]) {
-                uint8_t vcode = usx_vcode_lookup[usx_vsection_pos[i] + ((code & usx_vsection_mask[i]) >> usx_vsection_shift[i])];
-                (*bit_no_p) += ((vcode >> 5) + 1);
-                if (*bit_no_p > len)
-                    return 99;
-                return vcode & 0x1F;
-            }
-        } while (++i < SECTION_COUNT);
+        uint8_t vcode = usx_vcode_lookup256[read8bitCode(in, len, *bit_no_p)];
+        (*bit_no_p) += ((vcode >> 5) + 1);
+        if (*bit_no_p > len)
+            return 99;
+        return vcode & 0x1F;
     }
     return 99;
 }
@@ -967,32 +1020,49 @@ int readHCodeIdx(const char *in, int len, int *bit_no_p, const uint8_t usx_hcode
     return 99;
 }
 
-// TODO: Last value check.. Also len check in readBit
-/// Returns the position of step code (0, 10, 110, etc.) encountered in the stream
+/// Returns the position of step code (0, 10, 110, etc.) encountered in the stream \n
+/// Counts the leading 1 bits of the next 8 bits in one go, limit is never more than 5. \n
+/// Returns 99 if the stream ends before the step code does.
 int getStepCodeIdx(const char *in, int len, int *bit_no_p, int limit)
 {
-    int idx = 0;
-    while (*bit_no_p < len && readBit(in, *bit_no_p)) {
-        idx++;
-        (*bit_no_p)++;
-        if (idx == limit)
-            return idx;
+    int avail = len - *bit_no_p;
+    if (avail <= 0)
+        return 99;
+    uint8_t code = read8bitCode(in, len, *bit_no_p);
+    int ones = __builtin_clz(((uint32_t)(uint8_t)~code << 24) | 0x00FFFFFF);
+    if (ones >= limit && avail >= limit) {
+        (*bit_no_p) += limit;
+        return limit;
     }
-    if (*bit_no_p >= len)
+    if (ones >= avail) {
+        // Only 1s up to the end of the stream
+        (*bit_no_p) += avail;
         return 99;
-    (*bit_no_p)++;
-    return idx;
+    }
+    (*bit_no_p) += ones + 1;
+    return ones;
 }
 
-/// Reads specified number of bits and builds the corresponding integer
+/// Reads specified number of bits and builds the corresponding integer \n
+/// Takes as many bits as are left in the current byte at a time. Returns -1 if there are not enough bits left.
 int32_t getNumFromBits(const char *in, int len, int bit_no, int count)
 {
+    if (count == 0)
+        return 0;
+    if (bit_no + count > len)
+        return -1;
     int32_t ret = 0;
-    while (count-- && bit_no < len) {
-        ret += (readBit(in, bit_no) ? 1 << count : 0);
-        bit_no++;
+    const int end = bit_no + count;
+    while (bit_no < end) {
+        int bit_pos = bit_no & 7;
+        int take = 8 - bit_pos;
+        if (take > end - bit_no)
+            take = end - bit_no;
+        uint8_t bits = ((uint8_t)in[bit_no >> 3] >> (8 - bit_pos - take)) & ((1 << take) - 1);
+        ret = (ret << take) | bits;
+        bit_no += take;
     }
-    return count < 0 ? ret : -1;
+    return ret;
 }
 
 /// Decodes the count from the given bit stream at in. Also updates bit_no_p
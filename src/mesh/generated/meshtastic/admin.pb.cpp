@@ -21,6 +21,12 @@ PB_BIND(meshtastic_SharedContact, meshtastic_SharedContact, AUTO)
 PB_BIND(meshtastic_KeyVerificationAdmin, meshtastic_KeyVerificationAdmin, AUTO)
 
 
+PB_BIND(meshtastic_PipelineLatency, meshtastic_PipelineLatency, AUTO)
+
+
+PB_BIND(meshtastic_PipelineStatsPage, meshtastic_PipelineStatsPage, AUTO)
+
+
 
 
 
@@ -132,6 +132,31 @@ typedef struct _meshtastic_KeyVerificationAdmin {
     uint32_t security_number;
 } meshtastic_KeyVerificationAdmin;
 
+/* Latency summary of one part of the packet pipeline, in microseconds */
+typedef struct _meshtastic_PipelineLatency {
+    /* Stage or module name, SPI bus waits are prefixed with spi_ */
+    char name[32];
+    /* How many samples the summary covers */
+    uint32_t count;
+    /* Median, rounded up to a power of two bucket */
+    uint32_t p50_us;
+    /* 95th percentile, rounded up to a power of two bucket */
+    uint32_t p95_us;
+    /* Longest sample seen */
+    uint32_t max_us;
+} meshtastic_PipelineLatency;
+
+/* Response envelope for get_pipeline_stats_request, request the next page at offset + entries count until total */
+typedef struct _meshtastic_PipelineStatsPage {
+    /* Index of the first entry */
+    uint32_t offset;
+    /* How many summaries the node has */
+    uint32_t total;
+    /* The summaries */
+    pb_size_t entries_count;
+    meshtastic_PipelineLatency entries[3];
+} meshtastic_PipelineStatsPage;
+
 typedef PB_BYTES_ARRAY_T(8) meshtastic_AdminMessage_session_passkey_t;
 /* This message is handled by the Admin module and is responsible for all settings/channel read/write operations.
  This message is used to do settings operations to both remote AND local nodes.
@@ -191,6 +216,10 @@ typedef struct _meshtastic_AdminMessage {
         meshtastic_AdminMessage_BackupLocation restore_preferences;
         /* Remove backups of the node's preferences */
         meshtastic_AdminMessage_BackupLocation remove_backup_preferences;
+        /* Ask for the packet pipeline latency summaries, starting at this index */
+        uint32_t get_pipeline_stats_request;
+        /* One page of packet pipeline latency summaries */
+        meshtastic_PipelineStatsPage get_pipeline_stats_response;
         /* Set the owner for this node */
         meshtastic_User set_owner;
         /* Set channels (using the new API).
@@ -302,11 +331,15 @@ extern "C" {
 #define meshtastic_NodeRemoteHardwarePinsResponse_init_default {0, {meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default, meshtastic_NodeRemoteHardwarePin_init_default}}
 #define meshtastic_SharedContact_init_default    {0, false, meshtastic_User_init_default}
 #define meshtastic_KeyVerificationAdmin_init_default {_meshtastic_KeyVerificationAdmin_MessageType_MIN, 0, 0, false, 0}
+#define meshtastic_PipelineLatency_init_default  {"", 0, 0, 0, 0}
+#define meshtastic_PipelineStatsPage_init_default {0, 0, 0, {meshtastic_PipelineLatency_init_default, meshtastic_PipelineLatency_init_default, meshtastic_PipelineLatency_init_default}}
 #define meshtastic_AdminMessage_init_zero        {0, {0}, {0, {0}}}
 #define meshtastic_HamParameters_init_zero       {"", 0, 0, ""}
 #define meshtastic_NodeRemoteHardwarePinsResponse_init_zero {0, {meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero, meshtastic_NodeRemoteHardwarePin_init_zero}}
 #define meshtastic_SharedContact_init_zero       {0, false, meshtastic_User_init_zero}
 #define meshtastic_KeyVerificationAdmin_init_zero {_meshtastic_KeyVerificationAdmin_MessageType_MIN, 0, 0, false, 0}
+#define meshtastic_PipelineLatency_init_zero     {"", 0, 0, 0, 0}
+#define meshtastic_PipelineStatsPage_init_zero   {0, 0, 0, {meshtastic_PipelineLatency_init_zero, meshtastic_PipelineLatency_init_zero, meshtastic_PipelineLatency_init_zero}}
 
 /* Field tags (for use in manual encoding/decoding) */
 #define meshtastic_HamParameters_call_sign_tag   1
@@ -320,6 +353,14 @@ extern "C" {
 #define meshtastic_KeyVerificationAdmin_remote_nodenum_tag 2
 #define meshtastic_KeyVerificationAdmin_nonce_tag 3
 #define meshtastic_KeyVerificationAdmin_security_number_tag 4
+#define meshtastic_PipelineLatency_name_tag      1
+#define meshtastic_PipelineLatency_count_tag     2
+#define meshtastic_PipelineLatency_p50_us_tag    3
+#define meshtastic_PipelineLatency_p95_us_tag    4
+#define meshtastic_PipelineLatency_max_us_tag    5
+#define meshtastic_PipelineStatsPage_offset_tag  1
+#define meshtastic_PipelineStatsPage_total_tag   2
+#define meshtastic_PipelineStatsPage_entries_tag 3
 #define meshtastic_AdminMessage_get_channel_request_tag 1
 #define meshtastic_AdminMessage_get_channel_response_tag 2
 #define meshtastic_AdminMessage_get_owner_request_tag 3
@@ -345,6 +386,8 @@ extern "C" {
 #define meshtastic_AdminMessage_backup_preferences_tag 24
 #define meshtastic_AdminMessage_restore_preferences_tag 25
 #define meshtastic_AdminMessage_remove_backup_preferences_tag 26
+#define meshtastic_AdminMessage_get_pipeline_stats_request_tag 27
+#define meshtastic_AdminMessage_get_pipeline_stats_response_tag 28
 #define meshtastic_AdminMessage_set_owner_tag    32
 #define meshtastic_AdminMessage_set_channel_tag  33
 #define meshtastic_AdminMessage_set_config_tag   34
@@ -402,6 +445,8 @@ X(a, STATIC,   ONEOF,    UINT32,   (payload_variant,set_scale,set_scale),  23) \
 X(a, STATIC,   ONEOF,    UENUM,    (payload_variant,backup_preferences,backup_preferences),  24) \
 X(a, STATIC,   ONEOF,    UENUM,    (payload_variant,restore_preferences,restore_preferences),  25) \
 X(a, STATIC,   ONEOF,    UENUM,    (payload_variant,remove_backup_preferences,remove_backup_preferences),  26) \
+X(a, STATIC,   ONEOF,    UINT32,   (payload_variant,get_pipeline_stats_request,get_pipeline_stats_request),  27) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload_variant,get_pipeline_stats_response,get_pipeline_stats_response),  28) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (payload_variant,set_owner,set_owner),  32) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (payload_variant,set_channel,set_channel),  33) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (payload_variant,set_config,set_config),  34) \
@@ -441,6 +486,7 @@ X(a, STATIC,   SINGULAR, BYTES,    session_passkey, 101)
 #define meshtastic_AdminMessage_payload_variant_get_device_connection_status_response_MSGTYPE meshtastic_DeviceConnectionStatus
 #define meshtastic_AdminMessage_payload_variant_set_ham_mode_MSGTYPE meshtastic_HamParameters
 #define meshtastic_AdminMessage_payload_variant_get_node_remote_hardware_pins_response_MSGTYPE meshtastic_NodeRemoteHardwarePinsResponse
+#define meshtastic_AdminMessage_payload_variant_get_pipeline_stats_response_MSGTYPE meshtastic_PipelineStatsPage
 #define meshtastic_AdminMessage_payload_variant_set_owner_MSGTYPE meshtastic_User
 #define meshtastic_AdminMessage_payload_variant_set_channel_MSGTYPE meshtastic_Channel
 #define meshtastic_AdminMessage_payload_variant_set_config_MSGTYPE meshtastic_Config
@@ -480,11 +526,30 @@ X(a, STATIC,   OPTIONAL, UINT32,   security_number,   4)
 #define meshtastic_KeyVerificationAdmin_CALLBACK NULL
 #define meshtastic_KeyVerificationAdmin_DEFAULT NULL
 
+#define meshtastic_PipelineLatency_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   name,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             2) \
+X(a, STATIC,   SINGULAR, UINT32,   p50_us,            3) \
+X(a, STATIC,   SINGULAR, UINT32,   p95_us,            4) \
+X(a, STATIC,   SINGULAR, UINT32,   max_us,            5)
+#define meshtastic_PipelineLatency_CALLBACK NULL
+#define meshtastic_PipelineLatency_DEFAULT NULL
+
+#define meshtastic_PipelineStatsPage_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            1) \
+X(a, STATIC,   SINGULAR, UINT32,   total,             2) \
+X(a, STATIC,   REPEATED, MESSAGE,  entries,           3)
+#define meshtastic_PipelineStatsPage_CALLBACK NULL
+#define meshtastic_PipelineStatsPage_DEFAULT NULL
+#define meshtastic_PipelineStatsPage_entries_MSGTYPE meshtastic_PipelineLatency
+
 extern const pb_msgdesc_t meshtastic_AdminMessage_msg;
 extern const pb_msgdesc_t meshtastic_HamParameters_msg;
 extern const pb_msgdesc_t meshtastic_NodeRemoteHardwarePinsResponse_msg;
 extern const pb_msgdesc_t meshtastic_SharedContact_msg;
 extern const pb_msgdesc_t meshtastic_KeyVerificationAdmin_msg;
+extern const pb_msgdesc_t meshtastic_PipelineLatency_msg;
+extern const pb_msgdesc_t meshtastic_PipelineStatsPage_msg;
 
 /* Defines for backwards compatibility with code written before nanopb-0.4.0 */
 #define meshtastic_AdminMessage_fields &meshtastic_AdminMessage_msg
@@ -492,6 +557,8 @@ extern const pb_msgdesc_t meshtastic_KeyVerificationAdmin_msg;
 #define meshtastic_NodeRemoteHardwarePinsResponse_fields &meshtastic_NodeRemoteHardwarePinsResponse_msg
 #define meshtastic_SharedContact_fields &meshtastic_SharedContact_msg
 #define meshtastic_KeyVerificationAdmin_fields &meshtastic_KeyVerificationAdmin_msg
+#define meshtastic_PipelineLatency_fields &meshtastic_PipelineLatency_msg
+#define meshtastic_PipelineStatsPage_fields &meshtastic_PipelineStatsPage_msg
 
 /* Maximum encoded size of messages (where known) */
 #define MESHTASTIC_MESHTASTIC_ADMIN_PB_H_MAX_SIZE meshtastic_AdminMessage_size
@@ -499,6 +566,8 @@ extern const pb_msgdesc_t meshtastic_KeyVerificationAdmin_msg;
 #define meshtastic_HamParameters_size            31
 #define meshtastic_KeyVerificationAdmin_size     25
 #define meshtastic_NodeRemoteHardwarePinsResponse_size 496
+#define meshtastic_PipelineLatency_size          57
+#define meshtastic_PipelineStatsPage_size        189
 #define meshtastic_SharedContact_size            123
 
 #ifdef __cplusplus
@@ -1,6 +1,7 @@
 #if !MESHTASTIC_EXCLUDE_WEBSERVER
 #include "NodeDB.h"
 #include "PowerFSM.h"
+#include "RTC.h"
 #include "RadioLibInterface.h"
 #include "airtime.h"
 #include "main.h"
@@ -13,6 +14,7 @@
 #include "SPILock.h"
 #include "power.h"
 #include "serialization/JSON.h"
+#include "serialization/JSONWriter.h"
 #include <FSCommon.h>
 #include <HTTPBodyParser.hpp>
 #include <HTTPMultipartBodyParser.hpp>
@@ -265,15 +267,18 @@ void htmlDeleteDir(const char *dirname)
     root.close();
 }
 
-JSONArray htmlListDir(const char *dirname, uint8_t levels)
+static void writeDirList(JSONWriter &json, const char *key, const char *dirname, uint8_t levels)
 {
+    json.beginArray(key);
     File root = FSCom.open(dirname, FILE_O_READ);
-    JSONArray fileList;
     if (!root) {
-        return fileList;
+        json.endArray();
+        return;
     }
     if (!root.isDirectory()) {
-        return fileList;
+        root.close();
+        json.endArray();
+        return;
     }
 
     // iterate over the file list
@@ -282,36 +287,31 @@ JSONArray htmlListDir(const char *dirname, uint8_t levels)
         if (file.isDirectory() && !String(file.name()).endsWith(".")) {
             if (levels) {
 #ifdef ARCH_ESP32
-                fileList.push_back(new JSONValue(htmlListDir(file.path(), levels - 1)));
+                writeDirList(json, NULL, file.path(), levels - 1);
 #else
-                fileList.push_back(new JSONValue(htmlListDir(file.name(), levels - 1)));
+                writeDirList(json, NULL, file.name(), levels - 1);
 #endif
-                file.close();
             }
         } else {
-            JSONObject thisFileMap;
-            thisFileMap["size"] = new JSONValue((int)file.size());
 #ifdef ARCH_ESP32
-            thisFileMap["name"] = new JSONValue(String(file.path()).substring(1).c_str());
+            String fileName = String(file.path()).substring(1);
 #else
-            thisFileMap["name"] = new JSONValue(String(file.name()).substring(1).c_str());
+            String fileName = String(file.name()).substring(1);
 #endif
+            json.beginObject();
+            json.add("size", (int)file.size());
+            json.add("name", fileName.c_str());
             if (String(file.name()).substring(1).endsWith(".gz")) {
-#ifdef ARCH_ESP32
-                String modifiedFile = String(file.path()).substring(1);
-#else
-                String modifiedFile = String(file.name()).substring(1);
-#endif
-                modifiedFile.remove((modifiedFile.length() - 3), 3);
-                thisFileMap["nameModified"] = new JSONValue(modifiedFile.c_str());
+                fileName.remove((fileName.length() - 3), 3);
+                json.add("nameModified", fileName.c_str());
             }
-            fileList.push_back(new JSONValue(thisFileMap));
+            json.endObject();
         }
         file.close();
         file = root.openNextFile();
     }
     root.close();
-    return fileList;
+    json.endArray();
 }
 
 void handleFsBrowseStatic(HTTPRequest *req, HTTPResponse *res)
@@ -321,27 +321,20 @@ void handleFsBrowseStatic(HTTPRequest *req, HTTPResponse *res)
     res->setHeader("Access-Control-Allow-Methods", "GET");
 
     concurrency::LockGuard g(spiLock);
-    auto fileList = htmlListDir("/static", 10);
-
-    // create json output structure
-    JSONObject filesystemObj;
-    filesystemObj["total"] = new JSONValue((int)FSCom.totalBytes());
-    filesystemObj["used"] = new JSONValue((int)FSCom.usedBytes());
-    filesystemObj["free"] = new JSONValue(int(FSCom.totalBytes() - FSCom.usedBytes()));
-
-    JSONObject jsonObjInner;
-    jsonObjInner["files"] = new JSONValue(fileList);
-    jsonObjInner["filesystem"] = new JSONValue(filesystemObj);
-
-    JSONObject jsonObjOuter;
-    jsonObjOuter["data"] = new JSONValue(jsonObjInner);
-    jsonObjOuter["status"] = new JSONValue("ok");
 
-    JSONValue *value = new JSONValue(jsonObjOuter);
-
-    res->print(value->Stringify().c_str());
-
-    delete value;
+    // Each file is written out as it is listed, rather than building the whole tree first
+    JSONWriter json(*res);
+    json.beginObject();
+    json.beginObject("data");
+    writeDirList(json, "files", "/static", 10);
+    json.beginObject("filesystem");
+    json.add("total", (int)FSCom.totalBytes());
+    json.add("used", (int)FSCom.usedBytes());
+    json.add("free", int(FSCom.totalBytes() - FSCom.usedBytes()));
+    json.endObject();
+    json.endObject();
+    json.add("status", "ok");
+    json.endObject();
 }
 
 void handleFsDeleteStatic(HTTPRequest *req, HTTPResponse *res)
@@ -592,6 +585,49 @@ void handleFormUpload(HTTPRequest *req, HTTPResponse *res)
     delete parser;
 }
 
+/// Bit i set for each of names[i] in the comma separated fields= parameter, all of them if there is none
+static uint32_t getFieldsParameter(ResourceParameters *params, const char *const names[], size_t numNames)
+{
+    std::string list;
+    if (!params->getQueryParameter("fields", list))
+        return UINT32_MAX;
+
+    uint32_t fields = 0;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos)
+            end = list.size();
+        for (size_t i = 0; i < numNames; i++) {
+            if (list.compare(start, end - start, names[i]) == 0)
+                fields |= 1UL << i;
+        }
+        start = end + 1;
+    }
+    return fields;
+}
+
+static uint32_t getNumberParameter(ResourceParameters *params, const char *name, uint32_t defaultValue)
+{
+    std::string value;
+    if (!params->getQueryParameter(name, value) || value.empty())
+        return defaultValue;
+    return strtoul(value.c_str(), NULL, 10);
+}
+
+static void writeAirtimeLog(JSONWriter &json, const char *key, reportTypes reportType)
+{
+    json.beginArray(key);
+    uint32_t *logArray = airTime->airtimeReport(reportType);
+    for (int i = 0; i < airTime->getPeriodsToLog(); i++) {
+        json.add(NULL, (int)logArray[i]);
+    }
+    json.endArray();
+}
+
+enum ReportField { REPORT_AIRTIME, REPORT_WIFI, REPORT_MEMORY, REPORT_POWER, REPORT_DEVICE, REPORT_RADIO };
+static const char *const reportFieldNames[] = {"airtime", "wifi", "memory", "power", "device", "radio"};
+
 void handleReport(HTTPRequest *req, HTTPResponse *res)
 {
     ResourceParameters *params = req->getParams();
@@ -610,90 +646,130 @@ void handleReport(HTTPRequest *req, HTTPResponse *res)
         res->println("<pre>");
     }
 
-    // data->airtime->tx_log
-    JSONArray txLogValues;
-    uint32_t *logArray;
-    logArray = airTime->airtimeReport(TX_LOG);
-    for (int i = 0; i < airTime->getPeriodsToLog(); i++) {
-        txLogValues.push_back(new JSONValue((int)logArray[i]));
+    // ?fields=airtime,power only reports those sections
+    uint32_t fields = getFieldsParameter(params, reportFieldNames, sizeof(reportFieldNames) / sizeof(reportFieldNames[0]));
+
+    JSONWriter json(*res);
+    json.beginObject();
+    json.beginObject("data");
+
+    if (fields & (1 << REPORT_AIRTIME)) {
+        json.beginObject("airtime");
+        writeAirtimeLog(json, "tx_log", TX_LOG);
+        writeAirtimeLog(json, "rx_log", RX_LOG);
+        writeAirtimeLog(json, "rx_all_log", RX_ALL_LOG);
+        json.add("channel_utilization", airTime->channelUtilizationPercent());
+        json.add("utilization_tx", airTime->utilizationTXPercent());
+        json.add("seconds_since_boot", int(airTime->getSecondsSinceBoot()));
+        json.add("seconds_per_period", int(airTime->getSecondsPerPeriod()));
+        json.add("periods_to_log", airTime->getPeriodsToLog());
+        json.endObject();
     }
 
-    // data->airtime->rx_log
-    JSONArray rxLogValues;
-    logArray = airTime->airtimeReport(RX_LOG);
-    for (int i = 0; i < airTime->getPeriodsToLog(); i++) {
-        rxLogValues.push_back(new JSONValue((int)logArray[i]));
+    if (fields & (1 << REPORT_WIFI)) {
+        json.beginObject("wifi");
+        json.add("rssi", WiFi.RSSI());
+        json.add("ip", WiFi.localIP().toString().c_str());
+        json.endObject();
     }
 
-    // data->airtime->rx_all_log
-    JSONArray rxAllLogValues;
-    logArray = airTime->airtimeReport(RX_ALL_LOG);
-    for (int i = 0; i < airTime->getPeriodsToLog(); i++) {
-        rxAllLogValues.push_back(new JSONValue((int)logArray[i]));
-    }
-
-    // data->airtime
-    JSONObject jsonObjAirtime;
-    jsonObjAirtime["tx_log"] = new JSONValue(txLogValues);
-    jsonObjAirtime["rx_log"] = new JSONValue(rxLogValues);
-    jsonObjAirtime["rx_all_log"] = new JSONValue(rxAllLogValues);
-    jsonObjAirtime["channel_utilization"] = new JSONValue(airTime->channelUtilizationPercent());
-    jsonObjAirtime["utilization_tx"] = new JSONValue(airTime->utilizationTXPercent());
-    jsonObjAirtime["seconds_since_boot"] = new JSONValue(int(airTime->getSecondsSinceBoot()));
-    jsonObjAirtime["seconds_per_period"] = new JSONValue(int(airTime->getSecondsPerPeriod()));
-    jsonObjAirtime["periods_to_log"] = new JSONValue(airTime->getPeriodsToLog());
-
-    // data->wifi
-    JSONObject jsonObjWifi;
-    jsonObjWifi["rssi"] = new JSONValue(WiFi.RSSI());
-    jsonObjWifi["ip"] = new JSONValue(WiFi.localIP().toString().c_str());
-
-    // data->memory
-    JSONObject jsonObjMemory;
-    jsonObjMemory["heap_total"] = new JSONValue((int)memGet.getHeapSize());
-    jsonObjMemory["heap_free"] = new JSONValue((int)memGet.getFreeHeap());
-    jsonObjMemory["psram_total"] = new JSONValue((int)memGet.getPsramSize());
-    jsonObjMemory["psram_free"] = new JSONValue((int)memGet.getFreePsram());
-    spiLock->lock();
-    jsonObjMemory["fs_total"] = new JSONValue((int)FSCom.totalBytes());
-    jsonObjMemory["fs_used"] = new JSONValue((int)FSCom.usedBytes());
-    jsonObjMemory["fs_free"] = new JSONValue(int(FSCom.totalBytes() - FSCom.usedBytes()));
-    spiLock->unlock();
-
-    // data->power
-    JSONObject jsonObjPower;
-    jsonObjPower["battery_percent"] = new JSONValue(powerStatus->getBatteryChargePercent());
-    jsonObjPower["battery_voltage_mv"] = new JSONValue(powerStatus->getBatteryVoltageMv());
-    jsonObjPower["has_battery"] = new JSONValue(BoolToString(powerStatus->getHasBattery()));
-    jsonObjPower["has_usb"] = new JSONValue(BoolToString(powerStatus->getHasUSB()));
-    jsonObjPower["is_charging"] = new JSONValue(BoolToString(powerStatus->getIsCharging()));
-
-    // data->device
-    JSONObject jsonObjDevice;
-    jsonObjDevice["reboot_counter"] = new JSONValue((int)myNodeInfo.reboot_count);
-
-    // data->radio
-    JSONObject jsonObjRadio;
-    jsonObjRadio["frequency"] = new JSONValue(RadioLibInterface::instance->getFreq());
-    jsonObjRadio["lora_channel"] = new JSONValue((int)RadioLibInterface::instance->getChannelNum() + 1);
-
-    // collect data to inner data object
-    JSONObject jsonObjInner;
-    jsonObjInner["airtime"] = new JSONValue(jsonObjAirtime);
-    jsonObjInner["wifi"] = new JSONValue(jsonObjWifi);
-    jsonObjInner["memory"] = new JSONValue(jsonObjMemory);
-    jsonObjInner["power"] = new JSONValue(jsonObjPower);
-    jsonObjInner["device"] = new JSONValue(jsonObjDevice);
-    jsonObjInner["radio"] = new JSONValue(jsonObjRadio);
-
-    // create json output structure
-    JSONObject jsonObjOuter;
-    jsonObjOuter["data"] = new JSONValue(jsonObjInner);
-    jsonObjOuter["status"] = new JSONValue("ok");
-    // serialize and write it to the stream
-    JSONValue *value = new JSONValue(jsonObjOuter);
-    res->print(value->Stringify().c_str());
-    delete value;
+    if (fields & (1 << REPORT_MEMORY)) {
+        json.beginObject("memory");
+        json.add("heap_total", (int)memGet.getHeapSize());
+        json.add("heap_free", (int)memGet.getFreeHeap());
+        json.add("psram_total", (int)memGet.getPsramSize());
+        json.add("psram_free", (int)memGet.getFreePsram());
+        spiLock->lock();
+        uint64_t fsTotal = FSCom.totalBytes(), fsUsed = FSCom.usedBytes();
+        spiLock->unlock();
+        json.add("fs_total", (int)fsTotal);
+        json.add("fs_used", (int)fsUsed);
+        json.add("fs_free", int(fsTotal - fsUsed));
+        json.endObject();
+    }
+
+    if (fields & (1 << REPORT_POWER)) {
+        json.beginObject("power");
+        json.add("battery_percent", powerStatus->getBatteryChargePercent());
+        json.add("battery_voltage_mv", powerStatus->getBatteryVoltageMv());
+        json.add("has_battery", BoolToString(powerStatus->getHasBattery()));
+        json.add("has_usb", BoolToString(powerStatus->getHasUSB()));
+        json.add("is_charging", BoolToString(powerStatus->getIsCharging()));
+        json.endObject();
+    }
+
+    if (fields & (1 << REPORT_DEVICE)) {
+        json.beginObject("device");
+        json.add("reboot_counter", (int)myNodeInfo.reboot_count);
+        json.endObject();
+    }
+
+    if (fields & (1 << REPORT_RADIO)) {
+        json.beginObject("radio");
+        json.add("frequency", RadioLibInterface::instance->getFreq());
+        json.add("lora_channel", (int)RadioLibInterface::instance->getChannelNum() + 1);
+        json.endObject();
+    }
+
+    json.endObject();
+    json.add("status", "ok");
+    json.endObject();
+}
+
+enum NodeField {
+    NODE_SNR,
+    NODE_VIA_MQTT,
+    NODE_LAST_HEARD,
+    NODE_POSITION,
+    NODE_LONG_NAME,
+    NODE_SHORT_NAME,
+    NODE_MAC_ADDRESS,
+    NODE_HW_MODEL
+};
+static const char *const nodeFieldNames[] = {"snr",       "via_mqtt",   "last_heard",  "position",
+                                             "long_name", "short_name", "mac_address", "hw_model"};
+
+static void writeNode(JSONWriter &json, const meshtastic_NodeInfoLite *node, uint32_t fields)
+{
+    json.beginObject();
+
+    char id[16];
+    snprintf(id, sizeof(id), "!%08x", node->num);
+    json.add("id", id);
+
+    if (fields & (1 << NODE_SNR))
+        json.add("snr", node->snr);
+    if (fields & (1 << NODE_VIA_MQTT))
+        json.add("via_mqtt", BoolToString(node->via_mqtt));
+    if (fields & (1 << NODE_LAST_HEARD))
+        json.add("last_heard", (int)node->last_heard);
+
+    if (fields & (1 << NODE_POSITION)) {
+        if (nodeDB->hasValidPosition(node)) {
+            json.beginObject("position");
+            json.add("latitude", (float)node->position.latitude_i * 1e-7);
+            json.add("longitude", (float)node->position.longitude_i * 1e-7);
+            json.add("altitude", (int)node->position.altitude);
+            json.endObject();
+        } else {
+            json.addNull("position");
+        }
+    }
+
+    if (fields & (1 << NODE_LONG_NAME))
+        json.add("long_name", node->user.long_name);
+    if (fields & (1 << NODE_SHORT_NAME))
+        json.add("short_name", node->user.short_name);
+    if (fields & (1 << NODE_MAC_ADDRESS)) {
+        char macStr[18];
+        snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X", node->user.macaddr[0], node->user.macaddr[1],
+                 node->user.macaddr[2], node->user.macaddr[3], node->user.macaddr[4], node->user.macaddr[5]);
+        json.add("mac_address", macStr);
+    }
+    if (fields & (1 << NODE_HW_MODEL))
+        json.add("hw_model", (int)node->user.hw_model);
+
+    json.endObject();
 }
 
 void handleNodes(HTTPRequest *req, HTTPResponse *res)
@@ -714,57 +790,45 @@ void handleNodes(HTTPRequest *req, HTTPResponse *res)
         res->println("<pre>");
     }
 
-    JSONArray nodesArray;
-
+    /*
+        ?since= only lists nodes heard from at or after that time (seconds since 1970, like last_heard). Pass the time of
+        the previous reply to get just what changed. ?offset= and ?limit= page through the nodes that are listed, total
+        counts all of them. ?fields=long_name,position picks what to send besides the id. total and time are only sent
+        when paging or polling, so the plain node list stays as it was.
+    */
+    bool paged = params->isQueryParameterSet("offset") || params->isQueryParameterSet("limit") ||
+                 params->isQueryParameterSet("since");
+    uint32_t offset = getNumberParameter(params, "offset", 0);
+    uint32_t limit = getNumberParameter(params, "limit", UINT32_MAX);
+    uint32_t since = getNumberParameter(params, "since", 0);
+    uint32_t fields = getFieldsParameter(params, nodeFieldNames, sizeof(nodeFieldNames) / sizeof(nodeFieldNames[0]));
+
+    // Each node is written out as it is read, rather than building the whole list first
+    JSONWriter json(*res);
+    json.beginObject();
+    json.beginObject("data");
+    json.beginArray("nodes");
+
+    uint32_t total = 0;
     uint32_t readIndex = 0;
     const meshtastic_NodeInfoLite *tempNodeInfo = nodeDB->readNextMeshNode(readIndex);
     while (tempNodeInfo != NULL) {
-        if (tempNodeInfo->has_user) {
-            JSONObject node;
-
-            char id[16];
-            snprintf(id, sizeof(id), "!%08x", tempNodeInfo->num);
-
-            node["id"] = new JSONValue(id);
-            node["snr"] = new JSONValue(tempNodeInfo->snr);
-            node["via_mqtt"] = new JSONValue(BoolToString(tempNodeInfo->via_mqtt));
-            node["last_heard"] = new JSONValue((int)tempNodeInfo->last_heard);
-            node["position"] = new JSONValue();
-
-            if (nodeDB->hasValidPosition(tempNodeInfo)) {
-                JSONObject position;
-                position["latitude"] = new JSONValue((float)tempNodeInfo->position.latitude_i * 1e-7);
-                position["longitude"] = new JSONValue((float)tempNodeInfo->position.longitude_i * 1e-7);
-                position["altitude"] = new JSONValue((int)tempNodeInfo->position.altitude);
-                node["position"] = new JSONValue(position);
-            }
-
-            node["long_name"] = new JSONValue(tempNodeInfo->user.long_name);
-            node["short_name"] = new JSONValue(tempNodeInfo->user.short_name);
-            char macStr[18];
-            snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X", tempNodeInfo->user.macaddr[0],
-                     tempNodeInfo->user.macaddr[1], tempNodeInfo->user.macaddr[2], tempNodeInfo->user.macaddr[3],
-                     tempNodeInfo->user.macaddr[4], tempNodeInfo->user.macaddr[5]);
-            node["mac_address"] = new JSONValue(macStr);
-            node["hw_model"] = new JSONValue(tempNodeInfo->user.hw_model);
-
-            nodesArray.push_back(new JSONValue(node));
+        if (tempNodeInfo->has_user && tempNodeInfo->last_heard >= since) {
+            if (total >= offset && total - offset < limit)
+                writeNode(json, tempNodeInfo, fields);
+            total++;
         }
         tempNodeInfo = nodeDB->readNextMeshNode(readIndex);
     }
 
-    // collect data to inner data object
-    JSONObject jsonObjInner;
-    jsonObjInner["nodes"] = new JSONValue(nodesArray);
-
-    // create json output structure
-    JSONObject jsonObjOuter;
-    jsonObjOuter["data"] = new JSONValue(jsonObjInner);
-    jsonObjOuter["status"] = new JSONValue("ok");
-    // serialize and write it to the stream
-    JSONValue *value = new JSONValue(jsonObjOuter);
-    res->print(value->Stringify().c_str());
-    delete value;
+    json.endArray();
+    if (paged) {
+        json.add("total", total);
+        json.add("time", getTime());
+    }
+    json.endObject();
+    json.add("status", "ok");
+    json.endObject();
 }
 
 /*
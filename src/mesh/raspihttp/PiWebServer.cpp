@@ -39,10 +39,12 @@ mail:   marchammermann@googlemail.com
 #include "PiWebServer.h"
 #include "NodeDB.h"
 #include "PhoneAPI.h"
+#include "PipelineStats.h"
 #include "PowerFSM.h"
 #include "RadioLibInterface.h"
 #include "airtime.h"
 #include "graphics/Screen.h"
+#include "modules/Telemetry/HostSampler.h"
 #include "main.h"
 #include "mesh/wifi/WiFiAPClient.h"
 #include "sleep.h"
@@ -302,6 +304,48 @@ int handleAPIv1FromRadio(const struct _u_request *req, struct _u_response *res,
     return U_CALLBACK_COMPLETE;
 }
 
+/*
+ * Latency histograms of the packet pipeline, see PipelineStats
+ */
+int handleJSONLatency(const struct _u_request *req, struct _u_response *res, void *user_data)
+{
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+    std::string json = pipelineStats.toJson();
+    ulfius_add_header_to_response(res, "Content-Type", "application/json");
+    ulfius_set_string_body_response(res, 200, json.c_str());
+#else
+    ulfius_set_string_body_response(res, 404, "Pipeline stats are not built in");
+#endif
+    return U_CALLBACK_COMPLETE;
+}
+
+/*
+ * Host and daemon metrics for Prometheus, see HostSampler
+ */
+int handleMetrics(const struct _u_request *req, struct _u_response *res, void *user_data)
+{
+    std::string text = HostSampler::toPrometheus(hostSampler.sample());
+    if (airTime) {
+        char line[256];
+        snprintf(line, sizeof(line),
+                 "# HELP meshtasticd_airtime_budget_ms Transmit airtime banked under the duty cycle limit\n"
+                 "# TYPE meshtasticd_airtime_budget_ms gauge\nmeshtasticd_airtime_budget_ms %.0f\n",
+                 airTime->budget.getBalanceMs(millis()));
+        text += line;
+        text += "# HELP meshtasticd_tx_airtime_ms_total Transmit airtime per port, port 0 is packets relayed still encrypted\n"
+                "# TYPE meshtasticd_tx_airtime_ms_total counter\n";
+        for (size_t i = 0; i < airTime->budget.getNumPorts(); i++) {
+            const AirtimeBudget::PortAirtime &pa = airTime->budget.getPortAirtime(i);
+            snprintf(line, sizeof(line), "meshtasticd_tx_airtime_ms_total{port=\"%d\"} %llu\n", (int)pa.port,
+                     (unsigned long long)pa.airtimeMs);
+            text += line;
+        }
+    }
+    ulfius_add_header_to_response(res, "Content-Type", "text/plain; version=0.0.4");
+    ulfius_set_string_body_response(res, 200, text.c_str());
+    return U_CALLBACK_COMPLETE;
+}
+
 /*
 OpenSSL RSA Key Gen
 */
@@ -503,6 +547,8 @@ PiWebServerThread::PiWebServerThread()
         ulfius_add_endpoint_by_val(&instanceWeb, "OPTIONS", PREFIX, "/api/v1/fromradio/*", 1, &handleAPIv1FromRadio, &webAPI);
         ulfius_add_endpoint_by_val(&instanceWeb, "PUT", PREFIX, "/api/v1/toradio/*", 1, &handleAPIv1ToRadio, &webAPI);
         ulfius_add_endpoint_by_val(&instanceWeb, "OPTIONS", PREFIX, "/api/v1/toradio/*", 1, &handleAPIv1ToRadio, &webAPI);
+        ulfius_add_endpoint_by_val(&instanceWeb, "GET", PREFIX, "/json/latency", 1, &handleJSONLatency, NULL);
+        ulfius_add_endpoint_by_val(&instanceWeb, "GET", PREFIX, "/metrics", 1, &handleMetrics, NULL);
 
         // Add callback function to all endpoints for the Web Server
         ulfius_add_endpoint_by_val(&instanceWeb, "GET", NULL, "/*", 2, &callback_static_file, &configWeb);
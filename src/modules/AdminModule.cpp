@@ -30,6 +30,10 @@
 #include "mqtt/MQTT.h"
 #endif
 
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+#include "PipelineStats.h"
+#endif
+
 #if !MESHTASTIC_EXCLUDE_GPS
 #include "GPS.h"
 #endif
@@ -273,6 +277,11 @@ bool AdminModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp, meshta
         handleGetDeviceConnectionStatus(mp);
         break;
     }
+    case meshtastic_AdminMessage_get_pipeline_stats_request_tag: {
+        LOG_INFO("Client got pipeline stats from %u", r->get_pipeline_stats_request);
+        handleGetPipelineStats(mp, r->get_pipeline_stats_request);
+        break;
+    }
     case meshtastic_AdminMessage_get_module_config_response_tag: {
         LOG_INFO("Client received a get_module_config response");
         if (fromOthers && r->get_module_config_response.which_payload_variant ==
@@ -316,6 +325,7 @@ bool AdminModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp, meshta
             node->is_ignored = true;
             node->has_device_metrics = false;
             node->has_position = false;
+            nodeDB->indexPosition(node);
             node->user.public_key.size = 0;
             node->user.public_key.bytes[0] = 0;
             saveChanges(SEGMENT_NODEDATABASE, false);
@@ -336,6 +346,7 @@ bool AdminModule::handleReceivedProtobuf(const meshtastic_MeshPacket &mp, meshta
         meshtastic_NodeInfoLite *node = nodeDB->getMeshNode(nodeDB->getNodeNum());
         node->has_position = true;
         node->position = TypeConversions::ConvertToPositionLite(r->set_fixed_position);
+        nodeDB->indexPosition(node);
         nodeDB->setLocalPosition(r->set_fixed_position);
         config.position.fixed_position = true;
         saveChanges(SEGMENT_NODEDATABASE | SEGMENT_CONFIG, false);
@@ -1020,6 +1031,33 @@ void AdminModule::handleGetDeviceMetadata(const meshtastic_MeshPacket &req)
     myReply = allocDataProtobuf(r);
 }
 
+void AdminModule::handleGetPipelineStats(const meshtastic_MeshPacket &req, uint32_t offset)
+{
+    meshtastic_AdminMessage r = meshtastic_AdminMessage_init_default;
+    r.which_payload_variant = meshtastic_AdminMessage_get_pipeline_stats_response_tag;
+    meshtastic_PipelineStatsPage &page = r.get_pipeline_stats_response;
+    page.offset = offset;
+
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+    // A whole page has to fit one packet, so the client pages through with offset
+    page.total = pipelineStats.getNumSummaries();
+    PipelineStats::Histogram h;
+    const char *name;
+    while (page.entries_count < sizeof(page.entries) / sizeof(page.entries[0]) &&
+           (name = pipelineStats.getSummary(offset + page.entries_count, h)) != nullptr) {
+        meshtastic_PipelineLatency &e = page.entries[page.entries_count++];
+        strncpy(e.name, name, sizeof(e.name) - 1);
+        e.count = h.count;
+        e.p50_us = h.percentileUs(50);
+        e.p95_us = h.percentileUs(95);
+        e.max_us = h.maxUs;
+    }
+#endif
+
+    setPassKey(&r);
+    myReply = allocDataProtobuf(r);
+}
+
 void AdminModule::handleGetDeviceConnectionStatus(const meshtastic_MeshPacket &req)
 {
     meshtastic_AdminMessage r = meshtastic_AdminMessage_init_default;
@@ -1198,7 +1236,8 @@ bool AdminModule::messageIsResponse(const meshtastic_AdminMessage *r)
         r->which_payload_variant == meshtastic_AdminMessage_get_ringtone_response_tag ||
         r->which_payload_variant == meshtastic_AdminMessage_get_device_connection_status_response_tag ||
         r->which_payload_variant == meshtastic_AdminMessage_get_node_remote_hardware_pins_response_tag ||
-        r->which_payload_variant == meshtastic_AdminMessage_get_ui_config_response_tag)
+        r->which_payload_variant == meshtastic_AdminMessage_get_ui_config_response_tag ||
+        r->which_payload_variant == meshtastic_AdminMessage_get_pipeline_stats_response_tag)
         return true;
     else
         return false;
@@ -1215,7 +1254,8 @@ bool AdminModule::messageIsRequest(const meshtastic_AdminMessage *r)
         r->which_payload_variant == meshtastic_AdminMessage_get_ringtone_request_tag ||
         r->which_payload_variant == meshtastic_AdminMessage_get_device_connection_status_request_tag ||
         r->which_payload_variant == meshtastic_AdminMessage_get_node_remote_hardware_pins_request_tag ||
-        r->which_payload_variant == meshtastic_AdminMessage_get_ui_config_request_tag)
+        r->which_payload_variant == meshtastic_AdminMessage_get_ui_config_request_tag ||
+        r->which_payload_variant == meshtastic_AdminMessage_get_pipeline_stats_request_tag)
         return true;
     else
         return false;
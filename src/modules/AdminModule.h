@@ -44,6 +44,7 @@ class AdminModule : public ProtobufModule<meshtastic_AdminMessage>, public Obser
     void handleGetDeviceConnectionStatus(const meshtastic_MeshPacket &req);
     void handleGetNodeRemoteHardwarePins(const meshtastic_MeshPacket &req);
     void handleGetDeviceUIConfig(const meshtastic_MeshPacket &req);
+    void handleGetPipelineStats(const meshtastic_MeshPacket &req, uint32_t offset);
     /**
      * Setters
      */
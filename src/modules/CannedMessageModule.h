@@ -92,6 +92,8 @@ class CannedMessageModule : public SinglePortModule, public Observable<const UIF
             return false;
         }
     }
+    // wantPacket() also tracks the signal of every packet we hear
+    virtual meshtastic_PortNum getDispatchPortNum() override { return meshtastic_PortNum_UNKNOWN_APP; }
 
   protected:
     virtual int32_t runOnce() override;
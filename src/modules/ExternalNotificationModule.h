@@ -55,6 +55,8 @@ class ExternalNotificationModule : public SinglePortModule, private concurrency:
     virtual int32_t runOnce() override;
 
     virtual bool wantPacket(const meshtastic_MeshPacket *p) override;
+    // isTextPayload() covers several portnums
+    virtual meshtastic_PortNum getDispatchPortNum() override { return meshtastic_PortNum_UNKNOWN_APP; }
 
     bool isNagging = false;
 
@@ -34,6 +34,7 @@ class RoutingModule : public ProtobufModule<meshtastic_Routing>
 
     /// Override wantPacket to say we want to see all packets, not just those for our port number
     virtual bool wantPacket(const meshtastic_MeshPacket *p) override { return true; }
+    virtual meshtastic_PortNum getDispatchPortNum() override { return meshtastic_PortNum_UNKNOWN_APP; }
 };
 
 extern RoutingModule *routingModule;
\ No newline at end of file
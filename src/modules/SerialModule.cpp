@@ -6,6 +6,7 @@
 #include "RTC.h"
 #include "Router.h"
 #include "configuration.h"
+#include "main.h"
 #include <Arduino.h>
 #include <Throttle.h>
 
@@ -104,6 +105,12 @@ bool SerialModule::checkIsConnected()
     return Throttle::isWithinTimespanMs(lastContactMsec, SERIAL_CONNECTION_TIMEOUT);
 }
 
+void SerialModule::wakeForWrite()
+{
+    setIntervalFromNow(0);
+    runASAP = true;
+}
+
 int32_t SerialModule::runOnce()
 {
     /*
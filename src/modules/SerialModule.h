@@ -26,6 +26,8 @@ class SerialModule : public StreamAPI, private concurrency::OSThread
     /// Check the current underlying physical link to see if the client is currently connected
     virtual bool checkIsConnected() override;
 
+    virtual void wakeForWrite() override;
+
   private:
     uint32_t getBaudRate();
     void sendTelemetry(meshtastic_Telemetry m);
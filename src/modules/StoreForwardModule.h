@@ -80,6 +80,7 @@ class StoreForwardModule : private concurrency::OSThread, public ProtobufModule<
             return false;
         }
     }
+    virtual meshtastic_PortNum getDispatchPortNum() override { return meshtastic_PortNum_UNKNOWN_APP; }
 
   private:
     void populatePSRAM();
@@ -166,6 +166,17 @@ NullSensor pct2075Sensor;
 
 RCWL9620Sensor rcwl9620Sensor;
 CGRadSensSensor cgRadSens;
+
+// Initialized in this order, those found are then left to sensorScheduler
+static TelemetrySensor *const environmentSensors[] = {
+    &dfRobotLarkSensor, &dfRobotGravitySensor, &bmp085Sensor,
+#if __has_include(<Adafruit_BME280.h>)
+    &bmp280Sensor,
+#endif
+    &bme280Sensor,      &bmp3xxSensor,         &bme680Sensor,   &dps310Sensor,   &mcp9808Sensor, &shtc3Sensor,
+    &lps22hbSensor,     &sht31Sensor,          &sht4xSensor,    &ina219Sensor,   &ina260Sensor,  &ina3221Sensor,
+    &veml7700Sensor,    &tsl2591Sensor,        &opt3001Sensor,  &rcwl9620Sensor, &aht10Sensor,   &mlx90632Sensor,
+    &nau7802Sensor,     &max17048Sensor,       &cgRadSens,      &pct2075Sensor};
 #endif
 #ifdef T1000X_SENSOR_EN
 #include "Sensor/T1000xSensor.h"
@@ -219,60 +230,13 @@ int32_t EnvironmentTelemetryModule::runOnce()
 #ifdef T1000X_SENSOR_EN
             result = t1000xSensor.runOnce();
 #elif !MESHTASTIC_EXCLUDE_ENVIRONMENTAL_SENSOR_EXTERNAL
-            if (dfRobotLarkSensor.hasSensor())
-                result = dfRobotLarkSensor.runOnce();
-            if (dfRobotGravitySensor.hasSensor())
-                result = dfRobotGravitySensor.runOnce();
-            if (bmp085Sensor.hasSensor())
-                result = bmp085Sensor.runOnce();
-#if __has_include(<Adafruit_BME280.h>)
-            if (bmp280Sensor.hasSensor())
-                result = bmp280Sensor.runOnce();
-#endif
-            if (bme280Sensor.hasSensor())
-                result = bme280Sensor.runOnce();
-            if (bmp3xxSensor.hasSensor())
-                result = bmp3xxSensor.runOnce();
-            if (bme680Sensor.hasSensor())
-                result = bme680Sensor.runOnce();
-            if (dps310Sensor.hasSensor())
-                result = dps310Sensor.runOnce();
-            if (mcp9808Sensor.hasSensor())
-                result = mcp9808Sensor.runOnce();
-            if (shtc3Sensor.hasSensor())
-                result = shtc3Sensor.runOnce();
-            if (lps22hbSensor.hasSensor())
-                result = lps22hbSensor.runOnce();
-            if (sht31Sensor.hasSensor())
-                result = sht31Sensor.runOnce();
-            if (sht4xSensor.hasSensor())
-                result = sht4xSensor.runOnce();
-            if (ina219Sensor.hasSensor())
-                result = ina219Sensor.runOnce();
-            if (ina260Sensor.hasSensor())
-                result = ina260Sensor.runOnce();
-            if (ina3221Sensor.hasSensor())
-                result = ina3221Sensor.runOnce();
-            if (veml7700Sensor.hasSensor())
-                result = veml7700Sensor.runOnce();
-            if (tsl2591Sensor.hasSensor())
-                result = tsl2591Sensor.runOnce();
-            if (opt3001Sensor.hasSensor())
-                result = opt3001Sensor.runOnce();
-            if (rcwl9620Sensor.hasSensor())
-                result = rcwl9620Sensor.runOnce();
-            if (aht10Sensor.hasSensor())
-                result = aht10Sensor.runOnce();
-            if (mlx90632Sensor.hasSensor())
-                result = mlx90632Sensor.runOnce();
-            if (nau7802Sensor.hasSensor())
-                result = nau7802Sensor.runOnce();
-            if (max17048Sensor.hasSensor())
-                result = max17048Sensor.runOnce();
-            if (cgRadSens.hasSensor())
-                result = cgRadSens.runOnce();
-            if (pct2075Sensor.hasSensor())
-                result = pct2075Sensor.runOnce();
+            for (TelemetrySensor *sensor : environmentSensors) {
+                if (sensor->hasSensor()) {
+                    result = sensor->runOnce();
+                    if (sensor->hasSensor())
+                        sensorScheduler.add(sensor);
+                }
+            }
                 // this only works on the wismesh hub with the solar option. This is not an I2C sensor, so we don't need the
                 // sensormap here.
 #ifdef HAS_RAKPROT
@@ -289,26 +253,40 @@ int32_t EnvironmentTelemetryModule::runOnce()
         if (!moduleConfig.telemetry.environment_measurement_enabled && !ENVIRONMENTAL_TELEMETRY_MODULE_ENABLE) {
             return disable();
         } else {
-#if !MESHTASTIC_EXCLUDE_ENVIRONMENTAL_SENSOR_EXTERNAL
-            if (bme680Sensor.hasSensor())
-                result = bme680Sensor.runTrigger();
-#endif
+            result = sensorScheduler.service(millis());
         }
 
-        if (((lastSentToMesh == 0) ||
+        bool toMesh =
+            ((lastSentToMesh == 0) ||
              !Throttle::isWithinTimespanMs(lastSentToMesh, Default::getConfiguredOrDefaultMsScaled(
                                                                moduleConfig.telemetry.environment_update_interval,
                                                                default_telemetry_broadcast_interval_secs, numOnlineNodes))) &&
             airTime->isTxAllowedChannelUtil(config.device.role != meshtastic_Config_DeviceConfig_Role_SENSOR) &&
-            airTime->isTxAllowedAirUtil()) {
-            sendTelemetry();
-            lastSentToMesh = millis();
-        } else if (((lastSentToPhone == 0) || !Throttle::isWithinTimespanMs(lastSentToPhone, sendToPhoneIntervalMs)) &&
-                   (service->isToPhoneQueueEmpty())) {
-            // Just send to phone when it's not our time to send to mesh yet
-            // Only send while queue is empty (phone assumed connected)
-            sendTelemetry(NODENUM_BROADCAST, true);
-            lastSentToPhone = millis();
+            airTime->isTxAllowedAirUtil();
+        // Just send to phone when it's not our time to send to mesh yet
+        // Only send while queue is empty (phone assumed connected)
+        bool toPhone = !toMesh &&
+                       ((lastSentToPhone == 0) || !Throttle::isWithinTimespanMs(lastSentToPhone, sendToPhoneIntervalMs)) &&
+                       (service->isToPhoneQueueEmpty());
+
+        if (toMesh || toPhone) {
+            // Get the sensors measuring and come back for the results, rather than waiting on each in turn
+            uint32_t waitMs = sensorScheduler.isConverting() ? sensorScheduler.msUntilReady(millis())
+                                                             : sensorScheduler.startConversions(millis());
+            if (waitMs > 0)
+                return min(waitMs, result);
+
+            if (toMesh) {
+                sendTelemetry();
+                lastSentToMesh = millis();
+            } else {
+                sendTelemetry(NODENUM_BROADCAST, true);
+                lastSentToPhone = millis();
+            }
+            sensorScheduler.finishConversions();
+        } else {
+            // Whatever we started measuring is too old by the time we send again
+            sensorScheduler.finishConversions();
         }
     }
     return min(sendToPhoneIntervalMs, result);
@@ -2,8 +2,8 @@
 #include "../mesh/generated/meshtastic/telemetry.pb.h"
 #include "MeshService.h"
 #if ARCH_PORTDUINO
+#include "HostSampler.h"
 #include "PortduinoGlue.h"
-#include <filesystem>
 #endif
 
 int32_t HostMetricsModule::runOnce()
@@ -68,45 +68,24 @@ meshtastic_MeshPacket *HostMetricsModule::allocReply()
 #if ARCH_PORTDUINO
 meshtastic_Telemetry HostMetricsModule::getHostMetrics()
 {
-    std::string file_line;
     meshtastic_Telemetry t = meshtastic_Telemetry_init_zero;
     t.which_variant = meshtastic_Telemetry_host_metrics_tag;
     t.variant.host_metrics = meshtastic_HostMetrics_init_zero;
 
-    if (access("/proc/uptime", R_OK) == 0) {
-        std::ifstream proc_uptime("/proc/uptime");
-        if (proc_uptime.is_open()) {
-            std::getline(proc_uptime, file_line, ' ');
-            proc_uptime.close();
-            t.variant.host_metrics.uptime_seconds = stoul(file_line);
-        }
-    }
+    HostSampler::Sample s = hostSampler.sample();
+    t.variant.host_metrics.uptime_seconds = s.uptimeSecs;
+    t.variant.host_metrics.diskfree1_bytes = s.diskFreeBytes;
+    t.variant.host_metrics.freemem_bytes = s.memAvailableBytes;
+    t.variant.host_metrics.load1 = s.load1;
+    t.variant.host_metrics.load5 = s.load5;
+    t.variant.host_metrics.load15 = s.load15;
 
-    std::filesystem::space_info root = std::filesystem::space("/");
-    t.variant.host_metrics.diskfree1_bytes = root.available;
+    // The rest doesn't fit in HostMetrics, it is served on /metrics instead
+    LOG_DEBUG("Host metrics: rss=%llu, heap=%llu, cpu=%.1fs, threads=%u, packets in use=%u, queued rx=%u tx=%u/%u phone=%u",
+              (unsigned long long)s.rssBytes, (unsigned long long)s.heapBytes, s.cpuSecs, (unsigned)s.numThreads,
+              (unsigned)s.packetsInUse, (unsigned)s.fromRadioQueued, (unsigned)s.txQueued, (unsigned)s.txQueueMax,
+              (unsigned)s.toPhoneQueued);
 
-    if (access("/proc/meminfo", R_OK) == 0) {
-        std::ifstream proc_meminfo("/proc/meminfo");
-        if (proc_meminfo.is_open()) {
-            do {
-                std::getline(proc_meminfo, file_line);
-            } while (file_line.find("MemAvailable") == std::string::npos);
-            proc_meminfo.close();
-            t.variant.host_metrics.freemem_bytes = stoull(file_line.substr(file_line.find_first_of("0123456789"))) * 1024;
-        }
-    }
-    if (access("/proc/loadavg", R_OK) == 0) {
-        std::ifstream proc_loadavg("/proc/loadavg");
-        if (proc_loadavg.is_open()) {
-            std::getline(proc_loadavg, file_line, ' ');
-            t.variant.host_metrics.load1 = stof(file_line) * 100;
-            std::getline(proc_loadavg, file_line, ' ');
-            t.variant.host_metrics.load5 = stof(file_line) * 100;
-            std::getline(proc_loadavg, file_line, ' ');
-            t.variant.host_metrics.load15 = stof(file_line) * 100;
-            proc_loadavg.close();
-        }
-    }
     if (settingsStrings[hostMetrics_user_command] != "") {
         std::string userCommandResult = exec(settingsStrings[hostMetrics_user_command].c_str());
         if (userCommandResult.length() > 1) {
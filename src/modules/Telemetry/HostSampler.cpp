@@ -0,0 +1,242 @@
+#include "HostSampler.h"
+
+#if ARCH_PORTDUINO
+#include "MeshService.h"
+#include "RadioLibInterface.h"
+#include "Router.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+HostSampler hostSampler;
+
+// Skip past n space separated fields
+static const char *skipFields(const char *p, int n)
+{
+    while (n-- > 0 && p) {
+        p = strchr(p, ' ');
+        if (p)
+            p++;
+    }
+    return p;
+}
+
+// The number after key in a "Key:   1234 kB" style file, 0 if it isn't there
+static uint64_t findValue(const char *text, const char *key)
+{
+    const char *p = strstr(text, key);
+    return p ? strtoull(p + strlen(key), NULL, 10) : 0;
+}
+
+// The comm and utime + stime out of a /proc/<pid>/stat line. The name is in brackets and may itself contain spaces and
+// brackets, so look for the last closing one.
+static bool parseStat(const char *text, char *name, size_t nameLen, double *cpuSecs)
+{
+    const char *open = strchr(text, '(');
+    const char *close = strrchr(text, ')');
+    if (!open || !close || close < open)
+        return false;
+    if (name) {
+        size_t len = close - open - 1;
+        if (len >= nameLen)
+            len = nameLen - 1;
+        memcpy(name, open + 1, len);
+        name[len] = '\0';
+    }
+    // utime and stime are fields 14 and 15, the state (field 3) follows the name
+    const char *p = skipFields(close + 2, 11);
+    if (!p)
+        return false;
+    char *end;
+    unsigned long long utime = strtoull(p, &end, 10);
+    unsigned long long stime = strtoull(end, NULL, 10);
+    static const long ticks = sysconf(_SC_CLK_TCK);
+    *cpuSecs = (double)(utime + stime) / ticks;
+    return true;
+}
+
+HostSampler::~HostSampler()
+{
+    ProcFile *files[] = {&uptime, &meminfo, &loadavg, &statm, &selfStat};
+    for (ProcFile *f : files)
+        if (f->fd >= 0)
+            close(f->fd);
+    for (ProcFile &f : taskStat)
+        if (f.fd >= 0)
+            close(f.fd);
+}
+
+ssize_t HostSampler::readProc(ProcFile &f, const char *path)
+{
+    if (f.fd < 0)
+        f.fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (f.fd < 0)
+        return -1;
+    ssize_t len = pread(f.fd, buf, sizeof(buf) - 1, 0);
+    if (len < 0) {
+        close(f.fd);
+        f.fd = -1;
+        return -1;
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+void HostSampler::sampleThreads(Sample &s)
+{
+    int tids[HOST_SAMPLER_MAX_THREADS];
+    size_t numTids = 0;
+    DIR *dir = opendir("/proc/self/task");
+    if (!dir)
+        return;
+    struct dirent *e;
+    while ((e = readdir(dir)) != NULL && numTids < HOST_SAMPLER_MAX_THREADS) {
+        int tid = atoi(e->d_name);
+        if (tid > 0)
+            tids[numTids++] = tid;
+    }
+    closedir(dir);
+
+    // Let go of threads that have exited
+    for (ProcFile &f : taskStat) {
+        if (f.tid == 0)
+            continue;
+        bool alive = false;
+        for (size_t i = 0; i < numTids && !alive; i++)
+            alive = tids[i] == f.tid;
+        if (!alive) {
+            if (f.fd >= 0)
+                close(f.fd);
+            f.fd = -1;
+            f.tid = 0;
+        }
+    }
+
+    for (size_t i = 0; i < numTids; i++) {
+        ProcFile *f = NULL;
+        for (ProcFile &candidate : taskStat)
+            if (candidate.tid == tids[i])
+                f = &candidate;
+        for (size_t j = 0; !f && j < HOST_SAMPLER_MAX_THREADS; j++)
+            if (taskStat[j].tid == 0) {
+                f = &taskStat[j];
+                f->tid = tids[i];
+            }
+        if (!f)
+            break;
+
+        char path[40];
+        snprintf(path, sizeof(path), "/proc/self/task/%d/stat", f->tid);
+        Thread &t = s.threads[s.numThreads];
+        if (readProc(*f, path) > 0 && parseStat(buf, t.name, sizeof(t.name), &t.cpuSecs)) {
+            t.tid = f->tid;
+            s.numThreads++;
+        }
+    }
+}
+
+HostSampler::Sample HostSampler::sample()
+{
+    Sample s;
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (readProc(uptime, "/proc/uptime") > 0)
+        s.uptimeSecs = strtoul(buf, NULL, 10);
+
+    if (readProc(meminfo, "/proc/meminfo") > 0) {
+        s.memTotalBytes = findValue(buf, "MemTotal:") * 1024;
+        s.memAvailableBytes = findValue(buf, "MemAvailable:") * 1024;
+    }
+
+    if (readProc(loadavg, "/proc/loadavg") > 0) {
+        char *p = buf;
+        s.load1 = strtof(p, &p) * 100;
+        s.load5 = strtof(p, &p) * 100;
+        s.load15 = strtof(p, &p) * 100;
+    }
+
+    struct statvfs root;
+    if (statvfs("/", &root) == 0)
+        s.diskFreeBytes = (uint64_t)root.f_bavail * root.f_frsize;
+
+    if (readProc(statm, "/proc/self/statm") > 0) {
+        const char *p = skipFields(buf, 1);
+        if (p)
+            s.rssBytes = strtoull(p, NULL, 10) * sysconf(_SC_PAGESIZE);
+    }
+
+    if (readProc(selfStat, "/proc/self/stat") > 0)
+        parseStat(buf, NULL, 0, &s.cpuSecs);
+
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    struct mallinfo2 mi = mallinfo2();
+    s.heapBytes = mi.uordblks + mi.hblkhd;
+#elif defined(__GLIBC__)
+    struct mallinfo mi = mallinfo();
+    s.heapBytes = (unsigned)mi.uordblks + (unsigned)mi.hblkhd;
+#endif
+
+    sampleThreads(s);
+
+    s.packetsInUse = packetPool.getNumInUse();
+    if (router)
+        s.fromRadioQueued = router->getNumFromRadioQueued();
+    if (service)
+        s.toPhoneQueued = service->getNumQueuedForPhone();
+    if (RadioLibInterface::instance) {
+        meshtastic_QueueStatus qs = RadioLibInterface::instance->getQueueStatus();
+        s.txQueueMax = qs.maxlen;
+        s.txQueued = qs.maxlen - qs.free;
+    }
+    return s;
+}
+
+std::string HostSampler::toPrometheus(const Sample &s)
+{
+    std::string out;
+    char line[512];
+    auto metric = [&](const char *name, const char *type, const char *help, double value) {
+        snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n%s %.15g\n", name, help, name, type, name, value);
+        out += line;
+    };
+
+    metric("meshtasticd_host_uptime_seconds", "gauge", "Host uptime", s.uptimeSecs);
+    metric("meshtasticd_host_memory_total_bytes", "gauge", "Host memory", s.memTotalBytes);
+    metric("meshtasticd_host_memory_available_bytes", "gauge", "Host memory available", s.memAvailableBytes);
+    metric("meshtasticd_host_disk_free_bytes", "gauge", "Free space on /", s.diskFreeBytes);
+    metric("meshtasticd_host_load1", "gauge", "Host load average over 1 minute", s.load1 / 100.0);
+    metric("meshtasticd_host_load5", "gauge", "Host load average over 5 minutes", s.load5 / 100.0);
+    metric("meshtasticd_host_load15", "gauge", "Host load average over 15 minutes", s.load15 / 100.0);
+    metric("meshtasticd_resident_memory_bytes", "gauge", "Resident set size", s.rssBytes);
+    metric("meshtasticd_heap_bytes", "gauge", "Heap in use", s.heapBytes);
+    metric("meshtasticd_cpu_seconds_total", "counter", "CPU time used", s.cpuSecs);
+    metric("meshtasticd_packets_in_use", "gauge", "Packets allocated from the packet pool", s.packetsInUse);
+    metric("meshtasticd_from_radio_queued", "gauge", "Received packets waiting for the router", s.fromRadioQueued);
+    metric("meshtasticd_tx_queued", "gauge", "Packets waiting to be transmitted", s.txQueued);
+    metric("meshtasticd_tx_queue_max", "gauge", "Size of the transmit queue", s.txQueueMax);
+    metric("meshtasticd_to_phone_queued", "gauge", "Packets waiting for the client", s.toPhoneQueued);
+
+    out += "# HELP meshtasticd_thread_cpu_seconds_total CPU time used per thread\n"
+           "# TYPE meshtasticd_thread_cpu_seconds_total counter\n";
+    for (size_t i = 0; i < s.numThreads; i++) {
+        // Thread names are set by us, but keep the label valid whatever they contain
+        char name[sizeof(s.threads[i].name)];
+        size_t j = 0;
+        for (; s.threads[i].name[j]; j++) {
+            char c = s.threads[i].name[j];
+            name[j] = (c == '"' || c == '\\' || c < ' ') ? '_' : c;
+        }
+        name[j] = '\0';
+        snprintf(line, sizeof(line), "meshtasticd_thread_cpu_seconds_total{thread=\"%s\",tid=\"%d\"} %.15g\n", name,
+                 s.threads[i].tid, s.threads[i].cpuSecs);
+        out += line;
+    }
+    return out;
+}
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "configuration.h"
+
+#if ARCH_PORTDUINO
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <sys/types.h>
+
+#define HOST_SAMPLER_MAX_THREADS 32
+
+/**
+ * Cheap, repeatable sampling of the host and of meshtasticd itself, for HostMetrics telemetry and the /metrics page.
+ *
+ * The /proc files stay open and are re-read with pread() into a fixed buffer and parsed in place, so taking a sample
+ * costs a handful of syscalls instead of opening streams and building strings for every line. Safe to call from the
+ * web server thread and the mesh thread alike.
+ */
+class HostSampler
+{
+  public:
+    struct Thread {
+        int tid;
+        char name[16];  // As in /proc/self/task/<tid>/comm
+        double cpuSecs; // User plus system time since the thread started
+    };
+
+    struct Sample {
+        uint32_t uptimeSecs = 0;
+        uint64_t memTotalBytes = 0, memAvailableBytes = 0;
+        uint64_t diskFreeBytes = 0;                // For /
+        uint16_t load1 = 0, load5 = 0, load15 = 0; // In 1/100ths
+
+        uint64_t rssBytes = 0;
+        uint64_t heapBytes = 0; // In use by malloc
+        double cpuSecs = 0;     // The whole daemon
+        size_t numThreads = 0;
+        Thread threads[HOST_SAMPLER_MAX_THREADS];
+
+        size_t packetsInUse = 0; // Allocated from packetPool
+        size_t fromRadioQueued = 0;
+        size_t txQueued = 0, txQueueMax = 0;
+        size_t toPhoneQueued = 0;
+    };
+
+    ~HostSampler();
+
+    /// Take a fresh sample
+    Sample sample();
+
+    /// The sample in Prometheus' text exposition format
+    static std::string toPrometheus(const Sample &s);
+
+  private:
+    // A /proc file we keep open and read from the start each time
+    struct ProcFile {
+        int fd = -1;
+        int tid = 0; // For per thread files
+    };
+
+    std::mutex lock;
+    ProcFile uptime, meminfo, loadavg, statm, selfStat;
+    ProcFile taskStat[HOST_SAMPLER_MAX_THREADS];
+    char buf[4096];
+
+    // Read the whole of path into buf, opening it if need be. Returns the length read, or -1
+    ssize_t readProc(ProcFile &f, const char *path);
+    void sampleThreads(Sample &s);
+};
+
+extern HostSampler hostSampler;
+#endif
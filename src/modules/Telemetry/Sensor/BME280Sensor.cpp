@@ -17,17 +17,28 @@ int32_t BME280Sensor::runOnce()
         return DEFAULT_SENSOR_MINIMUM_WAIT_TIME_BETWEEN_READS;
     }
     status = bme280.begin(nodeTelemetrySensorsMap[sensorType].first, nodeTelemetrySensorsMap[sensorType].second);
+    setForcedSampling();
 
+    return initI2CSensor();
+}
+
+void BME280Sensor::setup() {}
+
+void BME280Sensor::setForcedSampling()
+{
     bme280.setSampling(Adafruit_BME280::MODE_FORCED,
                        Adafruit_BME280::SAMPLING_X1, // Temp. oversampling
                        Adafruit_BME280::SAMPLING_X1, // Pressure oversampling
                        Adafruit_BME280::SAMPLING_X1, // Humidity oversampling
                        Adafruit_BME280::FILTER_OFF, Adafruit_BME280::STANDBY_MS_1000);
-
-    return initI2CSensor();
 }
 
-void BME280Sensor::setup() {}
+bool BME280Sensor::startConversion()
+{
+    setForcedSampling();
+    conversionStarted = true;
+    return true;
+}
 
 bool BME280Sensor::getMetrics(meshtastic_Telemetry *measurement)
 {
@@ -36,7 +47,8 @@ bool BME280Sensor::getMetrics(meshtastic_Telemetry *measurement)
     measurement->variant.environment_metrics.has_barometric_pressure = true;
 
     LOG_DEBUG("BME280 getMetrics");
-    bme280.takeForcedMeasurement();
+    if (!takeStartedConversion())
+        bme280.takeForcedMeasurement();
     measurement->variant.environment_metrics.temperature = bme280.readTemperature();
     measurement->variant.environment_metrics.relative_humidity = bme280.readHumidity();
     measurement->variant.environment_metrics.barometric_pressure = bme280.readPressure() / 100.0F;
@@ -11,6 +11,9 @@ class BME280Sensor : public TelemetrySensor
   private:
     Adafruit_BME280 bme280;
 
+    // Writing the control register in forced mode starts a measurement
+    void setForcedSampling();
+
   protected:
     virtual void setup() override;
 
@@ -18,6 +21,8 @@ class BME280Sensor : public TelemetrySensor
     BME280Sensor();
     virtual int32_t runOnce() override;
     virtual bool getMetrics(meshtastic_Telemetry *measurement) override;
+    virtual bool startConversion() override;
+    virtual uint32_t getConversionMs() override { return 10; } // 9.3 ms at most with x1 oversampling
 };
 
 #endif
\ No newline at end of file
@@ -8,15 +8,13 @@
 #include "SPILock.h"
 #include "TelemetrySensor.h"
 
-BME680Sensor::BME680Sensor() : TelemetrySensor(meshtastic_TelemetrySensorType_BME680, "BME680") {}
+#ifndef BSEC_CHECK_INPUT
+#define BSEC_CHECK_INPUT(x, shift) (x & (1 << (shift - 1)))
+#endif
 
-int32_t BME680Sensor::runTrigger()
-{
-    if (!bme680.run()) {
-        checkStatus("runTrigger");
-    }
-    return 35;
-}
+static uint8_t bsecWorkBuffer[BSEC_MAX_WORKBUFFER_SIZE];
+
+BME680Sensor::BME680Sensor() : TelemetrySensor(meshtastic_TelemetrySensorType_BME680, "BME680") {}
 
 int32_t BME680Sensor::runOnce()
 {
@@ -24,36 +22,168 @@ int32_t BME680Sensor::runOnce()
     if (!hasSensor()) {
         return DEFAULT_SENSOR_MINIMUM_WAIT_TIME_BETWEEN_READS;
     }
-    if (!bme680.begin(nodeTelemetrySensorsMap[sensorType].first, *nodeTelemetrySensorsMap[sensorType].second))
-        checkStatus("begin");
+    bme68x.begin(nodeTelemetrySensorsMap[sensorType].first, *nodeTelemetrySensorsMap[sensorType].second);
+    if (!bsecInstance)
+        bsecInstance = new uint8_t[bsec_get_instance_size_m()];
 
-    if (bme680.status == BSEC_OK) {
+    bsec_library_return_t bsecStatus = BSEC_OK;
+    if (bme68x.checkStatus() == BME68X_ERROR || (bsecStatus = bsec_init_m(bsecInstance)) != BSEC_OK) {
+        checkStatus("begin", bsecStatus);
+        status = 0;
+    } else {
         status = 1;
-        if (!bme680.setConfig(bsec_config)) {
-            checkStatus("setConfig");
+        bsec_get_version_m(bsecInstance, &bsecVersion);
+        bsecStatus = bsec_set_configuration_m(bsecInstance, bsec_config, sizeof(bsec_config), bsecWorkBuffer,
+                                              sizeof(bsecWorkBuffer));
+        if (bsecStatus != BSEC_OK) {
+            checkStatus("setConfig", bsecStatus);
             status = 0;
         }
         loadState();
-        if (!bme680.updateSubscription(sensorList, ARRAY_LEN(sensorList), BSEC_SAMPLE_RATE_LP)) {
-            checkStatus("updateSubscription");
+
+        bsec_sensor_configuration_t virtualSensors[ARRAY_LEN(sensorList)];
+        bsec_sensor_configuration_t sensorSettings[BSEC_MAX_PHYSICAL_SENSOR];
+        uint8_t numSensorSettings = BSEC_MAX_PHYSICAL_SENSOR;
+        for (size_t i = 0; i < ARRAY_LEN(sensorList); i++) {
+            virtualSensors[i].sensor_id = sensorList[i];
+            virtualSensors[i].sample_rate = BSEC_SAMPLE_RATE_LP;
+        }
+        bsecStatus = bsec_update_subscription_m(bsecInstance, virtualSensors, ARRAY_LEN(sensorList), sensorSettings,
+                                                &numSensorSettings);
+        if (bsecStatus != BSEC_OK) {
+            checkStatus("updateSubscription", bsecStatus);
             status = 0;
         }
-        LOG_INFO("Init sensor: %s with the BSEC Library version %d.%d.%d.%d ", sensorName, bme680.version.major,
-                 bme680.version.minor, bme680.version.major_bugfix, bme680.version.minor_bugfix);
-    } else {
-        status = 0;
+        LOG_INFO("Init sensor: %s with the BSEC Library version %d.%d.%d.%d ", sensorName, bsecVersion.major,
+                 bsecVersion.minor, bsecVersion.major_bugfix, bsecVersion.minor_bugfix);
     }
     if (status == 0)
-        LOG_DEBUG("BME680Sensor::runOnce: bme680.status %d", bme680.status);
+        LOG_DEBUG("BME680Sensor::runOnce: bsec status %d", bsecStatus);
 
     return initI2CSensor();
 }
 
 void BME680Sensor::setup() {}
 
+int64_t BME680Sensor::getTimeNs()
+{
+    uint32_t now = millis();
+    if (now < lastMillis)
+        millisOverflows++;
+    lastMillis = now;
+    return (((int64_t)millisOverflows << 32) + now) * INT64_C(1000000);
+}
+
+uint32_t BME680Sensor::getServiceIntervalMs()
+{
+    if (!bsecInstance)
+        return 0;
+
+    int64_t waitNs = (measuring ? measurementDoneNs : bsecSettings.next_call) - getTimeNs();
+    return waitNs > 0 ? (uint32_t)((waitNs + 999999) / 1000000) : 1;
+}
+
+void BME680Sensor::service()
+{
+    int64_t nowNs = getTimeNs();
+    if (measuring) {
+        if (nowNs < measurementDoneNs)
+            return;
+        measuring = false;
+        finishMeasurement();
+    }
+    if (nowNs < bsecSettings.next_call)
+        return;
+
+    bsec_library_return_t bsecStatus = bsec_sensor_control_m(bsecInstance, nowNs, &bsecSettings);
+    if (bsecStatus < BSEC_OK) {
+        checkStatus("sensorControl", bsecStatus);
+        return;
+    }
+    if (bsecSettings.trigger_measurement && bsecSettings.op_mode == BME68X_FORCED_MODE)
+        startMeasurement(nowNs);
+}
+
+void BME680Sensor::startMeasurement(int64_t nowNs)
+{
+    bme68x.setTPH(bsecSettings.temperature_oversampling, bsecSettings.pressure_oversampling,
+                  bsecSettings.humidity_oversampling);
+    bme68x.setHeaterProf(bsecSettings.heater_temperature, bsecSettings.heater_duration);
+    bme68x.setOpMode(BME68X_FORCED_MODE);
+    if (bme68x.checkStatus() == BME68X_ERROR) {
+        checkStatus("startMeasurement", BSEC_OK);
+        return;
+    }
+
+    // The TPH part of the measurement is quoted in us, the heater runs for heater_duration ms on top
+    measurementStartNs = nowNs;
+    measurementDoneNs = nowNs + (int64_t)bme68x.getMeasDur(BME68X_FORCED_MODE) * 1000 +
+                        (int64_t)bsecSettings.heater_duration * 1000000;
+    measuring = true;
+}
+
+void BME680Sensor::finishMeasurement()
+{
+    bme68xData data;
+    if (!bme68x.fetchData()) {
+        LOG_DEBUG("%s measurement not ready", sensorName);
+        return;
+    }
+    bme68x.getData(data);
+    if (!(data.status & BME68X_NEW_DATA_MSK))
+        return;
+
+    bsec_input_t inputs[BSEC_MAX_PHYSICAL_SENSOR];
+    uint8_t numInputs = 0;
+    auto addInput = [&](uint8_t sensorId, float signal) {
+        if (BSEC_CHECK_INPUT(bsecSettings.process_data, sensorId)) {
+            inputs[numInputs].sensor_id = sensorId;
+            inputs[numInputs].signal = signal;
+            inputs[numInputs].time_stamp = measurementStartNs;
+            numInputs++;
+        }
+    };
+    addInput(BSEC_INPUT_HEATSOURCE, 0);
+    addInput(BSEC_INPUT_TEMPERATURE, data.temperature);
+    addInput(BSEC_INPUT_HUMIDITY, data.humidity);
+    addInput(BSEC_INPUT_PRESSURE, data.pressure);
+    if (data.status & BME68X_GASM_VALID_MSK)
+        addInput(BSEC_INPUT_GASRESISTOR, data.gas_resistance);
+    addInput(BSEC_INPUT_PROFILE_PART, 0);
+    if (!numInputs)
+        return;
+
+    bsec_output_t stepOutputs[BSEC_NUMBER_OUTPUTS];
+    uint8_t numStepOutputs = BSEC_NUMBER_OUTPUTS;
+    bsec_library_return_t bsecStatus = bsec_do_steps_m(bsecInstance, inputs, numInputs, stepOutputs, &numStepOutputs);
+    if (bsecStatus < BSEC_OK) {
+        checkStatus("doSteps", bsecStatus);
+        return;
+    }
+    // Not every step has outputs, getMetrics() wants the last ones there were
+    if (numStepOutputs) {
+        memcpy(outputs, stepOutputs, numStepOutputs * sizeof(bsec_output_t));
+        numOutputs = numStepOutputs;
+    }
+}
+
+float BME680Sensor::getOutput(uint8_t sensorId, uint8_t *accuracy)
+{
+    for (uint8_t i = 0; i < numOutputs; i++) {
+        if (outputs[i].sensor_id == sensorId) {
+            if (accuracy)
+                *accuracy = outputs[i].accuracy;
+            return outputs[i].signal;
+        }
+    }
+    if (accuracy)
+        *accuracy = 0;
+    return 0;
+}
+
 bool BME680Sensor::getMetrics(meshtastic_Telemetry *measurement)
 {
-    if (bme680.getData(BSEC_OUTPUT_RAW_PRESSURE).signal == 0)
+    if (getOutput(BSEC_OUTPUT_RAW_PRESSURE) == 0)
         return false;
 
     measurement->variant.environment_metrics.has_temperature = true;
@@ -62,13 +192,12 @@ bool BME680Sensor::getMetrics(meshtastic_Telemetry *measurement)
     measurement->variant.environment_metrics.has_gas_resistance = true;
     measurement->variant.environment_metrics.has_iaq = true;
 
-    measurement->variant.environment_metrics.temperature = bme680.getData(BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_TEMPERATURE).signal;
-    measurement->variant.environment_metrics.relative_humidity =
-        bme680.getData(BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_HUMIDITY).signal;
-    measurement->variant.environment_metrics.barometric_pressure = bme680.getData(BSEC_OUTPUT_RAW_PRESSURE).signal;
-    measurement->variant.environment_metrics.gas_resistance = bme680.getData(BSEC_OUTPUT_RAW_GAS).signal / 1000.0;
+    measurement->variant.environment_metrics.temperature = getOutput(BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_TEMPERATURE);
+    measurement->variant.environment_metrics.relative_humidity = getOutput(BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_HUMIDITY);
+    measurement->variant.environment_metrics.barometric_pressure = getOutput(BSEC_OUTPUT_RAW_PRESSURE);
+    measurement->variant.environment_metrics.gas_resistance = getOutput(BSEC_OUTPUT_RAW_GAS) / 1000.0;
     // Check if we need to save state to filesystem (every STATE_SAVE_PERIOD ms)
-    measurement->variant.environment_metrics.iaq = bme680.getData(BSEC_OUTPUT_IAQ).signal;
+    measurement->variant.environment_metrics.iaq = getOutput(BSEC_OUTPUT_IAQ);
     updateState();
     return true;
 }
@@ -81,7 +210,7 @@ void BME680Sensor::loadState()
     if (file) {
         file.read((uint8_t *)&bsecState, BSEC_MAX_STATE_BLOB_SIZE);
         file.close();
-        bme680.setState(bsecState);
+        bsec_set_state_m(bsecInstance, bsecState, BSEC_MAX_STATE_BLOB_SIZE, bsecWorkBuffer, sizeof(bsecWorkBuffer));
         LOG_INFO("%s state read from %s", sensorName, bsecConfigFileName);
     } else {
         LOG_INFO("No %s state found (File: %s)", sensorName, bsecConfigFileName);
@@ -99,7 +228,7 @@ void BME680Sensor::updateState()
     bool update = false;
     if (stateUpdateCounter == 0) {
         /* First state update when IAQ accuracy is >= 3 */
-        accuracy = bme680.getData(BSEC_OUTPUT_IAQ).accuracy;
+        getOutput(BSEC_OUTPUT_IAQ, &accuracy);
         if (accuracy >= 2) {
             LOG_DEBUG("%s state update IAQ accuracy %u >= 2", sensorName, accuracy);
             update = true;
@@ -117,7 +246,9 @@ void BME680Sensor::updateState()
     }
 
     if (update) {
-        bme680.getState(bsecState);
+        uint32_t stateSize = 0;
+        bsec_get_state_m(bsecInstance, 0, bsecState, BSEC_MAX_STATE_BLOB_SIZE, bsecWorkBuffer, sizeof(bsecWorkBuffer),
+                         &stateSize);
         if (FSCom.exists(bsecConfigFileName) && !FSCom.remove(bsecConfigFileName)) {
             LOG_WARN("Can't remove old state file");
         }
@@ -137,17 +268,17 @@ void BME680Sensor::updateState()
 #endif
 }
 
-void BME680Sensor::checkStatus(String functionName)
+void BME680Sensor::checkStatus(const char *functionName, bsec_library_return_t bsecStatus)
 {
-    if (bme680.status < BSEC_OK)
-        LOG_ERROR("%s BSEC2 code: %s", functionName.c_str(), String(bme680.status).c_str());
-    else if (bme680.status > BSEC_OK)
-        LOG_WARN("%s BSEC2 code: %s", functionName.c_str(), String(bme680.status).c_str());
-
-    if (bme680.sensor.status < BME68X_OK)
-        LOG_ERROR("%s BME68X code: %s", functionName.c_str(), String(bme680.sensor.status).c_str());
-    else if (bme680.sensor.status > BME68X_OK)
-        LOG_WARN("%s BME68X code: %s", functionName.c_str(), String(bme680.sensor.status).c_str());
+    if (bsecStatus < BSEC_OK)
+        LOG_ERROR("%s BSEC2 code: %d", functionName, bsecStatus);
+    else if (bsecStatus > BSEC_OK)
+        LOG_WARN("%s BSEC2 code: %d", functionName, bsecStatus);
+
+    if (bme68x.status < BME68X_OK)
+        LOG_ERROR("%s BME68X code: %d", functionName, bme68x.status);
+    else if (bme68x.status > BME68X_OK)
+        LOG_WARN("%s BME68X code: %d", functionName, bme68x.status);
 }
 
 #endif
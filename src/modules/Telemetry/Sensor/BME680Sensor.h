@@ -12,10 +12,32 @@ const uint8_t bsec_config[] = {
 #include "config/bme680/bme680_iaq_33v_3s_4d/bsec_iaq.txt"
 };
 
+/**
+ * The BME680 is driven through the BSEC library's own interface rather than Bsec2::run(), which starts the heater
+ * cycle and then waits in the driver for it to finish. Here service() starts the measurement BSEC asks for and comes
+ * back for the result once the sensor has had time to take it.
+ */
 class BME680Sensor : public TelemetrySensor
 {
   private:
-    Bsec2 bme680;
+    Bme68x bme68x;
+    uint8_t *bsecInstance = nullptr;
+    bsec_version_t bsecVersion = {};
+    bsec_bme_settings_t bsecSettings = {}; // What BSEC wants measured, and when it next wants to be asked
+    bsec_output_t outputs[BSEC_NUMBER_OUTPUTS] = {};
+    uint8_t numOutputs = 0;
+
+    bool measuring = false;
+    int64_t measurementStartNs = 0;
+    int64_t measurementDoneNs = 0;
+    uint32_t lastMillis = 0;
+    uint32_t millisOverflows = 0;
+
+    /// BSEC works in ns since boot, which millis() alone overflows
+    int64_t getTimeNs();
+    void startMeasurement(int64_t nowNs);
+    void finishMeasurement();
+    float getOutput(uint8_t sensorId, uint8_t *accuracy = nullptr);
 
   protected:
     virtual void setup() override;
@@ -34,12 +56,14 @@ class BME680Sensor : public TelemetrySensor
                                 BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_HUMIDITY};
     void loadState();
     void updateState();
-    void checkStatus(String functionName);
+    void checkStatus(const char *functionName, bsec_library_return_t bsecStatus);
 
   public:
     BME680Sensor();
-    int32_t runTrigger();
     virtual int32_t runOnce() override;
+    // Back when BSEC next wants a measurement, or when the one under way is done
+    virtual uint32_t getServiceIntervalMs() override;
+    virtual void service() override;
     virtual bool getMetrics(meshtastic_Telemetry *measurement) override;
 };
 
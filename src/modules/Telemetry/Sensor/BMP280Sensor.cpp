@@ -18,16 +18,27 @@ int32_t BMP280Sensor::runOnce()
     }
     bmp280 = Adafruit_BMP280(nodeTelemetrySensorsMap[sensorType].second);
     status = bmp280.begin(nodeTelemetrySensorsMap[sensorType].first);
+    setForcedSampling();
 
+    return initI2CSensor();
+}
+
+void BMP280Sensor::setup() {}
+
+void BMP280Sensor::setForcedSampling()
+{
     bmp280.setSampling(Adafruit_BMP280::MODE_FORCED,
                        Adafruit_BMP280::SAMPLING_X1, // Temp. oversampling
                        Adafruit_BMP280::SAMPLING_X1, // Pressure oversampling
                        Adafruit_BMP280::FILTER_OFF, Adafruit_BMP280::STANDBY_MS_1000);
-
-    return initI2CSensor();
 }
 
-void BMP280Sensor::setup() {}
+bool BMP280Sensor::startConversion()
+{
+    setForcedSampling();
+    conversionStarted = true;
+    return true;
+}
 
 bool BMP280Sensor::getMetrics(meshtastic_Telemetry *measurement)
 {
@@ -35,7 +46,8 @@ bool BMP280Sensor::getMetrics(meshtastic_Telemetry *measurement)
     measurement->variant.environment_metrics.has_barometric_pressure = true;
 
     LOG_DEBUG("BMP280 getMetrics");
-    bmp280.takeForcedMeasurement();
+    if (!takeStartedConversion())
+        bmp280.takeForcedMeasurement();
     measurement->variant.environment_metrics.temperature = bmp280.readTemperature();
     measurement->variant.environment_metrics.barometric_pressure = bmp280.readPressure() / 100.0F;
 
@@ -0,0 +1,89 @@
+#include "configuration.h"
+
+#if !MESHTASTIC_EXCLUDE_ENVIRONMENTAL_SENSOR
+
+#include "SensorScheduler.h"
+
+bool SensorScheduler::add(TelemetrySensor *sensor)
+{
+    if (count >= SENSOR_SCHEDULER_MAX_SENSORS) {
+        LOG_WARN("Too many sensors, not scheduling %s", sensor->getName());
+        return false;
+    }
+
+    // Go after the last sensor on the same bus, so each bus is talked to in one go
+    size_t at = count;
+    for (size_t i = 0; i < count; i++)
+        if (entries[i].sensor->getBus() == sensor->getBus())
+            at = i + 1;
+    for (size_t i = count; i > at; i--)
+        entries[i] = entries[i - 1];
+
+    entries[at].sensor = sensor;
+    entries[at].nextServiceMs = millis();
+    count++;
+    return true;
+}
+
+bool SensorScheduler::isDue(const Entry &e, uint32_t now, uint32_t slackMs)
+{
+    return e.sensor->getServiceIntervalMs() && (int32_t)(now + slackMs - e.nextServiceMs) >= 0;
+}
+
+uint32_t SensorScheduler::service(uint32_t now)
+{
+    uint32_t nextMs = UINT32_MAX;
+    for (size_t first = 0; first < count;) {
+        // Sensors on one bus are next to each other. If any of them needs the bus now, those due soon come along.
+        size_t last = first;
+        bool busDue = false;
+        while (last < count && entries[last].sensor->getBus() == entries[first].sensor->getBus())
+            busDue = isDue(entries[last++], now, 0) || busDue;
+        uint32_t slackMs = busDue ? SENSOR_SCHEDULER_BATCH_MS : 0;
+
+        for (size_t i = first; i < last; i++) {
+            Entry &e = entries[i];
+            if (isDue(e, now, slackMs)) {
+                e.sensor->service();
+                // Asked after service(), a sensor waiting on a measurement wants to be back sooner than usual
+                e.nextServiceMs = now + e.sensor->getServiceIntervalMs();
+            }
+            if (!e.sensor->getServiceIntervalMs())
+                continue;
+            uint32_t waitMs = e.nextServiceMs - now;
+            if (waitMs < nextMs)
+                nextMs = waitMs;
+        }
+        first = last;
+    }
+    return nextMs;
+}
+
+uint32_t SensorScheduler::startConversions(uint32_t now)
+{
+    uint32_t longestMs = 0;
+    for (size_t i = 0; i < count; i++) {
+        TelemetrySensor *sensor = entries[i].sensor;
+        if (sensor->startConversion() && sensor->getConversionMs() > longestMs)
+            longestMs = sensor->getConversionMs();
+    }
+    converting = true;
+    readyAtMs = now + longestMs;
+    return longestMs;
+}
+
+void SensorScheduler::finishConversions()
+{
+    for (size_t i = 0; i < count; i++)
+        entries[i].sensor->cancelConversion();
+    converting = false;
+}
+
+uint32_t SensorScheduler::msUntilReady(uint32_t now) const
+{
+    if (!converting || (int32_t)(now - readyAtMs) >= 0)
+        return 0;
+    return readyAtMs - now;
+}
+
+#endif
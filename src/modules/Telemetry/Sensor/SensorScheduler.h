@@ -0,0 +1,63 @@
+#include "configuration.h"
+
+#if !MESHTASTIC_EXCLUDE_ENVIRONMENTAL_SENSOR
+
+#pragma once
+#include "TelemetrySensor.h"
+
+#define SENSOR_SCHEDULER_MAX_SENSORS 32
+
+#ifndef SENSOR_SCHEDULER_BATCH_MS
+// How early a sensor may be serviced, when another on its bus is being serviced anyway
+#define SENSOR_SCHEDULER_BATCH_MS 10
+#endif
+
+/**
+ * Decides when the environment sensors get talked to, so the telemetry thread doesn't sit in delay() while each of
+ * them measures in turn.
+ *
+ * Before telemetry is due, startConversions() kicks off every sensor that can measure in the background, bus by bus,
+ * and says how long until the slowest of them is done. The caller comes back then and reads them all with
+ * getMetrics(), which no longer has to wait. Sensors that need regular attention (the BME680, whose measurements BSEC
+ * asks for) get service() calls at their own cadence instead of on every run of the module. A sensor can change its
+ * cadence from one call to the next, to come back once a measurement it started is done. When one sensor on a bus is
+ * due, the others on that bus due within SENSOR_SCHEDULER_BATCH_MS are serviced with it, rather than waking the module
+ * again moments later.
+ *
+ * The BMP280 and BME280 start a conversion before telemetry goes out, and the BME680 measures in the background between
+ * service() calls. The other drivers' libraries only offer blocking reads, so they still measure inside getMetrics().
+ */
+class SensorScheduler
+{
+  public:
+    /// Take charge of a sensor that has been set up. Sensors on the same bus are kept together.
+    bool add(TelemetrySensor *sensor);
+    size_t size() const { return count; }
+    TelemetrySensor *get(size_t i) const { return entries[i].sensor; }
+
+    /// Service whichever sensors are due. Returns the ms until the next one is, UINT32_MAX if none needs it.
+    uint32_t service(uint32_t now);
+
+    /// Start a conversion on every sensor that can do one. Returns the ms until all of them have finished.
+    uint32_t startConversions(uint32_t now);
+    bool isConverting() const { return converting; }
+    /// The ms until the conversions started last are done, 0 once they are
+    uint32_t msUntilReady(uint32_t now) const;
+    /// The results have been read, or aren't wanted any more. Conversions that weren't read are dropped.
+    void finishConversions();
+
+  private:
+    struct Entry {
+        TelemetrySensor *sensor;
+        uint32_t nextServiceMs;
+    };
+
+    static bool isDue(const Entry &e, uint32_t now, uint32_t slackMs);
+
+    Entry entries[SENSOR_SCHEDULER_MAX_SENSORS];
+    size_t count = 0;
+    bool converting = false;
+    uint32_t readyAtMs = 0;
+};
+
+#endif
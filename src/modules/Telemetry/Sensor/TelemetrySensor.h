@@ -29,6 +29,15 @@ class TelemetrySensor
     meshtastic_TelemetrySensorType sensorType = meshtastic_TelemetrySensorType_SENSOR_UNSET;
     unsigned status;
     bool initialized = false;
+    bool conversionStarted = false; // By startConversion(), getMetrics() reads the result instead of measuring
+
+    /// For getMetrics(): whether a conversion started earlier can be read now, rather than measuring from scratch
+    bool takeStartedConversion()
+    {
+        bool started = conversionStarted;
+        conversionStarted = false;
+        return started;
+    }
 
     int32_t initI2CSensor()
     {
@@ -52,12 +61,29 @@ class TelemetrySensor
     }
 
     bool hasSensor() { return nodeTelemetrySensorsMap[sensorType].first > 0; }
+    TwoWire *getBus() { return nodeTelemetrySensorsMap[sensorType].second; }
+    const char *getName() { return sensorName; }
 
     virtual int32_t runOnce() = 0;
     virtual bool isInitialized() { return initialized; }
     virtual bool isRunning() { return status > 0; }
 
     virtual bool getMetrics(meshtastic_Telemetry *measurement) = 0;
+
+    /**
+     * Sensors that can measure in the background implement these, so that SensorScheduler can start them all at once
+     * and come back for the results instead of getMetrics() waiting on each sensor in turn.
+     */
+    /// Start a measurement for the next getMetrics() to pick up. Returns false if the sensor can't.
+    virtual bool startConversion() { return false; }
+    /// How long after startConversion() the result can be read
+    virtual uint32_t getConversionMs() { return 0; }
+    /// Drop a started conversion nobody read, so the next getMetrics() measures afresh
+    void cancelConversion() { conversionStarted = false; }
+
+    /// Sensors that need attention between reads (e.g. the BSEC library) say how often, and get service() calls
+    virtual uint32_t getServiceIntervalMs() { return 0; }
+    virtual void service() {}
 };
 
 #endif
\ No newline at end of file
@@ -10,6 +10,12 @@
 #include "mesh/generated/meshtastic/mqtt.pb.h"
 #include "mesh/generated/meshtastic/telemetry.pb.h"
 #include "modules/RoutingModule.h"
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+#include "mesh/PipelineStats.h"
+#endif
+#if !MESHTASTIC_EXCLUDE_COMPRESSION
+#include "mesh/PayloadCompression.h"
+#endif
 #if defined(ARCH_ESP32)
 #include "../mesh/generated/meshtastic/paxcount.pb.h"
 #endif
@@ -26,6 +32,7 @@
 #include "Default.h"
 #if !defined(ARCH_NRF52) || NRF52_USE_JSON
 #include "serialization/JSON.h"
+#include "serialization/JSONReader.h"
 #include "serialization/MeshPacketSerializer.h"
 #endif
 #include <Throttle.h>
@@ -51,8 +58,15 @@ static uint8_t bytes[meshtastic_MqttClientProxyMessage_size + 30]; // 12 for cha
 
 static bool isMqttServerAddressPrivate = false;
 
-inline void onReceiveProto(char *topic, byte *payload, size_t length)
+inline void onReceiveProto(char *topic, byte *payload, size_t length, RecentPacketFilter &recentDownlinks)
 {
+    // Other gateways republish what we already have, check for that before doing any real work
+    uint32_t from, id;
+    if (peekServiceEnvelopePacket(payload, length, &from, &id) && recentDownlinks.contains(from, id, millis())) {
+        LOG_DEBUG("Ignore MQTT duplicate fr=0x%x,id=0x%x", from, id);
+        return;
+    }
+
     const DecodedServiceEnvelope e(payload, length);
     if (!e.validDecode || e.channel_id == NULL || e.gateway_id == NULL || e.packet == NULL) {
         LOG_ERROR("Invalid MQTT service envelope, topic %s, len %u!", topic, length);
@@ -115,94 +129,172 @@ inline void onReceiveProto(char *topic, byte *payload, size_t length)
         const meshtastic_NodeInfoLite *rx = nodeDB->getMeshNode(p->to);
         // Only accept PKI messages to us, or if we have both the sender and receiver in our nodeDB, as then it's
         // likely they discovered each other via a channel we have downlink enabled for
-        if (isToUs(p.get()) || (tx && tx->has_user && rx && rx->has_user))
+        if (isToUs(p.get()) || (tx && tx->has_user && rx && rx->has_user)) {
+            recentDownlinks.add(p->from, p->id, millis());
             router->enqueueReceivedMessage(p.release());
+        }
     } else if (router &&
-               perhapsDecode(p.get()) == DecodeState::DECODE_SUCCESS) // ignore messages if we don't have the channel key
+               perhapsDecode(p.get()) == DecodeState::DECODE_SUCCESS) { // ignore messages if we don't have the channel key
+        recentDownlinks.add(p->from, p->id, millis());
         router->enqueueReceivedMessage(p.release());
+    }
 }
 
 #if !defined(ARCH_NRF52) || NRF52_USE_JSON
-// returns true if this is a valid JSON envelope which we accept on downlink
-inline bool isValidJsonEnvelope(JSONObject &json)
+// The fields of a JSON downlink envelope we act on
+struct JsonEnvelope {
+    bool fromUs = false;     // "sender" is our own id, i.e. we uplinked it
+    bool badHopLimit = false;
+    bool haveFrom = false, haveType = false, havePayload = false;
+    double from = 0;
+    bool sendText = false, sendPosition = false; // "type"
+    bool haveChannel = false, haveTo = false, haveHopLimit = false;
+    double channel = 0, to = 0, hopLimit = 0;
+
+    // "payload", either text or a position
+    bool payloadIsText = false, payloadIsPosition = false;
+    char text[sizeof(meshtastic_Data_payload_t::bytes)];
+    size_t textLen = 0;
+    meshtastic_Position pos = meshtastic_Position_init_default;
+
+    // returns true if this is a valid JSON envelope which we accept on downlink
+    bool isValid()
+    {
+        return !fromUs && !badHopLimit && haveFrom && from == nodeDB->getNodeNum() && // only accept message if the "from" is us
+               haveType && havePayload;
+    }
+};
+
+/// Read a number for a key, skipping anything else. Returns false only if the JSON is invalid.
+inline bool readJsonNumber(JSONReader &json, bool *have, double *value)
 {
-    // if "sender" is provided, avoid processing packets we uplinked
-    return (json.find("sender") != json.end() ? (json["sender"]->AsString().compare(owner.id) != 0) : true) &&
-           (json.find("hopLimit") != json.end() ? json["hopLimit"]->IsNumber() : true) && // hop limit should be a number
-           (json.find("from") != json.end()) && json["from"]->IsNumber() &&
-           (json["from"]->AsNumber() == nodeDB->getNodeNum()) &&            // only accept message if the "from" is us
-           (json.find("type") != json.end()) && json["type"]->IsString() && // should specify a type
-           (json.find("payload") != json.end());                            // should have a payload
+    JSONReader::Token t = json.next();
+    *have = t == JSONReader::JSON_NUMBER;
+    if (*have)
+        *value = json.getNumber();
+    return json.skip();
+}
+
+/// Pick out the fields we use, without building the whole document. Returns false if it isn't valid JSON.
+inline bool readJsonEnvelope(JSONReader &json, JsonEnvelope &env)
+{
+    JSONReader::Token t = json.next();
+    if (t != JSONReader::JSON_OBJECT_START)
+        return json.skip() && json.next() == JSONReader::JSON_END; // Valid, but not an envelope
+    while ((t = json.next()) == JSONReader::JSON_KEY) {
+        bool ok = true;
+        if (json.equals("sender")) {
+            // if "sender" is provided, avoid processing packets we uplinked
+            env.fromUs = json.next() == JSONReader::JSON_STRING && json.equals(owner.id);
+            ok = json.skip();
+        } else if (json.equals("hopLimit")) {
+            ok = readJsonNumber(json, &env.haveHopLimit, &env.hopLimit);
+            env.badHopLimit = !env.haveHopLimit; // hop limit should be a number
+        } else if (json.equals("from")) {
+            ok = readJsonNumber(json, &env.haveFrom, &env.from);
+        } else if (json.equals("channel")) {
+            ok = readJsonNumber(json, &env.haveChannel, &env.channel);
+        } else if (json.equals("to")) {
+            ok = readJsonNumber(json, &env.haveTo, &env.to);
+        } else if (json.equals("type")) {
+            env.haveType = json.next() == JSONReader::JSON_STRING; // should specify a type
+            env.sendText = env.haveType && json.equals("sendtext");
+            env.sendPosition = env.haveType && json.equals("sendposition");
+            ok = json.skip();
+        } else if (json.equals("payload")) {
+            env.havePayload = true;
+            t = json.next();
+            env.payloadIsText = t == JSONReader::JSON_STRING;
+            env.payloadIsPosition = t == JSONReader::JSON_OBJECT_START;
+            if (env.payloadIsText) {
+                env.textLen = json.getString(env.text, sizeof(env.text));
+            } else if (env.payloadIsPosition) {
+                // nested JSON Position
+                env.pos = meshtastic_Position_init_default;
+                while (ok && (t = json.next()) == JSONReader::JSON_KEY) {
+                    bool have = false;
+                    double value = 0;
+                    if (json.equals("latitude_i")) {
+                        ok = readJsonNumber(json, &have, &value);
+                        if (have)
+                            env.pos.latitude_i = value;
+                    } else if (json.equals("longitude_i")) {
+                        ok = readJsonNumber(json, &have, &value);
+                        if (have)
+                            env.pos.longitude_i = value;
+                    } else if (json.equals("altitude")) {
+                        ok = readJsonNumber(json, &have, &value);
+                        if (have)
+                            env.pos.altitude = value;
+                    } else if (json.equals("time")) {
+                        ok = readJsonNumber(json, &have, &value);
+                        if (have)
+                            env.pos.time = value;
+                    } else {
+                        ok = json.skip();
+                    }
+                }
+                ok = ok && t == JSONReader::JSON_OBJECT_END;
+            } else {
+                ok = json.skip();
+            }
+        } else {
+            ok = json.skip();
+        }
+        if (!ok)
+            return false;
+    }
+    return t == JSONReader::JSON_OBJECT_END && json.next() == JSONReader::JSON_END;
 }
 
 inline void onReceiveJson(byte *payload, size_t length)
 {
-    char payloadStr[length + 1];
-    memcpy(payloadStr, payload, length);
-    payloadStr[length] = 0; // null terminated string
-    std::unique_ptr<JSONValue> json_value(JSON::Parse(payloadStr));
-    if (json_value == nullptr) {
+    JSONReader json((const char *)payload, length);
+    JsonEnvelope env;
+    if (!readJsonEnvelope(json, env)) {
         LOG_ERROR("JSON received payload on MQTT but not a valid JSON");
         return;
     }
 
-    JSONObject json;
-    json = json_value->AsObject();
-
-    if (!isValidJsonEnvelope(json)) {
+    if (!env.isValid()) {
         LOG_ERROR("JSON received payload on MQTT but not a valid envelope");
         return;
     }
 
     // this is a valid envelope
-    if (json["type"]->AsString().compare("sendtext") == 0 && json["payload"]->IsString()) {
-        std::string jsonPayloadStr = json["payload"]->AsString();
-        LOG_INFO("JSON payload %s, length %u", jsonPayloadStr.c_str(), jsonPayloadStr.length());
+    if (env.sendText && env.payloadIsText) {
+        LOG_INFO("JSON payload %.*s, length %u", (int)std::min(env.textLen, sizeof(env.text)), env.text, env.textLen);
+        if (env.textLen > sizeof(env.text)) {
+            LOG_WARN("Received MQTT json payload too long, drop");
+            return;
+        }
 
         // construct protobuf data packet using TEXT_MESSAGE, send it to the mesh
         meshtastic_MeshPacket *p = router->allocForSending();
         p->decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
-        if (json.find("channel") != json.end() && json["channel"]->IsNumber() &&
-            (json["channel"]->AsNumber() < channels.getNumChannels()))
-            p->channel = json["channel"]->AsNumber();
-        if (json.find("to") != json.end() && json["to"]->IsNumber())
-            p->to = json["to"]->AsNumber();
-        if (json.find("hopLimit") != json.end() && json["hopLimit"]->IsNumber())
-            p->hop_limit = json["hopLimit"]->AsNumber();
-        if (jsonPayloadStr.length() <= sizeof(p->decoded.payload.bytes)) {
-            memcpy(p->decoded.payload.bytes, jsonPayloadStr.c_str(), jsonPayloadStr.length());
-            p->decoded.payload.size = jsonPayloadStr.length();
-            service->sendToMesh(p, RX_SRC_LOCAL);
-        } else {
-            LOG_WARN("Received MQTT json payload too long, drop");
-        }
-    } else if (json["type"]->AsString().compare("sendposition") == 0 && json["payload"]->IsObject()) {
+        if (env.haveChannel && env.channel < channels.getNumChannels())
+            p->channel = env.channel;
+        if (env.haveTo)
+            p->to = env.to;
+        if (env.haveHopLimit)
+            p->hop_limit = env.hopLimit;
+        memcpy(p->decoded.payload.bytes, env.text, env.textLen);
+        p->decoded.payload.size = env.textLen;
+        service->sendToMesh(p, RX_SRC_LOCAL);
+    } else if (env.sendPosition && env.payloadIsPosition) {
         // invent the "sendposition" type for a valid envelope
-        JSONObject posit;
-        posit = json["payload"]->AsObject(); // get nested JSON Position
-        meshtastic_Position pos = meshtastic_Position_init_default;
-        if (posit.find("latitude_i") != posit.end() && posit["latitude_i"]->IsNumber())
-            pos.latitude_i = posit["latitude_i"]->AsNumber();
-        if (posit.find("longitude_i") != posit.end() && posit["longitude_i"]->IsNumber())
-            pos.longitude_i = posit["longitude_i"]->AsNumber();
-        if (posit.find("altitude") != posit.end() && posit["altitude"]->IsNumber())
-            pos.altitude = posit["altitude"]->AsNumber();
-        if (posit.find("time") != posit.end() && posit["time"]->IsNumber())
-            pos.time = posit["time"]->AsNumber();
-
         // construct protobuf data packet using POSITION, send it to the mesh
         meshtastic_MeshPacket *p = router->allocForSending();
         p->decoded.portnum = meshtastic_PortNum_POSITION_APP;
-        if (json.find("channel") != json.end() && json["channel"]->IsNumber() &&
-            (json["channel"]->AsNumber() < channels.getNumChannels()))
-            p->channel = json["channel"]->AsNumber();
-        if (json.find("to") != json.end() && json["to"]->IsNumber())
-            p->to = json["to"]->AsNumber();
-        if (json.find("hopLimit") != json.end() && json["hopLimit"]->IsNumber())
-            p->hop_limit = json["hopLimit"]->AsNumber();
+        if (env.haveChannel && env.channel < channels.getNumChannels())
+            p->channel = env.channel;
+        if (env.haveTo)
+            p->to = env.to;
+        if (env.haveHopLimit)
+            p->hop_limit = env.hopLimit;
         p->decoded.payload.size =
             pb_encode_to_bytes(p->decoded.payload.bytes, sizeof(p->decoded.payload.bytes), &meshtastic_Position_msg,
-                               &pos); // make the Data protobuf from position
+                               &env.pos); // make the Data protobuf from position
         service->sendToMesh(p, RX_SRC_LOCAL);
     } else {
         LOG_DEBUG("JSON ignore downlink message with unsupported type");
@@ -366,7 +458,7 @@ void MQTT::onReceive(char *topic, byte *payload, size_t length)
         return;
     }
 
-    onReceiveProto(topic, payload, length);
+    onReceiveProto(topic, payload, length, recentDownlinks);
 }
 
 void mqttInit()
@@ -392,11 +484,13 @@ MQTT::MQTT() : concurrency::OSThread("mqtt"), mqttQueue(MAX_MQTT_QUEUE)
             cryptTopic = moduleConfig.mqtt.root + cryptTopic;
             jsonTopic = moduleConfig.mqtt.root + jsonTopic;
             mapTopic = moduleConfig.mqtt.root + mapTopic;
+            statTopic = moduleConfig.mqtt.root + statTopic;
             isConfiguredForDefaultRootTopic = isDefaultRootTopic(moduleConfig.mqtt.root);
         } else {
             cryptTopic = "msh" + cryptTopic;
             jsonTopic = "msh" + jsonTopic;
             mapTopic = "msh" + mapTopic;
+            statTopic = "msh" + statTopic;
             isConfiguredForDefaultRootTopic = true;
         }
 
@@ -566,6 +660,7 @@ int32_t MQTT::runOnce()
     bool wantConnection = wantsLink();
 
     perhapsReportToMap();
+    perhapsReportPipelineStats();
 
     // If connected poll rapidly, otherwise only occasionally check for a wifi connection change and ability to contact server
     if (moduleConfig.mqtt.proxy_to_client_enabled) {
@@ -720,8 +815,24 @@ void MQTT::onSend(const meshtastic_MeshPacket &mp_encrypted, const meshtastic_Me
 
     LOG_DEBUG("MQTT onSend - Publish ");
     const meshtastic_MeshPacket *p;
+    meshtastic_MeshPacket *uncompressed = NULL;
     if (moduleConfig.mqtt.encryption_enabled) {
         p = &mp_encrypted;
+#if !MESHTASTIC_EXCLUDE_COMPRESSION
+        // Other MQTT clients can't decompress our payloads, encrypt the original one for them instead. Nobody else can
+        // read a PKI packet to us anyway.
+        if (mp_decoded.which_payload_variant == meshtastic_MeshPacket_decoded_tag && !mp_decoded.pki_encrypted &&
+            payloadCompression.wasCompressed(getFrom(&mp_decoded), mp_decoded.id)) {
+            uncompressed = packetPool.allocCopy(mp_decoded);
+            uncompressed->channel = chIndex;
+            if (perhapsEncode(uncompressed, false) != meshtastic_Routing_Error_NONE) {
+                LOG_WARN("MQTT onSend - Can't encrypt the uncompressed payload, not forwarding");
+                packetPool.release(uncompressed);
+                return;
+            }
+            p = uncompressed;
+        }
+#endif
         LOG_DEBUG("encrypted message");
     } else if (mp_decoded.which_payload_variant == meshtastic_MeshPacket_decoded_tag) {
         p = &mp_decoded;
@@ -734,6 +845,8 @@ void MQTT::onSend(const meshtastic_MeshPacket &mp_encrypted, const meshtastic_Me
     const meshtastic_ServiceEnvelope env = {
         .packet = const_cast<meshtastic_MeshPacket *>(p), .channel_id = const_cast<char *>(channelId), .gateway_id = owner.id};
     size_t numBytes = pb_encode_to_bytes(bytes, sizeof(bytes), &meshtastic_ServiceEnvelope_msg, &env);
+    if (uncompressed)
+        packetPool.release(uncompressed);
     std::string topic = cryptTopic + channelId + "/" + owner.id;
 
     if (moduleConfig.mqtt.proxy_to_client_enabled || this->isConnectedDirectly()) {
@@ -839,4 +952,48 @@ void MQTT::perhapsReportToMap()
 
     // Update the last report time
     last_report_to_map = millis();
-}
\ No newline at end of file
+}
+
+void MQTT::perhapsReportPipelineStats()
+{
+#if !MESHTASTIC_EXCLUDE_PIPELINE_STATS
+    if (!moduleConfig.mqtt.json_enabled || !(moduleConfig.mqtt.proxy_to_client_enabled || isConnectedDirectly()))
+        return;
+
+    if (Throttle::isWithinTimespanMs(last_pipeline_stats, pipeline_stats_interval_msecs))
+        return;
+    last_pipeline_stats = millis();
+
+    // Keep each message small enough to fit a client proxy text payload
+    char buf[sizeof(meshtastic_MqttClientProxyMessage{}.payload_variant.text)];
+    std::string topic = statTopic + owner.id;
+
+    LOG_INFO("MQTT Publish pipeline stats to %s", topic.c_str());
+    size_t next = 0;
+    do {
+        size_t from = next;
+        next = pipelineStats.writeStagesJson(buf, sizeof(buf), from);
+        if (next == from)
+            break;
+        publish((topic + "/stages").c_str(), buf, false);
+    } while (next <= NUM_PIPELINE_STAGES);
+
+    next = 0;
+    while (next < pipelineStats.getNumModules()) {
+        size_t from = next;
+        next = pipelineStats.writeModulesJson(buf, sizeof(buf), from);
+        if (next == from)
+            break;
+        publish((topic + "/modules").c_str(), buf, false);
+    }
+
+    next = 0;
+    do {
+        size_t from = next;
+        next = pipelineStats.writeSpiWaitsJson(buf, sizeof(buf), from);
+        if (next == from)
+            break;
+        publish((topic + "/spi").c_str(), buf, false);
+    } while (next < NUM_SPI_USERS);
+#endif
+}
@@ -6,6 +6,7 @@
 #include "concurrency/OSThread.h"
 #include "mesh/Channels.h"
 #include "mesh/generated/meshtastic/mqtt.pb.h"
+#include "mqtt/RecentPacketFilter.h"
 #if !defined(ARCH_NRF52) || NRF52_USE_JSON
 #include "serialization/JSON.h"
 #endif
@@ -104,6 +105,7 @@ class MQTT : private concurrency::OSThread
     std::string cryptTopic = "/2/e/";   // msh/2/e/CHANNELID/NODEID
     std::string jsonTopic = "/2/json/"; // msh/2/json/CHANNELID/NODEID
     std::string mapTopic = "/2/map/";   // For protobuf-encoded MapReport messages
+    std::string statTopic = "/2/stat/"; // msh/2/stat/NODEID, JSON pipeline latency summaries
 
     // For map reporting (only applies when enabled)
     const uint32_t default_map_position_precision = 14; // defaults to max. offset of ~1459m
@@ -111,6 +113,13 @@ class MQTT : private concurrency::OSThread
     uint32_t map_position_precision = default_map_position_precision;
     uint32_t map_publish_interval_msecs = default_map_publish_interval_secs * 1000;
 
+    // For pipeline latency reporting (only applies when json is enabled)
+    static const uint32_t pipeline_stats_interval_msecs = 15 * 60 * 1000;
+    uint32_t last_pipeline_stats = 0;
+
+    // Packets already taken from the downlink, so copies from other gateways aren't decrypted again
+    RecentPacketFilter recentDownlinks;
+
     /** Attempt to connect to server if necessary
      */
     void reconnect();
@@ -134,6 +143,9 @@ class MQTT : private concurrency::OSThread
     // Check if we should report unencrypted information about our node for consumption by a map
     void perhapsReportToMap();
 
+    // Publish the pipeline latency histograms every pipeline_stats_interval_msecs
+    void perhapsReportPipelineStats();
+
     /// Return 0 if sleep is okay, veto sleep if we are connected to pubsub server
     // int preflightSleepCb(void *unused = NULL) { return pubSub.connected() ? 1 : 0; }
 };
@@ -0,0 +1,75 @@
+#include "RecentPacketFilter.h"
+
+namespace
+{
+uint32_t mix(uint32_t h)
+{
+    // murmur3 finalizer
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+bool isFresh(uint32_t seenMs, uint32_t now)
+{
+    return (uint32_t)(now - seenMs) < (uint32_t)MQTT_RECENT_PACKET_EXPIRE_MS;
+}
+} // namespace
+
+void RecentPacketFilter::bucketsOf(uint32_t from, uint32_t id, size_t *first, size_t *second) const
+{
+    uint32_t h = mix(from ^ mix(id));
+    *first = h % numBuckets;
+    *second = (h >> 16) % numBuckets;
+}
+
+const RecentPacketFilter::Entry *RecentPacketFilter::find(uint32_t from, uint32_t id, uint32_t now) const
+{
+    size_t buckets[2];
+    bucketsOf(from, id, &buckets[0], &buckets[1]);
+    for (size_t b : buckets) {
+        const Entry *bucket = &entries[b * MQTT_RECENT_PACKET_WAYS];
+        for (size_t i = 0; i < MQTT_RECENT_PACKET_WAYS; i++) {
+            const Entry &e = bucket[i];
+            if (e.id == id && e.from == from && isFresh(e.seenMs, now))
+                return &e;
+        }
+    }
+    return nullptr;
+}
+
+bool RecentPacketFilter::contains(uint32_t from, uint32_t id, uint32_t now) const
+{
+    return id != 0 && find(from, id, now) != nullptr;
+}
+
+void RecentPacketFilter::add(uint32_t from, uint32_t id, uint32_t now)
+{
+    if (id == 0)
+        return;
+
+    Entry *e = const_cast<Entry *>(find(from, id, now));
+    if (!e) {
+        // Take a free or expired slot in either bucket, or else the oldest one
+        size_t buckets[2];
+        bucketsOf(from, id, &buckets[0], &buckets[1]);
+        for (size_t b = 0; b < 2 && !(e && (e->id == 0 || !isFresh(e->seenMs, now))); b++) {
+            Entry *bucket = &entries[buckets[b] * MQTT_RECENT_PACKET_WAYS];
+            for (size_t i = 0; i < MQTT_RECENT_PACKET_WAYS; i++) {
+                Entry &slot = bucket[i];
+                if (slot.id == 0 || !isFresh(slot.seenMs, now)) {
+                    e = &slot;
+                    break;
+                }
+                if (!e || (uint32_t)(now - slot.seenMs) > (uint32_t)(now - e->seenMs))
+                    e = &slot;
+            }
+        }
+    }
+    e->from = from;
+    e->id = id;
+    e->seenMs = now;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// How many downlinked packets we remember, in buckets of MQTT_RECENT_PACKET_WAYS
+#define MQTT_RECENT_PACKETS 128
+#define MQTT_RECENT_PACKET_WAYS 4
+
+/// Gateways republish a packet as they hear it, so copies turn up for about as long as a flood lasts
+#define MQTT_RECENT_PACKET_EXPIRE_MS (10 * 60 * 1000L)
+
+/**
+ * The (from, id) of packets recently taken from the MQTT downlink, so that copies republished by other gateways can be
+ * dropped before we decode and decrypt them again.
+ *
+ * Each key may live in one of two buckets (as in a cuckoo filter) and is stored in full, so there are no false
+ * positives. When both buckets are full the oldest entry is forgotten; a copy of it then takes the normal path and is
+ * dropped by the Router's PacketHistory instead.
+ */
+class RecentPacketFilter
+{
+  public:
+    /// Whether (from, id) was added less than MQTT_RECENT_PACKET_EXPIRE_MS ago
+    bool contains(uint32_t from, uint32_t id, uint32_t now) const;
+
+    void add(uint32_t from, uint32_t id, uint32_t now);
+
+  private:
+    struct Entry {
+        uint32_t from = 0;
+        uint32_t id = 0; // 0 for an empty slot, packets with no id are never added
+        uint32_t seenMs = 0;
+    };
+    Entry entries[MQTT_RECENT_PACKETS];
+
+    static const size_t numBuckets = MQTT_RECENT_PACKETS / MQTT_RECENT_PACKET_WAYS;
+
+    void bucketsOf(uint32_t from, uint32_t id, size_t *first, size_t *second) const;
+    const Entry *find(uint32_t from, uint32_t id, uint32_t now) const;
+};
@@ -20,4 +20,87 @@ DecodedServiceEnvelope::~DecodedServiceEnvelope()
 {
     if (validDecode)
         pb_release(&meshtastic_ServiceEnvelope_msg, this);
-}
\ No newline at end of file
+}
+namespace
+{
+// Protobuf wire types
+enum WireType : uint8_t { WIRE_VARINT = 0, WIRE_64BIT = 1, WIRE_LEN = 2, WIRE_32BIT = 5 };
+
+bool readVarint(const uint8_t *&p, const uint8_t *end, uint64_t *value)
+{
+    *value = 0;
+    for (uint8_t shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t b = *p++;
+        *value |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+/// Read the tag of the next field, and the value of a varint or fixed32 or the bounds of a length delimited one
+bool readField(const uint8_t *&p, const uint8_t *end, uint32_t *fieldNum, uint8_t *wireType, uint64_t *value,
+               const uint8_t **bytes)
+{
+    uint64_t tag;
+    if (!readVarint(p, end, &tag))
+        return false;
+    *fieldNum = tag >> 3;
+    *wireType = tag & 7;
+    switch (*wireType) {
+    case WIRE_VARINT:
+        return readVarint(p, end, value);
+    case WIRE_64BIT:
+        if (end - p < 8)
+            return false;
+        p += 8;
+        return true;
+    case WIRE_LEN:
+        if (!readVarint(p, end, value) || *value > (uint64_t)(end - p))
+            return false;
+        *bytes = p;
+        p += *value;
+        return true;
+    case WIRE_32BIT:
+        if (end - p < 4)
+            return false;
+        *value = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+        p += 4;
+        return true;
+    default:
+        return false; // Groups aren't used by our protos
+    }
+}
+} // namespace
+
+bool peekServiceEnvelopePacket(const uint8_t *payload, size_t length, uint32_t *from, uint32_t *id)
+{
+    *from = *id = 0;
+    bool havePacket = false;
+    const uint8_t *p = payload, *end = payload + length;
+    while (p < end) {
+        uint32_t fieldNum;
+        uint8_t wireType;
+        uint64_t value;
+        const uint8_t *bytes;
+        if (!readField(p, end, &fieldNum, &wireType, &value, &bytes))
+            return false;
+        if (fieldNum != meshtastic_ServiceEnvelope_packet_tag || wireType != WIRE_LEN)
+            continue;
+
+        // A repeated submessage is merged, so later values win
+        havePacket = true;
+        const uint8_t *q = bytes, *packetEnd = bytes + value;
+        while (q < packetEnd) {
+            if (!readField(q, packetEnd, &fieldNum, &wireType, &value, &bytes))
+                return false;
+            if (wireType != WIRE_32BIT)
+                continue;
+            if (fieldNum == meshtastic_MeshPacket_from_tag)
+                *from = value;
+            else if (fieldNum == meshtastic_MeshPacket_id_tag)
+                *id = value;
+        }
+    }
+    return havePacket;
+}
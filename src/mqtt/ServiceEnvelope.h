@@ -10,4 +10,9 @@ struct DecodedServiceEnvelope : public meshtastic_ServiceEnvelope {
     ~DecodedServiceEnvelope();
     // Clients must check that this is true before using.
     const bool validDecode;
-};
\ No newline at end of file
+};
+/**
+ * Read packet.from and packet.id straight from an encoded ServiceEnvelope, without decoding (or allocating) the rest.
+ * Fields that are absent read as 0. Returns false if the envelope is malformed or has no packet.
+ */
+bool peekServiceEnvelopePacket(const uint8_t *payload, size_t length, uint32_t *from, uint32_t *id);
@@ -9,24 +9,31 @@ class NRF52CryptoEngine : public CryptoEngine
 
     ~NRF52CryptoEngine() {}
 
-    virtual void encryptAESCtr(CryptoKey _key, uint8_t *_nonce, size_t numBytes, uint8_t *bytes) override
+    virtual void cryptAESCtr(CryptoContext &ctx, const uint8_t *bytes, size_t numBytes) const override
     {
-        if (_key.length > 16) {
-            AES_ctx ctx;
-            AES_init_ctx_iv(&ctx, _key.bytes, _nonce);
-            AES_CTR_xcrypt_buffer(&ctx, bytes, numBytes);
-        } else if (_key.length > 0) {
+        if (ctx.key.length > 16) {
+            AES_ctx aes;
+            AES_init_ctx_iv(&aes, ctx.key.bytes, ctx.nonce);
+            memcpy(ctx.scratch, bytes, numBytes);
+            AES_CTR_xcrypt_buffer(&aes, ctx.scratch, numBytes);
+        } else if (ctx.key.length > 0) {
+            // There is only the one CryptoCell, so AES128 callers take turns
+            concurrency::LockGuard g(&cellLock);
             nRFCrypto.begin();
-            nRFCrypto_AES ctx;
-            uint8_t myLen = ctx.blockLen(numBytes);
+            nRFCrypto_AES aes;
+            uint8_t myLen = aes.blockLen(numBytes);
             char encBuf[myLen] = {0};
-            ctx.begin();
-            ctx.Process((char *)bytes, numBytes, _nonce, _key.bytes, _key.length, encBuf, ctx.encryptFlag, ctx.ctrMode);
-            ctx.end();
+            aes.begin();
+            aes.Process((char *)bytes, numBytes, ctx.nonce, ctx.key.bytes, ctx.key.length, encBuf, aes.encryptFlag,
+                        aes.ctrMode);
+            aes.end();
             nRFCrypto.end();
-            memcpy(bytes, encBuf, numBytes);
+            memcpy(ctx.scratch, encBuf, numBytes);
         }
     }
+
+  private:
+    mutable concurrency::Lock cellLock;
 };
 
-CryptoEngine *crypto = new NRF52CryptoEngine();
\ No newline at end of file
+CryptoEngine *crypto = new NRF52CryptoEngine();
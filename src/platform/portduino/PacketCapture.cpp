@@ -0,0 +1,165 @@
+#include "PacketCapture.h"
+#include "RadioInterface.h"
+#include "configuration.h"
+#include "mesh-pb-constants.h"
+
+#include <string.h>
+#include <sys/time.h>
+
+PacketCapture packetCapture;
+
+#define PCAP_MAGIC 0xa1b2c3d4
+
+struct __attribute__((packed)) PcapFileHeader {
+    uint32_t magic;
+    uint16_t versionMajor;
+    uint16_t versionMinor;
+    int32_t thisZone;
+    uint32_t sigFigs;
+    uint32_t snapLen;
+    uint32_t linkType;
+};
+
+struct __attribute__((packed)) PcapRecordHeader {
+    uint32_t tsSec;
+    uint32_t tsUsec;
+    uint32_t inclLen;
+    uint32_t origLen;
+};
+
+bool PacketCapture::open(const std::string &path, bool _withDecoded)
+{
+    close();
+
+    FILE *f = fopen(path.c_str(), "a+b");
+    if (!f) {
+        LOG_ERROR("Can't open packet capture %s", path.c_str());
+        return false;
+    }
+
+    // Only append to something that is already one of our captures
+    PcapFileHeader existing;
+    fseek(f, 0, SEEK_SET);
+    size_t got = fread(&existing, 1, sizeof(existing), f);
+    if (got == 0) {
+        PcapFileHeader h = {PCAP_MAGIC, 2, 4, 0, 0, sizeof(PcapRecordHeader) + MAX_LORA_PAYLOAD_LEN + 1024, CAPTURE_LINKTYPE};
+        fwrite(&h, sizeof(h), 1, f);
+        fflush(f);
+    } else if (got != sizeof(existing) || existing.magic != PCAP_MAGIC || existing.linkType != CAPTURE_LINKTYPE) {
+        LOG_ERROR("%s is not a packet capture, not appending to it", path.c_str());
+        fclose(f);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+
+    file = f;
+    withDecoded = _withDecoded;
+    stopping = false;
+    writer = std::thread(&PacketCapture::writerLoop, this);
+    LOG_INFO("Capturing packets to %s", path.c_str());
+    return true;
+}
+
+void PacketCapture::close()
+{
+    if (!file)
+        return;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+    fclose(file);
+    file = nullptr;
+}
+
+void PacketCapture::writerLoop()
+{
+    std::vector<uint8_t> writing;
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        // Batch up whatever arrives within a second into a single write
+        wake.wait_for(guard, std::chrono::seconds(1), [this] { return stopping; });
+        writing.swap(pending);
+        bool done = stopping;
+        guard.unlock();
+
+        if (!writing.empty()) {
+            fwrite(writing.data(), 1, writing.size(), file);
+            fflush(file);
+            writing.clear();
+        }
+        if (done)
+            return;
+        guard.lock();
+    }
+}
+
+void PacketCapture::append(const CaptureRecordHeader &h, const meshtastic_MeshPacket *p, const uint8_t *body, size_t bodyLen)
+{
+    // The same header RadioInterface::beginSending() puts on the air
+    PacketHeader air;
+    air.to = p->to;
+    air.from = p->from;
+    air.id = p->id;
+    air.flags = (p->hop_limit & PACKET_FLAGS_HOP_LIMIT_MASK) | (p->want_ack ? PACKET_FLAGS_WANT_ACK_MASK : 0) |
+                (p->via_mqtt ? PACKET_FLAGS_VIA_MQTT_MASK : 0) |
+                ((p->hop_start << PACKET_FLAGS_HOP_START_SHIFT) & PACKET_FLAGS_HOP_START_MASK);
+    air.channel = h.type == CAPTURE_DECODED ? 0 : p->channel;
+    air.next_hop = p->next_hop;
+    air.relay_node = p->relay_node;
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    uint32_t len = sizeof(h) + sizeof(air) + bodyLen;
+    PcapRecordHeader rec = {(uint32_t)tv.tv_sec, (uint32_t)tv.tv_usec, len, len};
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (pending.size() + sizeof(rec) + len > MAX_PENDING) {
+        dropped++;
+        return;
+    }
+    const uint8_t *parts[] = {(const uint8_t *)&rec, (const uint8_t *)&h, (const uint8_t *)&air, body};
+    const size_t lens[] = {sizeof(rec), sizeof(h), sizeof(air), bodyLen};
+    for (size_t i = 0; i < 4; i++)
+        pending.insert(pending.end(), parts[i], parts[i] + lens[i]);
+}
+
+void PacketCapture::recordEncrypted(const meshtastic_MeshPacket *p, CaptureRecordType type, float frequencyMhz)
+{
+    if (!file || p->which_payload_variant != meshtastic_MeshPacket_encrypted_tag)
+        return;
+
+    CaptureRecordHeader h = {};
+    h.version = CAPTURE_FORMAT_VERSION;
+    h.type = type;
+    h.headerLen = sizeof(h);
+    h.rssi = p->rx_rssi;
+    h.snrQuarterDb = (int16_t)(p->rx_snr * 4);
+    h.frequencyKhz = (uint32_t)(frequencyMhz * 1000 + 0.5f);
+    h.rxTime = p->rx_time;
+    h.channelIndex = 0xFF;
+    h.flags = p->pki_encrypted ? CAPTURE_FLAG_PKI_ENCRYPTED : 0;
+    append(h, p, p->encrypted.bytes, p->encrypted.size);
+}
+
+void PacketCapture::recordDecoded(const meshtastic_MeshPacket *p)
+{
+    if (!wantsDecoded() || p->which_payload_variant != meshtastic_MeshPacket_decoded_tag)
+        return;
+
+    uint8_t body[meshtastic_Data_size];
+    size_t bodyLen = pb_encode_to_bytes(body, sizeof(body), &meshtastic_Data_msg, &p->decoded);
+
+    CaptureRecordHeader h = {};
+    h.version = CAPTURE_FORMAT_VERSION;
+    h.type = CAPTURE_DECODED;
+    h.headerLen = sizeof(h);
+    h.rssi = p->rx_rssi;
+    h.snrQuarterDb = (int16_t)(p->rx_snr * 4);
+    h.rxTime = p->rx_time;
+    h.channelIndex = p->channel;
+    h.flags = p->pki_encrypted ? CAPTURE_FLAG_PKI_ENCRYPTED : 0;
+    append(h, p, body, bodyLen);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "MeshTypes.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Binary packet capture, a cheap replacement for the per packet JSON trace.
+ *
+ * Files are classic pcap with link type LINKTYPE_USER0 (147), so standard tools can slice and merge them. Every record
+ * starts with a little endian CaptureRecordHeader followed by the 16 byte over the air PacketHeader and then:
+ *  - CAPTURE_RX / CAPTURE_TX: the encrypted payload exactly as it went over the air
+ *  - CAPTURE_DECODED: the encoded meshtastic_Data protobuf we got out of it, when decoded records are enabled
+ *
+ * Records are appended to a memory buffer and written out by a background thread, so the mesh thread never waits on
+ * the disk. If the disk can't keep up records are dropped rather than queued without bound.
+ *
+ * bin/capture-to-json.py turns a capture back into one JSON object per line.
+ */
+
+#define CAPTURE_LINKTYPE 147 // LINKTYPE_USER0
+#define CAPTURE_FORMAT_VERSION 1
+
+enum CaptureRecordType : uint8_t { CAPTURE_RX = 0, CAPTURE_TX = 1, CAPTURE_DECODED = 2 };
+
+#define CAPTURE_FLAG_PKI_ENCRYPTED 0x01
+
+struct __attribute__((packed)) CaptureRecordHeader {
+    uint8_t version;
+    uint8_t type;
+    uint16_t headerLen; // sizeof(CaptureRecordHeader), newer versions may append fields
+    int16_t rssi;
+    int16_t snrQuarterDb;
+    uint32_t frequencyKhz;
+    uint32_t rxTime;      // Mesh time in seconds since 1970, 0 if we had none
+    uint8_t channelIndex; // Local channel index for decoded records, 0xFF otherwise
+    uint8_t flags;
+    uint16_t reserved;
+};
+
+class PacketCapture
+{
+  public:
+    ~PacketCapture() { close(); }
+
+    /// Start capturing to path, appending if it is already a capture. Returns false if the file can't be used.
+    bool open(const std::string &path, bool withDecoded);
+    void close();
+
+    bool isOpen() const { return file != nullptr; }
+    bool wantsDecoded() const { return file != nullptr && withDecoded; }
+
+    /// An encrypted packet heard on or handed to the radio
+    void recordEncrypted(const meshtastic_MeshPacket *p, CaptureRecordType type, float frequencyMhz);
+    /// The decoded view of a packet we just managed to decrypt
+    void recordDecoded(const meshtastic_MeshPacket *p);
+
+    uint32_t getDropped() const { return dropped; }
+
+  private:
+    // Beyond this much unwritten data we start dropping records
+    static const size_t MAX_PENDING = 1024 * 1024;
+
+    FILE *file = nullptr;
+    bool withDecoded = false;
+
+    std::thread writer;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::vector<uint8_t> pending; // Protected by lock
+    bool stopping = false;        // Protected by lock
+    uint32_t dropped = 0;
+
+    void append(const CaptureRecordHeader &h, const meshtastic_MeshPacket *p, const uint8_t *body, size_t bodyLen);
+    void writerLoop();
+};
+
+extern PacketCapture packetCapture;
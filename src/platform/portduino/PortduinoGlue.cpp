@@ -5,6 +5,7 @@
 #include "sleep.h"
 #include "target_specific.h"
 
+#include "PacketCapture.h"
 #include "PortduinoGlue.h"
 #include "api/ServerAPI.h"
 #include "linux/gpio/LinuxGPIOPin.h"
@@ -27,8 +28,8 @@
 
 #include "platform/portduino/USBHal.h"
 
-std::map<configNames, int> settingsMap;
-std::map<configNames, std::string> settingsStrings;
+SettingsTable<int> settingsMap;
+SettingsTable<std::string> settingsStrings;
 std::ofstream traceFile;
 Ch341Hal *ch341Hal = nullptr;
 char *configPath = nullptr;
@@ -349,9 +350,8 @@ void portduinoSetup()
                            {txen_pin, txen_gpiochip, txen_line},
                            {sx126x_ant_sw_pin, sx126x_ant_sw_gpiochip, sx126x_ant_sw_line}};
         for (auto &pinMap : pinMappings) {
-            auto setMapIter = settingsMap.find(pinMap.pin);
-            if (setMapIter != settingsMap.end() && setMapIter->second != RADIOLIB_NC) {
-                if (initGPIOPin(setMapIter->second, gpioChipName + std::to_string(settingsMap[pinMap.gpiochip]),
+            if (settingsMap.count(pinMap.pin) && settingsMap[pinMap.pin] != RADIOLIB_NC) {
+                if (initGPIOPin(settingsMap[pinMap.pin], gpioChipName + std::to_string(settingsMap[pinMap.gpiochip]),
                                 settingsMap[pinMap.line]) != ERRNO_OK) {
                     printf("Error setting pin number %d. It may not exist, or may already be in use.\n",
                            settingsMap[pinMap.line]);
@@ -369,6 +369,11 @@ void portduinoSetup()
             exit(EXIT_FAILURE);
         }
     }
+    if (settingsStrings[captureFilename] != "" &&
+        !packetCapture.open(settingsStrings[captureFilename], settingsMap[captureDecoded])) {
+        std::cout << "*** Can't capture packets to " << settingsStrings[captureFilename] << std::endl;
+        exit(EXIT_FAILURE);
+    }
 
     return;
 }
@@ -411,6 +416,8 @@ bool loadConfig(const char *configPath)
                 settingsMap[logoutputlevel] = level_error;
             }
             settingsStrings[traceFilename] = yamlConfig["Logging"]["TraceFile"].as<std::string>("");
+            settingsStrings[captureFilename] = yamlConfig["Logging"]["CaptureFile"].as<std::string>("");
+            settingsMap[captureDecoded] = yamlConfig["Logging"]["CaptureDecoded"].as<bool>(true);
             if (yamlConfig["Logging"]["AsciiLogs"]) {
                 // Default is !isatty(1) but can be set explicitly in config.yaml
                 settingsMap[ascii_logs] = yamlConfig["Logging"]["AsciiLogs"].as<bool>();
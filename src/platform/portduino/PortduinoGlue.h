@@ -90,6 +90,8 @@ enum configNames {
     pointerDevice,
     logoutputlevel,
     traceFilename,
+    captureFilename,
+    captureDecoded,
     webserver,
     webserverport,
     webserverrootpath,
@@ -103,14 +105,36 @@ enum configNames {
     mac_address,
     hostMetrics_interval,
     hostMetrics_channel,
-    hostMetrics_user_command
+    hostMetrics_user_command,
+    NUM_CONFIG_NAMES // Must stay last
 };
 enum { no_screen, x11, fb, st7789, st7735, st7735s, st7796, ili9341, ili9342, ili9486, ili9488, hx8357d };
 enum { no_touchscreen, xpt2046, stmpe610, gt911, ft5x06 };
 enum { level_error, level_warn, level_info, level_debug, level_trace };
 
-extern std::map<configNames, int> settingsMap;
-extern std::map<configNames, std::string> settingsStrings;
+/**
+ * Settings from config.yaml, stored flat and indexed by configNames.
+ *
+ * Used like the std::map it replaces, but a lookup is a plain array load, which matters for the settings the packet
+ * path and the logger check every time. As with std::map, reading a setting with [] marks it as present for count().
+ */
+template <typename T> class SettingsTable
+{
+  public:
+    T &operator[](configNames key)
+    {
+        present[key] = true;
+        return values[key];
+    }
+    size_t count(configNames key) const { return present[key] ? 1 : 0; }
+
+  private:
+    T values[NUM_CONFIG_NAMES] = {};
+    bool present[NUM_CONFIG_NAMES] = {};
+};
+
+extern SettingsTable<int> settingsMap;
+extern SettingsTable<std::string> settingsStrings;
 extern std::ofstream traceFile;
 extern Ch341Hal *ch341Hal;
 int initGPIOPin(int pinNum, std::string gpioChipname, int line);
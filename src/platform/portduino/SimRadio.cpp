@@ -175,8 +175,10 @@ void SimRadio::onNotify(uint32_t notification)
             } else {
                 if (isChannelActive()) { // check if there is currently a LoRa packet on the channel
                     // LOG_DEBUG("Channel is active: set random delay");
+                    contention.noteChannelBusy(txQueue.getFront()->id, millis());
                     setTransmitDelay(); // reset random delay
                 } else {
+                    contention.noteChannelIdle(millis());
                     // Send any outgoing packets we have ready
                     meshtastic_MeshPacket *txp = txQueue.dequeue();
                     assert(txp);
@@ -252,6 +254,7 @@ void SimRadio::startReceive(meshtastic_MeshPacket *p)
     if (isActivelyReceiving()) {
         LOG_WARN("Collision detected, dropping current and previous packet!");
         rxBad++;
+        contention.noteCollision(millis());
         airTime->logAirtime(RX_ALL_LOG, getPacketTime(receivingPacket));
         packetPool.release(receivingPacket);
         receivingPacket = nullptr;
@@ -0,0 +1,382 @@
+#include "JSONReader.h"
+
+#include <string.h>
+
+namespace
+{
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+uint32_t readHex4(const char *s)
+{
+    return (hexValue(s[0]) << 12) | (hexValue(s[1]) << 8) | (hexValue(s[2]) << 4) | hexValue(s[3]);
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+} // namespace
+
+JSONReader::Token JSONReader::fail()
+{
+    failed = true;
+    return token = JSON_ERROR;
+}
+
+void JSONReader::skipWhitespace()
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+        p++;
+}
+
+JSONReader::Token JSONReader::next()
+{
+    if (failed)
+        return JSON_ERROR;
+
+    skipWhitespace();
+    if (expect == EXPECT_AFTER_VALUE) {
+        if (depth == 0)
+            return p == end ? token = JSON_END : fail();
+        if (p == end)
+            return fail();
+        bool object = inObject();
+        if (*p == ',') {
+            p++;
+            skipWhitespace();
+            expect = object ? EXPECT_KEY : EXPECT_VALUE;
+        } else if (*p == (object ? '}' : ']')) {
+            p++;
+            depth--;
+            return token = object ? JSON_OBJECT_END : JSON_ARRAY_END;
+        } else {
+            return fail();
+        }
+    }
+    if (p == end)
+        return fail();
+
+    if (expect == EXPECT_KEY_OR_END && *p == '}') {
+        p++;
+        depth--;
+        expect = EXPECT_AFTER_VALUE;
+        return token = JSON_OBJECT_END;
+    }
+    if (expect == EXPECT_VALUE_OR_END && *p == ']') {
+        p++;
+        depth--;
+        expect = EXPECT_AFTER_VALUE;
+        return token = JSON_ARRAY_END;
+    }
+
+    if (expect == EXPECT_KEY || expect == EXPECT_KEY_OR_END) {
+        if (*p != '"' || !readString())
+            return fail();
+        skipWhitespace();
+        if (p == end || *p != ':')
+            return fail();
+        p++;
+        expect = EXPECT_VALUE;
+        return token = JSON_KEY;
+    }
+
+    // A value
+    Token t;
+    switch (*p) {
+    case '{':
+        if (!open(true))
+            return fail();
+        expect = EXPECT_KEY_OR_END;
+        return token = JSON_OBJECT_START;
+    case '[':
+        if (!open(false))
+            return fail();
+        expect = EXPECT_VALUE_OR_END;
+        return token = JSON_ARRAY_START;
+    case '"':
+        if (!readString())
+            return fail();
+        t = JSON_STRING;
+        break;
+    case 't':
+        if (!readLiteral("true"))
+            return fail();
+        t = JSON_TRUE;
+        break;
+    case 'f':
+        if (!readLiteral("false"))
+            return fail();
+        t = JSON_FALSE;
+        break;
+    case 'n':
+        if (!readLiteral("null"))
+            return fail();
+        t = JSON_NULL;
+        break;
+    default:
+        if (!readNumber())
+            return fail();
+        t = JSON_NUMBER;
+        break;
+    }
+    expect = EXPECT_AFTER_VALUE;
+    return token = t;
+}
+
+bool JSONReader::open(bool isObject)
+{
+    if (depth == JSON_READER_MAX_DEPTH)
+        return false;
+    if (isObject)
+        objects |= 1UL << depth;
+    else
+        objects &= ~(1UL << depth);
+    depth++;
+    p++;
+    return true;
+}
+
+bool JSONReader::readString()
+{
+    const char *s = ++p;
+    while (p < end) {
+        char c = *p;
+        if (c == '"') {
+            text = s;
+            textLen = p - s;
+            p++;
+            return true;
+        }
+        if ((uint8_t)c < 0x20)
+            return false; // Control characters have to be escaped
+        if (c == '\\') {
+            if (end - p < 2)
+                return false;
+            c = p[1];
+            if (c == 'u') {
+                if (end - p < 6)
+                    return false;
+                for (int i = 2; i < 6; i++)
+                    if (hexValue(p[i]) < 0)
+                        return false;
+                p += 6;
+                continue;
+            }
+            if (!c || !strchr("\"\\/bfnrt", c))
+                return false;
+            p += 2;
+            continue;
+        }
+        p++;
+    }
+    return false;
+}
+
+bool JSONReader::readNumber()
+{
+    const char *s = p;
+    if (p < end && *p == '-')
+        p++;
+    if (p == end || !isDigit(*p))
+        return false;
+    if (*p == '0')
+        p++; // No leading zeros
+    else
+        while (p < end && isDigit(*p))
+            p++;
+    if (p < end && *p == '.') {
+        p++;
+        if (p == end || !isDigit(*p))
+            return false;
+        while (p < end && isDigit(*p))
+            p++;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        if (p < end && (*p == '+' || *p == '-'))
+            p++;
+        if (p == end || !isDigit(*p))
+            return false;
+        while (p < end && isDigit(*p))
+            p++;
+    }
+    text = s;
+    textLen = p - s;
+    return true;
+}
+
+bool JSONReader::readLiteral(const char *literal)
+{
+    size_t len = strlen(literal);
+    if ((size_t)(end - p) < len || memcmp(p, literal, len) != 0)
+        return false;
+    p += len;
+    return true;
+}
+
+bool JSONReader::skip()
+{
+    uint8_t until;
+    if (token == JSON_KEY) {
+        Token t = next();
+        if (t != JSON_OBJECT_START && t != JSON_ARRAY_START)
+            return t != JSON_ERROR;
+        until = depth - 1;
+    } else if (token == JSON_OBJECT_START || token == JSON_ARRAY_START) {
+        until = depth - 1;
+    } else {
+        return token != JSON_ERROR;
+    }
+    while (depth > until)
+        if (next() == JSON_ERROR)
+            return false;
+    return true;
+}
+
+size_t JSONReader::decodeChar(const char *&s, char out[4])
+{
+    if (*s != '\\') {
+        out[0] = *s++;
+        return 1;
+    }
+    char c = s[1];
+    s += 2;
+    switch (c) {
+    case 'b':
+        out[0] = '\b';
+        return 1;
+    case 'f':
+        out[0] = '\f';
+        return 1;
+    case 'n':
+        out[0] = '\n';
+        return 1;
+    case 'r':
+        out[0] = '\r';
+        return 1;
+    case 't':
+        out[0] = '\t';
+        return 1;
+    case 'u':
+        break;
+    default:
+        out[0] = c; // " \ and /
+        return 1;
+    }
+
+    uint32_t cp = readHex4(s);
+    s += 4;
+    // A surrogate pair makes up one character, a lone surrogate is kept as it is
+    if (cp >= 0xd800 && cp < 0xdc00 && s[0] == '\\' && s[1] == 'u') {
+        uint32_t low = readHex4(s + 2);
+        if (low >= 0xdc00 && low < 0xe000) {
+            cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+            s += 6;
+        }
+    }
+    if (cp < 0x80) {
+        out[0] = cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = 0xc0 | (cp >> 6);
+        out[1] = 0x80 | (cp & 0x3f);
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = 0xe0 | (cp >> 12);
+        out[1] = 0x80 | ((cp >> 6) & 0x3f);
+        out[2] = 0x80 | (cp & 0x3f);
+        return 3;
+    }
+    out[0] = 0xf0 | (cp >> 18);
+    out[1] = 0x80 | ((cp >> 12) & 0x3f);
+    out[2] = 0x80 | ((cp >> 6) & 0x3f);
+    out[3] = 0x80 | (cp & 0x3f);
+    return 4;
+}
+
+bool JSONReader::equals(const char *str) const
+{
+    if (token != JSON_KEY && token != JSON_STRING)
+        return false;
+    size_t len = strlen(str), at = 0;
+    const char *s = text, *stringEnd = text + textLen;
+    while (s < stringEnd) {
+        char c[4];
+        size_t n = decodeChar(s, c);
+        if (at + n > len || memcmp(str + at, c, n) != 0)
+            return false;
+        at += n;
+    }
+    return at == len;
+}
+
+size_t JSONReader::getString(char *buf, size_t bufSize) const
+{
+    if (token != JSON_KEY && token != JSON_STRING)
+        return 0;
+    size_t len = 0;
+    const char *s = text, *stringEnd = text + textLen;
+    while (s < stringEnd) {
+        char c[4];
+        size_t n = decodeChar(s, c);
+        for (size_t i = 0; i < n; i++, len++)
+            if (len < bufSize)
+                buf[len] = c[i];
+    }
+    return len;
+}
+
+double JSONReader::getNumber() const
+{
+    if (token != JSON_NUMBER)
+        return 0;
+    // Checked by readNumber, so only the parts need picking out
+    const char *s = text, *numberEnd = text + textLen;
+    bool negative = *s == '-';
+    if (negative)
+        s++;
+    double value = 0;
+    while (s < numberEnd && isDigit(*s))
+        value = value * 10 + (*s++ - '0');
+    if (s < numberEnd && *s == '.') {
+        s++;
+        double factor = 0.1;
+        while (s < numberEnd && isDigit(*s)) {
+            value += (*s++ - '0') * factor;
+            factor *= 0.1;
+        }
+    }
+    if (s < numberEnd) {
+        s++; // e or E
+        bool negativeExp = *s == '-';
+        if (*s == '-' || *s == '+')
+            s++;
+        int exp = 0;
+        while (s < numberEnd && isDigit(*s) && exp < 1000)
+            exp = exp * 10 + (*s++ - '0');
+        while (exp--)
+            value = negativeExp ? value / 10 : value * 10;
+    }
+    return negative ? -value : value;
+}
+
+bool JSONReader::isValid(const char *data, size_t length)
+{
+    JSONReader reader(data, length);
+    Token t;
+    do {
+        t = reader.next();
+    } while (t != JSON_END && t != JSON_ERROR);
+    return t == JSON_END;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// How deeply objects and arrays may nest
+#define JSON_READER_MAX_DEPTH 32
+
+/**
+ * A pull parser for JSON that reads the text where it is and never allocates.
+ *
+ * Each next() returns the following token of the document; strings and numbers are only decoded when asked for, so
+ * callers can pick out the fields they want and skip() the rest. Unlike JSON::Parse the text doesn't have to be NUL
+ * terminated, and what isn't valid JSON (per RFC 8259) is an error as soon as it is reached.
+ */
+class JSONReader
+{
+  public:
+    enum Token : uint8_t {
+        JSON_ERROR,
+        JSON_END, // Whole document read
+        JSON_OBJECT_START,
+        JSON_OBJECT_END,
+        JSON_ARRAY_START,
+        JSON_ARRAY_END,
+        JSON_KEY, // Followed by the key's value
+        JSON_STRING,
+        JSON_NUMBER,
+        JSON_TRUE,
+        JSON_FALSE,
+        JSON_NULL,
+    };
+
+    JSONReader(const char *data, size_t length) : p(data), end(data + length) {}
+
+    Token next();
+
+    /**
+     * Skip what the current token starts: the rest of an object or array, or the value of a key. Does nothing for
+     * other tokens.
+     * @return false if the document turned out not to be valid
+     */
+    bool skip();
+
+    /// Whether the current key or string is s
+    bool equals(const char *s) const;
+
+    /**
+     * Copy the current key or string, unescaped, to buf. Copies at most bufSize bytes and doesn't add a terminator.
+     * @return its whole length, more than bufSize if it didn't fit
+     */
+    size_t getString(char *buf, size_t bufSize) const;
+
+    /// The value of the current number
+    double getNumber() const;
+
+    /// How many objects and arrays the current token is inside of
+    uint8_t getDepth() const { return depth; }
+
+    /// Whether data is one JSON value, with nothing but whitespace around it
+    static bool isValid(const char *data, size_t length);
+
+  private:
+    enum Expect : uint8_t { EXPECT_VALUE, EXPECT_VALUE_OR_END, EXPECT_KEY, EXPECT_KEY_OR_END, EXPECT_AFTER_VALUE };
+
+    const char *p, *end;
+    const char *text = nullptr; // Of the current string (without its quotes) or number
+    size_t textLen = 0;
+    Token token = JSON_ERROR;
+    Expect expect = EXPECT_VALUE;
+    bool failed = false;
+    uint8_t depth = 0;
+    uint32_t objects = 0; // A bit per depth, set for objects and clear for arrays
+
+    Token fail();
+    void skipWhitespace();
+    bool inObject() const { return depth && (objects >> (depth - 1)) & 1; }
+    bool open(bool isObject);
+    bool readString();
+    bool readNumber();
+    bool readLiteral(const char *literal);
+
+    /// Decode one character of a string (checked by readString) to UTF-8, advancing s. Returns the number of bytes.
+    static size_t decodeChar(const char *&s, char out[4]);
+};
@@ -0,0 +1,192 @@
+#include "JSONWriter.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+void JSONWriter::flush()
+{
+    if (bufLen) {
+        out.write((const uint8_t *)buf, bufLen);
+        bufLen = 0;
+    }
+}
+
+void JSONWriter::write(const char *s, size_t len)
+{
+    length += len;
+    while (len) {
+        if (bufLen == sizeof(buf))
+            flush();
+        size_t n = sizeof(buf) - bufLen < len ? sizeof(buf) - bufLen : len;
+        memcpy(buf + bufLen, s, n);
+        bufLen += n;
+        s += n;
+        len -= n;
+    }
+}
+
+void JSONWriter::write(const char *s)
+{
+    write(s, strlen(s));
+}
+
+void JSONWriter::write(char c)
+{
+    if (bufLen == sizeof(buf))
+        flush();
+    buf[bufLen++] = c;
+    length++;
+}
+
+void JSONWriter::writeString(const char *s)
+{
+    write('"');
+    // Copy runs of plain characters in one go, escape the rest like JSONValue::StringifyString
+    const char *run = s;
+    for (;; s++) {
+        unsigned char c = *s;
+        const char *escape = nullptr;
+        char hex[7];
+        switch (c) {
+        case '"':
+            escape = "\\\"";
+            break;
+        case '\\':
+            escape = "\\\\";
+            break;
+        case '/':
+            escape = "\\/";
+            break;
+        case '\b':
+            escape = "\\b";
+            break;
+        case '\f':
+            escape = "\\f";
+            break;
+        case '\n':
+            escape = "\\n";
+            break;
+        case '\r':
+            escape = "\\r";
+            break;
+        case '\t':
+            escape = "\\t";
+            break;
+        default:
+            if (c && (c < 0x20 || c == 0x7F)) {
+                snprintf(hex, sizeof(hex), "\\u%04x", c);
+                escape = hex;
+            }
+            break;
+        }
+        if (!c || escape) {
+            write(run, s - run);
+            if (!c)
+                break;
+            write(escape);
+            run = s + 1;
+        }
+    }
+    write('"');
+}
+
+void JSONWriter::startValue(const char *key)
+{
+    if (depth && depth <= JSON_WRITER_MAX_DEPTH) {
+        uint32_t bit = 1UL << (depth - 1);
+        if (hasValues & bit)
+            write(',');
+        hasValues |= bit;
+    }
+    if (key) {
+        writeString(key);
+        write(':');
+    }
+}
+
+void JSONWriter::open(const char *key, char c)
+{
+    startValue(key);
+    write(c);
+    depth++;
+    if (depth <= JSON_WRITER_MAX_DEPTH)
+        hasValues &= ~(1UL << (depth - 1));
+}
+
+void JSONWriter::close(char c)
+{
+    if (depth)
+        depth--;
+    write(c);
+}
+
+void JSONWriter::beginObject(const char *key)
+{
+    open(key, '{');
+}
+
+void JSONWriter::endObject()
+{
+    close('}');
+}
+
+void JSONWriter::beginArray(const char *key)
+{
+    open(key, '[');
+}
+
+void JSONWriter::endArray()
+{
+    close(']');
+}
+
+void JSONWriter::add(const char *key, const char *s)
+{
+    if (!s) {
+        addNull(key);
+        return;
+    }
+    startValue(key);
+    writeString(s);
+}
+
+void JSONWriter::add(const char *key, bool b)
+{
+    startValue(key);
+    write(b ? "true" : "false");
+}
+
+void JSONWriter::add(const char *key, long n)
+{
+    char num[24];
+    snprintf(num, sizeof(num), "%ld", n);
+    startValue(key);
+    write(num);
+}
+
+void JSONWriter::add(const char *key, unsigned long n)
+{
+    char num[24];
+    snprintf(num, sizeof(num), "%lu", n);
+    startValue(key);
+    write(num);
+}
+
+void JSONWriter::add(const char *key, double n)
+{
+    if (isinf(n) || isnan(n)) {
+        addNull(key);
+        return;
+    }
+    char num[32];
+    snprintf(num, sizeof(num), "%.15g", n);
+    startValue(key);
+    write(num);
+}
+
+void JSONWriter::addNull(const char *key)
+{
+    startValue(key);
+    write("null");
+}
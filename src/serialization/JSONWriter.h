@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Print.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// How much output is gathered before it is written out
+#define JSON_WRITER_BUFFER_SIZE 128
+
+/// How deeply objects and arrays may nest
+#define JSON_WRITER_MAX_DEPTH 32
+
+/**
+ * Writes a JSON document straight to a Print (an HTTP response, a serial port...) as it is produced.
+ *
+ * Unlike building a JSONValue tree and calling Stringify() nothing is allocated, so large documents don't need to fit in
+ * the heap all at once. Values are added in order; inside an object each one needs its key, inside an array (or at the
+ * top level) the key is nullptr. Strings are escaped and numbers formatted the same way JSONValue does.
+ */
+class JSONWriter
+{
+  public:
+    explicit JSONWriter(Print &out) : out(out) {}
+    ~JSONWriter() { flush(); }
+
+    void beginObject(const char *key = nullptr);
+    void endObject();
+    void beginArray(const char *key = nullptr);
+    void endArray();
+
+    /// A string, or null if s is nullptr
+    void add(const char *key, const char *s);
+    void add(const char *key, bool b);
+    void add(const char *key, long n);
+    void add(const char *key, unsigned long n);
+    void add(const char *key, int n) { add(key, (long)n); }
+    void add(const char *key, unsigned int n) { add(key, (unsigned long)n); }
+    /// null if n is infinite or NaN, as there is no JSON for those
+    void add(const char *key, double n);
+    void addNull(const char *key);
+
+    /// Write out what is still buffered
+    void flush();
+
+    /// Bytes of JSON produced so far
+    size_t getLength() const { return length; }
+
+  private:
+    Print &out;
+    char buf[JSON_WRITER_BUFFER_SIZE];
+    size_t bufLen = 0;
+    size_t length = 0;
+    uint8_t depth = 0;
+    uint32_t hasValues = 0; // A bit per depth, set once something was written there and the next needs a comma
+
+    void write(const char *s, size_t len);
+    void write(const char *s);
+    void write(char c);
+    void writeString(const char *s);
+    /// Separator and key of the next value
+    void startValue(const char *key);
+    void open(const char *key, char c);
+    void close(char c);
+};
@@ -1,6 +1,7 @@
 #ifndef NRF52_USE_JSON
 #include "MeshPacketSerializer.h"
 #include "JSON.h"
+#include "JSONReader.h"
 #include "NodeDB.h"
 #include "mesh/generated/meshtastic/mqtt.pb.h"
 #include "mesh/generated/meshtastic/telemetry.pb.h"
@@ -31,11 +32,13 @@ std::string MeshPacketSerializer::JsonSerialize(const meshtastic_MeshPacket *mp,
             if (shouldLog)
                 LOG_DEBUG("got text message of size %u", mp->decoded.payload.size);
 
-            char payloadStr[(mp->decoded.payload.size) + 1];
-            memcpy(payloadStr, mp->decoded.payload.bytes, mp->decoded.payload.size);
-            payloadStr[mp->decoded.payload.size] = 0; // null terminated string
-            // check if this is a JSON payload
-            JSONValue *json_value = JSON::Parse(payloadStr);
+            // the text ends at the first NUL, if there is one
+            const char *payloadStr = (const char *)mp->decoded.payload.bytes;
+            size_t payloadLen = strnlen(payloadStr, mp->decoded.payload.size);
+            // check if this is a JSON payload, only building it if it is
+            JSONValue *json_value = NULL;
+            if (JSONReader::isValid(payloadStr, payloadLen))
+                json_value = JSON::Parse(std::string(payloadStr, payloadLen).c_str());
             if (json_value != NULL) {
                 if (shouldLog)
                     LOG_INFO("text message payload is of type json");
@@ -48,7 +51,7 @@ std::string MeshPacketSerializer::JsonSerialize(const meshtastic_MeshPacket *mp,
                 if (shouldLog)
                     LOG_INFO("text message payload is of type plaintext");
 
-                msgPayload["text"] = new JSONValue(payloadStr);
+                msgPayload["text"] = new JSONValue(std::string(payloadStr, payloadLen));
                 jsonObj["payload"] = new JSONValue(msgPayload);
             }
             break;
@@ -0,0 +1,201 @@
+#include "TestUtil.h"
+#include "mesh/AirtimeBudget.h"
+#include <Arduino.h>
+#include <unity.h>
+
+#include <stdio.h>
+
+namespace
+{
+meshtastic_MeshPacket packet(NodeNum from, PacketId id)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    p.from = from;
+    p.id = id;
+    return p;
+}
+
+const AirtimeBudget::PortAirtime *findPort(const AirtimeBudget &budget, meshtastic_PortNum port)
+{
+    for (size_t i = 0; i < budget.getNumPorts(); i++)
+        if (budget.getPortAirtime(i).port == port)
+            return &budget.getPortAirtime(i);
+    return nullptr;
+}
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_classify(void)
+{
+    TEST_ASSERT_EQUAL(AIRTIME_BACKGROUND, AirtimeBudget::classify(meshtastic_MeshPacket_Priority_BACKGROUND, true));
+    TEST_ASSERT_EQUAL(AIRTIME_BACKGROUND, AirtimeBudget::classify(meshtastic_MeshPacket_Priority_MIN, true));
+    TEST_ASSERT_EQUAL(AIRTIME_NORMAL, AirtimeBudget::classify(meshtastic_MeshPacket_Priority_DEFAULT, true));
+    TEST_ASSERT_EQUAL(AIRTIME_NORMAL, AirtimeBudget::classify(meshtastic_MeshPacket_Priority_ALERT, true));
+    TEST_ASSERT_EQUAL(AIRTIME_ESSENTIAL, AirtimeBudget::classify(meshtastic_MeshPacket_Priority_ACK, true));
+    // Relaying for others keeps the mesh working, whatever the packet
+    TEST_ASSERT_EQUAL(AIRTIME_ESSENTIAL, AirtimeBudget::classify(meshtastic_MeshPacket_Priority_BACKGROUND, false));
+}
+
+void test_unlimited(void)
+{
+    AirtimeBudget budget;
+    budget.setRate(100, 0);
+    TEST_ASSERT_FALSE(budget.isLimited());
+    uint32_t waitMs;
+    meshtastic_MeshPacket p = packet(1, 1);
+    for (int i = 0; i < 1000; i++) {
+        TEST_ASSERT_TRUE(budget.mayTransmit(AIRTIME_BACKGROUND, 5000, i, &waitMs));
+        budget.charge(&p, 5000, i);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0, budget.getBalanceMs(1000));
+}
+
+void test_sharesAndWaits(void)
+{
+    // 10%, so 60 s of airtime banked at most
+    AirtimeBudget budget;
+    uint32_t now = 1000;
+    budget.setRate(10, now);
+    TEST_ASSERT_TRUE(budget.isLimited());
+    TEST_ASSERT_EQUAL_FLOAT(60000, budget.getBalanceMs(now));
+
+    meshtastic_MeshPacket p = packet(1, 1);
+    uint32_t waitMs;
+    // Background stops with half the bank left
+    int sent = 0;
+    while (budget.mayTransmit(AIRTIME_BACKGROUND, 1000, now, &waitMs)) {
+        budget.charge(&p, 1000, now);
+        sent++;
+    }
+    TEST_ASSERT_EQUAL(30, sent);
+    TEST_ASSERT_EQUAL_UINT32(10000, waitMs);
+
+    // Others carry on down to their own floor
+    sent = 0;
+    while (budget.mayTransmit(AIRTIME_NORMAL, 1000, now, &waitMs)) {
+        budget.charge(&p, 1000, now);
+        sent++;
+    }
+    TEST_ASSERT_EQUAL(18, sent);
+    sent = 0;
+    while (budget.mayTransmit(AIRTIME_ESSENTIAL, 1000, now, &waitMs)) {
+        budget.charge(&p, 1000, now);
+        sent++;
+    }
+    TEST_ASSERT_EQUAL(12, sent);
+
+    // Earned back at the duty cycle rate
+    TEST_ASSERT_EQUAL_UINT32(10000, waitMs);
+    TEST_ASSERT_FALSE(budget.mayTransmit(AIRTIME_ESSENTIAL, 1000, now + 9999, &waitMs));
+    TEST_ASSERT_TRUE(budget.mayTransmit(AIRTIME_ESSENTIAL, 1000, now + 10000, &waitMs));
+    TEST_ASSERT_FALSE(budget.mayTransmit(AIRTIME_BACKGROUND, 1000, now + 10000, &waitMs));
+
+    // Never more than the bank holds
+    TEST_ASSERT_EQUAL_FLOAT(60000, budget.getBalanceMs(now + 24 * 3600 * 1000));
+
+    // A lower limit shrinks the bank
+    budget.setRate(1, now + 24 * 3600 * 1000);
+    TEST_ASSERT_EQUAL_FLOAT(6000, budget.getBalanceMs(now + 24 * 3600 * 1000));
+}
+
+void test_bigPacket(void)
+{
+    // 1% banks 6 s, a 4 s packet can't leave 3 s for the others so it waits for a full bank
+    AirtimeBudget budget;
+    budget.setRate(1, 0);
+    meshtastic_MeshPacket p = packet(1, 1);
+    uint32_t waitMs;
+    TEST_ASSERT_TRUE(budget.mayTransmit(AIRTIME_BACKGROUND, 4000, 0, &waitMs));
+    budget.charge(&p, 4000, 0);
+    TEST_ASSERT_FALSE(budget.mayTransmit(AIRTIME_BACKGROUND, 4000, 0, &waitMs));
+    TEST_ASSERT_EQUAL_UINT32(400000, waitMs);
+    TEST_ASSERT_TRUE(budget.mayTransmit(AIRTIME_BACKGROUND, 4000, waitMs, &waitMs));
+}
+
+void test_portAccounting(void)
+{
+    AirtimeBudget budget;
+    meshtastic_MeshPacket text = packet(1, 100), telemetry = packet(1, 101), relayed = packet(2, 100);
+    budget.notePort(&text, meshtastic_PortNum_TEXT_MESSAGE_APP);
+    budget.notePort(&telemetry, meshtastic_PortNum_TELEMETRY_APP);
+    budget.notePort(&relayed, meshtastic_PortNum_UNKNOWN_APP);
+    budget.charge(&text, 300, 0);
+    budget.charge(&telemetry, 200, 0);
+    budget.charge(&relayed, 400, 0);
+
+    // A retransmission is already encrypted, but still counts for its port
+    budget.notePort(&text, meshtastic_PortNum_UNKNOWN_APP);
+    budget.charge(&text, 300, 0);
+
+    TEST_ASSERT_EQUAL(3, budget.getNumPorts());
+    TEST_ASSERT_EQUAL_UINT32(2, findPort(budget, meshtastic_PortNum_TEXT_MESSAGE_APP)->packets);
+    TEST_ASSERT_EQUAL_UINT32(600, (uint32_t)findPort(budget, meshtastic_PortNum_TEXT_MESSAGE_APP)->airtimeMs);
+    TEST_ASSERT_EQUAL_UINT32(200, (uint32_t)findPort(budget, meshtastic_PortNum_TELEMETRY_APP)->airtimeMs);
+    TEST_ASSERT_EQUAL_UINT32(400, (uint32_t)findPort(budget, meshtastic_PortNum_UNKNOWN_APP)->airtimeMs);
+
+    // Ports past the table share its last slot
+    for (int port = 200; port < 230; port++) {
+        meshtastic_MeshPacket p = packet(1, port);
+        budget.notePort(&p, (meshtastic_PortNum)port);
+        budget.charge(&p, 10, 0);
+    }
+    TEST_ASSERT_EQUAL(AIRTIME_BUDGET_MAX_PORTS, budget.getNumPorts());
+    const AirtimeBudget::PortAirtime *other = findPort(budget, meshtastic_PortNum_MAX);
+    TEST_ASSERT_NOT_NULL(other);
+    TEST_ASSERT_EQUAL_UINT32(30 - (AIRTIME_BUDGET_MAX_PORTS - 4), other->packets);
+}
+
+void test_simulatedHour(void)
+{
+    // A node in a 10% region that wants to send a 1 s telemetry packet every 5 s, and must relay a 500 ms packet every
+    // 20 s. Without the budget it would run out of airtime and go silent, relays included.
+    AirtimeBudget budget;
+    budget.setRate(10, 0);
+    meshtastic_MeshPacket p = packet(1, 1);
+    uint32_t waitMs;
+    uint32_t telemetrySent = 0, telemetryDeferred = 0, relaysSent = 0, relaysDeferred = 0, totalMs = 0;
+    for (uint32_t now = 0; now < 3600 * 1000; now += 5000) {
+        if (budget.mayTransmit(AIRTIME_BACKGROUND, 1000, now, &waitMs)) {
+            budget.charge(&p, 1000, now);
+            telemetrySent++;
+            totalMs += 1000;
+        } else {
+            telemetryDeferred++;
+        }
+        if (now % 20000 == 0) {
+            if (budget.mayTransmit(AIRTIME_ESSENTIAL, 500, now, &waitMs)) {
+                budget.charge(&p, 500, now);
+                relaysSent++;
+                totalMs += 500;
+            } else {
+                relaysDeferred++;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, relaysDeferred);
+    TEST_ASSERT_EQUAL_UINT32(180, relaysSent);
+    // Everything sent fits in the hour's allowance plus what was banked at the start
+    TEST_ASSERT_TRUE(totalMs <= 360000 + 60000);
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "1 h at 10%%: %u telemetry sent, %u deferred, %u relays sent, %u ms airtime",
+             (unsigned)telemetrySent, (unsigned)telemetryDeferred, (unsigned)relaysSent, (unsigned)totalMs);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_classify);
+    RUN_TEST(test_unlimited);
+    RUN_TEST(test_sharesAndWaits);
+    RUN_TEST(test_bigPacket);
+    RUN_TEST(test_portAccounting);
+    RUN_TEST(test_simulatedHour);
+    exit(UNITY_END());
+}
+
+void loop() {}
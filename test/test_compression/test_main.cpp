@@ -0,0 +1,165 @@
+#include "TestUtil.h"
+#include "mesh/compression/dictcomp.h"
+#include "mesh/compression/unishox2.h"
+#include <Arduino.h>
+#include <unity.h>
+
+#include <string.h>
+
+// A mix of what we send: chat text, plus encoded NodeInfo User and Telemetry payloads. None of them are in
+// bin/compression-corpus.txt, so the benchmark measures payloads the dictionary wasn't trained on.
+static const char *texts[] = {
+    "Anybody up near the reservoir this evening?",
+    "Got it, reading you five by five",
+    "Leaving the office, home in about half an hour",
+    "Did the node on the water tower come back up?",
+    "Loud and clear from the east ridge",
+    "Lunch at the diner after the swap meet?",
+    "ok",
+    "The quick brown fox jumps over the lazy dog",
+};
+
+// User{id: "!a1b2c3d4", long_name: "Meshtastic c3d4", short_name: "c3d4", hw_model: 43}
+static const uint8_t nodeinfo[] = {0x0a, 0x09, 0x21, 0x61, 0x31, 0x62, 0x32, 0x63, 0x33, 0x64, 0x34, 0x12, 0x0f, 0x4d, 0x65,
+                                   0x73, 0x68, 0x74, 0x61, 0x73, 0x74, 0x69, 0x63, 0x20, 0x63, 0x33, 0x64, 0x34, 0x1a, 0x04,
+                                   0x63, 0x33, 0x64, 0x34, 0x28, 0x2b};
+
+// Telemetry{time, device_metrics{battery_level: 87, voltage: 4.05, channel_utilization: 12.5, air_util_tx: 1.2, uptime}}
+static const uint8_t telemetry[] = {0x0d, 0x80, 0x1c, 0x6c, 0x67, 0x12, 0x16, 0x08, 0x57, 0x15, 0x9a, 0x99, 0x81,
+                                    0x40, 0x1d, 0x00, 0x00, 0x48, 0x41, 0x25, 0x9a, 0x99, 0x99, 0x3f, 0x28, 0xe0, 0xd4,
+                                    0x03};
+
+static void assertRoundTrip(const uint8_t *in, size_t len)
+{
+    uint8_t compressed[DICTCOMP_MAX_INPUT * 2];
+    uint8_t plain[DICTCOMP_MAX_INPUT];
+
+    int clen = dictcomp_compress(in, len, compressed, sizeof(compressed));
+    TEST_ASSERT_GREATER_THAN(0, clen);
+    int plen = dictcomp_decompress(compressed, clen, plain, sizeof(plain));
+    TEST_ASSERT_EQUAL(len, plen);
+    TEST_ASSERT_EQUAL_MEMORY(in, plain, len);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_roundTripSamples(void)
+{
+    for (const char *t : texts)
+        assertRoundTrip((const uint8_t *)t, strlen(t));
+    assertRoundTrip(nodeinfo, sizeof(nodeinfo));
+    assertRoundTrip(telemetry, sizeof(telemetry));
+}
+
+void test_roundTripRandom(void)
+{
+    uint8_t in[DICTCOMP_MAX_INPUT];
+    randomSeed(42);
+    for (int iter = 0; iter < 2000; iter++) {
+        size_t len = random(DICTCOMP_MAX_INPUT + 1);
+        // Alternate between incompressible noise and repetitive text
+        for (size_t i = 0; i < len; i++)
+            in[i] = (iter & 1) ? random(256) : "the mesh "[random(9)];
+        assertRoundTrip(in, len);
+    }
+}
+
+void test_compressesCommonPayloads(void)
+{
+    uint8_t compressed[DICTCOMP_MAX_INPUT];
+    const char *hello = texts[0];
+    TEST_ASSERT_LESS_THAN(strlen(hello),
+                          dictcomp_compress((const uint8_t *)hello, strlen(hello), compressed, sizeof(compressed)));
+    TEST_ASSERT_LESS_THAN(sizeof(nodeinfo), dictcomp_compress(nodeinfo, sizeof(nodeinfo), compressed, sizeof(compressed)));
+}
+
+void test_rejectsBadInput(void)
+{
+    uint8_t compressed[DICTCOMP_MAX_INPUT];
+    uint8_t plain[DICTCOMP_MAX_INPUT];
+    const char *hello = texts[0];
+    int clen = dictcomp_compress((const uint8_t *)hello, strlen(hello), compressed, sizeof(compressed));
+
+    // Too long to compress, or too small an output buffer
+    uint8_t big[DICTCOMP_MAX_INPUT + 1] = {0};
+    TEST_ASSERT_EQUAL(-1, dictcomp_compress(big, sizeof(big), compressed, sizeof(compressed)));
+    TEST_ASSERT_EQUAL(-1, dictcomp_decompress(compressed, clen, plain, strlen(hello) - 1));
+
+    // Truncated stream
+    TEST_ASSERT_EQUAL(-1, dictcomp_decompress(compressed, 0, plain, sizeof(plain)));
+
+    // Unknown dictionary
+    compressed[0] = dictcomp_dict_id + 1;
+    TEST_ASSERT_EQUAL(-1, dictcomp_decompress(compressed, clen, plain, sizeof(plain)));
+
+    // Random garbage must never read or write out of bounds
+    randomSeed(7);
+    for (int iter = 0; iter < 5000; iter++) {
+        size_t len = random(sizeof(compressed));
+        for (size_t i = 0; i < len; i++)
+            compressed[i] = random(256);
+        compressed[0] = dictcomp_dict_id;
+        TEST_ASSERT_LESS_OR_EQUAL(sizeof(plain), dictcomp_decompress(compressed, len, plain, sizeof(plain)));
+    }
+}
+
+// Not a pass/fail test: reports ratio and speed against the Unishox2 codec we already ship
+void test_benchmarkAgainstUnishox2(void)
+{
+    const int rounds = 200;
+    char out[DICTCOMP_MAX_INPUT * 2];
+    char back[DICTCOMP_MAX_INPUT * 2];
+    size_t plainBytes = 0, dictBytes = 0, unishoxBytes = 0;
+
+    for (const char *t : texts) {
+        size_t len = strlen(t);
+        plainBytes += len;
+        dictBytes += dictcomp_compress((const uint8_t *)t, len, (uint8_t *)out, sizeof(out));
+        unishoxBytes += unishox2_compress_simple(t, len, out);
+    }
+
+    uint32_t start = micros();
+    for (int r = 0; r < rounds; r++) {
+        for (const char *t : texts) {
+            int clen = dictcomp_compress((const uint8_t *)t, strlen(t), (uint8_t *)out, sizeof(out));
+            dictcomp_decompress((const uint8_t *)out, clen, (uint8_t *)back, sizeof(back));
+        }
+    }
+    uint32_t dictUs = micros() - start;
+
+    start = micros();
+    for (int r = 0; r < rounds; r++) {
+        for (const char *t : texts) {
+            int clen = unishox2_compress_simple(t, strlen(t), out);
+            unishox2_decompress_simple(out, clen, back);
+        }
+    }
+    uint32_t unishoxUs = micros() - start;
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "text: %u bytes -> dictcomp %u (%u us), unishox2 %u (%u us) for %d round trips",
+             (unsigned)plainBytes, (unsigned)dictBytes, dictUs, (unsigned)unishoxBytes, unishoxUs, rounds);
+    TEST_MESSAGE(msg);
+
+    // Unishox2 only handles text, so binary payloads are dictcomp or nothing
+    int userLen = dictcomp_compress(nodeinfo, sizeof(nodeinfo), (uint8_t *)out, sizeof(out));
+    int telemetryLen = dictcomp_compress(telemetry, sizeof(telemetry), (uint8_t *)out, sizeof(out));
+    snprintf(msg, sizeof(msg), "nodeinfo: %u -> %d bytes, telemetry: %u -> %d bytes", (unsigned)sizeof(nodeinfo),
+             userLen, (unsigned)sizeof(telemetry), telemetryLen);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_roundTripSamples);
+    RUN_TEST(test_roundTripRandom);
+    RUN_TEST(test_compressesCommonPayloads);
+    RUN_TEST(test_rejectsBadInput);
+    RUN_TEST(test_benchmarkAgainstUnishox2);
+    exit(UNITY_END());
+}
+
+void loop() {}
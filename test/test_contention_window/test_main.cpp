@@ -0,0 +1,123 @@
+#include "TestUtil.h"
+#include "mesh/ContentionWindow.h"
+#include <unity.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_roleBounds(void)
+{
+    ContentionWindow cw;
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MIN, cw.getCWsize(0, 0));
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MAX, cw.getCWsize(100, 0));
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MAX, cw.getCWsize(250, 0));
+
+    cw.setRole(meshtastic_Config_DeviceConfig_Role_ROUTER);
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MIN, cw.getCWsize(0, 0));
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MAX - 1, cw.getCWsize(100, 0));
+
+    cw.setRole(meshtastic_Config_DeviceConfig_Role_TRACKER);
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MIN + 1, cw.getCWsize(0, 0));
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MAX, cw.getCWsize(100, 0));
+
+    // Far away senders get the small windows
+    cw.setRole(meshtastic_Config_DeviceConfig_Role_CLIENT);
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MIN, cw.getCWsizeForSnr(-20, 0));
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MAX, cw.getCWsizeForSnr(10, 0));
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MIN, cw.getCWsizeForSnr(-30, 0));
+}
+
+void test_backoff(void)
+{
+    ContentionWindow cw;
+    uint32_t now = 1000;
+
+    // Doubles on each packet put off by a busy channel, lost packet or retransmission, up to the bound
+    cw.noteChannelBusy(1, now);
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MIN + 1, cw.getCWsize(0, now));
+    cw.noteChannelBusy(1, now);
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MIN + 1, cw.getCWsize(0, now));
+    cw.noteCollision(now);
+    cw.noteRetransmission(now);
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MIN + 3, cw.getCWsize(0, now));
+    for (int i = 0; i < 10; i++)
+        cw.noteChannelBusy(2 + i, now);
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MAX - CONTENTION_CW_MIN, cw.getBackoff());
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MAX, cw.getCWsize(0, now));
+    // Relays go by SNR alone
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MIN, cw.getCWsizeForSnr(-20, now));
+
+    // Shrinks a step per run of clear channels, and a busy one starts the run over
+    for (int i = 0; i < CONTENTION_IDLE_TO_SHRINK - 1; i++)
+        cw.noteChannelIdle(now);
+    cw.noteChannelBusy(11, now);
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MAX - CONTENTION_CW_MIN, cw.getBackoff());
+    for (int i = 0; i < CONTENTION_IDLE_TO_SHRINK; i++)
+        cw.noteChannelIdle(now);
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MAX - CONTENTION_CW_MIN - 1, cw.getBackoff());
+
+    // And with time
+    cw.getCWsize(0, now + 2 * CONTENTION_DECAY_MSEC);
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MAX - CONTENTION_CW_MIN - 3, cw.getBackoff());
+    cw.getCWsize(0, now + 60 * CONTENTION_DECAY_MSEC);
+    TEST_ASSERT_EQUAL(0, cw.getBackoff());
+
+    // Backoff adds to what utilization asks for
+    cw.noteChannelBusy(12, now);
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MIN + 3, cw.getCWsize(40, now));
+
+    // A router may not back off past its smaller bound
+    for (int i = 0; i < 10; i++)
+        cw.noteChannelBusy(13 + i, now);
+    cw.setRole(meshtastic_Config_DeviceConfig_Role_ROUTER);
+    TEST_ASSERT_EQUAL(CONTENTION_CW_MAX - 1 - CONTENTION_CW_MIN, cw.getBackoff());
+}
+
+void test_relayOrder(void)
+{
+    // However far they have backed off, routers relay within the time clients wait before they start
+    ContentionWindow router, client;
+    router.setRole(meshtastic_Config_DeviceConfig_Role_ROUTER);
+    router.seed(1);
+    client.seed(2);
+    for (int i = 0; i < 10; i++) {
+        router.noteChannelBusy(i, 0);
+        client.noteChannelBusy(i, 0);
+    }
+    for (int i = 0; i < 1000; i++) {
+        float snr = -25 + i % 40;
+        TEST_ASSERT_LESS_THAN(2 * CONTENTION_CW_MAX, router.getTxDelaySlotsWeighted(snr, 0));
+        uint32_t slots = client.getTxDelaySlotsWeighted(snr, 0);
+        TEST_ASSERT_GREATER_OR_EQUAL(2 * CONTENTION_CW_MAX, slots);
+        TEST_ASSERT_LESS_THAN(client.getTxDelaySlotsWeightedWorst(snr, 0), slots);
+    }
+}
+
+void test_randomBelow(void)
+{
+    ContentionWindow cw;
+    cw.seed(12345);
+    uint32_t counts[8] = {0};
+    for (int i = 0; i < 8000; i++) {
+        uint32_t r = cw.randomBelow(8);
+        TEST_ASSERT_LESS_THAN(8, r);
+        counts[r]++;
+    }
+    for (uint32_t c : counts)
+        TEST_ASSERT_UINT32_WITHIN(200, 1000, c);
+    TEST_ASSERT_EQUAL(0, cw.randomBelow(0));
+    TEST_ASSERT_EQUAL(0, cw.randomBelow(1));
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_roleBounds);
+    RUN_TEST(test_backoff);
+    RUN_TEST(test_relayOrder);
+    RUN_TEST(test_randomBelow);
+    exit(UNITY_END());
+}
+
+void loop() {}
@@ -4,6 +4,12 @@
 #include "TestUtil.h"
 #include <unity.h>
 
+#ifdef ARCH_PORTDUINO
+#include <atomic>
+#include <thread>
+#include <vector>
+#endif
+
 void HexToBytes(uint8_t *result, const std::string hex, size_t len = 0)
 {
     if (len) {
@@ -178,6 +184,95 @@ void test_AES_CTR(void)
     TEST_ASSERT_EQUAL_MEMORY(expected, plain, 16);
 }
 
+void test_cryptPacket(void)
+{
+    // Same as the old API, without touching the engine's own key
+    CryptoKey k;
+    k.length = 16;
+    HexToBytes(k.bytes, "AE6852F8121067CC4BF7A5765577F39E");
+    uint8_t plain[40], expected[40];
+    for (size_t i = 0; i < sizeof(plain); i++)
+        plain[i] = i;
+    memcpy(expected, plain, sizeof(plain));
+    crypto->setKey(k);
+    crypto->encryptPacket(0x1234, 0x5678, sizeof(expected), expected);
+
+    CryptoContext ctx;
+    ctx.key = k;
+    TEST_ASSERT_TRUE(crypto->cryptPacket(ctx, 0x1234, 0x5678, plain, sizeof(plain)));
+    TEST_ASSERT_EQUAL_MEMORY(expected, ctx.scratch, sizeof(plain));
+
+    // and back
+    memcpy(plain, ctx.scratch, sizeof(plain));
+    TEST_ASSERT_TRUE(crypto->cryptPacket(ctx, 0x1234, 0x5678, plain, sizeof(plain)));
+    TEST_ASSERT_EQUAL(0, ctx.scratch[0]);
+    TEST_ASSERT_EQUAL(39, ctx.scratch[39]);
+
+    // No key means no encryption
+    ctx.key.length = 0;
+    TEST_ASSERT_TRUE(crypto->cryptPacket(ctx, 0x1234, 0x5678, plain, sizeof(plain)));
+    TEST_ASSERT_EQUAL_MEMORY(plain, ctx.scratch, sizeof(plain));
+
+    uint8_t tooBig[MAX_BLOCKSIZE + 1] = {0};
+    TEST_ASSERT_FALSE(crypto->cryptPacket(ctx, 0x1234, 0x5678, tooBig, sizeof(tooBig)));
+}
+
+#ifdef ARCH_PORTDUINO
+// Several threads decrypting at once, each with its own context. Build with -fsanitize=thread (env:native-tsan) to
+// have any data race reported.
+void test_parallelContexts(void)
+{
+    const int numThreads = 4, numPackets = 2000;
+    CryptoKey keys[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        keys[t].length = t % 2 ? 16 : 32;
+        for (int i = 0; i < keys[t].length; i++)
+            keys[t].bytes[i] = t * 31 + i;
+    }
+
+    // What each packet should encrypt to, worked out one at a time with the old API
+    std::vector<std::vector<uint8_t>> expected(numThreads * numPackets);
+    for (int t = 0; t < numThreads; t++) {
+        crypto->setKey(keys[t]);
+        for (int n = 0; n < numPackets; n++) {
+            std::vector<uint8_t> &e = expected[t * numPackets + n];
+            e.resize(1 + n % MAX_BLOCKSIZE);
+            for (size_t i = 0; i < e.size(); i++)
+                e[i] = n + i;
+            crypto->encryptPacket(t, n, e.size(), e.data());
+        }
+    }
+
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t] {
+            CryptoContext ctx;
+            ctx.key = keys[t];
+            uint8_t plain[MAX_BLOCKSIZE];
+            for (int n = 0; n < numPackets; n++) {
+                const std::vector<uint8_t> &e = expected[t * numPackets + n];
+                if (!crypto->cryptPacket(ctx, t, n, e.data(), e.size()))
+                    failures++;
+                memcpy(plain, ctx.scratch, e.size());
+                for (size_t i = 0; i < e.size(); i++)
+                    if (plain[i] != (uint8_t)(n + i)) {
+                        failures++;
+                        break;
+                    }
+                // and encrypting again gives what the old API did
+                crypto->cryptPacket(ctx, t, n, plain, e.size());
+                if (memcmp(ctx.scratch, e.data(), e.size()) != 0)
+                    failures++;
+            }
+        });
+    }
+    for (std::thread &t : threads)
+        t.join();
+    TEST_ASSERT_EQUAL(0, failures.load());
+}
+#endif
+
 void setup()
 {
     // NOTE!!! Wait for >2 secs
@@ -192,6 +287,10 @@ void setup()
     RUN_TEST(test_DH25519);
     RUN_TEST(test_AES_CTR);
     RUN_TEST(test_PKC);
+    RUN_TEST(test_cryptPacket);
+#ifdef ARCH_PORTDUINO
+    RUN_TEST(test_parallelContexts);
+#endif
     exit(UNITY_END()); // stop unit testing
 }
 
@@ -0,0 +1,244 @@
+#include "TestUtil.h"
+#include "mesh/FromRadioRing.h"
+#include "mesh/mesh-pb-constants.h"
+#include <Arduino.h>
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+meshtastic_MeshPacket packet(PacketId id, size_t payloadLen)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_zero;
+    p.from = 0x1234;
+    p.to = 0x5600 + id;
+    p.id = id;
+    p.which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    p.decoded.portnum = meshtastic_PortNum_TEXT_MESSAGE_APP;
+    p.decoded.payload.size = payloadLen;
+    memset(p.decoded.payload.bytes, 'a' + id % 26, payloadLen);
+    return p;
+}
+
+/// Read the next packet for cursor, returns its id or 0 if there is none
+PacketId readId(FromRadioRing &ring, FromRadioRing::Cursor &cursor)
+{
+    uint8_t buf[meshtastic_FromRadio_size];
+    size_t len = ring.read(cursor, buf);
+    if (!len)
+        return 0;
+    meshtastic_FromRadio fromRadio = meshtastic_FromRadio_init_zero;
+    TEST_ASSERT_TRUE(pb_decode_from_bytes(buf, len, &meshtastic_FromRadio_msg, &fromRadio));
+    TEST_ASSERT_EQUAL(meshtastic_FromRadio_packet_tag, fromRadio.which_payload_variant);
+    TEST_ASSERT_EQUAL_UINT32(0x5600 + fromRadio.packet.id, fromRadio.packet.to);
+    return fromRadio.packet.id;
+}
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_sameBytesAsFromRadio(void)
+{
+    FromRadioRing ring(4, 4096);
+    FromRadioRing::Cursor cursor;
+    ring.subscribe(cursor);
+    const size_t payloadLens[] = {0, 10, 100, meshtastic_Constants_DATA_PAYLOAD_LEN};
+    for (size_t payloadLen : payloadLens) {
+        meshtastic_MeshPacket p = packet(1, payloadLen);
+        meshtastic_FromRadio fromRadio = meshtastic_FromRadio_init_zero;
+        fromRadio.which_payload_variant = meshtastic_FromRadio_packet_tag;
+        fromRadio.packet = p;
+        uint8_t expected[meshtastic_FromRadio_size];
+        size_t expectedLen = pb_encode_to_bytes(expected, sizeof(expected), &meshtastic_FromRadio_msg, &fromRadio);
+
+        TEST_ASSERT_TRUE(ring.push(p, false));
+        uint8_t buf[meshtastic_FromRadio_size];
+        TEST_ASSERT_EQUAL(expectedLen, ring.read(cursor, buf));
+        TEST_ASSERT_EQUAL_MEMORY(expected, buf, expectedLen);
+    }
+}
+
+void test_everyClientGetsEveryPacket(void)
+{
+    FromRadioRing ring(8, 4096);
+    FromRadioRing::Cursor ble, serial;
+    ring.subscribe(ble);
+    ring.subscribe(serial);
+    for (PacketId id = 1; id <= 5; id++)
+        TEST_ASSERT_TRUE(ring.push(packet(id, 20), false));
+
+    for (PacketId id = 1; id <= 5; id++)
+        TEST_ASSERT_EQUAL_UINT32(id, readId(ring, ble));
+    TEST_ASSERT_FALSE(ring.available(ble));
+    // Still there for the slower client
+    TEST_ASSERT_EQUAL(5, ring.numQueued());
+    TEST_ASSERT_EQUAL_UINT32(0x5603, ring.findTo(3));
+    for (PacketId id = 1; id <= 5; id++)
+        TEST_ASSERT_EQUAL_UINT32(id, readId(ring, serial));
+    TEST_ASSERT_EQUAL(0, ring.numQueued());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.findTo(3));
+
+    // A client that leaves doesn't hold packets back
+    TEST_ASSERT_TRUE(ring.push(packet(6, 20), false));
+    TEST_ASSERT_EQUAL(1, ring.numQueued());
+    ring.unsubscribe(serial);
+    TEST_ASSERT_EQUAL_UINT32(6, readId(ring, ble));
+    TEST_ASSERT_EQUAL(0, ring.numQueued());
+}
+
+void test_keptUntilSomeoneConnects(void)
+{
+    FromRadioRing ring(8, 4096);
+    for (PacketId id = 1; id <= 3; id++)
+        TEST_ASSERT_TRUE(ring.push(packet(id, 20), false));
+    TEST_ASSERT_EQUAL(3, ring.numQueued());
+
+    FromRadioRing::Cursor first;
+    ring.subscribe(first);
+    TEST_ASSERT_EQUAL_UINT32(1, readId(ring, first));
+    TEST_ASSERT_EQUAL_UINT32(2, readId(ring, first));
+
+    // A later client starts where nobody has read yet
+    FromRadioRing::Cursor second;
+    ring.subscribe(second);
+    TEST_ASSERT_EQUAL_UINT32(3, readId(ring, second));
+    TEST_ASSERT_EQUAL(0, readId(ring, second));
+    TEST_ASSERT_EQUAL_UINT32(3, readId(ring, first));
+    TEST_ASSERT_EQUAL(0, ring.numQueued());
+}
+
+void test_full(void)
+{
+    FromRadioRing ring(4, 4096);
+    FromRadioRing::Cursor slow, fast;
+    ring.subscribe(slow);
+    ring.subscribe(fast);
+    for (PacketId id = 1; id <= 4; id++)
+        TEST_ASSERT_TRUE(ring.push(packet(id, 20), false));
+    for (PacketId id = 1; id <= 4; id++)
+        TEST_ASSERT_EQUAL_UINT32(id, readId(ring, fast));
+
+    // The slow client loses the oldest, the fast one already has it
+    TEST_ASSERT_TRUE(ring.push(packet(5, 20), false));
+    TEST_ASSERT_TRUE(ring.push(packet(6, 20), true));
+    TEST_ASSERT_EQUAL_UINT32(3, readId(ring, slow));
+    TEST_ASSERT_EQUAL_UINT32(5, readId(ring, fast));
+    TEST_ASSERT_EQUAL_UINT32(6, readId(ring, fast));
+
+    // Once nobody has read the oldest, only packets that may evict get in
+    for (PacketId id = 4; id <= 6; id++)
+        TEST_ASSERT_EQUAL_UINT32(id, readId(ring, slow));
+    for (PacketId id = 7; id <= 10; id++)
+        TEST_ASSERT_TRUE(ring.push(packet(id, 20), false));
+    TEST_ASSERT_FALSE(ring.push(packet(11, 20), false));
+    TEST_ASSERT_TRUE(ring.push(packet(12, 20), true));
+    TEST_ASSERT_EQUAL_UINT32(8, readId(ring, slow));
+    TEST_ASSERT_EQUAL_UINT32(8, readId(ring, fast));
+
+    // Out of bytes before slots
+    FromRadioRing small(16, 600);
+    FromRadioRing::Cursor cursor;
+    small.subscribe(cursor);
+    TEST_ASSERT_TRUE(small.push(packet(1, 200), false));
+    TEST_ASSERT_TRUE(small.push(packet(2, 200), false));
+    TEST_ASSERT_FALSE(small.push(packet(3, 200), false));
+    TEST_ASSERT_TRUE(small.push(packet(4, 200), true));
+    TEST_ASSERT_EQUAL_UINT32(2, readId(small, cursor));
+    TEST_ASSERT_EQUAL_UINT32(4, readId(small, cursor));
+}
+
+void test_stalledClient(void)
+{
+    // A client that stopped reading, such as a backgrounded app, doesn't keep the others from getting packets
+    FromRadioRing ring(4, 4096);
+    FromRadioRing::Cursor stalled, live;
+    ring.subscribe(stalled);
+    ring.subscribe(live);
+    for (PacketId id = 1; id <= 20; id++) {
+        TEST_ASSERT_TRUE(ring.push(packet(id, 20), false));
+        TEST_ASSERT_EQUAL_UINT32(id, readId(ring, live));
+    }
+    TEST_ASSERT_EQUAL(4, ring.numQueued());
+
+    // It gets whatever is still held when it comes back
+    for (PacketId id = 17; id <= 20; id++)
+        TEST_ASSERT_EQUAL_UINT32(id, readId(ring, stalled));
+    TEST_ASSERT_EQUAL(0, ring.numQueued());
+}
+
+void test_wrapsAround(void)
+{
+    // Sizes that don't divide the ring, so packets end up split across its end
+    FromRadioRing ring(8, 1000);
+    FromRadioRing::Cursor a, b;
+    ring.subscribe(a);
+    ring.subscribe(b);
+    PacketId nextA = 1, nextB = 1;
+    for (PacketId id = 1; id <= 500; id++) {
+        TEST_ASSERT_TRUE(ring.push(packet(id, (id * 37) % 200), false));
+        TEST_ASSERT_EQUAL_UINT32(nextA++, readId(ring, a));
+        if (id % 3 == 0) {
+            while (nextB <= id)
+                TEST_ASSERT_EQUAL_UINT32(nextB++, readId(ring, b));
+        }
+    }
+    while (nextB <= 500)
+        TEST_ASSERT_EQUAL_UINT32(nextB++, readId(ring, b));
+    TEST_ASSERT_EQUAL(0, ring.numQueued());
+}
+
+void test_benchmarkClients(void)
+{
+    // Three clients attached: encoding each packet once and copying it, against each client encoding its own
+    const int numPackets = 1000, numClients = 3;
+    FromRadioRing ring(32, 32 * FROM_RADIO_RING_BYTES_PER_PACKET);
+    FromRadioRing::Cursor cursors[numClients];
+    for (FromRadioRing::Cursor &c : cursors)
+        ring.subscribe(c);
+    uint8_t buf[meshtastic_FromRadio_size];
+
+    uint32_t start = micros();
+    for (int i = 0; i < numPackets; i++) {
+        ring.push(packet(i + 1, 100), false);
+        for (FromRadioRing::Cursor &c : cursors)
+            TEST_ASSERT_TRUE(ring.read(c, buf) > 0);
+    }
+    uint32_t sharedUs = micros() - start;
+
+    static meshtastic_FromRadio fromRadio;
+    start = micros();
+    for (int i = 0; i < numPackets; i++) {
+        meshtastic_MeshPacket p = packet(i + 1, 100);
+        for (int c = 0; c < numClients; c++) {
+            fromRadio = meshtastic_FromRadio_init_zero;
+            fromRadio.which_payload_variant = meshtastic_FromRadio_packet_tag;
+            fromRadio.packet = p;
+            TEST_ASSERT_TRUE(pb_encode_to_bytes(buf, sizeof(buf), &meshtastic_FromRadio_msg, &fromRadio) > 0);
+        }
+    }
+    uint32_t perClientUs = micros() - start;
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%d packets to %d clients: %u us shared, %u us encoded per client", numPackets, numClients,
+             (unsigned)sharedUs, (unsigned)perClientUs);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_sameBytesAsFromRadio);
+    RUN_TEST(test_everyClientGetsEveryPacket);
+    RUN_TEST(test_keptUntilSomeoneConnects);
+    RUN_TEST(test_full);
+    RUN_TEST(test_stalledClient);
+    RUN_TEST(test_wrapsAround);
+    RUN_TEST(test_benchmarkClients);
+    exit(UNITY_END());
+}
+
+void loop() {}
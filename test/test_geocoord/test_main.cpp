@@ -0,0 +1,209 @@
+#include "TestUtil.h"
+#include "gps/GeoCoord.h"
+#include <Arduino.h>
+#include <unity.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace
+{
+// Random points within maxDegrees of (lat, lon), as 1e-7 degree integers
+void scatter(int32_t lat, int32_t lon, double maxDegrees, size_t count, std::vector<int32_t> &lats, std::vector<int32_t> &lons)
+{
+    lats.resize(count);
+    lons.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        double dLat = (random(2000001) - 1000000) / 1e6 * maxDegrees;
+        double dLon = (random(2000001) - 1000000) / 1e6 * maxDegrees;
+        double pLat = lat * 1e-7 + dLat;
+        double pLon = lon * 1e-7 + dLon;
+        pLat = pLat > 89.9 ? 89.9 : (pLat < -89.9 ? -89.9 : pLat);
+        pLon = pLon > 180 ? pLon - 360 : (pLon < -180 ? pLon + 360 : pLon);
+        lats[i] = (int32_t)(pLat * 1e7);
+        lons[i] = (int32_t)(pLon * 1e7);
+    }
+}
+
+float angleDiff(float a, float b)
+{
+    float d = fmodf(fabsf(a - b), 2 * PI);
+    return d > PI ? 2 * PI - d : d;
+}
+
+struct Errors {
+    float distance = 0; // Worst relative error
+    float bearing = 0;  // Worst bearing error in degrees, for points more than 10 m away
+};
+
+Errors compare(int32_t lat, int32_t lon, const std::vector<int32_t> &lats, const std::vector<int32_t> &lons)
+{
+    size_t n = lats.size();
+    std::vector<float> meters(n), bearings(n);
+    GeoObserver(lat, lon).distanceAndBearing(lats.data(), lons.data(), n, meters.data(), bearings.data());
+
+    Errors e;
+    for (size_t i = 0; i < n; i++) {
+        double lat1 = lat * 1e-7, lon1 = lon * 1e-7, lat2 = lats[i] * 1e-7, lon2 = lons[i] * 1e-7;
+        float d = GeoCoord::latLongToMeter(lat1, lon1, lat2, lon2);
+        float b = GeoCoord::bearing(lat1, lon1, lat2, lon2);
+        if (d > 10) {
+            e.distance = fmaxf(e.distance, fabsf(meters[i] - d) / d);
+            e.bearing = fmaxf(e.bearing, angleDiff(bearings[i], b) * 180 / PI);
+        }
+    }
+    return e;
+}
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_fastAtan2(void)
+{
+    float worst = 0;
+    for (int i = 0; i < 3600; i++) {
+        float a = i * PI / 1800 - PI;
+        for (float r : {0.001f, 1.0f, 5000.0f}) {
+            float y = r * sinf(a), x = r * cosf(a);
+            worst = fmaxf(worst, fabsf(GeoObserver::fastAtan2(y, x) - atan2f(y, x)));
+        }
+    }
+    TEST_ASSERT_TRUE(worst < 1e-5);
+    TEST_ASSERT_EQUAL_FLOAT(0, GeoObserver::fastAtan2(0, 0));
+}
+
+// Within mesh range the local projection must stay within the documented bounds, at any latitude
+void test_localErrorBounds(void)
+{
+    const int32_t latitudes[] = {0, 375000000, 600000000, -450000000, 780000000};
+    std::vector<int32_t> lats, lons;
+    for (int32_t lat : latitudes) {
+        // Roughly 100 km in latitude, stay inside GEO_LOCAL_MAX_METERS in longitude too
+        scatter(lat, -1220000000, 0.6 * cos(lat * 1e-7 * PI / 180), 2000, lats, lons);
+        Errors e = compare(lat, -1220000000, lats, lons);
+        char msg[96];
+        snprintf(msg, sizeof(msg), "lat %.1f: distance %.4f%%, bearing %.4f deg", lat * 1e-7, e.distance * 100, e.bearing);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_TRUE(e.distance < 0.0001);
+        TEST_ASSERT_TRUE(e.bearing < 0.2);
+    }
+}
+
+// Points beyond the local range fall back to the exact functions, including across the antimeridian
+void test_farPoints(void)
+{
+    std::vector<int32_t> lats, lons;
+    scatter(100000000, 1790000000, 30, 500, lats, lons);
+    Errors e = compare(100000000, 1790000000, lats, lons);
+    TEST_ASSERT_TRUE(e.distance < 0.0001);
+    TEST_ASSERT_TRUE(e.bearing < 0.2);
+}
+
+void test_northEast(void)
+{
+    // One point 1 km north and one 1 km east, give or take
+    int32_t lats[] = {450000000 + 89968, 450000000};
+    int32_t lons[] = {70000000, 70000000 + 127218};
+    float north[2], east[2];
+    GeoObserver(450000000, 70000000).toLocalMeters(lats, lons, 2, north, east);
+    TEST_ASSERT_FLOAT_WITHIN(2, 1000, north[0]);
+    TEST_ASSERT_FLOAT_WITHIN(2, 0, east[0]);
+    TEST_ASSERT_FLOAT_WITHIN(2, 0, north[1]);
+    TEST_ASSERT_FLOAT_WITHIN(2, 1000, east[1]);
+}
+
+// Every point within the given meters north and east of the observer is inside the box
+void test_boxAround(void)
+{
+    const struct {
+        int32_t lat, lon;
+        float north, east;
+        double spread;
+    } cases[] = {
+        {450000000, 70000000, 5000, 8000, 0.2},      // A town
+        {-335000000, 1795000000, 20000, 90000, 1.5}, // Across the antimeridian
+        {880000000, 0, 50000, 50000, 2},             // Near the pole, longitudes are narrow
+    };
+    for (const auto &c : cases) {
+        GeoObserver observer(c.lat, c.lon);
+        int32_t minLat, maxLat, minLon, maxLon;
+        observer.boxAround(c.north, c.east, &minLat, &maxLat, &minLon, &maxLon);
+
+        std::vector<int32_t> lats, lons;
+        scatter(c.lat, c.lon, c.spread, 2000, lats, lons);
+        std::vector<float> north(lats.size()), east(lats.size());
+        observer.toLocalMeters(lats.data(), lons.data(), lats.size(), north.data(), east.data());
+        size_t inside = 0;
+        for (size_t i = 0; i < lats.size(); i++) {
+            if (fabsf(north[i]) > c.north || fabsf(east[i]) > c.east)
+                continue;
+            inside++;
+            bool lonInside = minLon <= maxLon ? lons[i] >= minLon && lons[i] <= maxLon : lons[i] >= minLon || lons[i] <= maxLon;
+            TEST_ASSERT_TRUE(lats[i] >= minLat && lats[i] <= maxLat);
+            TEST_ASSERT_TRUE(lonInside);
+        }
+        TEST_ASSERT_TRUE(inside > 0);
+    }
+
+    // Too wide to say, all longitudes
+    int32_t minLat, maxLat, minLon, maxLon;
+    GeoObserver(899000000, 0).boxAround(100000, 1000000, &minLat, &maxLat, &minLon, &maxLon);
+    TEST_ASSERT_EQUAL(-1800000000, minLon);
+    TEST_ASSERT_EQUAL(1800000000, maxLon);
+    TEST_ASSERT_EQUAL(900000000, maxLat);
+}
+
+// Not a pass/fail test: compares the cost of a full node list against the per node functions
+void test_benchmark(void)
+{
+    const size_t n = 250;
+    const int rounds = 200;
+    std::vector<int32_t> lats, lons;
+    scatter(375000000, -1220000000, 0.5, n, lats, lons);
+    std::vector<float> meters(n), bearings(n);
+    float sink = 0;
+
+    uint32_t start = micros();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < n; i++) {
+            sink += GeoCoord::latLongToMeter(37.5, -122.0, lats[i] * 1e-7, lons[i] * 1e-7);
+            sink += GeoCoord::bearing(37.5, -122.0, lats[i] * 1e-7, lons[i] * 1e-7);
+        }
+    }
+    uint32_t scalar = micros() - start;
+
+    start = micros();
+    for (int r = 0; r < rounds; r++) {
+        GeoObserver(375000000, -1220000000).distanceAndBearing(lats.data(), lons.data(), n, meters.data(), bearings.data());
+        sink += meters[r % n];
+    }
+    uint32_t batched = micros() - start;
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%u nodes: per node functions %u ns/node, batched %u ns/node (%.0f)", (unsigned)n,
+             (unsigned)((uint64_t)scalar * 1000 / (n * rounds)), (unsigned)((uint64_t)batched * 1000 / (n * rounds)), sink);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    randomSeed(1);
+    UNITY_BEGIN();
+    RUN_TEST(test_fastAtan2);
+    RUN_TEST(test_localErrorBounds);
+    RUN_TEST(test_farPoints);
+    RUN_TEST(test_northEast);
+    RUN_TEST(test_boxAround);
+    RUN_TEST(test_benchmark);
+    exit(UNITY_END());
+}
+
+void loop() {}
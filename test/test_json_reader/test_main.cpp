@@ -0,0 +1,190 @@
+#include "TestUtil.h"
+#include "serialization/JSON.h"
+#include "serialization/JSONReader.h"
+#include <Arduino.h>
+#include <unity.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+namespace
+{
+JSONReader reader(const char *text)
+{
+    return JSONReader(text, strlen(text));
+}
+
+bool isValid(const std::string &text)
+{
+    return JSONReader::isValid(text.data(), text.size());
+}
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_tokens(void)
+{
+    JSONReader json = reader(" {\"a\": [1, -2.5e1, true, false, null], \"b\": {}, \"c\": \"x\"} ");
+    const JSONReader::Token expected[] = {
+        JSONReader::JSON_OBJECT_START, JSONReader::JSON_KEY,    JSONReader::JSON_ARRAY_START, JSONReader::JSON_NUMBER,
+        JSONReader::JSON_NUMBER,       JSONReader::JSON_TRUE,   JSONReader::JSON_FALSE,       JSONReader::JSON_NULL,
+        JSONReader::JSON_ARRAY_END,    JSONReader::JSON_KEY,    JSONReader::JSON_OBJECT_START, JSONReader::JSON_OBJECT_END,
+        JSONReader::JSON_KEY,          JSONReader::JSON_STRING, JSONReader::JSON_OBJECT_END,  JSONReader::JSON_END,
+        JSONReader::JSON_END,
+    };
+    for (JSONReader::Token t : expected) {
+        TEST_ASSERT_EQUAL(t, json.next());
+        if (t == JSONReader::JSON_NUMBER)
+            TEST_ASSERT_EQUAL(2, json.getDepth());
+    }
+}
+
+void test_values(void)
+{
+    JSONReader json = reader("[0, -12, 3.25, 1e3, -2.5E-1, 4294967295, \"a\\\"\\\\\\/\\b\\f\\n\\r\\t\", \"\\u00e9\\u20ac\\ud83d\\ude00\"]");
+    TEST_ASSERT_EQUAL(JSONReader::JSON_ARRAY_START, json.next());
+    const double numbers[] = {0, -12, 3.25, 1000, -0.25, 4294967295.0};
+    for (double n : numbers) {
+        TEST_ASSERT_EQUAL(JSONReader::JSON_NUMBER, json.next());
+        TEST_ASSERT_TRUE(fabs(n - json.getNumber()) < 1e-9);
+    }
+
+    char buf[16];
+    TEST_ASSERT_EQUAL(JSONReader::JSON_STRING, json.next());
+    TEST_ASSERT_EQUAL(9, json.getString(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY("a\"\\/\b\f\n\r\t", buf, 9);
+    TEST_ASSERT_TRUE(json.equals("a\"\\/\b\f\n\r\t"));
+    TEST_ASSERT_FALSE(json.equals("a\"\\/\b\f\n\r"));
+    TEST_ASSERT_FALSE(json.equals("a\"\\/\b\f\n\r\tx"));
+
+    // UTF-8, with a surrogate pair
+    TEST_ASSERT_EQUAL(JSONReader::JSON_STRING, json.next());
+    TEST_ASSERT_EQUAL(9, json.getString(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY("\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80", buf, 9);
+    TEST_ASSERT_TRUE(json.equals("\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80"));
+
+    // Too long for the buffer, still tells the whole length
+    memset(buf, 0, sizeof(buf));
+    TEST_ASSERT_EQUAL(9, json.getString(buf, 4));
+    TEST_ASSERT_EQUAL_MEMORY("\xc3\xa9\xe2\x82", buf, 4);
+    TEST_ASSERT_EQUAL(0, buf[4]);
+
+    TEST_ASSERT_EQUAL(JSONReader::JSON_ARRAY_END, json.next());
+    TEST_ASSERT_EQUAL(JSONReader::JSON_END, json.next());
+}
+
+void test_skip(void)
+{
+    JSONReader json = reader("{\"skipped\": {\"a\": [1, {\"b\": []}], \"c\": \"}\"}, \"also\": 5, \"wanted\": 7}");
+    TEST_ASSERT_EQUAL(JSONReader::JSON_OBJECT_START, json.next());
+    double wanted = 0;
+    JSONReader::Token t;
+    while ((t = json.next()) == JSONReader::JSON_KEY) {
+        if (json.equals("wanted")) {
+            TEST_ASSERT_EQUAL(JSONReader::JSON_NUMBER, json.next());
+            wanted = json.getNumber();
+        } else {
+            TEST_ASSERT_TRUE(json.skip());
+        }
+    }
+    TEST_ASSERT_EQUAL(JSONReader::JSON_OBJECT_END, t);
+    TEST_ASSERT_TRUE(wanted == 7);
+    TEST_ASSERT_EQUAL(JSONReader::JSON_END, json.next());
+
+    // The rest of a container just opened
+    json = reader("[[1, [2]], 3]");
+    json.next();
+    TEST_ASSERT_EQUAL(JSONReader::JSON_ARRAY_START, json.next());
+    TEST_ASSERT_TRUE(json.skip());
+    TEST_ASSERT_EQUAL(JSONReader::JSON_NUMBER, json.next());
+
+    json = reader("{\"a\": [1, }");
+    json.next();
+    json.next();
+    TEST_ASSERT_FALSE(json.skip());
+}
+
+void test_validity(void)
+{
+    const char *valid[] = {"{}", " [ ] ", "\"text\"", "0", "-0.5e+3", "null", "true", "{\"a\":{\"b\":[1,2,{}]}}",
+                           "\"\\u0041\"", "[\"\xc3\xa9\"]"};
+    for (const char *text : valid)
+        TEST_ASSERT_TRUE_MESSAGE(isValid(text), text);
+
+    const char *invalid[] = {"",       " ",        "{",           "}",         "{\"a\"}",     "{\"a\":}",   "{\"a\" 1}",
+                             "{a:1}",  "[1,]",     "[1 2]",       "{} {}",     "01",          "1.",         "-",
+                             "1e",     ".5",       "tru",         "True",      "\"\\x\"",     "\"\\u12\"",  "\"abc",
+                             "\"\t\"", "{\"a\":1,}", "Hello there", "[1]]",      "{\"a\":1]"};
+    for (const char *text : invalid)
+        TEST_ASSERT_FALSE_MESSAGE(isValid(text), text);
+
+    // Text with a NUL in it isn't JSON
+    TEST_ASSERT_FALSE(isValid(std::string("{}\0", 3)));
+    // Nor is what is cut short
+    TEST_ASSERT_FALSE(JSONReader::isValid("{\"a\": 1}", 7));
+
+    std::string deep(JSON_READER_MAX_DEPTH, '[');
+    deep += std::string(JSON_READER_MAX_DEPTH, ']');
+    TEST_ASSERT_TRUE(isValid(deep));
+    TEST_ASSERT_FALSE(isValid("[" + deep + "]"));
+}
+
+void test_agreesWithParse(void)
+{
+    // What a sniffer sees: text messages, some of them JSON
+    const char *texts[] = {"Hello there", "{\"temp\": 21.5, \"unit\": \"C\"}", "[1, 2, 3]", "{\"a\": [1, 2,]}", "42",
+                           "ok {}", "{\"nested\": {\"deep\": [true, false, null]}}", "\"quoted\"", "-", "{\"a\" 1}"};
+    for (const char *text : texts) {
+        JSONValue *value = JSON::Parse(text);
+        TEST_ASSERT_EQUAL_MESSAGE(value != NULL, isValid(text), text);
+        delete value;
+    }
+}
+
+void test_benchmarkSniffing(void)
+{
+    const char *plain = "Meet at the trailhead at 9, bring water and a spare battery for the radio";
+    const char *json = "{\"type\": \"sendtext\", \"from\": 1234567890, \"payload\": \"Meet at the trailhead at 9\"}";
+    const int rounds = 2000;
+
+    int found = 0;
+    uint32_t start = micros();
+    for (int i = 0; i < rounds; i++) {
+        for (const char *text : {plain, json}) {
+            JSONValue *value = JSON::Parse(text);
+            found += value != NULL;
+            delete value;
+        }
+    }
+    uint32_t parseUs = micros() - start;
+
+    start = micros();
+    for (int i = 0; i < rounds; i++)
+        for (const char *text : {plain, json})
+            found += JSONReader::isValid(text, strlen(text));
+    uint32_t validateUs = micros() - start;
+    TEST_ASSERT_EQUAL(2 * rounds, found);
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%d texts: %u us with JSON::Parse, %u us with JSONReader::isValid", 2 * rounds,
+             (unsigned)parseUs, (unsigned)validateUs);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_tokens);
+    RUN_TEST(test_values);
+    RUN_TEST(test_skip);
+    RUN_TEST(test_validity);
+    RUN_TEST(test_agreesWithParse);
+    RUN_TEST(test_benchmarkSniffing);
+    exit(UNITY_END());
+}
+
+void loop() {}
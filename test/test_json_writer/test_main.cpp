@@ -0,0 +1,180 @@
+#include "TestUtil.h"
+#include "serialization/JSON.h"
+#include "serialization/JSONReader.h"
+#include "serialization/JSONWriter.h"
+#include <Arduino.h>
+#include <unity.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string>
+
+namespace
+{
+/// Collects what is written, counting the calls
+class StringPrint : public Print
+{
+  public:
+    std::string text;
+    size_t writes = 0;
+
+    size_t write(uint8_t c) override
+    {
+        writes++;
+        text += (char)c;
+        return 1;
+    }
+
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        writes++;
+        text.append((const char *)buffer, size);
+        return size;
+    }
+};
+
+std::string stringify(JSONValue *value)
+{
+    std::string s = value->Stringify();
+    delete value;
+    return s;
+}
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_structure(void)
+{
+    StringPrint out;
+    {
+        JSONWriter json(out);
+        json.beginObject();
+        json.beginObject("data");
+        json.beginArray("empty");
+        json.endArray();
+        json.beginArray("list");
+        json.add(NULL, 1);
+        json.beginObject();
+        json.endObject();
+        json.beginArray();
+        json.add(NULL, true);
+        json.addNull(NULL);
+        json.endArray();
+        json.add(NULL, (const char *)NULL);
+        json.endArray();
+        json.endObject();
+        json.add("status", "ok");
+        json.endObject();
+    }
+    TEST_ASSERT_EQUAL_STRING("{\"data\":{\"empty\":[],\"list\":[1,{},[true,null],null]},\"status\":\"ok\"}", out.text.c_str());
+}
+
+void test_values(void)
+{
+    StringPrint out;
+    {
+        JSONWriter json(out);
+        json.beginArray();
+        json.add(NULL, -2147483647L - 1);
+        json.add(NULL, 4294967295UL);
+        json.add(NULL, 0.1);
+        json.add(NULL, -12.5f);
+        json.add(NULL, INFINITY);
+        json.add(NULL, NAN);
+        json.add(NULL, false);
+        json.endArray();
+    }
+    TEST_ASSERT_EQUAL_STRING("[-2147483648,4294967295,0.1,-12.5,null,null,false]", out.text.c_str());
+}
+
+void test_matchesStringify(void)
+{
+    // Keys in order, as JSONObject sorts them
+    const char *text = "\"quoted\" back\\slash a/b \b\f\n\r\t \x01\x1f\x7f end";
+    const double numbers[] = {0, -1, 3.25, 1e21, 1e-7, 123456789012345678.0, 25.5 * 1e-7, 868.125};
+
+    JSONObject object;
+    JSONArray array;
+    for (double n : numbers)
+        array.push_back(new JSONValue(n));
+    object["numbers"] = new JSONValue(array);
+    object["text"] = new JSONValue(text);
+    object["yes"] = new JSONValue(true);
+    std::string expected = stringify(new JSONValue(object));
+
+    StringPrint out;
+    {
+        JSONWriter json(out);
+        json.beginObject();
+        json.beginArray("numbers");
+        for (double n : numbers)
+            json.add(NULL, n);
+        json.endArray();
+        json.add("text", text);
+        json.add("yes", true);
+        json.endObject();
+        TEST_ASSERT_EQUAL(expected.size(), json.getLength());
+    }
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), out.text.c_str());
+    TEST_ASSERT_TRUE(JSONReader::isValid(out.text.data(), out.text.size()));
+}
+
+void test_utf8(void)
+{
+    // Passed through as it is, where JSONValue mangles it when char is signed
+    StringPrint out;
+    {
+        JSONWriter json(out);
+        json.add(NULL, "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80");
+    }
+    TEST_ASSERT_EQUAL_STRING("\"caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80\"", out.text.c_str());
+
+    JSONReader reader(out.text.data(), out.text.size());
+    char buf[16];
+    TEST_ASSERT_EQUAL(JSONReader::JSON_STRING, reader.next());
+    TEST_ASSERT_EQUAL(14, reader.getString(buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_MEMORY("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80", buf, 14);
+}
+
+void test_buffered(void)
+{
+    // A big document goes out in buffer sized writes, and nothing is written until the buffer fills
+    StringPrint out;
+    size_t length;
+    {
+        JSONWriter json(out);
+        json.beginArray();
+        for (int i = 0; i < 1000; i++) {
+            json.beginObject();
+            json.add("id", i);
+            json.add("name", "a node with a fairly long name");
+            json.endObject();
+            TEST_ASSERT_EQUAL((json.getLength() - 1) / JSON_WRITER_BUFFER_SIZE, out.writes);
+        }
+        json.endArray();
+        length = json.getLength();
+    }
+    TEST_ASSERT_EQUAL(length, out.text.size());
+    TEST_ASSERT_EQUAL((length + JSON_WRITER_BUFFER_SIZE - 1) / JSON_WRITER_BUFFER_SIZE, out.writes);
+    TEST_ASSERT_TRUE(JSONReader::isValid(out.text.data(), out.text.size()));
+
+    char msg[100];
+    snprintf(msg, sizeof(msg), "%u bytes of JSON in %u writes of at most %u bytes", (unsigned)length, (unsigned)out.writes,
+             (unsigned)JSON_WRITER_BUFFER_SIZE);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_structure);
+    RUN_TEST(test_values);
+    RUN_TEST(test_matchesStringify);
+    RUN_TEST(test_utf8);
+    RUN_TEST(test_buffered);
+    exit(UNITY_END());
+}
+
+void loop() {}
@@ -0,0 +1,760 @@
+#include "MeshSim.h"
+
+#include <algorithm>
+#include <math.h>
+
+/// The firmware's airtime and contention window math, for the simulated modem settings
+class MeshSim::Timing : public RadioInterface
+{
+  public:
+    explicit Timing(const SimRadioParams &radio)
+    {
+        bw = radio.bw;
+        sf = radio.sf;
+        cr = radio.cr;
+        slotTimeMsec = computeSlotTimeMsec();
+    }
+
+    ErrorCode send(meshtastic_MeshPacket *) override { return ERRNO_UNKNOWN; }
+
+    uint32_t slotTime() const { return slotTimeMsec; }
+    uint32_t processingTime() const { return PROCESSING_TIME_MSEC; }
+};
+
+static bool isRouterRole(meshtastic_Config_DeviceConfig_Role role)
+{
+    return role == meshtastic_Config_DeviceConfig_Role_ROUTER || role == meshtastic_Config_DeviceConfig_Role_REPEATER ||
+           role == meshtastic_Config_DeviceConfig_Role_ROUTER_LATE;
+}
+
+SimNode::SimNode(MeshSim &sim, size_t index, float x, float y, meshtastic_Config_DeviceConfig_Role role)
+    : index(index), num((NodeNum)index + 1), x(x), y(y), role(role), sim(sim)
+{
+    contention.setRole(role);
+    suppressor.setRole(role);
+    suppressor.setOurRelayId(relayId());
+    // Own stream per node, so the layout drawn from the simulator's one doesn't depend on the policy
+    contention.seed(sim.config.seed * 2654435761u + num);
+}
+
+// Same bookkeeping as PacketHistory, minus the expiry: simulated runs are shorter than FLOOD_EXPIRE_TIME
+bool SimNode::wasSeenRecently(const SimPacket &p, bool *wasFallback, bool *weWereNextHop)
+{
+    if (p.id == 0)
+        return false;
+
+    auto key = std::make_pair(p.from, p.id);
+    auto found = history.find(key);
+    if (found == history.end()) {
+        history[key] = Record{p.nextHop, {p.relayNode, 0, 0}};
+        return false;
+    }
+
+    Record &r = found->second;
+    // First seen with a next hop other than us, now flooded by one of its relayers, and neither we nor that next hop relayed
+    if (wasFallback)
+        *wasFallback = p.from != num && r.nextHop != NO_NEXT_HOP_PREFERENCE && r.nextHop != relayId() &&
+                       p.nextHop == NO_NEXT_HOP_PREFERENCE && wasRelayer(p.relayNode, p.id, p.from) &&
+                       !wasRelayer(relayId(), p.id, p.from) && !wasRelayer(r.nextHop, p.id, p.from);
+    if (weWereNextHop)
+        *weWereNextHop = r.nextHop == relayId();
+    r.relayedBy[2] = r.relayedBy[1];
+    r.relayedBy[1] = r.relayedBy[0];
+    r.relayedBy[0] = p.relayNode;
+    return true;
+}
+
+bool SimNode::wasRelayer(uint8_t relayer, PacketId id, NodeNum sender) const
+{
+    auto found = history.find(std::make_pair(sender, id));
+    if (!relayer || found == history.end())
+        return false;
+    for (uint8_t r : found->second.relayedBy)
+        if (r == relayer)
+            return true;
+    return false;
+}
+
+uint8_t SimNode::getNextHop(const SimPacket &p, uint8_t failedHop)
+{
+    if (!sim.config.nextHopRouting || p.to == NODENUM_BROADCAST)
+        return NO_NEXT_HOP_PREFERENCE;
+    if (sim.config.multiPathNextHops && routes.knows(p.to, sim.now())) {
+        uint8_t avoid[] = {0, 0, 0, p.relayNode, failedHop};
+        auto record = history.find(std::make_pair(p.from, p.id));
+        if (record != history.end())
+            std::copy(record->second.relayedBy, record->second.relayedBy + 3, avoid);
+        return routes.getNextHop(p.to, p.hopLimit, avoid, sizeof(avoid), sim.now(), failedHop == NO_NEXT_HOP_PREFERENCE);
+    }
+    if (failedHop != NO_NEXT_HOP_PREFERENCE)
+        return NO_NEXT_HOP_PREFERENCE;
+    auto found = nextHops.find(p.to);
+    if (found == nextHops.end() || found->second == p.relayNode)
+        return NO_NEXT_HOP_PREFERENCE;
+    return found->second;
+}
+
+/// NextHopRouter::learnNextHop(): the ACK came back through relay_node, so that is a next hop to its sender
+void SimNode::learnNextHop(const SimPacket &p, float snr)
+{
+    if (!sim.config.nextHopRouting || p.relayNode == relayId())
+        return;
+    bool relayedOurs = wasRelayer(p.relayNode, p.requestId, p.to) ||
+                       (wasRelayer(relayId(), p.requestId, p.to) && p.hopStart != 0 && p.hopStart == p.hopLimit);
+    uint8_t hopsBeyond = p.hopStart > p.hopLimit ? p.hopStart - p.hopLimit : 0;
+
+    if (sim.config.multiPathNextHops) {
+        if (relayedOurs)
+            routes.noteDelivered(p.from, p.relayNode, hopsBeyond, snr, sim.now());
+        else
+            routes.noteAlternate(p.from, p.relayNode, hopsBeyond, snr, sim.now());
+        updateNodeNextHop(p.from);
+    } else if (relayedOurs) {
+        nextHops[p.from] = p.relayNode;
+    }
+}
+
+void SimNode::updateNodeNextHop(NodeNum dest)
+{
+    uint8_t best = routes.getNextHop(dest, HOP_MAX, nullptr, 0, sim.now());
+    if (best != NO_NEXT_HOP_PREFERENCE)
+        nextHops[dest] = best;
+    else
+        nextHops.erase(dest);
+}
+
+/// Router send(): stamp ourselves as relayer, pick a next hop and queue for the radio
+void SimNode::send(SimPacket p, bool relay, uint32_t delayMs)
+{
+    p.relayNode = relayId();
+    wasSeenRecently(p);
+    p.nextHop = getNextHop(p);
+
+    // NextHopRouter retransmits directed packets itself, ReliableRouter does it for our own want_ack ones
+    if (sim.config.nextHopRouting && (p.from != num || !p.wantAck) && p.nextHop != NO_NEXT_HOP_PREFERENCE &&
+        (p.hopLimit > 0 || p.wantAck))
+        startRetransmission(p, NUM_INTERMEDIATE_RETX);
+    else if (p.from == num && p.wantAck && retransmissions.count(std::make_pair(p.from, p.id)))
+        retransmissions[std::make_pair(p.from, p.id)].packet.nextHop = p.nextHop; // Remember whom we asked
+
+    // ReliableRouter: while we transmit we can't hear (implicit) ACKs, so push the other retransmissions out
+    uint32_t airtime = sim.airtimeMsec(p);
+    for (auto &r : retransmissions)
+        if (r.first.second != p.id)
+            r.second.dueMs += airtime;
+
+    if (relay)
+        sim.stats.relays++;
+    txQueue.push_back(Pending{p, sim.now() + delayMs, relay});
+    kickTransmitter();
+}
+
+void SimNode::originate(const SimPacket &p)
+{
+    if (p.wantAck)
+        startRetransmission(p, NUM_RELIABLE_RETX);
+    send(p, false, txDelayMsec());
+}
+
+/// FloodingRouter::perhapsRebroadcast() and NextHopRouter::perhapsRelay()
+bool SimNode::perhapsRelay(const SimPacket &p, float snr)
+{
+    if (p.to == num || p.from == num || p.hopLimit == 0 || p.id == 0)
+        return false;
+    if (p.nextHop != NO_NEXT_HOP_PREFERENCE && p.nextHop != relayId() && sim.config.nextHopRouting)
+        return false;
+    if (role == meshtastic_Config_DeviceConfig_Role_CLIENT_MUTE)
+        return false;
+    if (judgeRebroadcast(p) == RebroadcastSuppressor::REDUNDANT) {
+        sim.stats.relaysSuppressed++;
+        return false;
+    }
+
+    SimPacket copy = p;
+    copy.hopLimit--;
+    send(copy, true, txDelayMsecWeighted(snr));
+    return true;
+}
+
+bool SimNode::cancelSending(NodeNum from, PacketId id)
+{
+    auto it = std::find_if(txQueue.begin(), txQueue.end(),
+                           [&](const Pending &q) { return q.packet.from == from && q.packet.id == id; });
+    if (it == txQueue.end())
+        return false;
+    if (it->relay)
+        sim.stats.relaysCanceled++;
+    txQueue.erase(it);
+    return true;
+}
+
+/// FloodingRouter::judgeRebroadcast()
+RebroadcastSuppressor::Verdict SimNode::judgeRebroadcast(const SimPacket &p)
+{
+    if (!sim.config.suppressRebroadcasts || p.to != NODENUM_BROADCAST ||
+        role == meshtastic_Config_DeviceConfig_Role_ROUTER_LATE)
+        return RebroadcastSuppressor::UNKNOWN;
+    bool isRepeated = p.hopStart > 0 && p.hopStart == p.hopLimit;
+    if (isRepeated && wasRelayer(relayId(), p.id, p.from))
+        return RebroadcastSuppressor::UNKNOWN;
+
+    auto found = history.find(std::make_pair(p.from, p.id));
+    if (found == history.end())
+        return RebroadcastSuppressor::UNKNOWN;
+    return suppressor.judge(found->second.relayedBy, 3, sim.now());
+}
+
+/// FloodingRouter::perhapsCancelDupe(): somebody else already relayed it
+void SimNode::perhapsCancelDupe(const SimPacket &p)
+{
+    RebroadcastSuppressor::Verdict verdict = judgeRebroadcast(p);
+    if (verdict == RebroadcastSuppressor::REDUNDANT || (verdict == RebroadcastSuppressor::UNKNOWN && !isRouterRole(role)))
+        cancelSending(p.from, p.id);
+}
+
+bool SimNode::isInTxQueue(NodeNum from, PacketId id) const
+{
+    return std::any_of(txQueue.begin(), txQueue.end(),
+                       [&](const Pending &q) { return q.packet.from == from && q.packet.id == id; });
+}
+
+void SimNode::startRetransmission(const SimPacket &p, uint8_t numReTx)
+{
+    stopRetransmission(p.from, p.id);
+
+    Retransmission r;
+    r.packet = p;
+    r.remaining = numReTx - 1; // The first send is the caller's
+    r.dueMs = sim.now() + retransmissionMsec(p);
+    r.token = ++retransmissionToken;
+    auto key = std::make_pair(p.from, p.id);
+    retransmissions[key] = r;
+
+    uint64_t token = r.token;
+    sim.schedule(r.dueMs - sim.now(), [this, key, token] { onRetransmissionTimeout(key, token); });
+}
+
+void SimNode::stopRetransmission(NodeNum from, PacketId id)
+{
+    auto found = retransmissions.find(std::make_pair(from, id));
+    if (found == retransmissions.end())
+        return;
+    // Only once we actually sent it: don't cancel an ACKed packet still waiting for its first transmission
+    if (found->second.remaining < NUM_RELIABLE_RETX - 1 && (from == num || !isRouterRole(role)))
+        cancelSending(from, id);
+    retransmissions.erase(found);
+}
+
+void SimNode::onRetransmissionTimeout(std::pair<NodeNum, PacketId> key, uint64_t token)
+{
+    auto found = retransmissions.find(key);
+    if (found == retransmissions.end() || found->second.token != token)
+        return;
+
+    Retransmission &r = found->second;
+    if (sim.now() < r.dueMs) {
+        // Postponed by airtime we spent since
+        sim.schedule(r.dueMs - sim.now(), [this, key, token] { onRetransmissionTimeout(key, token); });
+        return;
+    }
+    if (r.remaining == 0) {
+        retransmissions.erase(found);
+        return;
+    }
+
+    SimPacket p = r.packet;
+    bool multiPath = sim.config.multiPathNextHops;
+    uint8_t failedHop = r.packet.nextHop;
+    if (p.to != NODENUM_BROADCAST && failedHop != NO_NEXT_HOP_PREFERENCE && multiPath) {
+        routes.noteFailed(p.to, failedHop, sim.now());
+        updateNodeNextHop(p.to);
+    }
+
+    p.relayNode = relayId();
+    wasSeenRecently(p);
+    if (r.remaining == 1) {
+        // Last attempt, fall back to flooding and forget the next hop unless we learned it since boot
+        p.nextHop = NO_NEXT_HOP_PREFERENCE;
+        if (!(multiPath && routes.knows(p.to, sim.now())))
+            nextHops.erase(p.to);
+    } else if (failedHop != NO_NEXT_HOP_PREFERENCE && multiPath) {
+        // Fail over to another next hop that relayed ours, or else ask the same one again
+        uint8_t failover = getNextHop(p, failedHop);
+        if (failover != NO_NEXT_HOP_PREFERENCE)
+            p.nextHop = failover;
+    } else if (!multiPath) {
+        p.nextHop = getNextHop(p);
+    }
+    r.packet.nextHop = p.nextHop;
+    sim.stats.retransmissions++;
+    contention.noteRetransmission(sim.now());
+    txQueue.push_back(Pending{p, sim.now() + txDelayMsec(), p.from != num});
+    kickTransmitter();
+
+    r.remaining--;
+    r.dueMs = sim.now() + retransmissionMsec(p);
+    sim.schedule(r.dueMs - sim.now(), [this, key, token] { onRetransmissionTimeout(key, token); });
+}
+
+void SimNode::kickTransmitter()
+{
+    if (txQueue.empty())
+        return;
+
+    uint64_t due = txQueue.front().dueMs;
+    for (auto &q : txQueue)
+        due = std::min(due, q.dueMs);
+    due = std::max(due, std::max(txUntilMs, sim.now()));
+
+    uint64_t token = ++txToken;
+    sim.schedule(due - sim.now(), [this, token] { tryTransmit(token); });
+}
+
+/// RadioLibInterface's transmit timer: send the next due packet, or back off while the channel is busy
+void SimNode::tryTransmit(uint64_t token)
+{
+    if (token != txToken || sim.now() < txUntilMs)
+        return;
+
+    auto next = txQueue.end();
+    for (auto it = txQueue.begin(); it != txQueue.end(); ++it)
+        if (it->dueMs <= sim.now() && (next == txQueue.end() || it->dueMs < next->dueMs))
+            next = it;
+    if (next == txQueue.end()) {
+        kickTransmitter();
+        return;
+    }
+
+    if (rxActive) {
+        contention.noteChannelBusy(next->packet.id, sim.now());
+        next->dueMs = sim.now() + txDelayMsec();
+        kickTransmitter();
+        return;
+    }
+    contention.noteChannelIdle(sim.now());
+
+    SimPacket p = next->packet;
+    txQueue.erase(next);
+    sim.transmit(index, p);
+    kickTransmitter();
+}
+
+void SimNode::sendAck(const SimPacket &p, uint8_t hopLimit)
+{
+    SimPacket ack;
+    ack.from = num;
+    ack.to = p.from;
+    ack.id = sim.nextId++;
+    ack.requestId = p.id;
+    ack.hopLimit = ack.hopStart = hopLimit;
+    ack.payloadLen = 4; // An encoded Routing message with error_reason NONE
+    send(ack, false, txDelayMsec());
+}
+
+/// RoutingModule::getHopLimitForResponse()
+uint8_t SimNode::getHopLimitForResponse(uint8_t hopStart, uint8_t hopLimit) const
+{
+    uint8_t limit = sim.config.hopLimit;
+    if (hopStart != 0) {
+        uint8_t hopsUsed = hopStart < hopLimit ? limit : hopStart - hopLimit;
+        if (hopsUsed > limit)
+            return hopsUsed;
+        else if ((uint8_t)(hopsUsed + 2) < limit)
+            return hopsUsed + 2;
+    }
+    return limit;
+}
+
+/// What Router::handleReceived() does with a packet fresh off the radio, through ReliableRouter and friends
+void SimNode::onReceive(const SimPacket &p, float snr)
+{
+    bool nextHopRouting = sim.config.nextHopRouting;
+    bool isBroadcast = p.to == NODENUM_BROADCAST;
+
+    // FloodingRouter::noteRelayer()
+    suppressor.noteHeard(p.relayNode, sim.now());
+    if (p.hopStart > 0 && p.hopStart - p.hopLimit == 1)
+        suppressor.noteRelayedFrom(p.relayNode, p.from & 0xff, sim.now());
+
+    // We couldn't have heard an (implicit) ACK while this was on the air
+    uint32_t airtime = sim.airtimeMsec(p);
+    for (auto &r : retransmissions)
+        r.second.dueMs += airtime;
+
+    // Someone rebroadcasting our packet is an implicit ACK
+    if (p.from == num)
+        stopRetransmission(p.from, p.id);
+
+    bool wasFallback = false, weWereNextHop = false;
+    if (wasSeenRecently(p, nextHopRouting && !isBroadcast ? &wasFallback : nullptr, &weWereNextHop)) {
+        sim.stats.dupes++;
+        // Another relayer of an ACK is an alternate next hop. NextHopRouter remembers the ACKs it learned from to tell, as
+        // duplicates are still encrypted when it sees them.
+        if (p.requestId && sim.config.multiPathNextHops)
+            learnNextHop(p, snr);
+        bool isRepeated = p.hopStart > 0 && p.hopStart == p.hopLimit;
+        if (nextHopRouting && !isBroadcast) {
+            stopRetransmission(p.from, p.id);
+            if (wasFallback) {
+                // A relayer fell back to flooding, and the next hop it asked before never relayed
+                if (!isInTxQueue(p.from, p.id))
+                    perhapsRelay(p, snr);
+            } else if (isRepeated) {
+                if (!isInTxQueue(p.from, p.id) && !perhapsRelay(p, snr) && p.to == num && p.wantAck)
+                    sendAck(p, 0);
+            } else if (!weWereNextHop) {
+                // A relayer whose next hop didn't relay it failed over to us
+                if (p.nextHop == relayId() && !wasRelayer(relayId(), p.id, p.from)) {
+                    if (!isInTxQueue(p.from, p.id))
+                        perhapsRelay(p, snr);
+                } else {
+                    perhapsCancelDupe(p);
+                }
+            }
+        } else if (isRepeated) {
+            if (!isInTxQueue(p.from, p.id))
+                perhapsRelay(p, snr);
+        } else {
+            perhapsCancelDupe(p);
+        }
+        return;
+    }
+
+    sim.noteReceived(index, p);
+
+    if (p.requestId) {
+        learnNextHop(p, snr);
+
+        if (p.to != num)
+            cancelSending(p.to, p.requestId);
+        stopRetransmission(p.to, p.requestId);
+    } else if (p.to == num && p.wantAck) {
+        sendAck(p, getHopLimitForResponse(p.hopStart, p.hopLimit));
+    }
+
+    perhapsRelay(p, snr);
+}
+
+void SimNode::addBusy(uint64_t startMs, uint64_t endMs)
+{
+    while (startMs < endMs) {
+        uint64_t bucket = startMs / 6000;
+        uint64_t bucketEnd = std::min(endMs, (bucket + 1) * 6000);
+        uint8_t slot = bucket % 10;
+        if (busyEpoch[slot] != bucket) {
+            busyEpoch[slot] = bucket;
+            busyMs[slot] = 0;
+        }
+        busyMs[slot] += bucketEnd - startMs;
+        startMs = bucketEnd;
+    }
+}
+
+float SimNode::channelUtilizationPercent() const
+{
+    uint64_t current = sim.now() / 6000;
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < 10; i++)
+        if (busyEpoch[i] + 10 > current)
+            total += busyMs[i];
+    return total * 100.0f / 60000;
+}
+
+/// The contention window before ContentionWindow: from channel utilization alone
+static uint8_t staticCWsize(float channelUtil)
+{
+    return CONTENTION_CW_MIN + (CONTENTION_CW_MAX - CONTENTION_CW_MIN) * std::min(channelUtil, 100.0f) / 100;
+}
+
+/// RadioInterface::getTxDelayMsec()
+uint32_t SimNode::txDelayMsec()
+{
+    auto &t = *sim.timing;
+    if (sim.config.adaptiveContention)
+        return contention.getTxDelaySlots(channelUtilizationPercent(), sim.now()) * t.slotTime();
+    return sim.random(0, 1 << staticCWsize(channelUtilizationPercent())) * t.slotTime();
+}
+
+/// RadioInterface::getTxDelayMsecWeighted(), for our own role rather than the global config
+uint32_t SimNode::txDelayMsecWeighted(float snr)
+{
+    auto &t = *sim.timing;
+    if (sim.config.adaptiveContention)
+        return contention.getTxDelaySlotsWeighted(snr, sim.now()) * t.slotTime();
+
+    // Arduino map() of the SNR range [-20, 10] onto the window, as it was
+    uint8_t cw = ((long)snr + 20) * (CONTENTION_CW_MAX - CONTENTION_CW_MIN) / 30 + CONTENTION_CW_MIN;
+    if (role == meshtastic_Config_DeviceConfig_Role_ROUTER || role == meshtastic_Config_DeviceConfig_Role_REPEATER)
+        return sim.random(0, 2 * cw) * t.slotTime();
+    return (2 * CONTENTION_CW_MAX * t.slotTime()) + sim.random(0, 1 << cw) * t.slotTime();
+}
+
+/// RadioInterface::getRetransmissionMsec()
+uint32_t SimNode::retransmissionMsec(const SimPacket &p)
+{
+    auto &t = *sim.timing;
+    uint32_t slots;
+    if (sim.config.adaptiveContention)
+        slots = contention.getRetransmissionSlots(channelUtilizationPercent(), sim.now());
+    else
+        slots = (1 << staticCWsize(channelUtilizationPercent())) + 2 * CONTENTION_CW_MAX +
+                (1 << ((CONTENTION_CW_MAX + CONTENTION_CW_MIN) / 2));
+    return 2 * sim.airtimeMsec(p) + slots * t.slotTime() + t.processingTime();
+}
+
+MeshSim::MeshSim(const Config &config) : config(config), timing(new Timing(config.radio)), rng(config.seed) {}
+
+MeshSim::~MeshSim() {}
+
+size_t MeshSim::addNode(float x, float y, meshtastic_Config_DeviceConfig_Role role)
+{
+    size_t index = nodes.size();
+    nodes.emplace_back(new SimNode(*this, index, x, y, role));
+    receiving.emplace_back();
+    snrCache.clear();
+    return index;
+}
+
+void MeshSim::addGrid(size_t cols, size_t rows, float spacing)
+{
+    for (size_t r = 0; r < rows; r++)
+        for (size_t c = 0; c < cols; c++)
+            addNode(c * spacing, r * spacing);
+}
+
+void MeshSim::addRandom(size_t count, float width, float height)
+{
+    std::uniform_real_distribution<float> xs(0, width), ys(0, height);
+    for (size_t i = 0; i < count; i++) {
+        float x = xs(rng);
+        addNode(x, ys(rng));
+    }
+}
+
+void MeshSim::exchangeNeighborInfo()
+{
+    updateSnrCache();
+    size_t n = nodes.size();
+    for (size_t i = 0; i < n; i++) {
+        std::vector<size_t> heard;
+        for (size_t j = 0; j < n; j++)
+            if (j != i && !isnan(snrCache[i * n + j]))
+                heard.push_back(j);
+        std::sort(heard.begin(), heard.end(),
+                  [&](size_t a, size_t b) { return snrCache[a * n + i] > snrCache[b * n + i]; });
+
+        uint8_t neighbors[REBROADCAST_NEIGHBORS_PER_NODE];
+        size_t count = std::min(heard.size(), (size_t)REBROADCAST_NEIGHBORS_PER_NODE);
+        for (size_t k = 0; k < count; k++)
+            neighbors[k] = nodes[heard[k]]->relayId();
+        for (size_t j : heard) {
+            nodes[j]->suppressor.noteHeard(nodes[i]->relayId(), nowMs);
+            nodes[j]->suppressor.noteNeighbors(nodes[i]->relayId(), neighbors, count, nowMs);
+        }
+    }
+}
+
+void MeshSim::updateSnrCache()
+{
+    size_t n = nodes.size();
+    if (snrCache.size() == n * n)
+        return;
+
+    const SimRadioParams &r = config.radio;
+    std::normal_distribution<float> shadowing(0, r.shadowingSigmaDb > 0 ? r.shadowingSigmaDb : 1);
+    snrCache.assign(n * n, NAN);
+    for (size_t a = 0; a < n; a++) {
+        for (size_t b = a + 1; b < n; b++) {
+            float d = hypotf(nodes[a]->x - nodes[b]->x, nodes[a]->y - nodes[b]->y);
+            float loss = r.refLossDb + 10 * r.pathLossExponent * log10f(std::max(d, 1.0f));
+            if (r.shadowingSigmaDb > 0)
+                loss += shadowing(rng);
+            float snr = r.txPowerDbm - loss - r.noiseFloorDbm;
+            if (snr >= r.snrFloorDb)
+                snrCache[a * n + b] = snrCache[b * n + a] = snr;
+        }
+    }
+}
+
+float MeshSim::linkSnr(size_t a, size_t b)
+{
+    updateSnrCache();
+    return snrCache[a * nodes.size() + b];
+}
+
+uint32_t MeshSim::airtimeMsec(const SimPacket &p) const
+{
+    return timing->getPacketTime((uint32_t)p.payloadLen + MESHTASTIC_HEADER_LENGTH);
+}
+
+void MeshSim::schedule(uint32_t delayMs, std::function<void()> fn)
+{
+    events.push(Event{nowMs + delayMs, eventSeq++, std::move(fn)});
+}
+
+/// Put p on the air from sender and work out who gets it intact
+void MeshSim::transmit(size_t sender, const SimPacket &p)
+{
+    if (nodes[sender]->down)
+        return;
+    updateSnrCache();
+    size_t n = nodes.size();
+    uint32_t airtime = airtimeMsec(p);
+
+    stats.transmissions++;
+    stats.airtimeMs += airtime;
+    SimNode &tx = *nodes[sender];
+    tx.txUntilMs = nowMs + airtime;
+    tx.addBusy(nowMs, nowMs + airtime);
+
+    // Half duplex: whatever we were receiving is gone
+    for (auto &r : receiving[sender]) {
+        if (!r->lost) {
+            r->lost = true;
+            stats.halfDuplexLosses++;
+        }
+    }
+
+    for (size_t j = 0; j < n; j++) {
+        float snr = snrCache[sender * n + j];
+        if (j == sender || isnan(snr) || nodes[j]->down)
+            continue;
+
+        std::shared_ptr<Reception> rx(new Reception{p, sender, nowMs + airtime, snr, false, false});
+        if (nodes[j]->txUntilMs > nowMs) {
+            rx->lost = true;
+            stats.halfDuplexLosses++;
+        }
+
+        // Overlapping signals: the stronger one survives if it is strong enough, otherwise neither does
+        for (auto &other : receiving[j]) {
+            bool otherSurvives = other->snr >= snr + config.radio.captureThresholdDb;
+            bool weSurvive = snr >= other->snr + config.radio.captureThresholdDb;
+            if (!otherSurvives && !other->lost) {
+                other->lost = other->collided = true;
+                stats.collisions++;
+            }
+            if (!weSurvive && !rx->lost) {
+                rx->lost = rx->collided = true;
+                stats.collisions++;
+            }
+        }
+
+        receiving[j].push_back(rx);
+        nodes[j]->rxActive++;
+        uint64_t startMs = nowMs;
+        schedule(airtime, [this, j, rx, startMs] {
+            auto &list = receiving[j];
+            list.erase(std::find(list.begin(), list.end(), rx));
+            SimNode &node = *nodes[j];
+            node.rxActive--;
+            node.addBusy(startMs, nowMs);
+            if (!rx->lost) {
+                stats.receptions++;
+                node.onReceive(rx->packet, rx->snr);
+            } else if (rx->collided) {
+                node.contention.noteCollision(nowMs);
+            }
+        });
+    }
+}
+
+void MeshSim::noteReceived(size_t index, const SimPacket &p)
+{
+    if (p.requestId) {
+        auto trace = traces.find(p.requestId);
+        if (trace != traces.end() && p.to == nodes[index]->num && !trace->second.acked) {
+            trace->second.acked = true;
+            stats.acked++;
+        }
+        return;
+    }
+
+    auto trace = traces.find(p.id);
+    if (trace == traces.end())
+        return;
+    if (p.to == NODENUM_BROADCAST || p.to == nodes[index]->num) {
+        trace->second.reached[index] = nowMs;
+        if (p.to != NODENUM_BROADCAST) {
+            stats.delivered++;
+            stats.deliveryLatencyMs += nowMs - trace->second.sentMs;
+        }
+    }
+}
+
+PacketId MeshSim::sendBroadcast(size_t from, uint8_t payloadLen)
+{
+    SimPacket p;
+    p.from = nodes[from]->num;
+    p.to = NODENUM_BROADCAST;
+    p.id = nextId++;
+    p.hopLimit = p.hopStart = config.hopLimit;
+    p.payloadLen = payloadLen;
+
+    traces[p.id] = Trace{nowMs, {}, false};
+    stats.originated++;
+    nodes[from]->originate(p);
+    return p.id;
+}
+
+PacketId MeshSim::sendDirect(size_t from, size_t to, bool wantAck, uint8_t payloadLen)
+{
+    SimPacket p;
+    p.from = nodes[from]->num;
+    p.to = nodes[to]->num;
+    p.id = nextId++;
+    p.hopLimit = p.hopStart = config.hopLimit;
+    p.wantAck = wantAck;
+    p.payloadLen = payloadLen;
+
+    traces[p.id] = Trace{nowMs, {}, false};
+    stats.originated++;
+    nodes[from]->originate(p);
+    return p.id;
+}
+
+void MeshSim::runFor(uint32_t ms)
+{
+    uint64_t end = nowMs + ms;
+    while (!events.empty() && events.top().atMs <= end) {
+        Event e = events.top();
+        events.pop();
+        nowMs = e.atMs;
+        e.fn();
+    }
+    nowMs = end;
+}
+
+void MeshSim::runUntilIdle(uint32_t maxMs)
+{
+    uint64_t end = nowMs + maxMs;
+    while (!events.empty() && events.top().atMs <= end) {
+        Event e = events.top();
+        events.pop();
+        nowMs = e.atMs;
+        e.fn();
+    }
+}
+
+size_t MeshSim::numReached(PacketId id) const
+{
+    auto trace = traces.find(id);
+    return trace == traces.end() ? 0 : trace->second.reached.size();
+}
+
+uint64_t MeshSim::reachLatencyMs(PacketId id) const
+{
+    auto trace = traces.find(id);
+    if (trace == traces.end() || trace->second.reached.empty())
+        return 0;
+    uint64_t last = 0;
+    for (auto &r : trace->second.reached)
+        last = std::max(last, r.second);
+    return last - trace->second.sentMs;
+}
+
+bool MeshSim::wasAcked(PacketId id) const
+{
+    auto trace = traces.find(id);
+    return trace != traces.end() && trace->second.acked;
+}
@@ -0,0 +1,272 @@
+#pragma once
+
+#include "mesh/ContentionWindow.h"
+#include "mesh/MeshTypes.h"
+#include "mesh/NextHopTable.h"
+#include "mesh/RadioInterface.h"
+#include "mesh/RebroadcastSuppressor.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+/**
+ * An in-process, many node model of the mesh's routing rules, for comparing routing schemes at scale.
+ *
+ * This is a model, not the firmware. The Router, NodeDB and modules are singletons and portduino's millis() is the
+ * wall clock, so we can't run hundreds of real routers side by side. Instead every SimNode carries its own copy of the
+ * state the routers keep (packet history, next hops, tx queue, retransmissions) and a hand-written copy of the rules of
+ * FloodingRouter, NextHopRouter (including its fallback relay) and ReliableRouter. NextHopTable, RebroadcastSuppressor,
+ * ContentionWindow and the airtime calculation are the firmware's own code; time is a virtual clock, so runs are fast
+ * and exactly repeatable for a given seed.
+ *
+ * Results say how the modelled rules compare with each other, not what a deployed mesh will see. A change to the routers
+ * needs the same change here, or the model drifts from them. Each benchmark says so in its output.
+ *
+ * The slot time depends on the region, so initRegion() has to run before a MeshSim is created.
+ */
+
+/// Just the header fields the routers look at, plus the payload size
+struct SimPacket {
+    NodeNum from = 0;
+    NodeNum to = NODENUM_BROADCAST;
+    PacketId id = 0;
+    uint8_t hopLimit = 0;
+    uint8_t hopStart = 0;
+    uint8_t relayNode = NO_NEXT_HOP_PREFERENCE;
+    uint8_t nextHop = NO_NEXT_HOP_PREFERENCE;
+    bool wantAck = false;
+    PacketId requestId = 0; // Set on ACKs
+    uint8_t payloadLen = 0;
+};
+
+/// Radio and propagation model, defaults are LongFast with a log-distance path loss
+struct SimRadioParams {
+    float bw = 250;
+    uint8_t sf = 11;
+    uint8_t cr = 5;
+    float txPowerDbm = 20;
+    float noiseFloorDbm = -114;   // Thermal noise over 250 kHz plus a 6 dB noise figure
+    float snrFloorDb = -17.5;     // Demodulation limit for SF11, weaker signals are neither received nor interfere
+    float refLossDb = 40;         // Path loss at 1 m
+    float pathLossExponent = 3;   // 2 is free space, 3-4 for ground level links
+    float shadowingSigmaDb = 0;   // Per link log-normal shadowing, fixed for the run
+    float captureThresholdDb = 6; // A reception survives an overlapping one that is at least this much weaker
+};
+
+struct SimStats {
+    uint32_t originated = 0;
+    uint32_t transmissions = 0;
+    uint32_t relays = 0;
+    uint32_t relaysCanceled = 0;
+    uint32_t relaysSuppressed = 0; // Not even queued, the relayers so far covered our neighbors
+    uint32_t retransmissions = 0;
+    uint32_t receptions = 0;       // Packets decoded by some node
+    uint32_t collisions = 0;       // Receptions lost to an overlapping transmission
+    uint32_t halfDuplexLosses = 0; // Receptions lost because the receiver was transmitting
+    uint32_t dupes = 0;
+    uint32_t delivered = 0; // Direct messages that reached their destination
+    uint32_t acked = 0;     // Direct messages whose ACK made it back
+    uint64_t deliveryLatencyMs = 0;
+    uint64_t airtimeMs = 0;
+};
+
+class MeshSim;
+
+/** One node: the routing state a single firmware instance keeps */
+class SimNode
+{
+  public:
+    SimNode(MeshSim &sim, size_t index, float x, float y, meshtastic_Config_DeviceConfig_Role role);
+
+    const size_t index;
+    const NodeNum num;
+    const float x, y;
+    meshtastic_Config_DeviceConfig_Role role;
+
+    /// Learned next hop (last byte) per destination, as NodeDB keeps it
+    std::map<NodeNum, uint8_t> nextHops;
+    /// Scored next hops per destination, as NextHopRouter keeps them
+    NextHopTable routes;
+
+    /// Switched off: neither sends nor hears anything
+    bool down = false;
+
+    uint8_t relayId() const { return (uint8_t)((num & 0xFF) ? (num & 0xFF) : 0xFF); }
+
+  private:
+    friend class MeshSim;
+
+    // As in NextHopRouter
+    static const uint8_t NUM_INTERMEDIATE_RETX = 2;
+    static const uint8_t NUM_RELIABLE_RETX = 3;
+
+    struct Record {
+        uint8_t nextHop;
+        uint8_t relayedBy[3];
+    };
+
+    struct Pending {
+        SimPacket packet;
+        uint64_t dueMs;
+        bool relay;
+    };
+
+    struct Retransmission {
+        SimPacket packet;
+        uint8_t remaining;
+        uint64_t dueMs;
+        uint64_t token;
+    };
+
+    MeshSim &sim;
+    ContentionWindow contention;
+    RebroadcastSuppressor suppressor;
+
+    std::map<std::pair<NodeNum, PacketId>, Record> history;
+    std::vector<Pending> txQueue;
+    std::map<std::pair<NodeNum, PacketId>, Retransmission> retransmissions;
+    uint64_t retransmissionToken = 0;
+    uint64_t txToken = 0;
+    uint64_t txUntilMs = 0;
+    uint32_t rxActive = 0; // Signals we are hearing right now, decodable or not
+
+    // Channel utilization over the last minute, in 6 s buckets
+    uint32_t busyMs[10] = {0};
+    uint64_t busyEpoch[10] = {0};
+
+    bool wasSeenRecently(const SimPacket &p, bool *wasFallback = nullptr, bool *weWereNextHop = nullptr);
+    bool wasRelayer(uint8_t relayer, PacketId id, NodeNum sender) const;
+    uint8_t getNextHop(const SimPacket &p, uint8_t failedHop = NO_NEXT_HOP_PREFERENCE);
+    void learnNextHop(const SimPacket &p, float snr);
+    void updateNodeNextHop(NodeNum dest);
+    uint8_t getHopLimitForResponse(uint8_t hopStart, uint8_t hopLimit) const;
+
+    void originate(const SimPacket &p);
+    void send(SimPacket p, bool relay, uint32_t delayMs);
+    bool perhapsRelay(const SimPacket &p, float snr);
+    void perhapsCancelDupe(const SimPacket &p);
+    RebroadcastSuppressor::Verdict judgeRebroadcast(const SimPacket &p);
+    bool cancelSending(NodeNum from, PacketId id);
+    bool isInTxQueue(NodeNum from, PacketId id) const;
+    void sendAck(const SimPacket &p, uint8_t hopLimit);
+
+    void startRetransmission(const SimPacket &p, uint8_t numReTx);
+    void stopRetransmission(NodeNum from, PacketId id);
+    void onRetransmissionTimeout(std::pair<NodeNum, PacketId> key, uint64_t token);
+
+    void kickTransmitter();
+    void tryTransmit(uint64_t token);
+
+    void onReceive(const SimPacket &p, float snr);
+
+    void addBusy(uint64_t startMs, uint64_t endMs);
+    float channelUtilizationPercent() const;
+    uint32_t txDelayMsec();
+    uint32_t txDelayMsecWeighted(float snr);
+    uint32_t retransmissionMsec(const SimPacket &p);
+};
+
+class MeshSim
+{
+  public:
+    struct Config {
+        SimRadioParams radio;
+        bool nextHopRouting = true;       // NextHopRouter rules, or plain FloodingRouter ones
+        bool adaptiveContention = true;   // Size contention windows as ContentionWindow does, or only from utilization and SNR
+        bool suppressRebroadcasts = true; // Let RebroadcastSuppressor cancel relays, or only cancel on any duplicate as before
+        bool multiPathNextHops = true;    // Keep scored alternates per destination, or only the last next hop as before
+        uint8_t hopLimit = 3;
+        uint32_t seed = 1;
+    };
+
+    explicit MeshSim(const Config &config);
+    ~MeshSim();
+
+    size_t addNode(float x, float y,
+                   meshtastic_Config_DeviceConfig_Role role = meshtastic_Config_DeviceConfig_Role_CLIENT);
+    /// Nodes spaced evenly on a cols x rows grid
+    void addGrid(size_t cols, size_t rows, float spacing);
+    /// Nodes dropped uniformly at random on a width x height area
+    void addRandom(size_t count, float width, float height);
+
+    size_t numNodes() const { return nodes.size(); }
+    SimNode &node(size_t index) { return *nodes[index]; }
+
+    /**
+     * Every node tells its neighbors who its neighbors are, as NeighborInfoModule does. Each one lists the
+     * REBROADCAST_NEIGHBORS_PER_NODE it hears best.
+     */
+    void exchangeNeighborInfo();
+
+    /// Send a packet from node index from, to a node index or to everyone
+    PacketId sendBroadcast(size_t from, uint8_t payloadLen = 40);
+    PacketId sendDirect(size_t from, size_t to, bool wantAck = true, uint8_t payloadLen = 40);
+
+    /// Advance the virtual clock, running everything scheduled until then
+    void runFor(uint32_t ms);
+    /// Run until nothing is left to do or maxMs have passed
+    void runUntilIdle(uint32_t maxMs = 60 * 60 * 1000);
+
+    uint64_t now() const { return nowMs; }
+    const SimStats &getStats() const { return stats; }
+
+    /// SNR of a transmission by node a as heard by node b, NAN if b can't hear it
+    float linkSnr(size_t a, size_t b);
+
+    /// How many nodes other than the sender got this packet, and how long it took to reach the last of them
+    size_t numReached(PacketId id) const;
+    uint64_t reachLatencyMs(PacketId id) const;
+    bool wasAcked(PacketId id) const;
+
+    uint32_t airtimeMsec(const SimPacket &p) const;
+
+  private:
+    friend class SimNode;
+
+    struct Event {
+        uint64_t atMs;
+        uint64_t seq;
+        std::function<void()> fn;
+        bool operator>(const Event &o) const { return atMs != o.atMs ? atMs > o.atMs : seq > o.seq; }
+    };
+
+    struct Reception {
+        SimPacket packet;
+        size_t sender;
+        uint64_t endMs;
+        float snr;
+        bool lost;
+        bool collided; // Lost to an overlapping transmission, the receiver notices a CRC error
+    };
+
+    struct Trace {
+        uint64_t sentMs;
+        std::map<size_t, uint64_t> reached;
+        bool acked;
+    };
+
+    class Timing;
+
+    Config config;
+    std::unique_ptr<Timing> timing;
+    std::vector<std::unique_ptr<SimNode>> nodes;
+    std::vector<float> snrCache; // nodes x nodes, row is the transmitter
+    std::vector<std::vector<std::shared_ptr<Reception>>> receiving;
+    std::map<PacketId, Trace> traces;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    std::mt19937 rng;
+    uint64_t nowMs = 0;
+    uint64_t eventSeq = 0;
+    PacketId nextId = 1;
+    SimStats stats;
+
+    void schedule(uint32_t delayMs, std::function<void()> fn);
+    void transmit(size_t sender, const SimPacket &p);
+    void noteReceived(size_t index, const SimPacket &p);
+    void updateSnrCache();
+    uint32_t random(uint32_t min, uint32_t max) { return min + rng() % (max - min); }
+};
@@ -0,0 +1,483 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include "MeshSim.h"
+#include <Arduino.h>
+
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+namespace
+{
+// 3 km is a comfortable LongFast link with the default path loss, 6 km is out of range
+const float SPACING = 3000;
+
+MeshSim::Config defaultConfig()
+{
+    MeshSim::Config config;
+    config.seed = 1;
+    return config;
+}
+
+/// What the benchmark numbers do and don't cover, so they aren't read as measurements of the firmware itself
+void noteSimulatedRules()
+{
+    TEST_MESSAGE("Model results: routing rules are MeshSim's copy of FloodingRouter, NextHopRouter and ReliableRouter, "
+                 "not the routers themselves; only NextHopTable, RebroadcastSuppressor, ContentionWindow and airtime run "
+                 "the firmware's own code");
+}
+
+void addLine(MeshSim &sim, size_t count, float spacing)
+{
+    for (size_t i = 0; i < count; i++)
+        sim.addNode(i * spacing, 0);
+}
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_linkBudget(void)
+{
+    MeshSim sim(defaultConfig());
+    addLine(sim, 3, SPACING);
+    TEST_ASSERT_FALSE(isnan(sim.linkSnr(0, 1)));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, sim.linkSnr(0, 1), sim.linkSnr(1, 0));
+    TEST_ASSERT_TRUE(isnan(sim.linkSnr(0, 2)));
+}
+
+// A broadcast on a line can't get further than its hop limit allows
+void test_lineHopLimit(void)
+{
+    MeshSim sim(defaultConfig());
+    addLine(sim, 6, SPACING);
+    PacketId id = sim.sendBroadcast(0);
+    sim.runUntilIdle();
+    TEST_ASSERT_EQUAL(4, sim.numReached(id));
+    TEST_ASSERT_EQUAL(4, sim.getStats().transmissions);
+    TEST_ASSERT_GREATER_THAN(3 * sim.airtimeMsec(SimPacket()), sim.reachLatencyMs(id));
+}
+
+// Same seed, same run
+void test_deterministic(void)
+{
+    SimStats a, b;
+    for (SimStats *s : {&a, &b}) {
+        MeshSim sim(defaultConfig());
+        sim.addRandom(60, 15000, 15000);
+        for (int i = 0; i < 10; i++) {
+            sim.sendBroadcast(i);
+            sim.runFor(2000);
+        }
+        sim.runUntilIdle();
+        *s = sim.getStats();
+    }
+    TEST_ASSERT_EQUAL(a.transmissions, b.transmissions);
+    TEST_ASSERT_EQUAL(a.receptions, b.receptions);
+    TEST_ASSERT_EQUAL(a.collisions, b.collisions);
+    TEST_ASSERT_EQUAL(a.relaysCanceled, b.relaysCanceled);
+}
+
+// Two nodes that can't hear each other both talk to the one in the middle at once
+void test_hiddenTerminalCollision(void)
+{
+    MeshSim::Config config = defaultConfig();
+    config.hopLimit = 0;
+    MeshSim sim(config);
+    size_t a = sim.addNode(-SPACING, 0);
+    sim.addNode(0, 0);
+    size_t c = sim.addNode(SPACING, 0);
+
+    sim.sendBroadcast(a);
+    sim.sendBroadcast(c);
+    sim.runUntilIdle();
+    TEST_ASSERT_EQUAL(0, sim.getStats().receptions);
+    TEST_ASSERT_EQUAL(2, sim.getStats().collisions);
+}
+
+// Same thing, but one of them is much closer so its packet survives
+void test_capture(void)
+{
+    MeshSim::Config config = defaultConfig();
+    config.hopLimit = 0;
+    MeshSim sim(config);
+    size_t a = sim.addNode(-2000, 0);
+    sim.addNode(0, 0);
+    size_t c = sim.addNode(4000, 0);
+
+    PacketId near = sim.sendBroadcast(a);
+    PacketId far = sim.sendBroadcast(c);
+    sim.runUntilIdle();
+    TEST_ASSERT_EQUAL(1, sim.numReached(near));
+    TEST_ASSERT_EQUAL(0, sim.numReached(far));
+    TEST_ASSERT_EQUAL(1, sim.getStats().collisions);
+}
+
+// Once a DM has been acked the sender knows who to hand the next one to, with plain flooding it never learns
+void test_nextHopLearnsRoute(void)
+{
+    for (bool nextHop : {false, true}) {
+        MeshSim::Config config = defaultConfig();
+        config.nextHopRouting = nextHop;
+        MeshSim sim(config);
+        addLine(sim, 4, SPACING);
+
+        for (int i = 0; i < 3; i++) {
+            PacketId id = sim.sendDirect(0, 3);
+            sim.runUntilIdle();
+            TEST_ASSERT_TRUE(sim.wasAcked(id));
+        }
+        auto &nextHops = sim.node(0).nextHops;
+        if (nextHop) {
+            TEST_ASSERT_EQUAL(1, nextHops.count(sim.node(3).num));
+            TEST_ASSERT_EQUAL(sim.node(1).relayId(), nextHops[sim.node(3).num]);
+        } else {
+            TEST_ASSERT_EQUAL(0, nextHops.size());
+        }
+    }
+}
+
+// Two routers between a pair that can't hear each other: both become next hops, and when the better one goes away the
+// sender moves over to the other
+void test_nextHopFailover(void)
+{
+    for (bool multiPath : {false, true}) {
+        MeshSim::Config config = defaultConfig();
+        config.multiPathNextHops = multiPath;
+        MeshSim sim(config);
+        sim.addNode(0, 0);
+        sim.addNode(SPACING, 1000, meshtastic_Config_DeviceConfig_Role_ROUTER);
+        sim.addNode(SPACING, -1000, meshtastic_Config_DeviceConfig_Role_ROUTER);
+        sim.addNode(2 * SPACING, 0);
+        NodeNum dest = sim.node(3).num;
+
+        for (int i = 0; i < 3; i++) {
+            PacketId id = sim.sendDirect(0, 3);
+            sim.runUntilIdle();
+            TEST_ASSERT_TRUE(sim.wasAcked(id));
+        }
+        SimNode &sender = sim.node(0);
+        TEST_ASSERT_EQUAL(1, sender.nextHops.count(dest));
+        uint8_t primary = sender.nextHops[dest];
+        uint8_t alternate = primary == sim.node(1).relayId() ? sim.node(2).relayId() : sim.node(1).relayId();
+        if (multiPath) {
+            TEST_ASSERT_GREATER_THAN(0, sender.routes.getDeliveryPercent(dest, alternate, sim.now()));
+            TEST_ASSERT_LESS_THAN(sender.routes.getCost(dest, alternate, sim.now()),
+                                  sender.routes.getCost(dest, primary, sim.now()));
+        }
+
+        sim.node(primary - 1).down = true;
+        PacketId id = sim.sendDirect(0, 3);
+        sim.runUntilIdle();
+        TEST_ASSERT_TRUE(sim.wasAcked(id));
+        // The final retry floods, so the other router relays ours as well. Rather than forgetting the route and flooding
+        // until the next ACK, the sender then goes through it.
+        id = sim.sendDirect(0, 3);
+        sim.runUntilIdle();
+        TEST_ASSERT_TRUE(sim.wasAcked(id));
+        if (multiPath) {
+            TEST_ASSERT_EQUAL(alternate, sender.nextHops[dest]);
+        } else {
+            TEST_ASSERT_TRUE(!sender.nextHops.count(dest) || sender.nextHops[dest] == alternate);
+        }
+    }
+}
+
+// The next hop of a relayer in the middle of the route goes away: the relayer's last retry floods, and a node that heard
+// its first attempt takes over as in NextHopRouter's fallback to flooding
+void test_nextHopFallbackRelay(void)
+{
+    MeshSim sim(defaultConfig());
+    addLine(sim, 4, SPACING);
+    // Hears 1 and 3 but not 0, and stays out of the route while it is learned
+    sim.addNode(2 * SPACING, 2500, meshtastic_Config_DeviceConfig_Role_CLIENT_MUTE);
+    for (int i = 0; i < 3; i++) {
+        PacketId id = sim.sendDirect(0, 3);
+        sim.runUntilIdle();
+        TEST_ASSERT_TRUE(sim.wasAcked(id));
+    }
+    TEST_ASSERT_EQUAL(sim.node(2).relayId(), sim.node(1).nextHops[sim.node(3).num]);
+
+    sim.node(4).role = meshtastic_Config_DeviceConfig_Role_CLIENT;
+    sim.node(2).down = true;
+    PacketId id = sim.sendDirect(0, 3);
+    sim.runUntilIdle();
+    TEST_ASSERT_TRUE(sim.wasAcked(id));
+}
+
+// Routers all around a sender, each hearing everyone else: once their neighbor lists are known none of them needs to relay
+void test_suppressCoveredRelays(void)
+{
+    for (bool suppress : {false, true}) {
+        MeshSim::Config config = defaultConfig();
+        config.suppressRebroadcasts = suppress;
+        MeshSim sim(config);
+        sim.addNode(0, 0);
+        for (int i = 0; i < 4; i++)
+            sim.addNode(i % 2 ? 500 : -500, i / 2 ? 500 : -500, meshtastic_Config_DeviceConfig_Role_ROUTER);
+        sim.exchangeNeighborInfo();
+
+        PacketId id = sim.sendBroadcast(0);
+        sim.runUntilIdle();
+        TEST_ASSERT_EQUAL(4, sim.numReached(id));
+        TEST_ASSERT_EQUAL(suppress ? 1 : 5, sim.getStats().transmissions);
+        TEST_ASSERT_EQUAL(suppress ? 4 : 0, sim.getStats().relaysSuppressed);
+    }
+}
+
+// Not a pass/fail test: reports how both routing schemes cope with a busy mesh of a few hundred nodes
+void test_benchmarkScale(void)
+{
+    noteSimulatedRules();
+    const size_t numNodes = 300;
+    const size_t numPairs = 10;
+    const int numPackets = 100;
+
+    for (bool nextHop : {false, true}) {
+        MeshSim::Config config = defaultConfig();
+        config.nextHopRouting = nextHop;
+        MeshSim sim(config);
+        sim.addRandom(numNodes, 20000, 20000);
+
+        // Every other packet is a DM within a few fixed pairs, so there are routes worth learning
+        uint32_t start = millis();
+        std::vector<PacketId> ids;
+        for (int i = 0; i < numPackets; i++) {
+            size_t from = i % numNodes;
+            size_t pair = (i / 2) % numPairs;
+            ids.push_back(i % 2 ? sim.sendDirect(pair, numNodes - 1 - pair) : sim.sendBroadcast(from));
+            sim.runFor(15000);
+        }
+        sim.runUntilIdle();
+        uint32_t elapsed = millis() - start;
+
+        size_t reached = 0, acked = 0;
+        for (int i = 0; i < numPackets; i++) {
+            if (i % 2)
+                acked += sim.wasAcked(ids[i]);
+            else
+                reached += sim.numReached(ids[i]);
+        }
+        const SimStats &s = sim.getStats();
+        char msg[256];
+        snprintf(msg, sizeof(msg),
+                 "%s, %u nodes: broadcasts reach %.1f%%, %u/%u DMs acked, %.1f tx per packet, %u collisions, %u canceled "
+                 "relays, %u s simulated in %u ms",
+                 nextHop ? "next hop" : "flooding", (unsigned)numNodes, 100.0 * reached / (numPackets / 2) / (numNodes - 1),
+                 (unsigned)acked, numPackets / 2, (double)s.transmissions / numPackets, s.collisions, s.relaysCanceled,
+                 (unsigned)(sim.now() / 1000), elapsed);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_EQUAL(numPackets, s.originated);
+    }
+}
+
+// Not a pass/fail test: delivery and latency of the fixed contention windows against ContentionWindow, from a sparse mesh
+// to a crowded one, with the same layout and traffic for both
+void test_benchmarkContention(void)
+{
+    noteSimulatedRules();
+    const int numPackets = 120;
+
+    for (size_t numNodes : {50, 150, 300}) {
+        for (bool adaptive : {false, true}) {
+            MeshSim::Config config = defaultConfig();
+            config.adaptiveContention = adaptive;
+            MeshSim sim(config);
+            sim.addRandom(numNodes, 15000, 15000);
+
+            // Bursty: a handful of packets from different corners of the mesh close together, then a pause
+            std::vector<PacketId> ids;
+            for (int i = 0; i < numPackets; i++) {
+                size_t from = (i * 37) % numNodes;
+                ids.push_back(i % 3 ? sim.sendBroadcast(from) : sim.sendDirect(from, numNodes - 1 - from));
+                sim.runFor(i % 4 == 3 ? 30000 : 1000);
+            }
+            sim.runUntilIdle();
+
+            size_t broadcasts = 0, reached = 0, acked = 0;
+            uint64_t latencyMs = 0;
+            for (int i = 0; i < numPackets; i++) {
+                if (i % 3) {
+                    broadcasts++;
+                    reached += sim.numReached(ids[i]);
+                    latencyMs += sim.reachLatencyMs(ids[i]);
+                } else {
+                    acked += sim.wasAcked(ids[i]);
+                }
+            }
+            const SimStats &s = sim.getStats();
+            char msg[256];
+            snprintf(msg, sizeof(msg),
+                     "%s, %u nodes: broadcasts reach %.1f%% in %u ms, %u/%u DMs acked in %u ms, %u collisions, %u "
+                     "retransmissions",
+                     adaptive ? "adaptive" : "fixed", (unsigned)numNodes, 100.0 * reached / broadcasts / (numNodes - 1),
+                     (unsigned)(latencyMs / broadcasts), (unsigned)acked, (unsigned)(numPackets - broadcasts),
+                     (unsigned)(s.delivered ? s.deliveryLatencyMs / s.delivered : 0), s.collisions, s.retransmissions);
+            TEST_MESSAGE(msg);
+            TEST_ASSERT_EQUAL(numPackets, s.originated);
+        }
+    }
+}
+
+// Not a pass/fail test: reach and airtime with and without RebroadcastSuppressor, from a sparse mesh to a crowded one
+// where a quarter of the nodes are routers. On the default channel no NeighborInfo goes over LoRa, so the suppressor
+// only has the relays it heard to go by; with NeighborInfo it also knows the neighbor lists.
+void test_benchmarkSuppression(void)
+{
+    noteSimulatedRules();
+    const int numPackets = 60;
+    const char *modes[] = {"cancel on dupe", "suppression from relays", "suppression with NeighborInfo"};
+
+    for (size_t numNodes : {50, 150, 300}) {
+        for (int mode = 0; mode < 3; mode++) {
+            MeshSim::Config config = defaultConfig();
+            config.suppressRebroadcasts = mode > 0;
+            MeshSim sim(config);
+            std::mt19937 rng(numNodes);
+            std::uniform_real_distribution<float> pos(0, 15000);
+            for (size_t i = 0; i < numNodes; i++) {
+                float x = pos(rng);
+                sim.addNode(x, pos(rng),
+                            i % 4 ? meshtastic_Config_DeviceConfig_Role_CLIENT : meshtastic_Config_DeviceConfig_Role_ROUTER);
+            }
+            if (mode == 2)
+                sim.exchangeNeighborInfo();
+            // Every node announces itself once, as it does with NodeInfo, before we start counting
+            for (size_t i = 0; i < numNodes; i++) {
+                sim.sendBroadcast(i);
+                sim.runUntilIdle();
+            }
+            SimStats before = sim.getStats();
+
+            size_t reached = 0;
+            uint64_t latencyMs = 0;
+            for (int i = 0; i < numPackets; i++) {
+                PacketId id = sim.sendBroadcast((i * 37) % numNodes);
+                sim.runUntilIdle();
+                reached += sim.numReached(id);
+                latencyMs += sim.reachLatencyMs(id);
+            }
+
+            const SimStats &s = sim.getStats();
+            char msg[256];
+            snprintf(msg, sizeof(msg),
+                     "%s, %u nodes: broadcasts reach %.1f%% in %u ms, %.1f tx and %.1f s airtime per packet, %u relays "
+                     "suppressed, %u canceled",
+                     modes[mode], (unsigned)numNodes, 100.0 * reached / numPackets / (numNodes - 1),
+                     (unsigned)(latencyMs / numPackets), (double)(s.transmissions - before.transmissions) / numPackets,
+                     (s.airtimeMs - before.airtimeMs) / 1000.0 / numPackets, s.relaysSuppressed - before.relaysSuppressed,
+                     s.relaysCanceled - before.relaysCanceled);
+            TEST_MESSAGE(msg);
+            TEST_ASSERT_EQUAL(numPackets, s.originated - before.originated);
+        }
+    }
+}
+
+// DMs between fixed pairs across a large mesh, after which the first relay of every route goes away. With only the last
+// next hop, every pair floods until an ACK teaches a new one; with alternates it mostly doesn't. Fails only if alternates
+// get fewer DMs acked than the single next hop on the same mesh.
+void test_benchmarkFailover(void)
+{
+    noteSimulatedRules();
+    const size_t numPairs = 20;
+
+    for (size_t numNodes : {150, 300}) {
+        size_t ackedSingle = 0;
+        for (bool multiPath : {false, true}) {
+            MeshSim::Config config = defaultConfig();
+            config.multiPathNextHops = multiPath;
+            MeshSim sim(config);
+            std::mt19937 rng(numNodes);
+            std::uniform_real_distribution<float> pos(0, 15000);
+            for (size_t i = 0; i < numNodes; i++) {
+                float x = pos(rng);
+                sim.addNode(x, pos(rng),
+                            i % 4 ? meshtastic_Config_DeviceConfig_Role_CLIENT : meshtastic_Config_DeviceConfig_Role_ROUTER);
+            }
+            sim.exchangeNeighborInfo();
+
+            // Pairs more than one hop apart, each learning its routes from a few DMs
+            std::vector<std::pair<size_t, size_t>> pairs;
+            for (size_t i = 0; pairs.size() < numPairs; i++) {
+                size_t from = (i * 7) % numNodes, to = (i * 13 + 5) % numNodes;
+                if (to != from && isnan(sim.linkSnr(from, to)))
+                    pairs.push_back(std::make_pair(from, to));
+            }
+            for (int round = 0; round < 3; round++) {
+                for (auto &pair : pairs) {
+                    sim.sendDirect(pair.first, pair.second);
+                    sim.runUntilIdle();
+                }
+            }
+
+            SimStats before = sim.getStats();
+            size_t acked = 0, numSent = 0;
+            for (auto &pair : pairs) {
+                SimNode &from = sim.node(pair.first);
+                auto nextHop = from.nextHops.find(sim.node(pair.second).num);
+                size_t relay = nextHop == from.nextHops.end() ? numNodes : nextHop->second - 1;
+                if (relay < numNodes && relay != pair.second)
+                    sim.node(relay).down = true;
+                for (int i = 0; i < 3; i++) {
+                    PacketId id = sim.sendDirect(pair.first, pair.second);
+                    sim.runUntilIdle();
+                    acked += sim.wasAcked(id);
+                    numSent++;
+                }
+                if (relay < numNodes)
+                    sim.node(relay).down = false;
+            }
+
+            const SimStats &s = sim.getStats();
+            char msg[256];
+            snprintf(msg, sizeof(msg),
+                     "%s, %u nodes: with the first relay gone %u/%u DMs acked, %.1f tx and %.1f s airtime per DM, %u "
+                     "retransmissions",
+                     multiPath ? "alternates" : "single next hop", (unsigned)numNodes, (unsigned)acked, (unsigned)numSent,
+                     (double)(s.transmissions - before.transmissions) / numSent,
+                     (s.airtimeMs - before.airtimeMs) / 1000.0 / numSent, s.retransmissions - before.retransmissions);
+            TEST_MESSAGE(msg);
+            if (multiPath)
+                TEST_ASSERT_GREATER_OR_EQUAL(ackedSingle, acked);
+            else
+                ackedSingle = acked;
+        }
+    }
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    // The slot time depends on the region
+    initRegion();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_linkBudget);
+    RUN_TEST(test_lineHopLimit);
+    RUN_TEST(test_deterministic);
+    RUN_TEST(test_hiddenTerminalCollision);
+    RUN_TEST(test_capture);
+    RUN_TEST(test_nextHopLearnsRoute);
+    RUN_TEST(test_nextHopFailover);
+    RUN_TEST(test_nextHopFallbackRelay);
+    RUN_TEST(test_suppressCoveredRelays);
+    RUN_TEST(test_benchmarkScale);
+    RUN_TEST(test_benchmarkContention);
+    RUN_TEST(test_benchmarkSuppression);
+    RUN_TEST(test_benchmarkFailover);
+    exit(UNITY_END());
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires ARCH_PORTDUINO");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+void loop() {}
@@ -0,0 +1,213 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#ifdef ARCH_PORTDUINO
+#include "mesh/MeshModule.h"
+#include "mesh/NodeDB.h"
+#include "mesh/SinglePortModule.h"
+#include <Arduino.h>
+
+#include <memory>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Minimal NodeDB needed by callModules
+class MockNodeDB : public NodeDB
+{
+  public:
+    meshtastic_NodeInfoLite *getMeshNode(NodeNum n) override { return &emptyNode; }
+    meshtastic_NodeInfoLite emptyNode = {};
+};
+
+// Names of the modules that handled the last packet, in call order
+std::vector<std::string> handledBy;
+
+class PortModule : public SinglePortModule
+{
+  public:
+    PortModule(const char *_name, meshtastic_PortNum port, bool _wants = true) : SinglePortModule(_name, port), wants(_wants)
+    {
+    }
+    int asked = 0;
+
+  protected:
+    bool wants;
+
+    bool wantPacket(const meshtastic_MeshPacket *p) override
+    {
+        asked++;
+        return wants && SinglePortModule::wantPacket(p);
+    }
+    ProcessMessage handleReceived(const meshtastic_MeshPacket &mp) override
+    {
+        handledBy.push_back(name);
+        return ProcessMessage::CONTINUE;
+    }
+};
+
+// Like RoutingModule: looks at everything, including what we can't decode
+class SniffModule : public MeshModule
+{
+  public:
+    SniffModule(const char *_name, bool _wants = true) : MeshModule(_name), wants(_wants)
+    {
+        isPromiscuous = true;
+        encryptedOk = true;
+    }
+    int asked = 0;
+
+  protected:
+    bool wants;
+
+    bool wantPacket(const meshtastic_MeshPacket *p) override
+    {
+        asked++;
+        return wants;
+    }
+    ProcessMessage handleReceived(const meshtastic_MeshPacket &mp) override
+    {
+        handledBy.push_back(name);
+        return ProcessMessage::CONTINUE;
+    }
+};
+
+meshtastic_MeshPacket makePacket(meshtastic_PortNum port)
+{
+    meshtastic_MeshPacket p = meshtastic_MeshPacket_init_default;
+    p.from = 0x1234;
+    p.to = NODENUM_BROADCAST;
+    p.id = 42;
+    p.which_payload_variant = meshtastic_MeshPacket_decoded_tag;
+    p.decoded.portnum = port;
+    return p;
+}
+
+void dispatch(meshtastic_MeshPacket p)
+{
+    handledBy.clear();
+    MeshModule::callModules(p, RX_SRC_RADIO);
+}
+} // namespace
+
+void setUp(void)
+{
+    handledBy.clear();
+}
+void tearDown(void) {}
+
+// Modules must be called in registration order, whether they filter on portnum or not
+void test_registrationOrder(void)
+{
+    PortModule a("a", meshtastic_PortNum_TEXT_MESSAGE_APP);
+    SniffModule s("s");
+    PortModule b("b", meshtastic_PortNum_TEXT_MESSAGE_APP);
+    PortModule c("c", meshtastic_PortNum_POSITION_APP);
+
+    dispatch(makePacket(meshtastic_PortNum_TEXT_MESSAGE_APP));
+    TEST_ASSERT_EQUAL(3, handledBy.size());
+    TEST_ASSERT_EQUAL_STRING("a", handledBy[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("s", handledBy[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("b", handledBy[2].c_str());
+    TEST_ASSERT_EQUAL(0, c.asked);
+
+    dispatch(makePacket(meshtastic_PortNum_POSITION_APP));
+    TEST_ASSERT_EQUAL(2, handledBy.size());
+    TEST_ASSERT_EQUAL_STRING("s", handledBy[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("c", handledBy[1].c_str());
+    TEST_ASSERT_EQUAL(1, a.asked);
+
+    // Nobody registered for this one but the sniffer
+    dispatch(makePacket(meshtastic_PortNum_PRIVATE_APP));
+    TEST_ASSERT_EQUAL(1, handledBy.size());
+    TEST_ASSERT_EQUAL_STRING("s", handledBy[0].c_str());
+    TEST_ASSERT_EQUAL(1, a.asked);
+    TEST_ASSERT_EQUAL(1, c.asked);
+}
+
+void test_encryptedOnlyToEncryptedOk(void)
+{
+    PortModule a("a", meshtastic_PortNum_TEXT_MESSAGE_APP);
+    SniffModule s("s");
+
+    meshtastic_MeshPacket p = makePacket(meshtastic_PortNum_TEXT_MESSAGE_APP);
+    p.which_payload_variant = meshtastic_MeshPacket_encrypted_tag;
+    dispatch(p);
+    TEST_ASSERT_EQUAL(1, handledBy.size());
+    TEST_ASSERT_EQUAL_STRING("s", handledBy[0].c_str());
+    TEST_ASSERT_EQUAL(0, a.asked);
+}
+
+void test_reindexOnRegistration(void)
+{
+    PortModule a("a", meshtastic_PortNum_TEXT_MESSAGE_APP);
+    {
+        PortModule b("b", meshtastic_PortNum_TEXT_MESSAGE_APP);
+        dispatch(makePacket(meshtastic_PortNum_TEXT_MESSAGE_APP));
+        TEST_ASSERT_EQUAL(2, handledBy.size());
+    }
+    dispatch(makePacket(meshtastic_PortNum_TEXT_MESSAGE_APP));
+    TEST_ASSERT_EQUAL(1, handledBy.size());
+
+    SniffModule s("s");
+    dispatch(makePacket(meshtastic_PortNum_TEXT_MESSAGE_APP));
+    TEST_ASSERT_EQUAL(2, handledBy.size());
+    TEST_ASSERT_EQUAL_STRING("s", handledBy[1].c_str());
+}
+
+// Not a pass/fail test: reports the per packet cost of finding the interested modules
+void test_benchmarkDispatch(void)
+{
+    // Roughly a full build: one module per portnum, plus a couple that look at everything but rarely want it
+    const int numPorts = 32;
+    std::vector<std::unique_ptr<PortModule>> portModules;
+    for (int i = 0; i < numPorts; i++)
+        portModules.emplace_back(new PortModule("port", (meshtastic_PortNum)(meshtastic_PortNum_PRIVATE_APP + 1 + i), false));
+    SniffModule canned("canned", false), neighbors("neighbors", false);
+
+    const int rounds = 20000;
+    meshtastic_MeshPacket p = makePacket(meshtastic_PortNum_PRIVATE_APP);
+    uint32_t start = micros();
+    for (int r = 0; r < rounds; r++) {
+        p.decoded.portnum = (meshtastic_PortNum)(meshtastic_PortNum_PRIVATE_APP + 1 + r % numPorts);
+        MeshModule::callModules(p, RX_SRC_RADIO);
+    }
+    uint32_t elapsed = micros() - start;
+
+    int asked = canned.asked + neighbors.asked;
+    for (auto &m : portModules)
+        asked += m->asked;
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%d modules: %u ns per packet, %.1f wantPacket() calls per packet", numPorts + 2,
+             (unsigned)((uint64_t)elapsed * 1000 / rounds), (double)asked / rounds);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL(rounds * 3, asked);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    const std::unique_ptr<MockNodeDB> mockNodeDB(new MockNodeDB());
+    nodeDB = mockNodeDB.get();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_registrationOrder);
+    RUN_TEST(test_encryptedOnlyToEncryptedOk);
+    RUN_TEST(test_reindexOnRegistration);
+    RUN_TEST(test_benchmarkDispatch);
+    exit(UNITY_END());
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires ARCH_PORTDUINO");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+void loop() {}
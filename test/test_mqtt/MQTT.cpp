@@ -7,6 +7,7 @@
 #include "mesh/Default.h"
 #include "mesh/MeshService.h"
 #include "mesh/NodeDB.h"
+#include "mesh/PayloadCompression.h"
 #include "mesh/Router.h"
 #include "modules/RoutingModule.h"
 #include "mqtt/MQTT.h"
@@ -371,6 +372,35 @@ void test_sendDirectlyConnectedEncrypted(void)
     TEST_ASSERT_EQUAL(encrypted.id, env.packet->id);
 }
 
+#if !MESHTASTIC_EXCLUDE_COMPRESSION
+// A packet that went out or arrived compressed is published encrypted with its original payload, for clients that
+// can't decompress it.
+void test_sendCompressedEncryptedAsOriginal(void)
+{
+    moduleConfig.mqtt.encryption_enabled = true;
+    meshtastic_MeshPacket p = decoded;
+    p.id = 40; // Remembered as compressed from now on, keep it away from the other tests' packets
+    memcpy(p.decoded.payload.bytes, "hello", 5);
+    p.decoded.payload.size = 5;
+    payloadCompression.noteCompressed(p.from, p.id);
+
+    mqtt->onSend(encrypted, p, 0);
+
+    TEST_ASSERT_EQUAL(1, pubsub->published_.size());
+    const DecodedServiceEnvelope &env = std::get<DecodedServiceEnvelope>(pubsub->published_.front().second);
+    TEST_ASSERT_TRUE(env.validDecode);
+    TEST_ASSERT_EQUAL(p.id, env.packet->id);
+    TEST_ASSERT_EQUAL(meshtastic_MeshPacket_encrypted_tag, env.packet->which_payload_variant);
+    // The test channel has no PSK, so the encrypted bytes are the encoded Data as is
+    meshtastic_Data data = meshtastic_Data_init_zero;
+    TEST_ASSERT_TRUE(
+        pb_decode_from_bytes(env.packet->encrypted.bytes, env.packet->encrypted.size, &meshtastic_Data_msg, &data));
+    TEST_ASSERT_EQUAL(5, data.payload.size);
+    TEST_ASSERT_EQUAL_MEMORY("hello", data.payload.bytes, 5);
+    TEST_ASSERT_FALSE(data.bitfield & BITFIELD_COMPRESSED_MASK);
+}
+#endif
+
 // Verify that the decoded MeshPacket is proxied through the MeshService when encryption_enabled = false.
 void test_proxyToMeshServiceDecoded(void)
 {
@@ -660,6 +690,93 @@ void test_receiveIgnoresInvalidHopLimit(void)
     TEST_ASSERT_TRUE(mockRouter->packets_.empty());
 }
 
+// Copies of a packet republished by other gateways are dropped.
+void test_receiveIgnoresDuplicates(void)
+{
+    unitTest->publish(&decoded, "!87654321");
+    unitTest->publish(&decoded, "!87654322");
+    unitTest->publish(&encrypted, "!87654323");
+
+    TEST_ASSERT_EQUAL(2, mockRouter->packets_.size());
+}
+
+// A packet we didn't take isn't remembered, so a later copy still gets through.
+void test_receiveDuplicateAfterRejected(void)
+{
+    meshtastic_MeshPacket p = decoded;
+    p.hop_limit = 10;
+    unitTest->publish(&p);
+    unitTest->publish(&decoded);
+
+    TEST_ASSERT_EQUAL(1, mockRouter->packets_.size());
+}
+
+// A decoded copy we reject doesn't hide the encrypted copy of the same packet that follows.
+void test_receiveEncryptedAfterRejectedDecoded(void)
+{
+    moduleConfig.mqtt.encryption_enabled = true;
+    meshtastic_MeshPacket d = decoded;
+    d.id = encrypted.id;
+    d.to = myNodeInfo.my_node_num;
+    meshtastic_MeshPacket e = encrypted;
+    e.to = myNodeInfo.my_node_num;
+
+    unitTest->publish(&d);
+    unitTest->publish(&e, "!87654322", "PKI");
+
+    TEST_ASSERT_EQUAL(1, mockRouter->packets_.size());
+    const meshtastic_MeshPacket &p = mockRouter->packets_.front();
+    TEST_ASSERT_EQUAL(meshtastic_MeshPacket_encrypted_tag, p.which_payload_variant);
+}
+
+// The packet's from and id are read without decoding the envelope.
+void test_peekServiceEnvelopePacket(void)
+{
+    meshtastic_MeshPacket p = encrypted;
+    p.from = 0x12345678;
+    p.id = 0x9abcdef0;
+    p.hop_limit = 3;
+    p.encrypted.size = 10;
+    const meshtastic_ServiceEnvelope env = {.packet = &p, .channel_id = "test", .gateway_id = "!87654321"};
+    uint8_t bytes[256];
+    size_t numBytes = pb_encode_to_bytes(bytes, sizeof(bytes), &meshtastic_ServiceEnvelope_msg, &env);
+
+    uint32_t from, id;
+    TEST_ASSERT_TRUE(peekServiceEnvelopePacket(bytes, numBytes, &from, &id));
+    TEST_ASSERT_EQUAL_HEX32(p.from, from);
+    TEST_ASSERT_EQUAL_HEX32(p.id, id);
+
+    // Truncated anywhere, it never reads past the end
+    for (size_t len = 0; len < numBytes; len++)
+        peekServiceEnvelopePacket(bytes, len, &from, &id);
+    TEST_ASSERT_FALSE(peekServiceEnvelopePacket(bytes, 0, &from, &id));
+}
+
+// Entries are forgotten once they expire, or when their buckets fill up.
+void test_recentPacketFilter(void)
+{
+    RecentPacketFilter filter;
+    filter.add(1, 100, 0);
+    TEST_ASSERT_TRUE(filter.contains(1, 100, 0));
+    TEST_ASSERT_FALSE(filter.contains(2, 100, 0));
+    TEST_ASSERT_FALSE(filter.contains(1, 101, 0));
+    TEST_ASSERT_TRUE(filter.contains(1, 100, MQTT_RECENT_PACKET_EXPIRE_MS - 1));
+    TEST_ASSERT_FALSE(filter.contains(1, 100, MQTT_RECENT_PACKET_EXPIRE_MS));
+
+    // Packets without an id are never duplicates
+    filter.add(1, 0, 0);
+    TEST_ASSERT_FALSE(filter.contains(1, 0, 0));
+
+    // Full, the most recent packets are kept
+    for (uint32_t id = 1; id <= 10 * MQTT_RECENT_PACKETS; id++)
+        filter.add(5, id, id);
+    size_t kept = 0;
+    for (uint32_t id = 10 * MQTT_RECENT_PACKETS - MQTT_RECENT_PACKETS / 2 + 1; id <= 10 * MQTT_RECENT_PACKETS; id++)
+        kept += filter.contains(5, id, 10 * MQTT_RECENT_PACKETS);
+    TEST_ASSERT_TRUE(kept > MQTT_RECENT_PACKETS / 4);
+    TEST_ASSERT_FALSE(filter.contains(5, 1, 10 * MQTT_RECENT_PACKETS));
+}
+
 // Publishing to a text channel.
 void test_publishTextMessageDirect(void)
 {
@@ -875,6 +992,9 @@ void setup()
     UNITY_BEGIN();
     RUN_TEST(test_sendDirectlyConnectedDecoded);
     RUN_TEST(test_sendDirectlyConnectedEncrypted);
+#if !MESHTASTIC_EXCLUDE_COMPRESSION
+    RUN_TEST(test_sendCompressedEncryptedAsOriginal);
+#endif
     RUN_TEST(test_proxyToMeshServiceDecoded);
     RUN_TEST(test_proxyToMeshServiceEncrypted);
     RUN_TEST(test_dontMqttMeOnPublicServer);
@@ -896,6 +1016,11 @@ void setup()
     RUN_TEST(test_receiveIgnoresDecodedAdminApp);
     RUN_TEST(test_receiveIgnoresUnexpectedFields);
     RUN_TEST(test_receiveIgnoresInvalidHopLimit);
+    RUN_TEST(test_receiveIgnoresDuplicates);
+    RUN_TEST(test_receiveDuplicateAfterRejected);
+    RUN_TEST(test_receiveEncryptedAfterRejectedDecoded);
+    RUN_TEST(test_peekServiceEnvelopePacket);
+    RUN_TEST(test_recentPacketFilter);
     RUN_TEST(test_publishTextMessageDirect);
     RUN_TEST(test_publishTextMessageWithProxy);
     RUN_TEST(test_reportToMapDefaultImprecise);
@@ -0,0 +1,140 @@
+#include "TestUtil.h"
+#include "mesh/NextHopTable.h"
+#include <unity.h>
+
+namespace
+{
+const NodeNum DEST = 0x12345678;
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_ranking(void)
+{
+    NextHopTable t;
+    TEST_ASSERT_FALSE(t.knows(DEST, 0));
+    TEST_ASSERT_EQUAL(NO_NEXT_HOP_PREFERENCE, t.getNextHop(DEST, HOP_MAX, nullptr, 0, 0));
+
+    // Same deliveries, but the link to 2 is weak and 3 is two hops further away
+    t.noteDelivered(DEST, 1, 0, 0, 0);
+    t.noteDelivered(DEST, 2, 0, -15, 0);
+    t.noteDelivered(DEST, 3, 2, 0, 0);
+    TEST_ASSERT_TRUE(t.knows(DEST, 0));
+    TEST_ASSERT_LESS_THAN(t.getCost(DEST, 2, 0), t.getCost(DEST, 1, 0));
+    TEST_ASSERT_LESS_THAN(t.getCost(DEST, 3, 0), t.getCost(DEST, 2, 0));
+    TEST_ASSERT_EQUAL(1, t.getNextHop(DEST, HOP_MAX, nullptr, 0, 0));
+
+    // Not back to one that already relayed the packet, nor to one further away than the packet can go
+    const uint8_t relayed[] = {1};
+    TEST_ASSERT_EQUAL(2, t.getNextHop(DEST, HOP_MAX, relayed, 1, 0));
+    const uint8_t both[] = {2, 1};
+    TEST_ASSERT_EQUAL(3, t.getNextHop(DEST, 2, both, 2, 0));
+    TEST_ASSERT_EQUAL(NO_NEXT_HOP_PREFERENCE, t.getNextHop(DEST, 1, both, 2, 0));
+    TEST_ASSERT_EQUAL(UINT32_MAX, t.getCost(DEST, 4, 0));
+}
+
+void test_failover(void)
+{
+    // 1 has delivered for a while, 2 only once
+    NextHopTable t;
+    for (int i = 0; i < 10; i++)
+        t.noteDelivered(DEST, 1, 0, 0, 0);
+    t.noteDelivered(DEST, 2, 0, 0, 0);
+
+    // One failure is bad luck, after two in a row the other one takes over
+    t.noteFailed(DEST, 1, 0);
+    TEST_ASSERT_EQUAL(1, t.getNextHop(DEST, HOP_MAX, nullptr, 0, 0));
+    t.noteFailed(DEST, 1, 0);
+    TEST_ASSERT_EQUAL(2, t.getNextHop(DEST, HOP_MAX, nullptr, 0, 0));
+
+    // Until none delivers often enough to be used, though we still know the destination
+    for (int i = 0; i < 4; i++) {
+        t.noteFailed(DEST, 1, 0);
+        t.noteFailed(DEST, 2, 0);
+    }
+    TEST_ASSERT_LESS_THAN(NEXT_HOP_MIN_DELIVERY, t.getDeliveryPercent(DEST, 2, 0));
+    TEST_ASSERT_EQUAL(NO_NEXT_HOP_PREFERENCE, t.getNextHop(DEST, HOP_MAX, nullptr, 0, 0));
+    TEST_ASSERT_TRUE(t.knows(DEST, 0));
+
+    // A new ACK brings it back
+    t.noteDelivered(DEST, 2, 0, 0, 1);
+    t.noteDelivered(DEST, 2, 0, 0, 2);
+    TEST_ASSERT_EQUAL(2, t.getNextHop(DEST, HOP_MAX, nullptr, 0, 2));
+}
+
+void test_alternates(void)
+{
+    // An ACK through a node we didn't hear relay our packet doesn't make a route on its own
+    NextHopTable t;
+    t.noteAlternate(DEST, 5, 0, 10, 0);
+    TEST_ASSERT_FALSE(t.knows(DEST, 0));
+    TEST_ASSERT_EQUAL(0, t.getDeliveryPercent(DEST, 5, 0));
+
+    // Even a better one is only used when the next hops that relayed ours won't do
+    t.noteDelivered(DEST, 1, 0, -15, 0);
+    t.noteAlternate(DEST, 5, 0, 10, 0);
+    TEST_ASSERT_LESS_THAN(t.getCost(DEST, 1, 0), t.getCost(DEST, 5, 0));
+    TEST_ASSERT_EQUAL(1, t.getNextHop(DEST, HOP_MAX, nullptr, 0, 0));
+    const uint8_t relayed[] = {1};
+    TEST_ASSERT_EQUAL(5, t.getNextHop(DEST, HOP_MAX, relayed, 1, 0));
+    // But never for a retransmission, it might not hear us
+    TEST_ASSERT_EQUAL(NO_NEXT_HOP_PREFERENCE, t.getNextHop(DEST, HOP_MAX, relayed, 1, 0, false));
+
+    // Relaying ours makes it a proper next hop
+    t.noteDelivered(DEST, 5, 0, 10, 0);
+    TEST_ASSERT_EQUAL(5, t.getNextHop(DEST, HOP_MAX, nullptr, 0, 0));
+
+    // Alternates make way for next hops that relayed ours, never the other way round
+    t.noteAlternate(DEST, 6, 0, 10, 0);
+    t.noteDelivered(DEST, 7, 0, 10, 0);
+    TEST_ASSERT_EQUAL(0, t.getDeliveryPercent(DEST, 6, 0));
+    t.noteAlternate(DEST, 8, 0, 10, 0);
+    TEST_ASSERT_EQUAL(0, t.getDeliveryPercent(DEST, 8, 0));
+    TEST_ASSERT_NOT_EQUAL(0, t.getDeliveryPercent(DEST, 1, 0));
+    TEST_ASSERT_NOT_EQUAL(0, t.getDeliveryPercent(DEST, 7, 0));
+}
+
+void test_expiry(void)
+{
+    NextHopTable t;
+    t.noteDelivered(DEST, 1, 0, 0, 0);
+    uint8_t fresh = t.getDeliveryPercent(DEST, 1, 0);
+    TEST_ASSERT_EQUAL(fresh / 2, t.getDeliveryPercent(DEST, 1, NEXT_HOP_EXPIRE_MSEC / 2));
+    TEST_ASSERT_EQUAL(NO_NEXT_HOP_PREFERENCE, t.getNextHop(DEST, HOP_MAX, nullptr, 0, NEXT_HOP_EXPIRE_MSEC / 2));
+    TEST_ASSERT_TRUE(t.knows(DEST, NEXT_HOP_EXPIRE_MSEC / 2));
+    TEST_ASSERT_FALSE(t.knows(DEST, NEXT_HOP_EXPIRE_MSEC));
+
+    // Across millis() wrapping
+    NextHopTable w;
+    w.noteDelivered(DEST, 1, 0, 0, UINT32_MAX - 1000);
+    TEST_ASSERT_EQUAL(1, w.getNextHop(DEST, HOP_MAX, nullptr, 0, 1000));
+}
+
+void test_full(void)
+{
+    // Newcomers replace the destination we sent to least recently
+    NextHopTable t;
+    for (uint32_t i = 0; i < NEXT_HOP_MAX_DESTINATIONS; i++)
+        t.noteDelivered(i + 1, 1, 0, 0, i);
+    TEST_ASSERT_EQUAL(1, t.getNextHop(1, HOP_MAX, nullptr, 0, NEXT_HOP_MAX_DESTINATIONS));
+    t.noteDelivered(DEST, 1, 0, 0, NEXT_HOP_MAX_DESTINATIONS + 1);
+    TEST_ASSERT_TRUE(t.knows(DEST, NEXT_HOP_MAX_DESTINATIONS + 1));
+    TEST_ASSERT_TRUE(t.knows(1, NEXT_HOP_MAX_DESTINATIONS + 1));
+    TEST_ASSERT_FALSE(t.knows(2, NEXT_HOP_MAX_DESTINATIONS + 1));
+    TEST_ASSERT_TRUE(t.knows(3, NEXT_HOP_MAX_DESTINATIONS + 1));
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_ranking);
+    RUN_TEST(test_failover);
+    RUN_TEST(test_alternates);
+    RUN_TEST(test_expiry);
+    RUN_TEST(test_full);
+    exit(UNITY_END());
+}
+
+void loop() {}
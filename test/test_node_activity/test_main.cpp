@@ -0,0 +1,159 @@
+#include "TestUtil.h"
+#include "mesh/NodeActivity.h"
+#include <Arduino.h>
+#include <unity.h>
+
+#include <vector>
+
+namespace
+{
+struct Node {
+    uint32_t lastHeard;
+    bool viaMqtt;
+};
+
+// What NodeDB used to do: look at every node. Buckets include the minute secs ago in full, so the oldest second
+// counts too.
+size_t bruteForce(const std::vector<Node> &nodes, uint32_t now, uint32_t secs, bool localOnly)
+{
+    size_t count = 0;
+    for (const Node &n : nodes) {
+        if (localOnly && n.viaMqtt)
+            continue;
+        int delta = (int)(now - n.lastHeard);
+        if (delta < 0)
+            delta = 0;
+        if ((uint32_t)delta <= secs)
+            count++;
+    }
+    return count;
+}
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_onlineWindow(void)
+{
+    NodeActivity activity;
+    const uint32_t now = 1700000000 - 1700000000 % 60;
+    activity.add(now - 10, false, now);
+    activity.add(now - 3600, true, now);
+    activity.add(now - 7200 - 60, false, now); // Too old to count
+    activity.add(0, false, now);               // Never heard
+
+    TEST_ASSERT_EQUAL(2, activity.countHeardWithin(now, 7200, false));
+    TEST_ASSERT_EQUAL(1, activity.countHeardWithin(now, 7200, true));
+    TEST_ASSERT_EQUAL(1, activity.countHeardWithin(now, 15 * 60, false));
+
+    // Hearing a node again moves it to the newer bucket
+    activity.remove(now - 3600, true);
+    activity.add(now - 5, false, now);
+    TEST_ASSERT_EQUAL(2, activity.countHeardWithin(now, 15 * 60, true));
+
+    // Two hours later they have all expired
+    TEST_ASSERT_EQUAL(0, activity.countHeardWithin(now + 7200 + 60, 7200, false));
+}
+
+// Our clock can jump backwards, a last_heard in the future counts as just now
+void test_futureCountsAsNow(void)
+{
+    NodeActivity activity;
+    activity.add(1000000, false, 900000);
+    TEST_ASSERT_EQUAL(1, activity.countHeardWithin(900000, 7200, false));
+    TEST_ASSERT_EQUAL(1, activity.countHeardWithin(900000, 600, false));
+
+    // Once the clock catches up it ages like any other
+    TEST_ASSERT_EQUAL(1, activity.countHeardWithin(1000000 + 600, 600, false));
+    TEST_ASSERT_EQUAL(0, activity.countHeardWithin(1000000 + 660, 600, false));
+}
+
+// A timestamp from before an RTC reset must not stop the nodes heard now from counting
+void test_futureDoesNotHideNow(void)
+{
+    NodeActivity activity;
+    const uint32_t now = 1700000000;
+    activity.add(now + 30 * 24 * 3600, false, now); // Loaded from the DB, written with a clock a month ahead
+    activity.add(now, false, now);
+    activity.add(now - 60, true, now);
+
+    TEST_ASSERT_EQUAL(3, activity.countHeardWithin(now, 7200, false));
+    TEST_ASSERT_EQUAL(2, activity.countHeardWithin(now, 600, true));
+
+    // Hearing the future node again moves it to now
+    activity.remove(now + 30 * 24 * 3600, false);
+    activity.add(now + 10, false, now + 10);
+    TEST_ASSERT_EQUAL(3, activity.countHeardWithin(now + 10, 7200, false));
+    TEST_ASSERT_EQUAL(0, activity.countHeardWithin(now + 3 * 3600, 7200, false));
+}
+
+// When our clock goes backwards, what was heard after it counts as just now
+void test_clockGoesBack(void)
+{
+    NodeActivity activity;
+    const uint32_t now = 1700000000 - 1700000000 % 60;
+    activity.add(now - 600, false, now);
+    activity.add(now - 3 * 3600, false, now); // Long gone, and stays gone
+    TEST_ASSERT_EQUAL(1, activity.countHeardWithin(now, 7200, false));
+
+    const uint32_t reset = 3600; // RTC back to an hour after 1970
+    TEST_ASSERT_EQUAL(1, activity.countHeardWithin(reset, 7200, false));
+    activity.add(reset, false, reset);
+    TEST_ASSERT_EQUAL(2, activity.countHeardWithin(reset, 600, false));
+
+    // Then GPS sets it right again
+    TEST_ASSERT_EQUAL(1, activity.countHeardWithin(now, 7200, false));
+    activity.remove(now - 600, false);
+    TEST_ASSERT_EQUAL(0, activity.countHeardWithin(now, 7200, false));
+}
+
+// Random updates over a day must agree with counting every node, to the minute
+void test_matchesFullScan(void)
+{
+    randomSeed(42);
+    NodeActivity activity;
+    std::vector<Node> nodes(300);
+    uint32_t now = 1700000000;
+    for (Node &n : nodes) {
+        n = {now - (uint32_t)random(4 * 3600), random(4) == 0};
+        activity.add(n.lastHeard, n.viaMqtt, now);
+    }
+
+    int mismatches = 0;
+    for (int step = 0; step < 2000; step++) {
+        now += random(90);
+        Node &n = nodes[random(nodes.size())];
+        activity.remove(n.lastHeard, n.viaMqtt);
+        // Now and then a node whose clock is ahead of ours, like one loaded from before an RTC reset
+        n = {random(20) == 0 ? now + (uint32_t)random(3 * 3600) : now, random(4) == 0};
+        activity.add(n.lastHeard, n.viaMqtt, now);
+
+        // Compare on minute boundaries, where both agree exactly
+        uint32_t minute = now - now % 60;
+        for (uint32_t secs : {300u, 1800u, 7200u}) {
+            for (bool localOnly : {false, true}) {
+                if (activity.countHeardWithin(minute, secs, localOnly) != bruteForce(nodes, minute, secs, localOnly))
+                    mismatches++;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(0, mismatches);
+}
+
+void setup()
+{
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(10);
+    delay(2000);
+
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_onlineWindow);
+    RUN_TEST(test_futureCountsAsNow);
+    RUN_TEST(test_futureDoesNotHideNow);
+    RUN_TEST(test_clockGoesBack);
+    RUN_TEST(test_matchesFullScan);
+    exit(UNITY_END());
+}
+
+void loop() {}
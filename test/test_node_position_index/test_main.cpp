@@ -0,0 +1,201 @@
+#include "TestUtil.h"
+#include "mesh/NodePositionIndex.h"
+#include <Arduino.h>
+#include <unity.h>
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+namespace
+{
+struct Node {
+    uint16_t dbIndex;
+    int32_t lat, lon;
+};
+
+// Nodes scattered around a point, spread given in 1e-7 degrees
+std::vector<Node> scatter(size_t count, int32_t lat, int32_t lon, int32_t spread)
+{
+    std::vector<Node> nodes;
+    for (size_t i = 0; i < count; i++)
+        nodes.push_back({(uint16_t)i, lat + (int32_t)random(-spread, spread), lon + (int32_t)random(-spread, spread)});
+    return nodes;
+}
+
+std::vector<uint16_t> bruteForceNearest(const std::vector<Node> &nodes, int32_t lat, int32_t lon, size_t count)
+{
+    const double lonScale = cos(lat * 1e-7 * M_PI / 180);
+    std::vector<std::pair<double, uint16_t>> all;
+    for (const Node &n : nodes) {
+        double dLat = (double)n.lat - lat, dLon = ((double)n.lon - lon) * lonScale;
+        all.push_back(std::make_pair(dLat * dLat + dLon * dLon, n.dbIndex));
+    }
+    std::sort(all.begin(), all.end());
+    std::vector<uint16_t> nearest;
+    for (size_t i = 0; i < count && i < all.size(); i++)
+        nearest.push_back(all[i].second);
+    return nearest;
+}
+
+void fill(NodePositionIndex &index, const std::vector<Node> &nodes)
+{
+    index.clear();
+    for (const Node &n : nodes)
+        index.set(n.dbIndex, n.lat, n.lon);
+}
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_setMoveRemove(void)
+{
+    NodePositionIndex index;
+    int32_t minLat, maxLat, minLon, maxLon;
+    TEST_ASSERT_FALSE(index.getBounds(&minLat, &maxLat, &minLon, &maxLon));
+
+    index.set(1, 473000000, 85000000);
+    index.set(2, 474000000, 86000000);
+    index.set(3, 472000000, 84000000);
+    TEST_ASSERT_EQUAL(3, index.size());
+    TEST_ASSERT_TRUE(index.getBounds(&minLat, &maxLat, &minLon, &maxLon));
+    TEST_ASSERT_EQUAL(472000000, minLat);
+    TEST_ASSERT_EQUAL(474000000, maxLat);
+    TEST_ASSERT_EQUAL(84000000, minLon);
+    TEST_ASSERT_EQUAL(86000000, maxLon);
+
+    // Moving a node that was on the edge shrinks the box
+    index.set(2, 473500000, 85500000);
+    TEST_ASSERT_EQUAL(3, index.size());
+    index.getBounds(&minLat, &maxLat, &minLon, &maxLon);
+    TEST_ASSERT_EQUAL(473500000, maxLat);
+    TEST_ASSERT_EQUAL(85500000, maxLon);
+
+    index.remove(3);
+    index.getBounds(&minLat, &maxLat, &minLon, &maxLon);
+    TEST_ASSERT_EQUAL(473000000, minLat);
+    TEST_ASSERT_EQUAL(85000000, minLon);
+
+    // Node 1 leaves the DB, node 2 takes its place
+    index.removeAndShift(1);
+    TEST_ASSERT_EQUAL(1, index.size());
+    TEST_ASSERT_EQUAL(1, index.getEntries()[0].dbIndex);
+    TEST_ASSERT_EQUAL(473500000, index.getEntries()[0].latitude_i);
+
+    // It is found under its new index, and the old one is free
+    index.set(1, 473600000, 85600000);
+    TEST_ASSERT_EQUAL(1, index.size());
+    index.set(2, 473600000, 85600000);
+    TEST_ASSERT_EQUAL(2, index.size());
+    index.remove(1);
+    index.remove(2);
+    TEST_ASSERT_EQUAL(0, index.size());
+}
+
+void test_findInBox(void)
+{
+    randomSeed(7);
+    // Spread over several cells, on both sides of the equator and the prime meridian
+    std::vector<Node> nodes = scatter(500, 0, 0, 20000000);
+    NodePositionIndex index;
+    fill(index, nodes);
+
+    for (int q = 0; q < 50; q++) {
+        int32_t lat0 = random(-20000000, 20000000), lat1 = lat0 + random(0, 10000000);
+        int32_t lon0 = random(-20000000, 20000000), lon1 = lon0 + random(0, 10000000);
+        std::vector<uint16_t> found;
+        index.findInBox(lat0, lat1, lon0, lon1, found);
+        std::sort(found.begin(), found.end());
+
+        std::vector<uint16_t> expected;
+        for (const Node &n : nodes)
+            if (n.lat >= lat0 && n.lat <= lat1 && n.lon >= lon0 && n.lon <= lon1)
+                expected.push_back(n.dbIndex);
+        TEST_ASSERT_EQUAL(expected.size(), found.size());
+        TEST_ASSERT_TRUE(expected == found);
+    }
+
+    // Boxes may cross the antimeridian
+    index.clear();
+    index.set(0, 100000000, 1799000000);
+    index.set(1, 100000000, -1799000000);
+    index.set(2, 100000000, 0);
+    std::vector<uint16_t> found;
+    TEST_ASSERT_EQUAL(2, index.findInBox(90000000, 110000000, 1790000000, -1790000000, found));
+}
+
+void test_findNearest(void)
+{
+    randomSeed(11);
+    const struct {
+        int32_t lat, lon, spread;
+        size_t count;
+    } cases[] = {
+        {473000000, 85000000, 3000000, 300},    // A city mesh, a few cells
+        {473000000, 85000000, 200000000, 300},  // A continent of MQTT nodes, sparse cells
+        {-335000000, -706000000, 500000, 50},   // All in one or two cells
+        {890000000, 100000000, 5000000, 100},   // Close to the pole, cells are narrow
+    };
+    for (const auto &c : cases) {
+        std::vector<Node> nodes = scatter(c.count, c.lat, c.lon, c.spread);
+        NodePositionIndex index;
+        fill(index, nodes);
+        for (int q = 0; q < 20; q++) {
+            int32_t lat = c.lat + random(-c.spread, c.spread), lon = c.lon + random(-c.spread, c.spread);
+            size_t k = 1 + random(0, 12);
+            uint16_t found[12];
+            size_t n = index.findNearest(lat, lon, k, found);
+            std::vector<uint16_t> expected = bruteForceNearest(nodes, lat, lon, k);
+            TEST_ASSERT_EQUAL(expected.size(), n);
+            for (size_t i = 0; i < n; i++)
+                TEST_ASSERT_EQUAL(expected[i], found[i]);
+        }
+    }
+
+    NodePositionIndex index;
+    uint16_t found[4];
+    TEST_ASSERT_EQUAL(0, index.findNearest(0, 0, 4, found));
+    index.set(9, 10, 10);
+    TEST_ASSERT_EQUAL(1, index.findNearest(900000000, 1800000000, 4, found));
+    TEST_ASSERT_EQUAL(9, found[0]);
+}
+
+void test_benchmarkNearest(void)
+{
+    randomSeed(3);
+    std::vector<Node> nodes = scatter(1000, 473000000, 85000000, 20000000);
+    NodePositionIndex index;
+    fill(index, nodes);
+
+    const int rounds = 2000;
+    uint16_t found[8];
+    uint32_t start = micros();
+    for (int i = 0; i < rounds; i++)
+        index.findNearest(nodes[i % nodes.size()].lat, nodes[i % nodes.size()].lon, 8, found);
+    uint32_t indexed = micros() - start;
+
+    start = micros();
+    for (int i = 0; i < rounds; i++)
+        bruteForceNearest(nodes, nodes[i % nodes.size()].lat, nodes[i % nodes.size()].lon, 8);
+    uint32_t scanned = micros() - start;
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "8 nearest of %u nodes: %u us indexed, %u us sorting them all", (unsigned)nodes.size(),
+             (unsigned)(indexed / rounds), (unsigned)(scanned / rounds));
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_setMoveRemove);
+    RUN_TEST(test_findInBox);
+    RUN_TEST(test_findNearest);
+    RUN_TEST(test_benchmarkNearest);
+    exit(UNITY_END());
+}
+
+void loop() {}
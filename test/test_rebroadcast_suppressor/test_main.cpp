@@ -0,0 +1,178 @@
+#include "TestUtil.h"
+#include "mesh/RebroadcastSuppressor.h"
+#include <unity.h>
+
+namespace
+{
+const uint8_t US = 0x10;
+
+/// A suppressor that has heard the given neighbors directly
+void hear(RebroadcastSuppressor &s, const uint8_t *nodes, size_t count, uint32_t now)
+{
+    for (size_t i = 0; i < count; i++)
+        s.noteHeard(nodes[i], now);
+}
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_coverage(void)
+{
+    RebroadcastSuppressor s;
+    s.setOurRelayId(US);
+    const uint8_t ours[] = {1, 2, 3, 4};
+    hear(s, ours, 4, 0);
+    TEST_ASSERT_EQUAL(4, s.getNumNeighbors(0));
+
+    // 1 reaches 2 and 3, but not 4
+    const uint8_t of1[] = {US, 2, 3, 9};
+    s.noteNeighbors(1, of1, 4, 0);
+    const uint8_t by1[] = {1};
+    bool complete;
+    TEST_ASSERT_EQUAL(25, s.getExtraCoverage(by1, 1, 0, &complete));
+    TEST_ASSERT_TRUE(complete);
+    TEST_ASSERT_EQUAL(RebroadcastSuppressor::USEFUL, s.judge(by1, 1, 0));
+
+    // 4 was there too, so nobody is left. We don't count as a relayer of our own packet.
+    const uint8_t of4[] = {US, 3};
+    s.noteNeighbors(4, of4, 2, 0);
+    const uint8_t by1and4[] = {1, US, 4};
+    TEST_ASSERT_EQUAL(0, s.getExtraCoverage(by1and4, 3, 0));
+    TEST_ASSERT_EQUAL(RebroadcastSuppressor::REDUNDANT, s.judge(by1and4, 3, 0));
+
+    // Without the neighbors of a relayer, all we know is that it reached itself
+    const uint8_t by5[] = {5};
+    TEST_ASSERT_EQUAL(100, s.getExtraCoverage(by5, 1, 0, &complete));
+    TEST_ASSERT_FALSE(complete);
+    const uint8_t by3[] = {3};
+    TEST_ASSERT_EQUAL(75, s.getExtraCoverage(by3, 1, 0, &complete));
+    TEST_ASSERT_FALSE(complete);
+    TEST_ASSERT_EQUAL(RebroadcastSuppressor::UNKNOWN, s.judge(nullptr, 0, 0));
+}
+
+void test_counterFallback(void)
+{
+    // No neighbor lists at all: clients cancel on the first duplicate, routers never do
+    RebroadcastSuppressor s;
+    s.setOurRelayId(US);
+    const uint8_t one[] = {1}, two[] = {2, US, 1}, twice[] = {1, 1}, three[] = {3, 2, 1};
+    TEST_ASSERT_EQUAL(RebroadcastSuppressor::USEFUL, s.judge(one, 1, 0));
+    TEST_ASSERT_EQUAL(RebroadcastSuppressor::USEFUL, s.judge(twice, 2, 0));
+    TEST_ASSERT_EQUAL(RebroadcastSuppressor::REDUNDANT, s.judge(two, 3, 0));
+
+    s.setRole(meshtastic_Config_DeviceConfig_Role_ROUTER);
+    TEST_ASSERT_EQUAL(RebroadcastSuppressor::UNKNOWN, s.judge(two, 3, 0));
+    TEST_ASSERT_EQUAL(RebroadcastSuppressor::UNKNOWN, s.judge(three, 3, 0));
+
+    // A full NeighborInfo may have left neighbors out, so it can tell us a relay is redundant but not that it is useful
+    const uint8_t ours[] = {20, 21, 22, 23};
+    hear(s, ours, 4, 0);
+    const uint8_t full[REBROADCAST_NEIGHBORS_PER_NODE] = {20, 21, 22, 23, 30, 31, 32, 33, 34, 35};
+    const uint8_t partial[] = {30};
+    s.noteNeighbors(1, full, REBROADCAST_NEIGHBORS_PER_NODE, 0);
+    s.noteNeighbors(2, partial, 1, 0);
+    s.noteNeighbors(3, full, REBROADCAST_NEIGHBORS_PER_NODE, 0);
+    TEST_ASSERT_EQUAL(RebroadcastSuppressor::REDUNDANT, s.judge(one, 1, 0));
+    const uint8_t by2and3[] = {2, 3};
+    bool complete;
+    TEST_ASSERT_EQUAL(0, s.getExtraCoverage(by2and3, 2, 0, &complete));
+    TEST_ASSERT_FALSE(complete);
+    const uint8_t by2[] = {2};
+    TEST_ASSERT_EQUAL(RebroadcastSuppressor::USEFUL, s.judge(by2, 1, 0));
+}
+
+// Without any NeighborInfo, relays one hop from the sender tell who hears whom
+void test_linksFromRelays(void)
+{
+    RebroadcastSuppressor s;
+    s.setOurRelayId(US);
+    s.setRole(meshtastic_Config_DeviceConfig_Role_ROUTER);
+    const uint8_t ours[] = {1, 2, 3, 4};
+    hear(s, ours, 4, 0);
+
+    const uint8_t by1[] = {1};
+    TEST_ASSERT_EQUAL(75, s.getExtraCoverage(by1, 1, 0));
+    TEST_ASSERT_EQUAL(RebroadcastSuppressor::UNKNOWN, s.judge(by1, 1, 0));
+
+    // 2 relayed what 1 sent, 1 relayed what 3 sent. Either way round the two heard each other.
+    s.noteRelayedFrom(2, 1, 0);
+    s.noteRelayedFrom(1, 3, 0);
+    TEST_ASSERT_EQUAL(25, s.getExtraCoverage(by1, 1, 0));
+    // Nodes we never heard directly don't take up room
+    s.noteRelayedFrom(4, 99, 0);
+    s.noteRelayedFrom(1, 4, 0);
+    TEST_ASSERT_EQUAL(0, s.getExtraCoverage(by1, 1, 0));
+    TEST_ASSERT_EQUAL(4, s.getNumNeighbors(0));
+
+    // Links only ever add to what a relayer reaches, so they can make a relay redundant but never useful
+    TEST_ASSERT_EQUAL(RebroadcastSuppressor::REDUNDANT, s.judge(by1, 1, 0));
+    const uint8_t by2[] = {2};
+    TEST_ASSERT_EQUAL(50, s.getExtraCoverage(by2, 1, 0));
+    TEST_ASSERT_EQUAL(RebroadcastSuppressor::UNKNOWN, s.judge(by2, 1, 0));
+
+    // Links not heard again are forgotten after one to two REBROADCAST_LINKS_EXPIRE_MSEC, with the neighbors still around
+    const uint32_t step = REBROADCAST_LINKS_EXPIRE_MSEC / 2 + 1;
+    hear(s, ours, 4, step);
+    hear(s, ours, 4, 2 * step);
+    TEST_ASSERT_EQUAL(0, s.getExtraCoverage(by1, 1, 2 * step));
+    s.noteRelayedFrom(3, 1, 2 * step);
+    hear(s, ours, 4, 3 * step);
+    hear(s, ours, 4, 4 * step);
+    TEST_ASSERT_EQUAL(50, s.getExtraCoverage(by1, 1, 4 * step));
+}
+
+void test_expiry(void)
+{
+    RebroadcastSuppressor s;
+    const uint8_t ours[] = {1, 2};
+    hear(s, ours, 2, 0);
+    const uint8_t of1[] = {2};
+    s.noteNeighbors(1, of1, 1, 0);
+
+    uint32_t later = REBROADCAST_HEARD_EXPIRE_MSEC + 1;
+    s.noteHeard(1, later);
+    TEST_ASSERT_EQUAL(1, s.getNumNeighbors(later));
+    const uint8_t by1[] = {1};
+    TEST_ASSERT_EQUAL(0, s.getExtraCoverage(by1, 1, later));
+    TEST_ASSERT_EQUAL(-1, s.getExtraCoverage(by1, 1, REBROADCAST_NEIGHBORS_EXPIRE_MSEC + 1));
+
+    // Across millis() wrapping
+    RebroadcastSuppressor w;
+    w.noteHeard(1, UINT32_MAX - 1000);
+    TEST_ASSERT_EQUAL(1, w.getNumNeighbors(1000));
+}
+
+void test_full(void)
+{
+    // Newcomers replace whoever we have known least about for longest
+    RebroadcastSuppressor s;
+    for (uint32_t i = 0; i < REBROADCAST_MAX_NODES; i++)
+        s.noteHeard(i + 1, i);
+    s.noteHeard(1, REBROADCAST_MAX_NODES);
+    s.noteHeard(200, REBROADCAST_MAX_NODES + 1);
+    TEST_ASSERT_EQUAL(REBROADCAST_MAX_NODES, s.getNumNeighbors(REBROADCAST_MAX_NODES + 1));
+
+    // 2 was the one to go, so 1 covers itself and only 3 to 11 of the ones it lists
+    uint8_t all[REBROADCAST_NEIGHBORS_PER_NODE];
+    for (size_t i = 0; i < REBROADCAST_NEIGHBORS_PER_NODE; i++)
+        all[i] = i + 2;
+    const uint8_t by1[] = {1};
+    s.noteNeighbors(1, all, REBROADCAST_NEIGHBORS_PER_NODE, REBROADCAST_MAX_NODES + 1);
+    TEST_ASSERT_EQUAL((REBROADCAST_MAX_NODES - 1 - (REBROADCAST_NEIGHBORS_PER_NODE - 1)) * 100 / REBROADCAST_MAX_NODES,
+                      s.getExtraCoverage(by1, 1, REBROADCAST_MAX_NODES + 1));
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_coverage);
+    RUN_TEST(test_counterFallback);
+    RUN_TEST(test_linksFromRelays);
+    RUN_TEST(test_expiry);
+    RUN_TEST(test_full);
+    exit(UNITY_END());
+}
+
+void loop() {}
@@ -0,0 +1,248 @@
+#include "DebugConfiguration.h"
+#include "TestUtil.h"
+#include <unity.h>
+
+#if !MESHTASTIC_EXCLUDE_ENVIRONMENTAL_SENSOR
+#include "modules/Telemetry/Sensor/SensorScheduler.h"
+#include <Arduino.h>
+
+#include <vector>
+
+namespace
+{
+// Sensors are grouped by bus pointer only, these are never dereferenced
+TwoWire *const busA = reinterpret_cast<TwoWire *>(0x1000);
+TwoWire *const busB = reinterpret_cast<TwoWire *>(0x2000);
+
+class MockSensor;
+std::vector<MockSensor *> started;
+
+/// A sensor that takes conversionMs to measure in the background, or that measures inside getMetrics() if that is 0
+class MockSensor : public TelemetrySensor
+{
+  public:
+    MockSensor(meshtastic_TelemetrySensorType type, TwoWire *bus, uint32_t conversionMs, uint32_t serviceIntervalMs = 0)
+        : TelemetrySensor(type, "Mock"), conversionMs(conversionMs), serviceIntervalMs(serviceIntervalMs)
+    {
+        nodeTelemetrySensorsMap[type].first = 0x40;
+        nodeTelemetrySensorsMap[type].second = bus;
+    }
+    ~MockSensor() { nodeTelemetrySensorsMap[sensorType] = {0, nullptr}; }
+
+    uint32_t conversionMs, serviceIntervalMs;
+    uint32_t intervalAfterService = 0; // If set, the cadence changes to this once serviced
+    uint32_t serviced = 0;
+    uint32_t blockingReads = 0;
+
+    virtual int32_t runOnce() override { return 0; }
+    virtual bool getMetrics(meshtastic_Telemetry *measurement) override
+    {
+        if (!takeStartedConversion())
+            blockingReads++;
+        return true;
+    }
+    virtual bool startConversion() override
+    {
+        if (!conversionMs)
+            return false;
+        started.push_back(this);
+        conversionStarted = true;
+        return true;
+    }
+    virtual uint32_t getConversionMs() override { return conversionMs; }
+    virtual uint32_t getServiceIntervalMs() override { return serviceIntervalMs; }
+    virtual void service() override
+    {
+        serviced++;
+        if (intervalAfterService)
+            serviceIntervalMs = intervalAfterService;
+    }
+
+  protected:
+    virtual void setup() override {}
+};
+} // namespace
+
+void setUp(void)
+{
+    started.clear();
+}
+void tearDown(void) {}
+
+void test_startsAllAtOnce(void)
+{
+    MockSensor fast(meshtastic_TelemetrySensorType_BMP280, busA, 10);
+    MockSensor slow(meshtastic_TelemetrySensorType_BME280, busA, 40);
+    MockSensor blocking(meshtastic_TelemetrySensorType_SHT31, busA, 0);
+    SensorScheduler scheduler;
+    scheduler.add(&fast);
+    scheduler.add(&slow);
+    scheduler.add(&blocking);
+
+    const uint32_t now = 1000;
+    TEST_ASSERT_FALSE(scheduler.isConverting());
+    // The wait is for the slowest sensor, not the sum of them all
+    TEST_ASSERT_EQUAL_UINT32(40, scheduler.startConversions(now));
+    TEST_ASSERT_TRUE(scheduler.isConverting());
+    TEST_ASSERT_EQUAL(2, started.size());
+    TEST_ASSERT_EQUAL_UINT32(30, scheduler.msUntilReady(now + 10));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.msUntilReady(now + 40));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.msUntilReady(now + 1000));
+
+    meshtastic_Telemetry m = meshtastic_Telemetry_init_zero;
+    for (size_t i = 0; i < scheduler.size(); i++)
+        scheduler.get(i)->getMetrics(&m);
+    scheduler.finishConversions();
+    TEST_ASSERT_EQUAL_UINT32(0, fast.blockingReads);
+    TEST_ASSERT_EQUAL_UINT32(0, slow.blockingReads);
+    TEST_ASSERT_EQUAL_UINT32(1, blocking.blockingReads);
+
+    // A read that wasn't prepared for measures as before
+    fast.getMetrics(&m);
+    TEST_ASSERT_EQUAL_UINT32(1, fast.blockingReads);
+}
+
+// Conversions nobody read are dropped, the next read measures afresh
+void test_abandonedConversions(void)
+{
+    MockSensor sensor(meshtastic_TelemetrySensorType_BMP280, busA, 10);
+    SensorScheduler scheduler;
+    scheduler.add(&sensor);
+
+    scheduler.startConversions(1000);
+    scheduler.finishConversions();
+    TEST_ASSERT_FALSE(scheduler.isConverting());
+
+    meshtastic_Telemetry m = meshtastic_Telemetry_init_zero;
+    sensor.getMetrics(&m);
+    TEST_ASSERT_EQUAL_UINT32(1, sensor.blockingReads);
+}
+
+void test_groupsByBus(void)
+{
+    MockSensor a1(meshtastic_TelemetrySensorType_BMP280, busA, 10);
+    MockSensor b1(meshtastic_TelemetrySensorType_BME280, busB, 10);
+    MockSensor a2(meshtastic_TelemetrySensorType_SHT31, busA, 10);
+    MockSensor b2(meshtastic_TelemetrySensorType_AHT10, busB, 10);
+    MockSensor a3(meshtastic_TelemetrySensorType_MCP9808, busA, 10);
+    SensorScheduler scheduler;
+    scheduler.add(&a1);
+    scheduler.add(&b1);
+    scheduler.add(&a2);
+    scheduler.add(&b2);
+    scheduler.add(&a3);
+
+    scheduler.startConversions(0);
+    MockSensor *expected[] = {&a1, &a2, &a3, &b1, &b2};
+    TEST_ASSERT_EQUAL(5, started.size());
+    for (size_t i = 0; i < 5; i++)
+        TEST_ASSERT_EQUAL_PTR(expected[i], started[i]);
+}
+
+void test_serviceCadence(void)
+{
+    MockSensor often(meshtastic_TelemetrySensorType_BME680, busA, 0, 35);
+    // On its own bus, so it isn't brought forward to join the other
+    MockSensor rarely(meshtastic_TelemetrySensorType_BMP280, busB, 0, 1000);
+    MockSensor never(meshtastic_TelemetrySensorType_SHT31, busA, 0);
+    SensorScheduler scheduler;
+    scheduler.add(&often);
+    scheduler.add(&rarely);
+    scheduler.add(&never);
+
+    // Run the way the module does: sleep for as long as the scheduler asks
+    uint32_t now = millis();
+    const uint32_t end = now + 3500;
+    uint32_t runs = 0;
+    while ((int32_t)(end - now) > 0) {
+        uint32_t waitMs = scheduler.service(now);
+        TEST_ASSERT_TRUE(waitMs > 0 && waitMs <= 35);
+        now += waitMs;
+        runs++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(3500 / 35, often.serviced);
+    TEST_ASSERT_EQUAL_UINT32(4, rarely.serviced);
+    TEST_ASSERT_EQUAL_UINT32(0, never.serviced);
+    // Apart from the first, runs for the slow sensor fall between those of the fast one
+    TEST_ASSERT_EQUAL_UINT32(often.serviced + rarely.serviced - 1, runs);
+
+    SensorScheduler idle;
+    idle.add(&never);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, idle.service(now));
+}
+
+// A sensor due on a bus takes along the others on that bus that are nearly due, but not those on another bus
+void test_batchesServiceByBus(void)
+{
+    MockSensor a(meshtastic_TelemetrySensorType_BMP280, busA, 0, 100);
+    MockSensor nearlyDue(meshtastic_TelemetrySensorType_BME280, busA, 0, 100 + SENSOR_SCHEDULER_BATCH_MS / 2);
+    MockSensor otherBus(meshtastic_TelemetrySensorType_SHT31, busB, 0, 100 + SENSOR_SCHEDULER_BATCH_MS / 4);
+    MockSensor notDueYet(meshtastic_TelemetrySensorType_AHT10, busA, 0, 100 + SENSOR_SCHEDULER_BATCH_MS * 2);
+    SensorScheduler scheduler;
+    scheduler.add(&a);
+    scheduler.add(&nearlyDue);
+    scheduler.add(&otherBus);
+    scheduler.add(&notDueYet);
+
+    uint32_t now = millis();
+    scheduler.service(now);
+    TEST_ASSERT_EQUAL_UINT32(1, nearlyDue.serviced);
+
+    now += 100;
+    TEST_ASSERT_EQUAL_UINT32(SENSOR_SCHEDULER_BATCH_MS / 4, scheduler.service(now));
+    TEST_ASSERT_EQUAL_UINT32(2, a.serviced);
+    TEST_ASSERT_EQUAL_UINT32(2, nearlyDue.serviced);
+    TEST_ASSERT_EQUAL_UINT32(1, otherBus.serviced);
+    TEST_ASSERT_EQUAL_UINT32(1, notDueYet.serviced);
+
+    // The other bus gets its own turn, which doesn't bring along anything on the first
+    now += SENSOR_SCHEDULER_BATCH_MS / 4;
+    TEST_ASSERT_EQUAL_UINT32(SENSOR_SCHEDULER_BATCH_MS * 2 - SENSOR_SCHEDULER_BATCH_MS / 4, scheduler.service(now));
+    TEST_ASSERT_EQUAL_UINT32(2, otherBus.serviced);
+    TEST_ASSERT_EQUAL_UINT32(1, notDueYet.serviced);
+}
+
+// Like the BME680 after it starts a measurement, a sensor can ask to be back sooner than its usual cadence
+void test_intervalAfterService(void)
+{
+    MockSensor measuring(meshtastic_TelemetrySensorType_BME680, busA, 0, 3000);
+    measuring.intervalAfterService = 150;
+    SensorScheduler scheduler;
+    scheduler.add(&measuring);
+
+    TEST_ASSERT_EQUAL_UINT32(150, scheduler.service(millis()));
+}
+
+void test_capacity(void)
+{
+    MockSensor sensor(meshtastic_TelemetrySensorType_BMP280, busA, 10);
+    SensorScheduler scheduler;
+    for (size_t i = 0; i < SENSOR_SCHEDULER_MAX_SENSORS; i++)
+        TEST_ASSERT_TRUE(scheduler.add(&sensor));
+    TEST_ASSERT_FALSE(scheduler.add(&sensor));
+    TEST_ASSERT_EQUAL(SENSOR_SCHEDULER_MAX_SENSORS, scheduler.size());
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_startsAllAtOnce);
+    RUN_TEST(test_abandonedConversions);
+    RUN_TEST(test_groupsByBus);
+    RUN_TEST(test_serviceCadence);
+    RUN_TEST(test_batchesServiceByBus);
+    RUN_TEST(test_intervalAfterService);
+    RUN_TEST(test_capacity);
+    exit(UNITY_END());
+}
+#else
+void setup()
+{
+    initializeTestEnvironment();
+    LOG_WARN("This test requires environment sensors");
+    UNITY_BEGIN();
+    UNITY_END();
+}
+#endif
+void loop() {}
@@ -0,0 +1,137 @@
+#include "TestUtil.h"
+#include "mesh/StreamFramer.h"
+#include <Arduino.h>
+#include <unity.h>
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#define MAX_PAYLOAD 512
+
+namespace
+{
+typedef std::vector<uint8_t> Bytes;
+
+Bytes frame(const Bytes &payload)
+{
+    Bytes b = {STREAM_FRAME_START1, STREAM_FRAME_START2, (uint8_t)(payload.size() >> 8), (uint8_t)payload.size()};
+    b.insert(b.end(), payload.begin(), payload.end());
+    return b;
+}
+
+Bytes payloadOf(size_t len, uint8_t seed)
+{
+    Bytes b;
+    for (size_t i = 0; i < len; i++)
+        b.push_back((uint8_t)(seed + i * 7)); // Includes the framing bytes now and then
+    return b;
+}
+
+void append(Bytes &to, const Bytes &b)
+{
+    to.insert(to.end(), b.begin(), b.end());
+}
+
+void append(Bytes &to, const char *text)
+{
+    to.insert(to.end(), text, text + strlen(text));
+}
+
+/// Every frame found in stream, fed in chunks of chunkSize bytes
+std::vector<Bytes> split(const Bytes &stream, size_t chunkSize)
+{
+    uint8_t buf[STREAM_FRAME_HEADER_LEN + MAX_PAYLOAD];
+    StreamFramer framer(buf, MAX_PAYLOAD);
+    std::vector<Bytes> frames;
+    for (size_t at = 0; at < stream.size(); at += chunkSize) {
+        const uint8_t *bytes = stream.data() + at;
+        size_t len = std::min(chunkSize, stream.size() - at);
+        while (len) {
+            size_t used = framer.feed(bytes, len);
+            TEST_ASSERT_TRUE(used > 0 || framer.hasFrame());
+            bytes += used;
+            len -= used;
+            if (framer.hasFrame())
+                frames.push_back(Bytes(framer.getPayload(), framer.getPayload() + framer.getPayloadLen()));
+        }
+    }
+    return frames;
+}
+} // namespace
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_anyChunking(void)
+{
+    std::vector<Bytes> payloads = {payloadOf(10, 1), payloadOf(0, 0), payloadOf(MAX_PAYLOAD, 3), payloadOf(1, 0x94)};
+    Bytes stream;
+    for (const Bytes &p : payloads)
+        append(stream, frame(p));
+
+    for (size_t chunkSize = 1; chunkSize <= stream.size(); chunkSize = chunkSize < 20 ? chunkSize + 1 : chunkSize * 2) {
+        std::vector<Bytes> frames = split(stream, chunkSize);
+        TEST_ASSERT_EQUAL(payloads.size(), frames.size());
+        for (size_t i = 0; i < frames.size(); i++)
+            TEST_ASSERT_TRUE(payloads[i] == frames[i]);
+    }
+}
+
+void test_skipsNoise(void)
+{
+    Bytes stream;
+    append(stream, "INFO | Booting\r\n");
+    append(stream, frame(payloadOf(20, 5)));
+    append(stream, "DEBUG | \x94 stray framing byte\r\n");
+    // A repeated first framing byte still starts the frame
+    stream.push_back(STREAM_FRAME_START1);
+    append(stream, frame(payloadOf(30, 6)));
+    // A length that is too long isn't a frame
+    append(stream, {STREAM_FRAME_START1, STREAM_FRAME_START2, 0x7f, 0xff, 1, 2, 3});
+    append(stream, frame(payloadOf(40, 7)));
+
+    for (size_t chunkSize : {1, 3, 64, 1000}) {
+        std::vector<Bytes> frames = split(stream, chunkSize);
+        TEST_ASSERT_EQUAL(3, frames.size());
+        TEST_ASSERT_TRUE(payloadOf(20, 5) == frames[0]);
+        TEST_ASSERT_TRUE(payloadOf(30, 6) == frames[1]);
+        TEST_ASSERT_TRUE(payloadOf(40, 7) == frames[2]);
+    }
+}
+
+void test_benchmarkChunks(void)
+{
+    Bytes stream;
+    for (int i = 0; i < 500; i++) {
+        append(stream, "DEBUG | some log text between the packets\r\n");
+        append(stream, frame(payloadOf(100 + i % 200, i)));
+    }
+
+    uint32_t start = micros();
+    size_t bytewise = split(stream, 1).size();
+    uint32_t bytewiseUs = micros() - start;
+    start = micros();
+    size_t chunked = split(stream, 64).size();
+    uint32_t chunkedUs = micros() - start;
+    TEST_ASSERT_EQUAL(500, bytewise);
+    TEST_ASSERT_EQUAL(500, chunked);
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "%u bytes: %u us a byte at a time, %u us in 64 byte chunks", (unsigned)stream.size(),
+             (unsigned)bytewiseUs, (unsigned)chunkedUs);
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_anyChunking);
+    RUN_TEST(test_skipsNoise);
+    RUN_TEST(test_benchmarkChunks);
+    exit(UNITY_END());
+}
+
+void loop() {}
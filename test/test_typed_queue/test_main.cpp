@@ -0,0 +1,225 @@
+#include "TestUtil.h"
+#include "mesh/PointerQueue.h"
+#include <Arduino.h>
+#include <unity.h>
+
+#include <stdio.h>
+
+#ifdef ARCH_PORTDUINO
+#include <atomic>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#endif
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_fifo(void)
+{
+    // Not a power of two, so the bound isn't just the size of the ring
+    TypedQueue<uint32_t> q(5);
+    TEST_ASSERT_TRUE(q.isEmpty());
+    TEST_ASSERT_EQUAL(5, q.numFree());
+    for (uint32_t i = 1; i <= 5; i++)
+        TEST_ASSERT_TRUE(q.enqueue(i, 0));
+    TEST_ASSERT_FALSE(q.enqueue(6, 0));
+    TEST_ASSERT_EQUAL(5, q.numUsed());
+    TEST_ASSERT_EQUAL(0, q.numFree());
+    TEST_ASSERT_EQUAL_UINT32(1, q.getOverflows());
+    TEST_ASSERT_EQUAL(5, q.getMaxUsed());
+
+    uint32_t x;
+    for (uint32_t i = 1; i <= 5; i++) {
+        TEST_ASSERT_TRUE(q.dequeue(&x, 0));
+        TEST_ASSERT_EQUAL_UINT32(i, x);
+    }
+    TEST_ASSERT_FALSE(q.dequeue(&x, 0));
+    TEST_ASSERT_TRUE(q.isEmpty());
+
+    // Round and round the ring
+    uint32_t next = 100;
+    for (uint32_t i = 100; i < 10000; i++) {
+        TEST_ASSERT_TRUE(q.enqueue(i, 0));
+        if (i % 3 == 0) {
+            while (q.dequeue(&x, 0))
+                TEST_ASSERT_EQUAL_UINT32(next++, x);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, q.getOverflows());
+    TEST_ASSERT_EQUAL(5, q.getMaxUsed());
+}
+
+void test_pointers(void)
+{
+    int values[3] = {1, 2, 3};
+    PointerQueue<int> q(2);
+    TEST_ASSERT_NULL(q.dequeuePtr(0));
+    TEST_ASSERT_TRUE(q.enqueue(&values[0], 0));
+    TEST_ASSERT_TRUE(q.enqueue(&values[1], 0));
+    // Making room the way Router does, by dropping the oldest
+    while (!q.enqueue(&values[2], 0))
+        TEST_ASSERT_EQUAL_PTR(&values[0], q.dequeuePtr(0));
+    TEST_ASSERT_EQUAL_PTR(&values[1], q.dequeuePtr(0));
+    TEST_ASSERT_EQUAL_PTR(&values[2], q.dequeuePtr(0));
+    TEST_ASSERT_NULL(q.dequeuePtr(0));
+}
+
+#ifdef ARCH_PORTDUINO
+namespace
+{
+const int numProducers = 4;
+const uint32_t perProducer = 200000;
+
+/// What the queue used to be on native, with the lock it would have needed
+class LockedQueue
+{
+    std::mutex m;
+    std::queue<uint32_t> q;
+    size_t maxElements;
+
+  public:
+    explicit LockedQueue(size_t maxElements) : maxElements(maxElements) {}
+
+    bool enqueue(uint32_t x, TickType_t)
+    {
+        std::lock_guard<std::mutex> g(m);
+        if (q.size() >= maxElements)
+            return false;
+        q.push(x);
+        return true;
+    }
+
+    bool dequeue(uint32_t *p, TickType_t)
+    {
+        std::lock_guard<std::mutex> g(m);
+        if (q.empty())
+            return false;
+        *p = q.front();
+        q.pop();
+        return true;
+    }
+};
+
+/**
+ * numProducers threads each send perProducer values (their number in the top byte, a count below), retrying while the
+ * queue is full. Returns how long it took in microseconds, and how many values arrived out of order.
+ */
+template <class Q> uint32_t runProducers(Q &q, uint32_t *outOfOrder, uint32_t *received)
+{
+    uint32_t start = micros();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numProducers; t++) {
+        threads.emplace_back([&q, t] {
+            for (uint32_t n = 0; n < perProducer; n++) {
+                while (!q.enqueue((uint32_t)t << 24 | n, 0))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    uint32_t next[numProducers] = {0};
+    *outOfOrder = *received = 0;
+    while (*received < numProducers * perProducer) {
+        uint32_t x;
+        if (!q.dequeue(&x, 0)) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t t = x >> 24;
+        if (t >= numProducers || (x & 0xffffff) != next[t]++)
+            (*outOfOrder)++;
+        (*received)++;
+    }
+    for (std::thread &t : threads)
+        t.join();
+    return micros() - start;
+}
+} // namespace
+
+void test_stressProducers(void)
+{
+    TypedQueue<uint32_t> q(64);
+    uint32_t outOfOrder, received;
+    runProducers(q, &outOfOrder, &received);
+    TEST_ASSERT_EQUAL_UINT32(numProducers * perProducer, received);
+    TEST_ASSERT_EQUAL_UINT32(0, outOfOrder);
+    TEST_ASSERT_TRUE(q.isEmpty());
+    TEST_ASSERT_TRUE(q.getMaxUsed() <= 64);
+}
+
+void test_stressDropOldest(void)
+{
+    // Producers that make room by throwing away the oldest element, as Router does, so the queue has several readers
+    TypedQueue<uint32_t> q(8);
+    std::atomic<uint32_t> dropped(0);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numProducers; t++) {
+        threads.emplace_back([&, t] {
+            for (uint32_t n = 0; n < perProducer / 4; n++) {
+                uint32_t old;
+                while (!q.enqueue((uint32_t)t << 24 | n, 0)) {
+                    if (q.dequeue(&old, 0))
+                        dropped++;
+                }
+            }
+        });
+    }
+
+    uint32_t last[numProducers], received = 0, outOfOrder = 0;
+    bool seen[numProducers] = {false};
+    std::thread consumer([&] {
+        uint32_t x;
+        while (!done || !q.isEmpty()) {
+            if (!q.dequeue(&x, 0))
+                continue;
+            uint32_t t = x >> 24, n = x & 0xffffff;
+            if (t >= numProducers || (seen[t] && n <= last[t]))
+                outOfOrder++;
+            seen[t] = true;
+            last[t] = n;
+            received++;
+        }
+    });
+    for (std::thread &t : threads)
+        t.join();
+    done = true;
+    consumer.join();
+
+    // Nothing lost or seen twice: every value was either read or dropped
+    TEST_ASSERT_EQUAL_UINT32(numProducers * (perProducer / 4), received + dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, outOfOrder);
+}
+
+void test_benchmarkProducers(void)
+{
+    uint32_t outOfOrder, received;
+    TypedQueue<uint32_t> lockFree(64);
+    uint32_t lockFreeUs = runProducers(lockFree, &outOfOrder, &received);
+    LockedQueue locked(64);
+    uint32_t lockedUs = runProducers(locked, &outOfOrder, &received);
+
+    char msg[140];
+    snprintf(msg, sizeof(msg), "%d producers x %u values: %u us lock-free, %u us with a mutex", numProducers,
+             (unsigned)perProducer, (unsigned)lockFreeUs, (unsigned)lockedUs);
+    TEST_MESSAGE(msg);
+}
+#endif
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_fifo);
+    RUN_TEST(test_pointers);
+#ifdef ARCH_PORTDUINO
+    RUN_TEST(test_stressProducers);
+    RUN_TEST(test_stressDropOldest);
+    RUN_TEST(test_benchmarkProducers);
+#endif
+    exit(UNITY_END());
+}
+
+void loop() {}
@@ -0,0 +1,162 @@
+#include "TestUtil.h"
+#include "mesh/compression/unishox2.h"
+#include <Arduino.h>
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+
+// Output of the original bit-at-a-time codec, the table-driven one must produce exactly the same bits
+static const struct {
+    const char *text;
+    const char *compressedHex;
+} golden[] = {
+    {"Hello everyone, anyone on tonight?", "8767c7149fd3dfcd6324a73e6b1aac51597edda07d8b"},
+    {"HELLO WORLD THIS IS LOUD", "80767c7140803deb7c7408203b0586905869070141dc3a"},
+    {"Mixed CASE and ALLCAPS words, OK?", "879bfe7d20e424340d4e7480278e399f1a05ef5beb4490507d8fb1"},
+    {"Node !a1b2c3d4 at 0xDEADBEEF", "86574d0fb9149436587a8a611407f11d26f56df779"},
+    {"550e8400-e29b-41d4-a716-446655440000", "919543a10038a6d07529c59119955100000b"},
+    {"Call (555) 123-4567 at 12:34:56", "8733c708860aaa2468acea6110e0934ac5"},
+    {"2024-05-17T08:15:30.123Z", "9008090ab905580919"},
+    {"aaaaaaaaaaaaaaaaaaaaaaa bbbbbbbbb", "916075555555555555555555555488a5bbbbbbbbb2"},
+    {"the mention of testing and nothing with the ment", "c766bcbc8bac55f0a1ea2f3d94e74b2a3b5e7b2f7b8ec8cf10"},
+    {"{\"lat\": 52.52, \"lon\": 13.405, \"name\":\"base\"}", "8a138981fe2cb796bd081c560ff14f0f98c5e840c9f2cbf3d4e9882c"},
+    {"https://www.meshtastic.org/docs and http://example.com",
+     "f688f1a2fdf7f7f727e5ebb44ea2f9275bf62df55ce94e74bb44782fd7fd3e7c70c9f35e4b"},
+    {"h\xc3\xa9llo w\xc3\xb6rld \xe2\x9c\x93 caf\xc3\xa9", "f63c0a9e38a5ee70ddf1d23e2bbab99f83eabd45"},
+    {"line one\nline two\r\nline\tthree", "f178d5631ce2f1a8f7a1d7178c7bc76db6"},
+    {"\x01\x02\x03 binary \x7f\x1f end", "91fb404080c8189a5b985c9e481fc7c8195b990b"},
+    {"1234567890 9876543210 42", "94df1ce75dbbd47aaefdbace78b98f5cdf"},
+    {"", "97"},
+};
+
+static const char *texts[] = {
+    "Hello everyone, anyone on tonight?",
+    "Copy that, loud and clear",
+    "On my way, be there in 10 minutes",
+    "Is the router on the hill back online?",
+    "Checking in from the north side, signal is good",
+    "Meet at the trailhead parking lot at noon?",
+    "ALPHA-1 at grid 0xDEADBEEF",
+    "The quick brown fox jumps over the lazy dog",
+};
+
+static void toHex(const char *in, int len, char *hex)
+{
+    for (int i = 0; i < len; i++)
+        sprintf(hex + i * 2, "%02x", (uint8_t)in[i]);
+    hex[len * 2] = 0;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_bitExact(void)
+{
+    char out[256];
+    char hex[sizeof(out) * 2 + 1];
+    char back[256];
+
+    for (const auto &g : golden) {
+        int len = strlen(g.text);
+        int clen = unishox2_compress_simple(g.text, len, out);
+        toHex(out, clen, hex);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(g.compressedHex, hex, g.text);
+
+        int dlen = unishox2_decompress_simple(out, clen, back);
+        TEST_ASSERT_EQUAL(len, dlen);
+        TEST_ASSERT_EQUAL_MEMORY(g.text, back, len);
+    }
+}
+
+void test_roundTripRandom(void)
+{
+    // Alphabets that exercise each of the encoder's sets: upper case runs, hex/nibbles, frequent sequences, UTF-8 and binary
+    static const char *alphabets[] = {
+        "abcdef0123456789",         "ABCDEFGHIJKLMNOPQRSTUVWXYZ ", "the and tion ment://www.", "\xc3\xa9\xe2\x9c\x93 x\n\r\t",
+        "\x01\x7f\x80\xff ",        "-:()0123456789",              "\"{}<>=/ ",
+    };
+    const int numAlphabets = sizeof(alphabets) / sizeof(alphabets[0]);
+    char in[240];
+    char out[sizeof(in) * 4];
+    char back[sizeof(in) + 1];
+
+    randomSeed(42);
+    for (int iter = 0; iter < 5000; iter++) {
+        int len = random(sizeof(in));
+        const char *alphabet = alphabets[iter % numAlphabets];
+        int alphabetLen = strlen(alphabet);
+        for (int i = 0; i < len; i++)
+            in[i] = (iter & 1) ? alphabet[random(alphabetLen)] : alphabets[random(numAlphabets)][random(4)];
+
+        int clen = unishox2_compress(in, len, out, sizeof(out), USX_PSET_DFLT);
+        TEST_ASSERT_LESS_OR_EQUAL(sizeof(out), clen);
+        int dlen = unishox2_decompress(out, clen, back, sizeof(back), USX_PSET_DFLT);
+        TEST_ASSERT_EQUAL(len, dlen);
+        TEST_ASSERT_EQUAL_MEMORY(in, back, len);
+    }
+}
+
+void test_decompressGarbage(void)
+{
+    char in[64];
+    char back[200];
+
+    // Must never write past the output buffer or read past the input
+    randomSeed(7);
+    for (int iter = 0; iter < 20000; iter++) {
+        int len = random(sizeof(in) + 1);
+        for (int i = 0; i < len; i++)
+            in[i] = random(256);
+        int dlen = unishox2_decompress(in, len, back, sizeof(back), USX_PSET_DFLT);
+        TEST_ASSERT_LESS_OR_EQUAL(sizeof(back) + 1, dlen);
+    }
+}
+
+// Not a pass/fail test: reports codec throughput on chat sized messages
+void test_benchmark(void)
+{
+    const int rounds = 1000;
+    const int numTexts = sizeof(texts) / sizeof(texts[0]);
+    char compressed[numTexts][128];
+    int compressedLen[numTexts];
+    char back[128];
+    size_t plainBytes = 0;
+
+    for (int i = 0; i < numTexts; i++)
+        plainBytes += strlen(texts[i]);
+
+    uint32_t start = micros();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < numTexts; i++)
+            compressedLen[i] = unishox2_compress_simple(texts[i], strlen(texts[i]), compressed[i]);
+    }
+    uint32_t compressUs = micros() - start;
+
+    start = micros();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < numTexts; i++)
+            unishox2_decompress_simple(compressed[i], compressedLen[i], back);
+    }
+    uint32_t decompressUs = micros() - start;
+
+    char msg[160];
+    uint64_t totalBytes = (uint64_t)plainBytes * rounds;
+    snprintf(msg, sizeof(msg), "%u bytes x %d rounds: compress %u us (%u KB/s), decompress %u us (%u KB/s)",
+             (unsigned)plainBytes, rounds, compressUs, (unsigned)(totalBytes * 1000000 / (compressUs + 1) / 1024),
+             decompressUs, (unsigned)(totalBytes * 1000000 / (decompressUs + 1) / 1024));
+    TEST_MESSAGE(msg);
+}
+
+void setup()
+{
+    initializeTestEnvironment();
+    UNITY_BEGIN();
+    RUN_TEST(test_bitExact);
+    RUN_TEST(test_roundTripRandom);
+    RUN_TEST(test_decompressGarbage);
+    RUN_TEST(test_benchmark);
+    exit(UNITY_END());
+}
+
+void loop() {}